@@ -100,6 +100,23 @@ void DataElement::resize( unsigned int newNumLocalData )
 	numLocalData_ = newNumLocalData;
 	cinfo()->dinfo()->destroyData( temp );
 	numLocalData_ = newNumLocalData;
+	markMsgsRewired();
+}
+
+void DataElement::shiftLocalData( unsigned int newNumLocalData, int offset )
+{
+	char* temp = data_;
+	if ( numLocalData_ == 0 ) {
+		data_ = cinfo()->dinfo()->allocData( newNumLocalData );
+	} else {
+		int n = numLocalData_;
+		unsigned int startEntry = ( ( offset % n ) + n ) % n;
+		data_ = cinfo()->dinfo()->copyData(
+					temp, numLocalData_, newNumLocalData, startEntry );
+	}
+	cinfo()->dinfo()->destroyData( temp );
+	numLocalData_ = newNumLocalData;
+	markMsgsRewired();
 }
 
 /////////////////////////////////////////////////////////////////////////
@@ -112,5 +129,6 @@ void DataElement::zombieSwap( const Cinfo* zCinfo )
 	data_ = zCinfo->dinfo()->allocData( numLocalData_ );
 	replaceCinfo( zCinfo );
 	size_ = zCinfo->dinfo()->sizeIncrement();
+	markMsgsRewired();
 	Element::zombieSwap( zCinfo ); // Handles clock tick reassignment.
 }
@@ -113,6 +113,14 @@ class DataElement: public Element
 		 */
 		void resize( unsigned int newNumData );
 
+		/**
+		 * Changes the number of data entries on the current node to
+		 * newNumLocalData. Old entry i + offset becomes new entry i
+		 * where it exists. The other new entries are copies of old
+		 * ones. Used when entries move between nodes.
+		 */
+		void shiftLocalData( unsigned int newNumLocalData, int offset );
+
 		/**
 		 * Inherited virtual.
 		 * Changes the number of fields on the specified data entry.
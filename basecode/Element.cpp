@@ -14,6 +14,16 @@
 #include "../shell/Shell.h"
 #include "../scheduling/Clock.h"
 
+/**
+ * Backs Element::classIndex. Never freed, because Elements may still be
+ * destroyed during static destruction.
+ */
+static Element::ClassIndex& elementsByClass()
+{
+    static Element::ClassIndex* index = new Element::ClassIndex();
+    return *index;
+}
+
 Element::Element( Id id, const Cinfo* c, const string& name )
     :	name_( name ),
       id_( id ),
@@ -25,11 +35,15 @@ Element::Element( Id id, const Cinfo* c, const string& name )
       isDoomed_( false )
 {
     id.bindIdToElement( this );
+    elementsByClass()[ c ].insert( id );
 }
 
 
 Element::~Element()
 {
+    ClassIndex::iterator c = elementsByClass().find( cinfo_ );
+    if ( c != elementsByClass().end() )
+        c->second.erase( id_ );
     // A flag that the Element is doomed, used to avoid lookups
     // when deleting Msgs.
     id_.zeroOut();
@@ -60,6 +74,15 @@ const string& Element::getName() const
 
 void Element::setName( const string& val )
 {
+    // Re-file the Msg from the parent, if any, under the new name.
+    ObjId mid = findParentMsg();
+    if ( mid.dataIndex != BADINDEX )
+    {
+        Element* pa = Msg::getMsg( mid )->e1();
+        pa->dropChildMsg( name_, mid );
+        pa->children_.insert( make_pair( val, mid ) );
+        Shell::clearPathCache();
+    }
     name_ = val;
 }
 
@@ -76,6 +99,16 @@ Id Element::id() const
 /////////////////////////////////////////////////////////////////////////
 // Msg Management
 /////////////////////////////////////////////////////////////////////////
+
+/// BindIndex of the childOut SrcFinfo of Neutral.
+static BindIndex childBindIndex()
+{
+    static const Finfo* cf = Neutral::initCinfo()->findFinfo( "childOut" );
+    static const BindIndex bi =
+        dynamic_cast< const SrcFinfo* >( cf )->getBindIndex();
+    return bi;
+}
+
 void Element::addMsg( ObjId m )
 {
     while ( m_.size() > 0 )
@@ -117,22 +150,86 @@ void Element::dropMsg( ObjId mid )
     // Here we have the spectacularly ugly C++ erase-remove idiot.
     m_.erase( remove( m_.begin(), m_.end(), mid ), m_.end() );
 
+    bool droppedChild = false;
     for ( vector< vector< MsgFuncBinding > >::iterator i = msgBinding_.begin(); i != msgBinding_.end(); ++i )
     {
         matchMid match( mid );
-        i->erase( remove_if( i->begin(), i->end(), match ), i->end() );
+        vector< MsgFuncBinding >::iterator end =
+            remove_if( i->begin(), i->end(), match );
+        if ( end != i->end() &&
+                BindIndex( i - msgBinding_.begin() ) == childBindIndex() )
+            droppedChild = true;
+        i->erase( end, i->end() );
+    }
+    // The child may already be renamed or half destroyed, so look for
+    // the Msg rather than the name.
+    if ( droppedChild )
+    {
+        for ( ChildIndex::iterator i = children_.begin();
+                i != children_.end(); ++i )
+        {
+            if ( i->second == mid )
+            {
+                children_.erase( i );
+                Shell::clearPathCache();
+                break;
+            }
+        }
     }
     markRewired();
 }
 
+/// True if the Msg/Func pair is the childOut->parentMsg link of Neutral.
+static bool isChildMsg( const Cinfo* c, FuncId fid, BindIndex bindIndex )
+{
+    static const Finfo* pf = Neutral::initCinfo()->findFinfo( "parentMsg" );
+    static const FuncId pafid =
+        dynamic_cast< const DestFinfo* >( pf )->getFid();
+
+    return bindIndex == childBindIndex() && fid == pafid &&
+           c->isA( "Neutral" );
+}
+
 void Element::addMsgAndFunc( ObjId mid, FuncId fid, BindIndex bindIndex )
 {
     if ( msgBinding_.size() < bindIndex + 1U )
         msgBinding_.resize( bindIndex + 1 );
     msgBinding_[ bindIndex ].push_back( MsgFuncBinding( mid, fid ) );
+    if ( isChildMsg( cinfo_, fid, bindIndex ) )
+    {
+        const Msg* m = Msg::getMsg( mid );
+        assert( m );
+        children_.insert( make_pair( m->e2()->getName(), mid ) );
+    }
     markRewired();
 }
 
+pair< Element::ChildIndex::const_iterator, Element::ChildIndex::const_iterator >
+Element::findChildMsgs( const string& name ) const
+{
+    return children_.equal_range( name );
+}
+
+const Element::ClassIndex& Element::classIndex()
+{
+    return elementsByClass();
+}
+
+bool Element::dropChildMsg( const string& name, ObjId mid )
+{
+    pair< ChildIndex::iterator, ChildIndex::iterator > range =
+        children_.equal_range( name );
+    for ( ChildIndex::iterator i = range.first; i != range.second; ++i )
+    {
+        if ( i->second == mid )
+        {
+            children_.erase( i );
+            return true;
+        }
+    }
+    return false;
+}
+
 void Element::clearBinding( BindIndex b )
 {
     assert( b < msgBinding_.size() );
@@ -153,6 +250,7 @@ void Element::clearAllMsgs()
     m_.clear();
     msgBinding_.clear();
     msgDigest_.clear();
+    children_.clear();
 }
 
 /// virtual func, this base version must be called by all derived classes
@@ -371,6 +469,25 @@ ObjId Element::findCaller( FuncId fid ) const
     return ObjId( 0, BADINDEX );
 }
 
+ObjId Element::findParentMsg() const
+{
+    for ( vector< ObjId >::const_iterator i = m_.begin(); i != m_.end(); ++i )
+    {
+        const Msg* m = Msg::getMsg( *i );
+        if ( !m || m->e2() != this )
+            continue;
+        pair< ChildIndex::const_iterator, ChildIndex::const_iterator >
+            range = m->e1()->findChildMsgs( name_ );
+        for ( ChildIndex::const_iterator j = range.first;
+                j != range.second; ++j )
+        {
+            if ( j->second == *i )
+                return *i;
+        }
+    }
+    return ObjId( 0, BADINDEX );
+}
+
 unsigned int Element::findBinding( MsgFuncBinding b ) const
 {
     for ( unsigned int i = 0; i < msgBinding_.size(); ++i )
@@ -555,6 +672,28 @@ void Element::putOffNodeTargetsInDigest(
     }
 }
 
+/**
+ * Resolves the direct entry of the digest function and the data of each
+ * target, so that send does not have to on every call. The data pointers
+ * are only cached for plain data entries here on this node: field arrays
+ * may be reallocated by their parent at any time. If the target data
+ * themselves move, markMsgsRewired brings us back here.
+ */
+static void bindDirectTargets( MsgDigest& md )
+{
+    md.direct = md.func->directFunc();
+    md.data.assign( md.targets.size(), 0 );
+    if ( !md.direct )
+        return;
+    for ( unsigned int i = 0; i < md.targets.size(); ++i )
+    {
+        const Eref& tgt = md.targets[i];
+        if ( tgt.dataIndex() != ALLDATA && !tgt.element()->hasFields() &&
+                tgt.isDataHere() )
+            md.data[i] = tgt.data();
+    }
+}
+
 unsigned int findNumDigest( const vector< vector< MsgDigest > > & md,
                             unsigned int totFunc, unsigned int numData, unsigned int funcNum	)
 {
@@ -615,6 +754,11 @@ void Element::digestMessages()
             }
         }
     }
+    for ( vector< vector< MsgDigest > >::iterator
+            i = msgDigest_.begin(); i != msgDigest_.end(); ++i )
+        for ( vector< MsgDigest >::iterator
+                j = i->begin(); j != i->end(); ++j )
+            bindDirectTargets( *j );
 }
 
 /////////////////////////////////////////////////////////////////////////
@@ -708,6 +852,19 @@ void Element::markRewired( )
     isRewired_ = true;
 }
 
+void Element::markMsgsRewired()
+{
+    for ( vector< ObjId >::const_iterator i = m_.begin();
+            i != m_.end(); ++i )
+    {
+        if ( i->bad() )
+            continue;
+        const Msg* m = Msg::getMsg( *i );
+        m->e1()->markRewired();
+        m->e2()->markRewired();
+    }
+}
+
 void Element::printMsgDigest( unsigned int srcIndex, unsigned int dataId ) const
 {
     unsigned int numSrcMsgs = msgBinding_.size();
@@ -739,6 +896,8 @@ void Element::printMsgDigest( unsigned int srcIndex, unsigned int dataId ) const
 
 void Element::replaceCinfo( const Cinfo* newCinfo )
 {
+    elementsByClass()[ cinfo_ ].erase( id_ );
+    elementsByClass()[ newCinfo ].insert( id_ );
     cinfo_ = newCinfo;
     // Stuff to be done for data is handled by derived classes in ZombeSwap.
 }
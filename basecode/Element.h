@@ -53,7 +53,8 @@ public:
     const string& getName() const;
 
     /**
-     * Changes name of Element
+     * Changes name of Element, and re-files it under the new name in
+     * the child index of its parent.
      */
     void setName( const string& val );
 
@@ -195,6 +196,23 @@ public:
      */
     const vector< MsgFuncBinding >* getMsgAndFunc( BindIndex b ) const;
 
+    typedef unordered_multimap< string, ObjId > ChildIndex;
+
+    /**
+     * Returns the range of parent->child Msgs from this Element to
+     * children with the specified name. Used by Neutral::child.
+     */
+    pair< ChildIndex::const_iterator, ChildIndex::const_iterator >
+    findChildMsgs( const string& name ) const;
+
+    typedef unordered_map< const Cinfo*, unordered_set< Id > > ClassIndex;
+
+    /**
+     * The Elements of each class. Kept up to date as Elements are
+     * created, destroyed and zombified, for wildcard searches by class.
+     */
+    static const ClassIndex& classIndex();
+
     /**
      * Returns true if there are one or more Msgs on the specified
      * BindIndex
@@ -258,6 +276,12 @@ public:
      */
     void markRewired();
 
+    /**
+     * Marks both ends of every Msg on this Element as rewired. Used when
+     * the data move, as the digests of the sources point into them.
+     */
+    void markMsgsRewired();
+
     /**
      * Utility function for debugging
      */
@@ -297,6 +321,14 @@ public:
      */
     ObjId findCaller( FuncId fid ) const;
 
+    /**
+     * Returns the Msg from the parent of this Element, found through
+     * the child index of the parent rather than by scanning all the
+     * bindings of the parent. Returns ObjId( 0, BADINDEX ) if there is
+     * none.
+     */
+    ObjId findParentMsg() const;
+
     /**
      * More general function. Fills up vector of ObjIds that call the
      * specified Fid on current Element. Returns # found
@@ -395,6 +427,12 @@ private:
     unsigned int getInputs( vector< Id >& ret, const DestFinfo* finfo )
     const;
 
+    /**
+     * Removes the entry for Msg mid from the child index.
+     * Returns true if there was one.
+     */
+    bool dropChildMsg( const string& name, ObjId mid );
+
 
     string name_; /// Name of the Element.
 
@@ -436,6 +474,14 @@ private:
      */
     vector< vector < MsgDigest > > msgDigest_;
 
+    /**
+     * Index of the parent->child Msgs on the childOut binding, by name
+     * of the child. Kept up to date as children are adopted, renamed,
+     * moved and deleted, so that looking up a child by name does not
+     * scan all the children.
+     */
+    ChildIndex children_;
+
     /// Returns tick on which element is scheduled. -1 for disabled.
     int tick_;
 
@@ -60,6 +60,17 @@ public:
         ( reinterpret_cast< T* >( e.data() )->*func_ )( e );
     }
 
+    static void direct( const OpFunc* f, const Eref& e, char* data )
+    {
+        ( reinterpret_cast< T* >( data )->*
+          static_cast< const EpFunc0* >( f )->func_ )( e );
+    }
+
+    MsgDigest::Direct directFunc() const
+    {
+        return reinterpret_cast< MsgDigest::Direct >( &EpFunc0::direct );
+    }
+
 private:
     void ( T::*func_ )( const Eref& e );
 };
@@ -76,6 +87,17 @@ public:
         ( reinterpret_cast< T* >( e.data() )->*func_ )( e, arg );
     }
 
+    static void direct( const OpFunc* f, const Eref& e, char* data, A arg )
+    {
+        ( reinterpret_cast< T* >( data )->*
+          static_cast< const EpFunc1* >( f )->func_ )( e, arg );
+    }
+
+    MsgDigest::Direct directFunc() const
+    {
+        return reinterpret_cast< MsgDigest::Direct >( &EpFunc1::direct );
+    }
+
 private:
     void ( T::*func_ )( const Eref& e, A );
 };
@@ -93,6 +115,18 @@ public:
         ( reinterpret_cast< T* >( e.data() )->*func_ )( e, arg1, arg2 );
     }
 
+    static void direct( const OpFunc* f, const Eref& e, char* data,
+                        A1 arg1, A2 arg2 )
+    {
+        ( reinterpret_cast< T* >( data )->*
+          static_cast< const EpFunc2* >( f )->func_ )( e, arg1, arg2 );
+    }
+
+    MsgDigest::Direct directFunc() const
+    {
+        return reinterpret_cast< MsgDigest::Direct >( &EpFunc2::direct );
+    }
+
 private:
     void ( T::*func_ )( const Eref& e, A1, A2 );
 };
@@ -78,12 +78,20 @@ unsigned int LocalDataElement::getNode( unsigned int dataId ) const {
 			return 0; // Sure to have some data on node 0.
 		}
 	}
+	if ( !nodeStarts_.empty() ) {
+		// The last node whose block starts at or before dataId. Skips
+		// the nodes with empty blocks.
+		return upper_bound( nodeStarts_.begin(), nodeStarts_.end() - 1,
+						dataId ) - nodeStarts_.begin() - 1;
+	}
 	return dataId / numPerNode_;
 }
 
 /// Inherited virtual. Returns start DataId on specified node
 unsigned int LocalDataElement::startDataIndex( unsigned int node ) const
 {
+	if ( !nodeStarts_.empty() )
+		return nodeStarts_[node];
 	if ( numPerNode_ * node < numData_ )
 		return numPerNode_ * node;
 	else
@@ -91,6 +99,8 @@ unsigned int LocalDataElement::startDataIndex( unsigned int node ) const
 }
 
 unsigned int LocalDataElement::rawIndex( unsigned int dataId ) const {
+	if ( !nodeStarts_.empty() )
+		return dataId - localDataStart_;
 	return dataId % numPerNode_;
 }
 
@@ -115,11 +125,25 @@ unsigned int LocalDataElement::setDataSize( unsigned int numData )
 // virtual func, overridden.
 void LocalDataElement::resize( unsigned int newNumData )
 {
+	nodeStarts_.clear();
 	DataElement::resize( setDataSize( newNumData ) );
 }
 
+void LocalDataElement::setNodeStarts( const vector< unsigned int >& starts )
+{
+	assert( starts.size() == Shell::numNodes() + 1 );
+	assert( starts.front() == 0 && starts.back() == numData_ );
+	int offset = static_cast< int >( starts[ Shell::myNode() ] ) -
+			static_cast< int >( localDataStart_ );
+	nodeStarts_ = starts;
+	localDataStart_ = starts[ Shell::myNode() ];
+	shiftLocalData( getNumOnNode( Shell::myNode() ), offset );
+}
+
 unsigned int LocalDataElement::getNumOnNode( unsigned int node ) const
 {
+	if ( !nodeStarts_.empty() )
+		return nodeStarts_[node + 1] - nodeStarts_[node];
 	unsigned int lastUsedNode = numData_ / numPerNode_;
 	if ( lastUsedNode > node )
 		return numPerNode_;
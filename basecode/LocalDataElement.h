@@ -99,6 +99,15 @@ class LocalDataElement: public DataElement
 		/////////////////////////////////////////////////////////////////
 		unsigned int setDataSize( unsigned int numData );
 
+		/**
+		 * Moves the boundaries between the blocks of entries on each
+		 * node. Entries from starts[i] up to starts[i+1] go on node i.
+		 * Entries that stay on this node keep their data; those that
+		 * arrive start as copies of entries that were here, and
+		 * Shell::loadBalance then sets the state sent along with them. A resize goes back to equal blocks.
+		 */
+		void setNodeStarts( const vector< unsigned int >& starts );
+
 	private:
 		/**
 		 * This is the total number of data entries on this Element, in
@@ -115,6 +124,13 @@ class LocalDataElement: public DataElement
 		 */
 		unsigned int numPerNode_;
 
+		/**
+		 * Start index of the data on each node, and numData_ at the end,
+		 * when set by setNodeStarts. Empty for the equal blocks above.
+		 * Note that setDataSize runs before this is constructed.
+		 */
+		vector< unsigned int > nodeStarts_;
+
 		/**
 		 * Precomputed value for start index of data on this node.
 		 */
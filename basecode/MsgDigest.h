@@ -21,11 +21,23 @@
 class MsgDigest
 {
 	public:
+		/// Type-erased OpFunc entry point, see OpFunc::directFunc.
+		typedef void ( *Direct )();
+
 		MsgDigest( const OpFunc* f, const vector< Eref >& t )
-				: func( f ), targets( t )
+				: func( f ), targets( t ), direct( 0 )
 		{;}
 		const OpFunc* func;
 		vector< Eref > targets;
+
+		/**
+		 * Filled in by Element::digestMessages when func can be called
+		 * on the target data directly. data[i] is then the data of
+		 * targets[i], or 0 where it has to be looked up on each send:
+		 * ALLDATA, field and off-node targets.
+		 */
+		Direct direct;
+		vector< char* > data;
 };
 
 #endif // _MSG_DIGEST_H
@@ -21,6 +21,17 @@ public:
     {
         (reinterpret_cast< T* >( e.data() )->*func_)();
     }
+
+    static void direct( const OpFunc* f, const Eref& e, char* data )
+    {
+        (reinterpret_cast< T* >( data )->*
+         static_cast< const OpFunc0* >( f )->func_)();
+    }
+
+    MsgDigest::Direct directFunc() const
+    {
+        return reinterpret_cast< MsgDigest::Direct >( &OpFunc0::direct );
+    }
 private:
     void ( T::*func_ )( );
 };
@@ -35,6 +46,17 @@ public:
     {
         (reinterpret_cast< T* >( e.data() )->*func_)( arg );
     }
+
+    static void direct( const OpFunc* f, const Eref& e, char* data, A arg )
+    {
+        (reinterpret_cast< T* >( data )->*
+         static_cast< const OpFunc1* >( f )->func_)( arg );
+    }
+
+    MsgDigest::Direct directFunc() const
+    {
+        return reinterpret_cast< MsgDigest::Direct >( &OpFunc1::direct );
+    }
 private:
     void ( T::*func_ )( A );
 };
@@ -52,6 +74,18 @@ public:
         (reinterpret_cast< T* >( e.data() )->*func_)( arg1, arg2 );
     }
 
+    static void direct( const OpFunc* f, const Eref& e, char* data,
+                        A1 arg1, A2 arg2 )
+    {
+        (reinterpret_cast< T* >( data )->*
+         static_cast< const OpFunc2* >( f )->func_)( arg1, arg2 );
+    }
+
+    MsgDigest::Direct directFunc() const
+    {
+        return reinterpret_cast< MsgDigest::Direct >( &OpFunc2::direct );
+    }
+
 private:
     void ( T::*func_ )( A1, A2 );
 };
@@ -63,6 +63,28 @@ public:
     virtual void opVecBuffer( const Eref& e, double* buf ) const
     {;}
 
+    /**
+     * For the OpFuncs of 'get' functions, puts the value into buf packed
+     * as Conv does, without the leading size that opBuffer writes.
+     * Other OpFuncs leave buf empty.
+     */
+    virtual void getBuffer( const Eref& e, vector< double >& buf ) const
+    {
+        buf.clear();
+    }
+
+    /**
+     * Entry point that runs the function on a target whose data the
+     * caller has already looked up, which spares the virtual op() and
+     * Eref::data() calls on every send. The real type is the DirectOp of
+     * the base class for the arity. Returns 0 for functions that have to
+     * go through op(), such as HopFuncs.
+     */
+    virtual MsgDigest::Direct directFunc() const
+    {
+        return 0;
+    }
+
     static const OpFunc* lookop( unsigned int opIndex );
 
     unsigned int opIndex() const
@@ -82,6 +104,8 @@ private:
 class OpFunc0Base: public OpFunc
 {
 public:
+    typedef void ( *DirectOp )( const OpFunc* f, const Eref& e, char* data );
+
     bool checkFinfo( const Finfo* s ) const
     {
         return dynamic_cast< const SrcFinfo0* >( s );
@@ -102,6 +126,8 @@ public:
 template< class A > class OpFunc1Base: public OpFunc
 {
 public:
+    typedef void ( *DirectOp )( const OpFunc* f, const Eref& e, char* data,
+                                A arg );
 
     bool checkFinfo( const Finfo* s ) const
     {
@@ -159,6 +185,9 @@ public:
 template< class A1, class A2 > class OpFunc2Base: public OpFunc
 {
 public:
+    typedef void ( *DirectOp )( const OpFunc* f, const Eref& e, char* data,
+                                A1 arg1, A2 arg2 );
+
     bool checkFinfo( const Finfo* s ) const
     {
         return dynamic_cast< const SrcFinfo2< A1, A2 >* >( s );
@@ -357,6 +386,14 @@ public:
         Conv< A >::val2buf( ret, &buf );
     }
 
+    void getBuffer( const Eref& e, vector< double >& buf ) const
+    {
+        A ret = returnOp( e );
+        buf.resize( Conv< A >::size( ret ) );
+        double* p = buf.data();
+        Conv< A >::val2buf( ret, &p );
+    }
+
 };
 
 /**
@@ -12,8 +12,39 @@
 #include "../shell/Shell.h"
 #include "../shell/Neutral.h"
 
+/**
+ * True if field is the get of a vector valued field, or of a lookup field
+ * with vectors as keys or values.
+ */
+static bool getsVector( const Cinfo* cinfo, const string& field )
+{
+    if ( field.size() <= 3 || field.compare( 0, 3, "get" ) != 0 )
+        return false;
+    string name = field.substr( 3 );
+    const Finfo* f = cinfo->findFinfo( name );
+    if ( !f )
+    {
+        name[0] = std::tolower( name[0] );
+        f = cinfo->findFinfo( name );
+    }
+    return f && f->rttiType().find( "vector" ) != string::npos;
+}
+
 const OpFunc* SetGet::checkSet( const string& field, ObjId& tgt, FuncId& fid ) 
 {
+    // While a run goes on in the background, only scalar fields of its
+    // objects may be read, and the clock stopped. Vectors may be resized
+    // by the run as they are read.
+    if ( Shell::isWaitingForBackgroundRun() &&
+            ( field.compare( 0, 3, "get" ) != 0 ||
+              getsVector( tgt.element()->cinfo(), field ) ) &&
+            !( tgt.id == Id( 1 ) && field == "stop" ) )
+    {
+        cout << "Warning: SetGet::checkSet: simulation in progress, '" <<
+             field << "' on " << tgt.id.path() << " ignored.\n";
+        return 0;
+    }
+
     // string field = "set_" + destField;
     const Finfo* f = tgt.element()->cinfo()->findFinfo( field );
     if ( !f )   // Could be a child element? Note that field name will
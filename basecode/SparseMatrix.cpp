@@ -18,6 +18,6 @@
 using namespace std;
 
 
-const unsigned int SM_MAX_ROWS = 200000;
-const unsigned int SM_MAX_COLUMNS = 200000;
+const unsigned int SM_MAX_ROWS = 10000000;
+const unsigned int SM_MAX_COLUMNS = 10000000;
 const unsigned int SM_RESERVE = 8;
@@ -423,6 +423,23 @@ public:
                           colIndexArg.begin(), colIndexArg.end() );
         rowStart_[rowNum + 1] = N_.size();
     }
+
+    /**
+     * Takes over a whole matrix already in compressed row form, by
+     * swapping the arrays in. Column indices must be in increasing order
+     * within each row. The matrix keeps its size.
+     */
+    void swapRows( vector< T >& entry, vector< unsigned int >& colIndex,
+                   vector< unsigned int >& rowStart )
+    {
+        assert( rowStart.size() == nrows_ + 1 );
+        assert( entry.size() == colIndex.size() );
+        assert( rowStart.back() == entry.size() );
+        N_.swap( entry );
+        colIndex_.swap( colIndex );
+        rowStart_.swap( rowStart );
+    }
+
 	/// Here we expose the sparse matrix for MOOSE use.
 	const vector< T >& matrixEntry() const
 	{
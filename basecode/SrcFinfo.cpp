@@ -71,12 +71,18 @@ void SrcFinfo0::send( const Eref& e ) const {
 	const vector< MsgDigest >& md = e.msgDigest( getBindIndex() );
 	for ( vector< MsgDigest >::const_iterator
 		i = md.begin(); i != md.end(); ++i ) {
+		// The types were checked when the Msg was made.
+		assert( dynamic_cast< const OpFunc0Base* >( i->func ) );
 		const OpFunc0Base* f =
-			dynamic_cast< const OpFunc0Base* >( i->func );
-		assert( f );
+			static_cast< const OpFunc0Base* >( i->func );
+		OpFunc0Base::DirectOp direct =
+			reinterpret_cast< OpFunc0Base::DirectOp >( i->direct );
+		vector< char* >::const_iterator d = i->data.begin();
 		for ( vector< Eref >::const_iterator
-			j = i->targets.begin(); j != i->targets.end(); ++j ) {
-			if ( j->dataIndex() == ALLDATA ) {
+			j = i->targets.begin(); j != i->targets.end(); ++j, ++d ) {
+			if ( *d ) {
+				direct( f, *j, *d );
+			} else if ( j->dataIndex() == ALLDATA ) {
 				Element* e = j->element();
 				unsigned int start = e->localDataStart();
 				unsigned int end = start + e->numData();
@@ -101,12 +101,20 @@ template < class T > class SrcFinfo1: public SrcFinfo
 			const vector< MsgDigest >& md = er.msgDigest( getBindIndex() );
 			for ( vector< MsgDigest >::const_iterator
 				i = md.begin(); i != md.end(); ++i ) {
+				// The types were checked when the Msg was made.
+				assert( dynamic_cast< const OpFunc1Base< T >* >( i->func ) );
 				const OpFunc1Base< T >* f =
-					dynamic_cast< const OpFunc1Base< T >* >( i->func );
-				assert( f );
+					static_cast< const OpFunc1Base< T >* >( i->func );
+				typename OpFunc1Base< T >::DirectOp direct =
+					reinterpret_cast< typename OpFunc1Base< T >::DirectOp >(
+									i->direct );
+				vector< char* >::const_iterator d = i->data.begin();
 				for ( vector< Eref >::const_iterator
-					j = i->targets.begin(); j != i->targets.end(); ++j ) {
-					if ( j->dataIndex() == ALLDATA ) {
+					j = i->targets.begin(); j != i->targets.end();
+					++j, ++d ) {
+					if ( *d ) {
+						direct( f, *j, *d, arg );
+					} else if ( j->dataIndex() == ALLDATA ) {
 						Element* e = j->element();
 						unsigned int start = e->localDataStart();
 						unsigned int end = start + e->numLocalData();
@@ -129,9 +137,10 @@ template < class T > class SrcFinfo1: public SrcFinfo
 			const vector< MsgDigest >& md = er.msgDigest( getBindIndex() );
 			for ( vector< MsgDigest >::const_iterator
 				i = md.begin(); i != md.end(); ++i ) {
+				// The types were checked when the Msg was made.
+				assert( dynamic_cast< const OpFunc1Base< T >* >( i->func ) );
 				const OpFunc1Base< T >* f =
-					dynamic_cast< const OpFunc1Base< T >* >( i->func );
-				assert( f );
+					static_cast< const OpFunc1Base< T >* >( i->func );
 				for ( vector< Eref >::const_iterator
 					j = i->targets.begin(); j != i->targets.end(); ++j ) {
 					if ( j->element() != tgt.element() )
@@ -167,9 +176,10 @@ template < class T > class SrcFinfo1: public SrcFinfo
 			unsigned int argPos = 0;
 			for ( vector< MsgDigest >::const_iterator
 				i = md.begin(); i != md.end(); ++i ) {
+				// The types were checked when the Msg was made.
+				assert( dynamic_cast< const OpFunc1Base< T >* >( i->func ) );
 				const OpFunc1Base< T >* f =
-					dynamic_cast< const OpFunc1Base< T >* >( i->func );
-				assert( f );
+					static_cast< const OpFunc1Base< T >* >( i->func );
 				for ( vector< Eref >::const_iterator
 					j = i->targets.begin(); j != i->targets.end(); ++j ) {
 					if ( j->dataIndex() == ALLDATA ) {
@@ -223,12 +233,21 @@ template < class T1, class T2 > class SrcFinfo2: public SrcFinfo
 			const vector< MsgDigest >& md = e.msgDigest( getBindIndex() );
 			for ( vector< MsgDigest >::const_iterator
 				i = md.begin(); i != md.end(); ++i ) {
+				// The types were checked when the Msg was made.
+				assert( ( dynamic_cast<
+						const OpFunc2Base< T1, T2 >* >( i->func ) ) );
 				const OpFunc2Base< T1, T2 >* f =
-					dynamic_cast< const OpFunc2Base< T1, T2 >* >( i->func );
-				assert( f );
+					static_cast< const OpFunc2Base< T1, T2 >* >( i->func );
+				typename OpFunc2Base< T1, T2 >::DirectOp direct =
+					reinterpret_cast<
+					typename OpFunc2Base< T1, T2 >::DirectOp >( i->direct );
+				vector< char* >::const_iterator d = i->data.begin();
 				for ( vector< Eref >::const_iterator
-					j = i->targets.begin(); j != i->targets.end(); ++j ) {
-					if ( j->dataIndex() == ALLDATA ) {
+					j = i->targets.begin(); j != i->targets.end();
+					++j, ++d ) {
+					if ( *d ) {
+						direct( f, *j, *d, arg1, arg2 );
+					} else if ( j->dataIndex() == ALLDATA ) {
 						Element* e = j->element();
 						unsigned int start = e->localDataStart();
 						unsigned int end = start + e->numData();
@@ -247,9 +266,11 @@ template < class T1, class T2 > class SrcFinfo2: public SrcFinfo
 			const vector< MsgDigest >& md = e.msgDigest( getBindIndex() );
 			for ( vector< MsgDigest >::const_iterator
 				i = md.begin(); i != md.end(); ++i ) {
+				// The types were checked when the Msg was made.
+				assert( ( dynamic_cast<
+						const OpFunc2Base< T1, T2 >* >( i->func ) ) );
 				const OpFunc2Base< T1, T2 >* f =
-					dynamic_cast< const OpFunc2Base< T1, T2 >* >( i->func );
-				assert( f );
+					static_cast< const OpFunc2Base< T1, T2 >* >( i->func );
 				for ( vector< Eref >::const_iterator
 					j = i->targets.begin(); j != i->targets.end(); ++j ) {
 					if ( j->element() != tgt.element() )
@@ -301,10 +322,11 @@ template < class T1, class T2, class T3 > class SrcFinfo3: public SrcFinfo
 			const vector< MsgDigest >& md = e.msgDigest( getBindIndex() );
 			for ( vector< MsgDigest >::const_iterator
 				i = md.begin(); i != md.end(); ++i ) {
+				// The types were checked when the Msg was made.
+				assert( ( dynamic_cast<
+						const OpFunc3Base< T1, T2, T3 >* >( i->func ) ) );
 				const OpFunc3Base< T1, T2, T3 >* f =
-					dynamic_cast< const OpFunc3Base< T1, T2, T3 >* >(
-									i->func );
-				assert( f );
+					static_cast< const OpFunc3Base< T1, T2, T3 >* >( i->func );
 				for ( vector< Eref >::const_iterator
 					j = i->targets.begin(); j != i->targets.end(); ++j ) {
 					if ( j->dataIndex() == ALLDATA ) {
@@ -353,10 +375,12 @@ template < class T1, class T2, class T3, class T4 > class SrcFinfo4: public SrcF
 			const vector< MsgDigest >& md = e.msgDigest( getBindIndex() );
 			for ( vector< MsgDigest >::const_iterator
 				i = md.begin(); i != md.end(); ++i ) {
+				// The types were checked when the Msg was made.
+				assert( ( dynamic_cast<
+						const OpFunc4Base< T1, T2, T3, T4 >* >( i->func ) ) );
 				const OpFunc4Base< T1, T2, T3, T4 >* f =
-					dynamic_cast< const OpFunc4Base< T1, T2, T3, T4 >* >(
-									i->func );
-				assert( f );
+					static_cast<
+					const OpFunc4Base< T1, T2, T3, T4 >* >( i->func );
 				for ( vector< Eref >::const_iterator
 					j = i->targets.begin(); j != i->targets.end(); ++j ) {
 					if ( j->dataIndex() == ALLDATA ) {
@@ -407,10 +431,12 @@ template < class T1, class T2, class T3, class T4, class T5 > class SrcFinfo5: p
 			const vector< MsgDigest >& md = e.msgDigest( getBindIndex() );
 			for ( vector< MsgDigest >::const_iterator
 				i = md.begin(); i != md.end(); ++i ) {
+				// The types were checked when the Msg was made.
+				assert( ( dynamic_cast<
+						const OpFunc5Base< T1, T2, T3, T4, T5 >* >( i->func ) ) );
 				const OpFunc5Base< T1, T2, T3, T4, T5 >* f =
-					dynamic_cast<
+					static_cast<
 					const OpFunc5Base< T1, T2, T3, T4, T5 >* >( i->func );
-				assert( f );
 				for ( vector< Eref >::const_iterator
 					j = i->targets.begin(); j != i->targets.end(); ++j ) {
 					if ( j->dataIndex() == ALLDATA ) {
@@ -464,11 +490,12 @@ template < class T1, class T2, class T3, class T4, class T5, class T6 > class Sr
 			const vector< MsgDigest >& md = e.msgDigest( getBindIndex() );
 			for ( vector< MsgDigest >::const_iterator
 				i = md.begin(); i != md.end(); ++i ) {
+				// The types were checked when the Msg was made.
+				assert( ( dynamic_cast<
+						const OpFunc6Base< T1, T2, T3, T4, T5, T6 >* >( i->func ) ) );
 				const OpFunc6Base< T1, T2, T3, T4, T5, T6 >* f =
-					dynamic_cast<
-					const OpFunc6Base< T1, T2, T3, T4, T5, T6 >* >(
-									i->func );
-				assert( f );
+					static_cast<
+					const OpFunc6Base< T1, T2, T3, T4, T5, T6 >* >( i->func );
 				for ( vector< Eref >::const_iterator
 					j = i->targets.begin(); j != i->targets.end(); ++j ) {
 					if ( j->dataIndex() == ALLDATA ) {
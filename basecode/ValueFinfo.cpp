@@ -19,6 +19,10 @@ DestFinfo* ValueFinfoBase::getFinfo() const {
 	return get_;
 }
 
+DestFinfo* ValueFinfoBase::setFinfo() const {
+	return set_;
+}
+
 vector< string > ValueFinfoBase::innerDest() const
 {
 	vector< string > ret;
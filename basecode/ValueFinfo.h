@@ -23,6 +23,9 @@ class ValueFinfoBase: public Finfo
 
 		DestFinfo* getFinfo() const;
 
+		/// Returns the 'set' DestFinfo, or 0 if the field is read-only.
+		DestFinfo* setFinfo() const;
+
 		///////////////////////////////////////////////////////////////
 		// Override the default virtual function for the set/get destfinfos
 		///////////////////////////////////////////////////////////////
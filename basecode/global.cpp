@@ -19,6 +19,7 @@
 #include "global.h"
 #include <numeric>
 #include <regex>
+#include <mutex>
 
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -233,6 +234,9 @@ string toString(double x)
 
 void addSolverProf(const string& name, double time, size_t steps)
 {
+    // Solvers on the same tick may run on different threads.
+    static std::mutex profMutex;
+    std::lock_guard<std::mutex> lock(profMutex);
     solverProfMap[name] =
         solverProfMap[name] + valarray<double>({time, (double)steps});
 }
@@ -53,6 +53,7 @@ extern void testMpiBuiltins();
 extern void testMpiShell();
 extern void testMsg();
 extern void testMpiMsg();
+extern void testMpi();
 // extern void testKinetics();
 extern void testKsolve();
 extern void testKsolveProcess();
@@ -286,6 +287,7 @@ void mpiTests()
     MOOSE_TEST( "testMpiShell", testMpiShell());
     MOOSE_TEST( "testMpiBuiltins", testMpiBuiltins());
     MOOSE_TEST( "testMpiScheduling", testMpiScheduling());
+    MOOSE_TEST( "testMpi", testMpi());
 #endif
 }
 #if ! defined(PYMOOSE) && ! defined(MOOSE_LIB)
@@ -31,6 +31,7 @@
 #include "../builtins/Arith.h"
 #include "../biophysics/IntFire.h"
 #include "../randnum/randnum.h"
+#include "../utility/ThreadPool.h"
 
 #include <queue>
 
@@ -102,6 +103,18 @@ void testSendMsg()
             reinterpret_cast<Arith*>(e2.element()->data(i))->getOutput();
         assert(doubleEq(val, temp));
     }
+    // Function and target data are resolved in the digest, which has to
+    // follow the data when they are reallocated.
+    assert(md[0].direct);
+    assert(md[0].data[0] == e2.element()->data(0));
+    e2.element()->resize(size * 2);
+    for(unsigned int i = 0; i < size; ++i)
+        s.send(Eref(e1.element(), i), 3.0 * i);
+    for(unsigned int i = 0; i < size; ++i) {
+        double val =
+            reinterpret_cast<Arith*>(e2.element()->data(i))->getOutput();
+        assert(doubleEq(val, 3.0 * i));
+    }
     cout << "." << flush;
 
     delete i1.element();
@@ -881,6 +894,132 @@ void testSparseMsg()
     cout << "." << flush;
 }
 
+/// Compares the whole matrix of two SparseMsgs, row by row.
+static bool sameMatrix( SparseMsg* a, SparseMsg* b )
+{
+    const SparseMatrix< unsigned int >& ma = a->getMatrix();
+    const SparseMatrix< unsigned int >& mb = b->getMatrix();
+    if ( ma.nRows() != mb.nRows() || ma.nEntries() != mb.nEntries() )
+        return false;
+    vector< unsigned int > ea, ca, eb, cb;
+    for ( unsigned int i = 0; i < ma.nRows(); ++i ) {
+        ma.getRow( i, ea, ca );
+        mb.getRow( i, eb, cb );
+        if ( ea != eb || ca != cb )
+            return false;
+    }
+    return true;
+}
+
+void testSparseMsgSampling()
+{
+    static const double p = 0.05;
+    static const unsigned int numSrc = 400;
+    static const unsigned int numTgt = 300;
+    const Cinfo* ic = IntFire::initCinfo();
+    const Cinfo* sshc = SimpleSynHandler::initCinfo();
+    const Cinfo* sc = Synapse::initCinfo();
+    const Finfo* f1 = ic->findFinfo("spikeOut");
+    const Finfo* f2 = sc->findFinfo("addSpike");
+    assert(f1 && f2);
+
+    Id sshid = Id::nextId();
+    Element* syn = new GlobalDataElement(sshid, sshc, "syn", numTgt);
+    Id syns(sshid.value() + 1);
+    Id cells = Id::nextId();
+    Element* src = new GlobalDataElement(cells, ic, "src", numSrc);
+
+    SparseMsg* sm = new SparseMsg(src, syns.element(), 0);
+    f1->addMsg(f2, sm->mid(), src);
+    assert(sm->getSampling() == "dense");
+
+    // Dense sampling gives what one draw per pair, targets outermost, does.
+    sm->setRandomConnectivity(p, 1234);
+    unsigned int n = sm->getMatrix().nEntries();
+    SparseMatrix< unsigned int > ref;
+    ref.setSize(numSrc, numTgt);
+    moose::RNG rng;
+    rng.setSeed(1234);
+    unsigned int numRef = 0;
+    for(unsigned int i = 0; i < numTgt; ++i) {
+        unsigned int k = 0;
+        for(unsigned int j = 0; j < numSrc; ++j)
+            if(rng.uniform() < p) {
+                ref.set(j, i, k++);
+                ++numRef;
+            }
+        assert(Field<unsigned int>::get(ObjId(sshid, i), "numSynapses") == k);
+    }
+    assert(n == numRef);
+    vector< unsigned int > e, c, re, rc;
+    for(unsigned int j = 0; j < numSrc; ++j) {
+        sm->getMatrix().getRow(j, e, c);
+        ref.getRow(j, re, rc);
+        assert(e == re && c == rc);
+    }
+
+    // Skip sampling is reproducible, and does not depend on the number
+    // of threads.
+    sm->setSampling("skip");
+    sm->setSampling("sideways");
+    assert(sm->getSampling() == "skip");
+    sm->setRandomConnectivity(p, 1234);
+    n = sm->getMatrix().nEntries();
+    SparseMsg* sm2 = new SparseMsg(src, syns.element(), 0);
+    f1->addMsg(f2, sm2->mid(), src);
+    sm2->setSampling("skip");
+    moose::ThreadPool::global().reserve(4);
+    sm2->setRandomConnectivity(p, 1234);
+    assert(sameMatrix(sm, sm2));
+    double mean = p * numSrc * numTgt;
+    assert(fabs(n - mean) < 5.0 * sqrt(mean));
+    for(unsigned int j = 0; j < numSrc; ++j) {
+        sm->getMatrix().getRow(j, e, c);
+        for(unsigned int k = 1; k < c.size(); ++k)
+            assert(c[k - 1] < c[k]);
+    }
+    unsigned int total = 0;
+    for(unsigned int i = 0; i < numTgt; ++i) {
+        sm->getMatrix().getColumn(i, e, c);
+        sort(e.begin(), e.end());
+        for(unsigned int k = 0; k < e.size(); ++k)
+            assert(e[k] == k);
+        total += e.size();
+    }
+    assert(total == n);
+    sm2->setRandomConnectivity(p, 99);
+    assert(!sameMatrix(sm, sm2));
+
+    delete syn;
+    delete src;
+    cout << "." << flush;
+}
+
+void testThreadPoolNested()
+{
+    // A parallelFor from inside a chunk, on the caller or on a worker,
+    // runs serially where it is.
+    moose::ThreadPool& pool = moose::ThreadPool::global();
+    pool.reserve(4);
+    vector<double> sums(8, 0.0);
+    pool.parallelFor(8, 1, [&sums](size_t begin, size_t end) {
+        for(size_t i = begin; i < end; ++i) {
+            vector<double> part(100, 0.0);
+            moose::ThreadPool::global().parallelFor(100, 10,
+                    [&part, i](size_t b, size_t e) {
+                        for(size_t j = b; j < e; ++j)
+                            part[j] = i * j;
+                    });
+            moose::ThreadPool::global().reserve(8);
+            for(double x : part)
+                sums[i] += x;
+        }
+    });
+    for(unsigned int i = 0; i < 8; ++i)
+        assert(doubleEq(sums[i], i * 4950.0));
+    cout << "." << flush;
+}
+
 void test2ArgSetVec()
 {
     const Cinfo* ac = Arith::initCinfo();
@@ -1828,6 +1967,8 @@ void testAsync()
     testSparseMatrixReorder();
     testSparseMatrixFill();
     testSparseMsg();
+    testSparseMsgSampling();
+    testThreadPoolNested();
     testSharedMsg();
     testConvVector();
     testConvVectorOfVectors();
@@ -318,13 +318,13 @@ void CaConcBase::decrease(const Eref& e, double I)
 /////////////////////////////////////////////////////
 
 // Dummy instantiation of vSetSolve, does nothing
-void CaConcBase::vSetSolver(const Eref& e, Id hsolve)
+void CaConcBase::vSetSolver(const Eref& e, ObjId hsolve)
 {
     ;
 }
 
 // static func
-void CaConcBase::zombify(Element* orig, const Cinfo* zClass, Id hsolve)
+void CaConcBase::zombify(Element* orig, const Cinfo* zClass, ObjId hsolve)
 {
     if(orig->cinfo() == zClass)
         return;
@@ -101,13 +101,13 @@ class CaConcBase
 		void updateDimensions( const Eref& e );
 
 		/// Used to set up the solver. Dummy for regular classes.
-		virtual void vSetSolver( const Eref& e, Id hsolve );
+		virtual void vSetSolver( const Eref& e, ObjId hsolve );
 
 		/**
 		 * Swaps Cinfos in order to make Zombies.
 		 */
 		static void zombify( Element* orig, const Cinfo* zClass,
-						Id hsolve );
+						ObjId hsolve );
 
 		/*
 		 * This Finfo is used to send out Ca concentration to channels.
@@ -181,25 +181,30 @@ double Compartment::vGetInitVm( const Eref& e ) const
 void Compartment::vProcess( const Eref& e, ProcPtr p )
 {
     //cout << "Compartment " << e.id().path() << ":: process: A = " << A_ << ", B = " << B_ << endl;
+    integrate( p->dt );
+    // Send out Vm to channels, SpikeGens, etc.
+    VmOut()->send( e, Vm_ );
+
+    // The axial/raxial messages go out in the 'init' phase.
+}
+
+void Compartment::integrate( double dt )
+{
     A_ += inject_ + sumInject_ + Em_ * invRm_;
     if ( B_ > EPSILON )
     {
-        double x = exp( -B_ * p->dt / Cm_ );
+        double x = exp( -B_ * dt / Cm_ );
         Vm_ = Vm_ * x + ( A_ / B_ )  * ( 1.0 - x );
     }
     else
     {
-        Vm_ += ( A_ - Vm_ * B_ ) * p->dt / Cm_;
+        Vm_ += ( A_ - Vm_ * B_ ) * dt / Cm_;
     }
     A_ = 0.0;
     B_ = invRm_;
     lastIm_ = Im_;
     Im_ = 0.0;
     sumInject_ = 0.0;
-    // Send out Vm to channels, SpikeGens, etc.
-    VmOut()->send( e, Vm_ );
-
-    // The axial/raxial messages go out in the 'init' phase.
 }
 
 void Compartment::vReinit(  const Eref& e, ProcPtr p )
@@ -116,6 +116,12 @@ public:
     static const Cinfo* initCinfo();
 
 protected:
+    /**
+     * Advances Vm_ by one time step, and clears the terms gathered for
+     * it. Does the work of vProcess without sending VmOut.
+     */
+    void integrate( double dt );
+
     double Vm_;
     double initVm_;
     double Em_;
@@ -710,12 +710,12 @@ void CompartmentBase::setGeomAndElec( const Eref& e,
 //////////////////////////////////////////////////////////////////
 
 // Dummy instantiation of vSetSolve, does nothing
-void CompartmentBase::vSetSolver( const Eref& e, Id hsolve )
+void CompartmentBase::vSetSolver( const Eref& e, ObjId hsolve )
 {;}
 
 // static func
 void CompartmentBase::zombify( Element* orig, const Cinfo* zClass,
-				Id hsolve )
+				ObjId hsolve )
 {
 	if ( orig->cinfo() == zClass )
 		return;
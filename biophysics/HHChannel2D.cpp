@@ -500,6 +500,38 @@ void HHChannel2D::destroyGate(const Eref &e, string gateType)
              << gateType << "'. Ignored\n";
 }
 
+// static func
+void HHChannel2D::zombify(Element *orig, const Cinfo *zClass, ObjId hsolve)
+{
+    if(orig->cinfo() == zClass)
+        return;
+    unsigned int start = orig->localDataStart();
+    unsigned int num = orig->numLocalData();
+    if(num == 0)
+        return;
+    // The zombie keeps the parameters, indices and gate pointers in its
+    // HHChannel2D part, so a copy of that carries everything over. The
+    // gate states, Gk and Ik may live in the solver.
+    vector<HHChannel2D> data(num);
+    for(unsigned int i = 0; i < num; ++i) {
+        Eref er(orig, i + start);
+        const HHChannel2D *c = reinterpret_cast<const HHChannel2D *>(er.data());
+        data[i] = *c;
+        data[i].X_ = c->vGetX(er);
+        data[i].Y_ = c->vGetY(er);
+        data[i].Z_ = c->vGetZ(er);
+        data[i].ChanCommon::vSetGk(er, c->vGetGk(er));
+        data[i].ChanCommon::vSetIk(er, c->vGetIk(er));
+    }
+    orig->zombieSwap(zClass);
+    for(unsigned int i = 0; i < num; ++i) {
+        Eref er(orig, i + start);
+        HHChannel2D *c = reinterpret_cast<HHChannel2D *>(er.data());
+        *c = data[i];
+        c->vSetSolver(er, hsolve);
+    }
+}
+
 ///////////////////////////////////////////////////
 // Unit tests
 ///////////////////////////////////////////////////
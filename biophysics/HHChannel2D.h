@@ -99,8 +99,8 @@ public:
      * the message source will be a CaConc object, but there
      * are other options for computing the conc.
      */
-    void conc1(double conc);
-    void conc2(double conc);
+    virtual void conc1(double conc);
+    virtual void conc2(double conc);
 
 
     /**
@@ -132,10 +132,23 @@ public:
      */
     void innerDestroyGate(const string& gateName, HHGate2D** gatePtr,
                           Id chanId);
+
+    /**
+     * Which value dimension dim of a gate with the given index string
+     * looks up: 0 for Vm, 1 for conc1, 2 for conc2, or -1 if none.
+     */
+    static int dependency(string index, unsigned int dim);
+
+    /**
+     * Swaps the class of all entries of orig to zClass, keeping the
+     * parameters, indices and gates. Used by the HSolve to take over
+     * HHChannel2Ds, and to give them back.
+     */
+    static void zombify(Element* orig, const Cinfo* zClass, ObjId hsolve);
+
     static const Cinfo* initCinfo();
 
 private:
-    int dependency(string index, unsigned int dim);
     double depValue(int dependency);
     double conc1_;
     double conc2_;
@@ -390,9 +390,9 @@ void HHChannelBase::vSetZpower(const Eref &e, double power) {
 
 /////////////////////////////////////////////////////////////////////
 // Dummy instantiation, the zombie derivatives make the real function
-void HHChannelBase::vSetSolver(const Eref &e, Id hsolve) { ; }
+void HHChannelBase::vSetSolver(const Eref &e, ObjId hsolve) { ; }
 
-void HHChannelBase::zombify(Element *orig, const Cinfo *zClass, Id hsolve) {
+void HHChannelBase::zombify(Element *orig, const Cinfo *zClass, ObjId hsolve) {
     if (orig->cinfo() == zClass) return;
     unsigned int start = orig->localDataStart();
     unsigned int num = orig->numLocalData();
@@ -268,3 +268,45 @@ void MarkovChannel::handleState( vector< double > state )
 {
     state_ = state;
 }
+
+///////////////////////////
+//Solver interface
+///////////////////////////
+
+void MarkovChannel::vSetSolver( const Eref& e, ObjId hsolve )
+{
+    ;
+}
+
+// static func
+void MarkovChannel::zombify( Element* orig, const Cinfo* zClass, ObjId hsolve )
+{
+    if ( orig->cinfo() == zClass )
+        return;
+    unsigned int start = orig->localDataStart();
+    unsigned int num = orig->numLocalData();
+    if ( num == 0 )
+        return;
+    // The zombie keeps the parameters in its MarkovChannel part, so a
+    // copy of that carries everything over. The state, Gk and Ik may
+    // live in the solver.
+    vector< MarkovChannel > data( num );
+    for ( unsigned int i = 0; i < num; ++i )
+    {
+        Eref er( orig, i + start );
+        const MarkovChannel* mc =
+            reinterpret_cast< const MarkovChannel* >( er.data() );
+        data[i] = *mc;
+        data[i].state_ = mc->getState();
+        data[i].ChanCommon::vSetGk( er, mc->vGetGk( er ) );
+        data[i].ChanCommon::vSetIk( er, mc->vGetIk( er ) );
+    }
+    orig->zombieSwap( zClass );
+    for ( unsigned int i = 0; i < num; ++i )
+    {
+        Eref er( orig, i + start );
+        MarkovChannel* mc = reinterpret_cast< MarkovChannel* >( er.data() );
+        *mc = data[i];
+        mc->vSetSolver( er, hsolve );
+    }
+}
@@ -48,17 +48,17 @@ class MarkovChannel : public ChanCommon
 	void setLigandGated ( vector< vector< bool > > );
 
 	//Probabilities of the channel occupying all possible states.
-	vector< double > getState ( ) const;
+	virtual vector< double > getState ( ) const;
 	void setState(  vector< double >  );
 
 	//The initial state of the channel. State of the channel is reset to this
 	//vector during a call to reinit().
 	vector< double > getInitialState() const;
-	void setInitialState( vector< double > );
+	virtual void setInitialState( vector< double > );
 
 	//Conductances associated with each open/conducting state.
 	vector< double > getGbars( ) const;
-	void setGbars( vector< double > );
+	virtual void setGbars( vector< double > );
 
 	//////////////////////
 	//MsgDest functions
@@ -67,7 +67,14 @@ class MarkovChannel : public ChanCommon
 	void vProcess( const Eref&, const ProcPtr);
 	void vReinit( const Eref&, const ProcPtr);
 	void handleLigandConc( double );
-	void handleState( vector< double > );
+	virtual void handleState( vector< double > );
+
+	virtual void vSetSolver( const Eref& e, ObjId hsolve );
+
+	//Swaps the class of all entries of orig to zClass, keeping the
+	//parameters and state. Used by the HSolve to take over
+	//MarkovChannels, and to give them back.
+	static void zombify( Element* orig, const Cinfo* zClass, ObjId hsolve );
 
 	private:
 	double g_;												//Expected conductance of the channel.
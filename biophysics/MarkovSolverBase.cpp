@@ -606,6 +606,113 @@ Matrix* MarkovSolverBase::computeMatrixExponential()
 //MsgDest functions
 //////////////
 
+// Adds weight * ( state * A ) to w.
+static void addVecMatMul( double* w, const double* state, const Matrix* A,
+						double weight, unsigned int n )
+{
+	for ( unsigned int i = 0; i < n; ++i )
+	{
+		double sum = 0;
+		for ( unsigned int j = 0; j < n; ++j )
+			sum += state[j] * (*A)[j][i];
+		w[i] += weight * sum;
+	}
+}
+
+void MarkovSolverBase::advanceState( double* state, double Vm,
+									double ligandConc ) const
+{
+	// Scratch space, one per thread, as the HSolve may advance channels
+	// sharing this solver from several threads.
+	static thread_local Vector result;
+	unsigned int n = size_;
+	result.assign( n, 0.0 );
+
+	if ( !expMats2d_.empty() )
+	{
+		double xv = ( Vm - xMin_ ) * invDx_;
+		double yv = ( ligandConc - yMin_ ) * invDy_;
+		xv = ( xv < 0 ) ? 0 : ( ( xv > xDivs_ ) ? xDivs_ : xv );
+		yv = ( yv < 0 ) ? 0 : ( ( yv > yDivs_ ) ? yDivs_ : yv );
+		unsigned int xIndex = static_cast< unsigned int >( xv );
+		unsigned int yIndex = static_cast< unsigned int >( yv );
+		double xF = xv - xIndex;
+		double yF = yv - yIndex;
+		double xFyF = xF * yF;
+		bool isEndOfX = ( xIndex == xDivs_ );
+		bool isEndOfY = ( yIndex == yDivs_ );
+
+		const vector< Matrix* >& row0 = expMats2d_[ xIndex ];
+		if ( isEndOfX && isEndOfY )
+			addVecMatMul( &result[0], state, row0[ yIndex ], 1.0, n );
+		else if ( isEndOfX )
+		{
+			addVecMatMul( &result[0], state, row0[ yIndex ], 1 - yF, n );
+			addVecMatMul( &result[0], state, row0[ yIndex + 1 ], yF, n );
+		}
+		else
+		{
+			const vector< Matrix* >& row1 = expMats2d_[ xIndex + 1 ];
+			if ( isEndOfY )
+			{
+				addVecMatMul( &result[0], state, row0[ yIndex ], 1 - xF, n );
+				addVecMatMul( &result[0], state, row1[ yIndex ], xF, n );
+			}
+			else
+			{
+				addVecMatMul( &result[0], state, row0[ yIndex ],
+						1 - xF - yF + xFyF, n );
+				addVecMatMul( &result[0], state, row1[ yIndex ],
+						xF - xFyF, n );
+				addVecMatMul( &result[0], state, row0[ yIndex + 1 ],
+						yF - xFyF, n );
+				addVecMatMul( &result[0], state, row1[ yIndex + 1 ],
+						xFyF, n );
+			}
+		}
+	}
+	else if ( !expMats1d_.empty() )
+	{
+		double x = rateTable_->areAllRatesVoltageDep() ? Vm : ligandConc;
+		if ( x <= xMin_ )
+			addVecMatMul( &result[0], state, expMats1d_[0], 1.0, n );
+		else if ( x >= xMax_ )
+			addVecMatMul( &result[0], state, expMats1d_.back(), 1.0, n );
+		else
+		{
+			double xv = ( x - xMin_ ) * invDx_;
+			unsigned int xIndex = static_cast< unsigned int >( xv );
+			if ( xIndex >= xDivs_ )
+				xIndex = xDivs_ - 1;
+			double xF = xv - xIndex;
+			addVecMatMul( &result[0], state, expMats1d_[ xIndex ], 1 - xF, n );
+			addVecMatMul( &result[0], state, expMats1d_[ xIndex + 1 ], xF, n );
+		}
+	}
+	else if ( expMat_ )
+		addVecMatMul( &result[0], state, expMat_, 1.0, n );
+	else
+		return;
+
+	for ( unsigned int i = 0; i < n; ++i )
+		state[i] = result[i];
+}
+
+double MarkovSolverBase::getLigandConc() const
+{
+	return ligandConc_;
+}
+
+double MarkovSolverBase::getDt() const
+{
+	return dt_;
+}
+
+unsigned int MarkovSolverBase::getSize() const
+{
+	return size_;
+}
+
 void MarkovSolverBase::reinit( const Eref& e, ProcPtr p )
 {
 	if ( initialState_.empty() )
@@ -759,6 +866,9 @@ void MarkovSolverBase::setLookupParams( )
 			if ( xDivs_ < divs )
 				xDivs_ = divs;
 		}
+
+		if ( !listOfVoltageRates.empty() )
+			invDx_ = xDivs_ / ( xMax_ - xMin_ );
 	}
 
 	if ( rateTable_->areAnyRates2d() )
@@ -100,6 +100,18 @@ class MarkovSolverBase {
 	//function.
 	void computeState();
 
+	//Advances state, of size getSize(), by one time step of getDt() at the
+	//given voltage and ligand concentration. Does the same interpolation
+	//as computeState(), but works in place without allocating, and does
+	//not touch the solver's own state. Inputs outside the table are
+	//clamped to its edges. Used by the HSolve, which keeps the states of
+	//all the channels that share this solver.
+	void advanceState( double* state, double Vm, double ligandConc ) const;
+
+	double getLigandConc() const;
+	double getDt() const;
+	unsigned int getSize() const;
+
 	///////////////////////////
 	//MsgDest functions.
 	//////////////////////////
@@ -170,21 +170,7 @@ bool SynChan::getNormalizeWeights() const
 
 void SynChan::normalizeGbar()
 {
-        if ( doubleEq( tau2_, 0.0 ) ) {
-                // norm_ = 1.0;
-                norm_ = ChanCommon::getGbar();
-        } else {
-                if ( doubleEq( tau1_, tau2_ ) ) {
-                    norm_ = ChanCommon::getGbar() * SynE() / tau1_;
-                } else {
-                    double tpeak = tau1_ * tau2_ * log( tau1_ / tau2_ ) /
-                            ( tau1_ - tau2_ );
-                    norm_ = ChanCommon::getGbar() * ( tau1_ - tau2_ ) /
-                            ( tau1_ * tau2_ * (
-                            exp( -tpeak / tau1_ ) - exp( -tpeak / tau2_ )
-                                                ));
-                }
-        }
+	norm_ = normalization( ChanCommon::getGbar(), tau1_, tau2_ );
 		/*
 		 * Can't handle at this time. Simple but tedious to implement.
 	if ( normalizeWeights_ && getNumSynapses() > 0 )
@@ -192,6 +178,20 @@ void SynChan::normalizeGbar()
 		*/
 }
 
+double SynChan::normalization( double Gbar, double tau1, double tau2 )
+{
+        if ( doubleEq( tau2, 0.0 ) )
+                // return 1.0;
+                return Gbar;
+        if ( doubleEq( tau1, tau2 ) )
+                return Gbar * SynE() / tau1;
+        double tpeak = tau1 * tau2 * log( tau1 / tau2 ) / ( tau1 - tau2 );
+        return Gbar * ( tau1 - tau2 ) /
+                ( tau1 * tau2 * (
+                exp( -tpeak / tau1 ) - exp( -tpeak / tau2 )
+                                ));
+}
+
 ///////////////////////////////////////////////////
 // Dest function definitions
 ///////////////////////////////////////////////////
@@ -254,3 +254,38 @@ void SynChan::activation( double val )
 {
 	activation_ += val;
 }
+
+///////////////////////////////////////////////////
+// Solver interface
+///////////////////////////////////////////////////
+
+void SynChan::vSetSolver( const Eref& e, ObjId hsolve )
+{;}
+
+// static func
+void SynChan::zombify( Element* orig, const Cinfo* zClass, ObjId hsolve )
+{
+	if ( orig->cinfo() == zClass )
+		return;
+	unsigned int start = orig->localDataStart();
+	unsigned int num = orig->numLocalData();
+	if ( num == 0 )
+		return;
+	// The zombie keeps the parameters in its SynChan part, so a copy of
+	// that carries everything over. Gk and Ik may live in the solver.
+	vector< SynChan > data( num );
+	for ( unsigned int i = 0; i < num; ++i ) {
+		Eref er( orig, i + start );
+		const SynChan* sc = reinterpret_cast< const SynChan* >( er.data() );
+		data[i] = *sc;
+		data[i].ChanCommon::vSetGk( er, sc->vGetGk( er ) );
+		data[i].ChanCommon::vSetIk( er, sc->vGetIk( er ) );
+	}
+	orig->zombieSwap( zClass );
+	for ( unsigned int i = 0; i < num; ++i ) {
+		Eref er( orig, i + start );
+		SynChan* sc = reinterpret_cast< SynChan* >( er.data() );
+		*sc = data[i];
+		sc->vSetSolver( er, hsolve );
+	}
+}
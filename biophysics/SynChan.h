@@ -20,10 +20,10 @@ class SynChan: public ChanCommon
 		// Value field access function definitions
 		/////////////////////////////////////////////////////////////////
 
-		void setTau1( double tau1 );
+		virtual void setTau1( double tau1 );
 		double getTau1() const;
 
-		void setTau2( double tau2 );
+		virtual void setTau2( double tau2 );
 		double getTau2() const;
 
 		void setNormalizeWeights( bool value );
@@ -36,6 +36,10 @@ class SynChan: public ChanCommon
 		// Utility function for any time Gbar changes
 		void normalizeGbar();
 
+		/// Scale factor that makes the peak conductance of a single
+		/// event equal to Gbar. Also used by the HSolve.
+		static double normalization( double Gbar, double tau1, double tau2 );
+
 		/// Utility function used to do the alpha function calculations for
 		/// Gk.
 		/// Separated out for convenience so that derived classes can use.
@@ -56,7 +60,19 @@ class SynChan: public ChanCommon
 		void vProcess( const Eref& e, ProcPtr p );
 		void vReinit( const Eref& e, ProcPtr p );
 
-		void activation( double val );
+		virtual void activation( double val );
+///////////////////////////////////////////////////
+// Solver interface
+///////////////////////////////////////////////////
+		virtual void vSetSolver( const Eref& e, ObjId hsolve );
+
+		/**
+		 * Swaps the class of all entries of orig to zClass, keeping
+		 * the parameters. Used by the HSolve to take over SynChans,
+		 * and to give them back.
+		 */
+		static void zombify( Element* orig, const Cinfo* zClass,
+						ObjId hsolve );
 ///////////////////////////////////////////////////
 		/**
 		 * Override base class function for spike handling
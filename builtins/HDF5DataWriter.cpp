@@ -57,9 +57,19 @@ const Cinfo * HDF5DataWriter::initCinfo()
       &HDF5DataWriter::setFlushLimit,
       &HDF5DataWriter::getFlushLimit);
 
+    static ValueFinfo< HDF5DataWriter, bool> asyncWrite(
+      "asyncWrite",
+      "If true, data is written to file on a thread of its own while the"
+      " simulation fills the next buffer of `flushLimit` steps. The"
+      " simulation only waits for the disk if a buffer fills up before the"
+      " previous one has been written. Default: false.",
+      &HDF5DataWriter::setAsyncWrite,
+      &HDF5DataWriter::getAsyncWrite);
+
     static Finfo * finfos[] = {
         requestOut(),
         &flushLimit,
+        &asyncWrite,
         &proc,
     };
 
@@ -102,7 +112,7 @@ const Cinfo * HDF5DataWriter::initCinfo()
 
 static const Cinfo * hdf5dataWriterCinfo = HDF5DataWriter::initCinfo();
 
-HDF5DataWriter::HDF5DataWriter(): flushLimit_(4*1024*1024), steps_(0)
+HDF5DataWriter::HDF5DataWriter(): flushLimit_(4*1024*1024), asyncWrite_(false), steps_(0)
 {
 }
 
@@ -117,6 +127,7 @@ void HDF5DataWriter::close()
         return;
     }
     this->flush();
+    std::lock_guard< std::recursive_mutex > lock(hdf5Mutex());
     for (map < string, hid_t >::iterator ii = nodemap_.begin();
          ii != nodemap_.end(); ++ii){
         if (ii->second >= 0){
@@ -133,22 +144,50 @@ void HDF5DataWriter::close()
 
 void HDF5DataWriter::flush()
 {
+    writer_.wait();
     if (filehandle_ < 0){
         cerr << "HDF5DataWriter::flush() - "
                 "Filehandle invalid. Cannot write data." << endl;
         return;
     }
+    std::lock_guard< std::recursive_mutex > lock(hdf5Mutex());
+    swapPending();
+    writePending();
+    HDF5WriterBase::flush();
+    H5Fflush(filehandle_, H5F_SCOPE_LOCAL);
+}
+
+void HDF5DataWriter::flushAsync()
+{
+    writer_.wait();
+    swapPending();
+    writer_.submit([this]{
+        std::lock_guard< std::recursive_mutex > lock(hdf5Mutex());
+        writePending();
+    });
+}
+
+void HDF5DataWriter::swapPending()
+{
+    pending_.resize(datasets_.size());
+    for (unsigned int ii = 0; ii < datasets_.size(); ++ii){
+        pending_[ii].swap(data_[ii]);
+    }
+}
 
+/**
+   Append the data in pending_ to the datasets and clear it, keeping the
+   buffers allocated for reuse. */
+void HDF5DataWriter::writePending()
+{
     for (unsigned int ii = 0; ii < datasets_.size(); ++ii){
-        herr_t status = appendToDataset(datasets_[ii], data_[ii]);
-        data_[ii].clear();
+        herr_t status = appendToDataset(datasets_[ii], pending_[ii]);
+        pending_[ii].clear();
         if (status < 0){
             cerr << "Warning: appending data for object " << src_[ii]
                  << " returned status " << status << endl;
         }
     }
-    HDF5WriterBase::flush();
-    H5Fflush(filehandle_, H5F_SCOPE_LOCAL);
 }
 
 /**
@@ -168,24 +207,26 @@ void HDF5DataWriter::process(const Eref & e, ProcPtr p)
     ++steps_;
     if (steps_ >= flushLimit_){
         steps_ = 0;
-        for (unsigned int ii = 0; ii < datasets_.size(); ++ii){
-            herr_t status = appendToDataset(datasets_[ii], data_[ii]);
-            data_[ii].clear();
-            if (status < 0){
-                cerr << "Warning: appending data for object " << src_[ii]
-                     << " returned status " << status << endl;
-            }
+        if (asyncWrite_){
+            flushAsync();
+            return;
         }
+        std::lock_guard< std::recursive_mutex > lock(hdf5Mutex());
+        swapPending();
+        writePending();
     }
 }
 
 void HDF5DataWriter::reinit(const Eref & e, ProcPtr p)
 {
+    writer_.wait();
+    std::lock_guard< std::recursive_mutex > lock(hdf5Mutex());
     steps_ = 0;
     for (unsigned int ii = 0; ii < data_.size(); ++ii){
         H5Dclose(datasets_[ii]);
     }
     data_.clear();
+    pending_.clear();
     src_.clear();
     func_.clear();
     datasets_.clear();
@@ -301,6 +342,16 @@ unsigned int HDF5DataWriter::getFlushLimit() const
     return flushLimit_;
 }
 
+void HDF5DataWriter::setAsyncWrite(bool value)
+{
+    asyncWrite_ = value;
+}
+
+bool HDF5DataWriter::getAsyncWrite() const
+{
+    return asyncWrite_;
+}
+
 #endif // USE_HDF5
 //
 // HDF5DataWriter.cpp ends here
@@ -46,6 +46,8 @@ class HDF5DataWriter: public HDF5WriterBase
     virtual ~HDF5DataWriter();
     void setFlushLimit(unsigned int limit);
     unsigned int getFlushLimit() const;
+    void setAsyncWrite(bool value);
+    bool getAsyncWrite() const;
     // void flush();
     void process(const Eref &e, ProcPtr p);
     void reinit(const Eref &e, ProcPtr p);
@@ -53,7 +55,16 @@ class HDF5DataWriter: public HDF5WriterBase
     virtual void close();
     static const Cinfo* initCinfo();
   protected:
+    /// Hands the buffered data over to writer_, to be written while
+    /// the next buffer fills up.
+    void flushAsync();
+    void swapPending();
+    void writePending();
     unsigned int flushLimit_;
+    bool asyncWrite_;
+    BackgroundWriter writer_;
+    // Data being written by writer_, swapped with data_ on each flush.
+    vector <vector < double > > pending_;
     // Maps the paths of data sources to vectors storing the data
     // locally
     vector <ObjId> src_;
@@ -47,6 +47,79 @@ using namespace std;
 ///////////////////////
 // Utility functions
 ///////////////////////
+std::recursive_mutex& hdf5Mutex()
+{
+    static std::recursive_mutex mutex;
+    return mutex;
+}
+
+BackgroundWriter::BackgroundWriter(): busy_(false), stop_(false)
+{
+}
+
+BackgroundWriter::BackgroundWriter(const BackgroundWriter& other)
+    : busy_(false), stop_(false)
+{
+}
+
+BackgroundWriter& BackgroundWriter::operator=(const BackgroundWriter& other)
+{
+    return *this;
+}
+
+BackgroundWriter::~BackgroundWriter()
+{
+    if (!thread_.joinable()){
+        return;
+    }
+    {
+        std::unique_lock< std::mutex > lock(mutex_);
+        cond_.wait(lock, [this]{ return !busy_; });
+        stop_ = true;
+    }
+    cond_.notify_all();
+    thread_.join();
+}
+
+void BackgroundWriter::submit(std::function< void() > job)
+{
+    {
+        std::unique_lock< std::mutex > lock(mutex_);
+        cond_.wait(lock, [this]{ return !busy_; });
+        job_ = std::move(job);
+        busy_ = true;
+    }
+    // The thread is only started by the first job, as most writers
+    // never use it.
+    if (!thread_.joinable()){
+        thread_ = std::thread(&BackgroundWriter::run, this);
+    }
+    cond_.notify_all();
+}
+
+void BackgroundWriter::wait()
+{
+    std::unique_lock< std::mutex > lock(mutex_);
+    cond_.wait(lock, [this]{ return !busy_; });
+}
+
+void BackgroundWriter::run()
+{
+    std::unique_lock< std::mutex > lock(mutex_);
+    while (true){
+        cond_.wait(lock, [this]{ return busy_ || stop_; });
+        if (!busy_){
+            return;
+        }
+        lock.unlock();
+        job_();
+        lock.lock();
+        job_ = nullptr;
+        busy_ = false;
+        cond_.notify_all();
+    }
+}
+
 /**
    Create or open attribute at specified path.
 
@@ -570,6 +643,7 @@ bool HDF5WriterBase::isOpen() const
 
 herr_t HDF5WriterBase::openFile()
 {
+    std::lock_guard< std::recursive_mutex > lock(hdf5Mutex());
     herr_t status = 0;
     if (filehandle_ >= 0){
         cout << "Warning: closing already open file and opening " << filename_ <<  endl;
@@ -652,6 +726,7 @@ unsigned int HDF5WriterBase::getCompression() const
 // file.
 void HDF5WriterBase::flush()
 {
+    std::lock_guard< std::recursive_mutex > lock(hdf5Mutex());
     flushAttributes();
     sattr_.clear();
     dattr_.clear();
@@ -682,6 +757,7 @@ void HDF5WriterBase::close()
         return;
     }
     flush();
+    std::lock_guard< std::recursive_mutex > lock(hdf5Mutex());
     herr_t status = H5Fclose(filehandle_);
     filehandle_ = -1;
     if (status < 0){
@@ -32,12 +32,48 @@
 #ifndef _HDF5IO_H
 #define _HDF5IO_H
 #include <typeinfo>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 hid_t require_attribute(hid_t file_id, string path,
                         hid_t data_type, hid_t data_id);
 
 hid_t require_group(hid_t file_id, string path);
 
+/**
+   The HDF5 library is not thread safe unless it was built to be, so
+   every writer holds this lock while it calls into HDF5.
+ */
+std::recursive_mutex& hdf5Mutex();
+
+/**
+   Runs the file writes of one writer on a thread of its own, one job at
+   a time. submit() waits for the previous job to finish before it hands
+   over the next, so the caller only blocks when it gets a full buffer
+   ahead of the disk. Copies start out idle and do not share the thread.
+ */
+class BackgroundWriter
+{
+  public:
+    BackgroundWriter();
+    BackgroundWriter(const BackgroundWriter& other);
+    BackgroundWriter& operator=(const BackgroundWriter& other);
+    ~BackgroundWriter();
+    void submit(std::function< void() > job);
+    /// Blocks until the last job submitted has been done.
+    void wait();
+  private:
+    void run();
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::function< void() > job_;
+    bool busy_;
+    bool stop_;
+};
+
 class HDF5WriterBase
 {
   public:
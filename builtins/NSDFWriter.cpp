@@ -159,7 +159,7 @@ const Cinfo * NSDFWriter::initCinfo()
 
 static const Cinfo * nsdfWriterCinfo = NSDFWriter::initCinfo();
 
-NSDFWriter::NSDFWriter(): eventGroup_(-1), uniformGroup_(-1), dataGroup_(-1), modelGroup_(-1), mapGroup_(-1), modelRoot_("/")
+NSDFWriter::NSDFWriter(): eventGroup_(-1), uniformGroup_(-1), dataGroup_(-1), modelGroup_(-1), mapGroup_(-1), modelRoot_("/"), pendingSteps_(0)
 {
     ;
 }
@@ -175,6 +175,7 @@ void NSDFWriter::close()
         return;
     }
     flush();
+    std::lock_guard< std::recursive_mutex > lock(hdf5Mutex());
     closeUniformData();
     if (uniformGroup_ >= 0){
         H5Gclose(uniformGroup_);
@@ -474,29 +475,53 @@ hid_t NSDFWriter::getEventDataset(string srcPath, string srcField)
 }
 
 void NSDFWriter::flush()
+{
+    writer_.wait();
+    std::lock_guard< std::recursive_mutex > lock(hdf5Mutex());
+    swapBuffers();
+    writePendingData();
+    // flush HDF5 nodes.
+    HDF5DataWriter::flush();
+}
+
+void NSDFWriter::swapBuffers()
+{
+    pendingData_.resize(data_.size());
+    pendingData_.swap(data_);
+    pendingEvents_.resize(events_.size());
+    pendingEvents_.swap(events_);
+    pendingSteps_ = steps_;
+    steps_ = 0;
+}
+
+/**
+   Append the pending uniform and event data to their datasets.
+ */
+void NSDFWriter::writePendingData()
 {
     // We need to update the tend on each write since we do not know
     // when the simulation is getting over and when it is just paused.
     writeScalarAttr<string>(filehandle_, "tend", iso_time(NULL));
 
+    const unsigned long steps = pendingSteps_;
     // append all uniform data
     for (map< string, hid_t>::iterator it = classFieldToUniform_.begin();
          it != classFieldToUniform_.end(); ++it){
         map< string, vector < unsigned int > >::iterator idxit = classFieldToSrcIndex_.find(it->first);
         if (idxit == classFieldToSrcIndex_.end()){
-            cerr << "Error: NSDFWriter::flush - could not find entry for " << it->first <<endl;
+            cerr << "Error: NSDFWriter::writePendingData - could not find entry for " << it->first <<endl;
             break;
         }
-        if (data_.size() == 0 || data_[0].size() == 0){
+        if (pendingData_.size() == 0 || steps == 0){
             break;
         }
-        double * buffer = (double*)calloc(idxit->second.size() * steps_, sizeof(double));
+        double * buffer = (double*)calloc(idxit->second.size() * steps, sizeof(double));
         vector< double > values;
         for (unsigned int ii = 0; ii < idxit->second.size(); ++ii){
-            for (unsigned int jj = 0; jj < steps_; ++jj){
-                buffer[ii * steps_ + jj] = data_[idxit->second[ii]][jj];
+            for (unsigned int jj = 0; jj < steps; ++jj){
+                buffer[ii * steps + jj] = pendingData_[idxit->second[ii]][jj];
             }
-            data_[idxit->second[ii]].clear();
+            pendingData_[idxit->second[ii]].clear();
         }
 
         hid_t filespace = H5Dget_space(it->second);
@@ -507,12 +532,12 @@ void NSDFWriter::flush()
         hsize_t maxdims[2];
         // retrieve current datset dimensions
         herr_t status = H5Sget_simple_extent_dims(filespace, dims, maxdims);
-        hsize_t newdims[] = {dims[0], dims[1] + steps_}; // new column count
+        hsize_t newdims[] = {dims[0], dims[1] + steps}; // new column count
         status = H5Dset_extent(it->second, newdims); // extend dataset to new column count
         H5Sclose(filespace);
         filespace = H5Dget_space(it->second); // get the updated filespace
         hsize_t start[2] = {0, dims[1]};
-        dims[1] = steps_; // change dims for memspace & hyperslab
+        dims[1] = steps; // change dims for memspace & hyperslab
         hid_t memspace = H5Screate_simple(2, dims, NULL);
         H5Sselect_hyperslab(filespace, H5S_SELECT_SET, start, NULL, dims, NULL);
         status = H5Dwrite(it->second, H5T_NATIVE_DOUBLE,  memspace, filespace, H5P_DEFAULT, buffer);
@@ -521,18 +546,20 @@ void NSDFWriter::flush()
         free(buffer);
     }
 
+    pendingSteps_ = 0;
+
     // append all event data
     for (unsigned int ii = 0; ii < eventSrc_.size(); ++ii){
         appendToDataset(getEventDataset(eventSrc_[ii], eventSrcFields_[ii]),
-                        events_[ii]);
-        events_[ii].clear();
+                        pendingEvents_[ii]);
+        pendingEvents_[ii].clear();
     }
-    // flush HDF5 nodes.
-    HDF5DataWriter::flush();
 }
 
 void NSDFWriter::reinit(const Eref& eref, const ProcPtr proc)
 {
+    writer_.wait();
+    std::lock_guard< std::recursive_mutex > lock(hdf5Mutex());
     // write environment
     // write model
     // write map
@@ -593,8 +620,16 @@ void NSDFWriter::process(const Eref& eref, ProcPtr proc)
     // for (unsigned int ii = 0; ii < events_.size(); ++ii){
     //     herr_t status = appendToDataset(eventDatasets_[ii], events_[ii]);
     // }
-    NSDFWriter::flush();
-    steps_ = 0;
+    if (!asyncWrite_){
+        NSDFWriter::flush();
+        return;
+    }
+    writer_.wait();
+    swapBuffers();
+    writer_.submit([this]{
+        std::lock_guard< std::recursive_mutex > lock(hdf5Mutex());
+        writePendingData();
+    });
  }
 
 NSDFWriter& NSDFWriter::operator=( const NSDFWriter& other)
@@ -112,6 +112,10 @@ class NSDFWriter: public HDF5DataWriter
 
   protected:
     hid_t getEventDataset(string srcPath, string srcField);
+    /// Moves the buffered uniform and event data into the pending
+    /// buffers, leaving empty ones to fill.
+    void swapBuffers();
+    void writePendingData();
     void sortOutUniformSources(const Eref& eref);
     /* hid_t getUniformDataset(string srcPath, string srcField); */
     map <string, string> env_; // environment attributes
@@ -160,6 +164,12 @@ class NSDFWriter: public HDF5DataWriter
     map< string, vector < string > > classFieldToObjectField_;
     vector < string > vars_;
     string modelRoot_;
+    // Data handed over to writer_: the uniform data in the order of
+    // data_, and the event times. Only the writer touches these while
+    // it is busy.
+    vector< vector< double > > pendingData_;
+    vector< vector< double > > pendingEvents_;
+    unsigned long pendingSteps_;
 
 };
 #endif // _NSDFWRITER_H
@@ -173,7 +173,7 @@ const Cinfo * NSDFWriter2::initCinfo()
 
 static const Cinfo * nsdfWriterCinfo = NSDFWriter2::initCinfo();
 
-NSDFWriter2::NSDFWriter2(): eventGroup_(-1), uniformGroup_(-1), dataGroup_(-1), modelGroup_(-1), mapGroup_(-1), modelRoot_("/")
+NSDFWriter2::NSDFWriter2(): eventGroup_(-1), uniformGroup_(-1), dataGroup_(-1), modelGroup_(-1), mapGroup_(-1), pendingSteps_(0), modelRoot_("/")
 {
     ;
 }
@@ -189,6 +189,7 @@ void NSDFWriter2::close()
         return;
     }
     flush();
+    std::lock_guard< std::recursive_mutex > lock(hdf5Mutex());
     closeUniformData();
     if (uniformGroup_ >= 0){
         H5Gclose(uniformGroup_);
@@ -515,22 +516,53 @@ hid_t NSDFWriter2::getEventDataset(string srcPath, string srcField)
 }
 
 void NSDFWriter2::flush()
+{
+    writer_.wait();
+    std::lock_guard< std::recursive_mutex > lock(hdf5Mutex());
+    swapBuffers();
+    writePendingData();
+    // flush HDF5 nodes.
+    HDF5DataWriter::flush();
+}
+
+void NSDFWriter2::swapBuffers()
+{
+    pendingBlocks_.resize(blocks_.size());
+    for (unsigned int ii = 0; ii < blocks_.size(); ++ii){
+        vector< vector< double > >& data = blocks_[ii].data;
+        pendingBlocks_[ii].resize(data.size());
+        pendingBlocks_[ii].swap(data);
+    }
+    pendingEvents_.resize(events_.size());
+    pendingEvents_.swap(events_);
+    pendingSteps_ = steps_;
+    steps_ = 0;
+}
+
+/**
+   Append the pending uniform and event data to their datasets. The
+   buffers are cleared but stay allocated, so that once they have been
+   through a couple of flushes process() does not allocate any more.
+ */
+void NSDFWriter2::writePendingData()
 {
     // We need to update the tend on each write since we do not know
     // when the simulation is getting over and when it is just paused.
     writeScalarAttr<string>(filehandle_, "tend", iso_time(NULL));
 
     // append all uniform data
-	for ( vector< Block >::iterator bit = blocks_.begin(); (steps_ > 0) && (bit != blocks_.end()); bit++ ) {
-		assert( steps_ == bit->data[0].size() );
-        double* buffer = (double*)calloc(bit->data.size() * steps_, sizeof(double));
-        for (unsigned int ii = 0; ii < bit->data.size(); ++ii){
-            for (unsigned int jj = 0; jj < steps_; ++jj){
-                buffer[ii * steps_ + jj] = bit->data[ii][jj];
-            }
-            bit->data[ii].clear();
+    const unsigned long steps = pendingSteps_;
+	for ( unsigned int bb = 0; (steps > 0) && (bb < blocks_.size()); bb++ ) {
+		vector< vector< double > >& data = pendingBlocks_[bb];
+		hid_t dataset = blocks_[bb].dataset;
+		assert( steps == data[0].size() );
+        writeBuf_.resize(data.size() * steps);
+        for (unsigned int ii = 0; ii < data.size(); ++ii){
+            std::copy(data[ii].begin(), data[ii].end(),
+                      writeBuf_.begin() + ii * steps);
+            data[ii].clear();
         }
-        hid_t filespace = H5Dget_space(bit->dataset);
+        hid_t filespace = H5Dget_space(dataset);
         if (filespace < 0){
 			cout << "Error: NSDFWriter2::flush(): Failed to open filespace\n";
             break;
@@ -539,41 +571,40 @@ void NSDFWriter2::flush()
         hsize_t maxdims[2];
         // retrieve current datset dimensions
         herr_t status = H5Sget_simple_extent_dims(filespace, dims, maxdims);
-        hsize_t newdims[] = {dims[0], dims[1] + steps_}; // new column count
-        status = H5Dset_extent(bit->dataset, newdims); // extend dataset to new column count
+        hsize_t newdims[] = {dims[0], dims[1] + steps}; // new column count
+        status = H5Dset_extent(dataset, newdims); // extend dataset to new column count
 		if ( status < 0 ) {
 			cout << "Error: NSDFWriter2::flush(): Fail to extend dataset\n";
             break;
 		}
         H5Sclose(filespace);
-        filespace = H5Dget_space(bit->dataset); // get the updated filespace
+        filespace = H5Dget_space(dataset); // get the updated filespace
         hsize_t start[2] = {0, dims[1]};
-        dims[1] = steps_; // change dims for memspace & hyperslab
+        dims[1] = steps; // change dims for memspace & hyperslab
         hid_t memspace = H5Screate_simple(2, dims, NULL);
         H5Sselect_hyperslab(filespace, H5S_SELECT_SET, start, NULL, dims, NULL);
-        status = H5Dwrite(bit->dataset, H5T_NATIVE_DOUBLE,  memspace, filespace, H5P_DEFAULT, buffer);
+        status = H5Dwrite(dataset, H5T_NATIVE_DOUBLE,  memspace, filespace, H5P_DEFAULT, &writeBuf_[0]);
 		if ( status < 0 ) {
 			cout << "Error: NSDFWriter2::flush(): Failed to write data\n";
             break;
 		}
         H5Sclose(memspace);
         H5Sclose(filespace);
-        free(buffer);
     }
-	steps_ = 0;
+	pendingSteps_ = 0;
 
     // append all event data
     for (unsigned int ii = 0; ii < eventSrc_.size(); ++ii){
         appendToDataset(getEventDataset(eventSrc_[ii], eventSrcFields_[ii]),
-                        events_[ii]);
-        events_[ii].clear();
+                        pendingEvents_[ii]);
+        pendingEvents_[ii].clear();
     }
-    // flush HDF5 nodes.
-    HDF5DataWriter::flush();
 }
 
 void NSDFWriter2::reinit(const Eref& eref, const ProcPtr proc)
 {
+    writer_.wait();
+    std::lock_guard< std::recursive_mutex > lock(hdf5Mutex());
     // write environment
     // write model
     // write map
@@ -630,7 +661,16 @@ void NSDFWriter2::process(const Eref& eref, ProcPtr proc)
     if (steps_ < flushLimit_){
         return;
     }
-    NSDFWriter2::flush();
+    if (!asyncWrite_){
+        NSDFWriter2::flush();
+        return;
+    }
+    writer_.wait();
+    swapBuffers();
+    writer_.submit([this]{
+        std::lock_guard< std::recursive_mutex > lock(hdf5Mutex());
+        writePendingData();
+    });
  }
 
 NSDFWriter2& NSDFWriter2::operator=( const NSDFWriter2& other)
@@ -145,6 +145,10 @@ class NSDFWriter2: public HDF5DataWriter
 
   protected:
     hid_t getEventDataset(string srcPath, string srcField);
+    /// Moves the buffered uniform and event data into the pending
+    /// buffers, leaving empty ones to fill.
+    void swapBuffers();
+    void writePendingData();
     // void sortOutUniformSources(const Eref& eref);
 	void buildUniformSources(const Eref& eref);
 	void sortMsgs(const Eref& eref);
@@ -167,6 +171,12 @@ class NSDFWriter2: public HDF5DataWriter
 	vector< string > blockStrVec_;
 	vector< Block > blocks_;
 	vector< unsigned int > mapMsgIdx_; // Look up tgt idx from consolidated block idx.
+	// Data handed over to writer_: one data array per block, and the
+	// event times. Only the writer touches these while it is busy.
+	vector< vector< vector< double > > > pendingBlocks_;
+	vector< vector< double > > pendingEvents_;
+	unsigned long pendingSteps_;
+	vector< double > writeBuf_; // Row-major copy of one block's data.
 
     map< string, vector< hid_t > > classFieldToEvent_;
     map< string, vector< string > > classFieldToEventSrc_;
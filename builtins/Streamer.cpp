@@ -244,7 +244,8 @@ void Streamer::reinit(const Eref& e, ProcPtr p)
     // write now.
     currTime_ = 0.0;
     zipWithTime( );
-    StreamerBase::writeToOutFile(datafilePath_, format_, WRITE, data_, columns_);
+    sink_.open( datafilePath_, format_, columns_ );
+    sink_.write( data_ );
     data_.clear( );
 }
 
@@ -255,7 +256,8 @@ void Streamer::reinit(const Eref& e, ProcPtr p)
 void Streamer::cleanUp( )
 {
     zipWithTime( );
-    StreamerBase::writeToOutFile( datafilePath_, format_, APPEND, data_, columns_ );
+    sink_.write( data_ );
+    sink_.sync( );
     data_.clear( );
 }
 
@@ -269,7 +271,7 @@ void Streamer::process(const Eref& e, ProcPtr p)
 {
     // LOG( moose::debug, "Writing Streamer data to file." );
     zipWithTime( );
-    StreamerBase::writeToOutFile( datafilePath_, format_, APPEND, data_, columns_ );
+    sink_.write( data_ );
     data_.clear();
     numWriteEvents_ += 1;
 }
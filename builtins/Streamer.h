@@ -96,6 +96,9 @@ private:
     /*  Keep data in vector */
     vector<double> data_;
 
+    /*  The open data file */
+    StreamSink sink_;
+
 };
 
 #endif   /* ----- #ifndef Streamer_INC  ----- */
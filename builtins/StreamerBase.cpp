@@ -146,3 +146,153 @@ string StreamerBase::vectorToCSV( const vector<double>& ys, const string& fmt )
         res += std::to_string(v) + ",";
     return res;
 }
+
+/*-----------------------------------------------------------------------------
+ *  StreamSink
+ *-----------------------------------------------------------------------------*/
+StreamSink::StreamSink() : fp_(NULL), numRows_(0), headerSize_(0)
+{
+}
+
+StreamSink::StreamSink( const StreamSink& other ) :
+    fp_(NULL), numRows_(0), headerSize_(0)
+{
+}
+
+StreamSink& StreamSink::operator=( const StreamSink& other )
+{
+    return *this;
+}
+
+StreamSink::~StreamSink()
+{
+    close();
+}
+
+set< StreamSink* >& StreamSink::openSinks()
+{
+    static set< StreamSink* > sinks;
+    return sinks;
+}
+
+void StreamSink::syncAll()
+{
+    for( auto sink : openSinks() )
+        sink->sync();
+}
+
+bool StreamSink::isOpen() const
+{
+    return fp_ != NULL;
+}
+
+bool StreamSink::open( const string& filepath, const string& format
+        , const vector<string>& columns )
+{
+    close();
+    fp_ = fopen( filepath.c_str(), "wb" );
+    if( NULL == fp_ )
+    {
+        LOG( moose::warning, "Failed to open " << filepath );
+        return false;
+    }
+    openSinks().insert( this );
+
+    // Data goes to disk in 1 MB writes.
+    buffer_.resize( 1 << 20 );
+    setvbuf( fp_, &buffer_[0], _IOFBF, buffer_.size() );
+
+    format_ = format;
+    columns_ = columns;
+    numRows_ = 0;
+    if( "npy" == format_  || "npz" == format_ )
+    {
+        format_ = "npy";
+        // Leave room for the number of rows to grow to 32 digits.
+        headerSize_ = cnpy2::npyHeader( columns_, {0} ).size() + 32;
+        headerSize_ = cnpy2::npyHeader( columns_, {0}, headerSize_ ).size();
+        writeNpyHeader();
+    }
+    else if( "bin" == format_ )
+    {
+        const uint32_t version = 1;
+        const uint32_t numCols = columns_.size();
+        fwrite( "MOOSEBIN", 1, 8, fp_ );
+        fwrite( &version, sizeof(version), 1, fp_ );
+        fwrite( &numCols, sizeof(numCols), 1, fp_ );
+        for( auto& col : columns_ )
+        {
+            const uint32_t len = col.size();
+            fwrite( &len, sizeof(len), 1, fp_ );
+            fwrite( col.data(), 1, len, fp_ );
+        }
+        fflush( fp_ );
+    }
+    else
+    {
+        if( "csv" != format_ && "dat" != format_ )
+            LOG( moose::warning, "Unsupported format " << format
+                    << ". Use npy, csv or bin. Falling back to default csv"
+               );
+        format_ = "csv";
+        for( auto& col : columns_ )
+            fprintf( fp_, "%s ", col.c_str() );
+        fputc( '\n', fp_ );
+    }
+    return true;
+}
+
+void StreamSink::writeNpyHeader()
+{
+    string header = cnpy2::npyHeader( columns_, {numRows_}, headerSize_ );
+    assert( header.size() == headerSize_ );
+    fseek( fp_, 0, SEEK_SET );
+    fwrite( header.data(), 1, header.size(), fp_ );
+    fseek( fp_, 0, SEEK_END );
+}
+
+void StreamSink::write( const vector<double>& data )
+{
+    if( NULL == fp_ || columns_.empty() || data.empty() )
+        return;
+
+    const size_t numCols = columns_.size();
+    const uint64_t numRows = data.size() / numCols;
+    if( "csv" == format_ )
+    {
+        for( size_t i = 0; i < numRows * numCols; i += numCols )
+        {
+            for( size_t ii = 0; ii + 1 < numCols; ii++ )
+                fprintf( fp_, "%.17g ", data[i+ii] );
+            fprintf( fp_, "%.17g\n", data[i+numCols-1] );
+        }
+    }
+    else if( "bin" == format_ )
+    {
+        fwrite( &numRows, sizeof(numRows), 1, fp_ );
+        fwrite( &data[0], sizeof(double), numRows * numCols, fp_ );
+        fflush( fp_ );
+    }
+    else
+        fwrite( &data[0], sizeof(double), numRows * numCols, fp_ );
+    numRows_ += numRows;
+}
+
+void StreamSink::sync()
+{
+    if( NULL == fp_ )
+        return;
+    if( "npy" == format_ )
+        writeNpyHeader();
+    fflush( fp_ );
+}
+
+void StreamSink::close()
+{
+    if( NULL == fp_ )
+        return;
+    sync();
+    fclose( fp_ );
+    fp_ = NULL;
+    openSinks().erase( this );
+}
@@ -21,6 +21,8 @@
 #include <map>
 #include <fstream>
 #include <sstream>
+#include <set>
+#include <cstdio>
 
 #include "TableBase.h"
 
@@ -30,6 +32,66 @@ class TableBase;
 
 enum OpenMode {WRITE, APPEND, WRITE_STR, APPEND_STR, WRITE_BIN, APPEND_BIN};
 
+/**
+ * @brief A data file that stays open while a Table or Streamer writes to
+ * it.
+ *
+ * Rows go through a large write buffer straight into the file, instead of
+ * the file being reopened on every write. Formats:
+ *
+ *  npy : numpy structured array. The header is written with room to spare
+ *  and its shape is only filled in by sync() and close().
+ *  csv or dat: space separated text, one row per line.
+ *  bin : chunked binary that can be read while it is being written. The
+ *  file starts with the magic string "MOOSEBIN", the uint32 version (1),
+ *  the uint32 number of columns, and each column name as a uint32 length
+ *  followed by its characters. Then come chunks, each a uint64 row count
+ *  followed by that many rows of native doubles. Every chunk is flushed
+ *  as soon as it is written, so a reader that only takes chunks whose
+ *  data is all there can follow the file during a run.
+ *
+ * Anything else falls back to csv.
+ */
+class StreamSink
+{
+public:
+    StreamSink();
+    /// Copies start out closed.
+    StreamSink( const StreamSink& other );
+    StreamSink& operator=( const StreamSink& other );
+    ~StreamSink();
+
+    /// Creates filepath, replacing any file there, and writes the header.
+    bool open( const string& filepath, const string& format
+            , const vector<string>& columns );
+
+    /// Appends rows of data, which holds as many values per row as there
+    /// are columns.
+    void write( const vector<double>& data );
+
+    /// Pushes buffered data to the file and brings the npy header up to
+    /// date, so that the file can be read as it is.
+    void sync();
+
+    void close();
+    bool isOpen() const;
+
+    /// Syncs every open sink. Called when a simulation run ends.
+    static void syncAll();
+
+private:
+    void writeNpyHeader();
+    static set< StreamSink* >& openSinks();
+
+    FILE* fp_;
+    string format_;
+    vector<string> columns_;
+    size_t numRows_;
+    // Length of the npy header, which is kept the same on rewrites.
+    size_t headerSize_;
+    vector<char> buffer_;
+};
+
 class StreamerBase : public TableBase
 {
 
@@ -83,11 +83,22 @@ const Cinfo* Table::initCinfo()
 
     static ValueFinfo< Table, string > format(
         "format"
-        , "Data format for table: default csv"
+        , "Data format for table: csv (default), npy, or bin for a chunked"
+        " binary file that can be read while the simulation runs."
         , &Table::setFormat
         , &Table::getFormat
     );
 
+    static ValueFinfo< Table, unsigned int > ringSize(
+        "ringSize"
+        , "Number of [time, value] pairs that the Table also keeps in a"
+        " ring buffer, which can be read with moose.poll while the"
+        " simulation runs in the background. 0 (default) turns it off."
+        " Pairs are dropped if the ring fills up before it is read."
+        , &Table::setRingSize
+        , &Table::getRingSize
+    );
+
     // relevant for Streamer class.  When data is written to a datafile, this is
     // used to create column name.
     static ValueFinfo< Table, string > columnName(
@@ -147,6 +158,7 @@ const Cinfo* Table::initCinfo()
         &outfile,               // Value
         &useStreamer,           // Value
         &useSpikeMode,          // Value
+        &ringSize,              // Value
         handleInput(),		// DestFinfo
         &spike,			// DestFinfo
         requestOut(),		// SrcFinfo
@@ -236,8 +248,8 @@ Table::~Table( )
     if( useFileStreamer_ )
     {
         mergeWithTime( data_ );
-        assert( ! datafile_.empty() );
-        StreamerBase::writeToOutFile( datafile_, format_, APPEND, data_, columns_);
+        sink_.write( data_ );
+        sink_.close();
         clearAllVecs();
     }
 }
@@ -261,6 +273,7 @@ void Table::process( const Eref& e, ProcPtr p )
     vector< double > ret;
     requestOut()->send( e, &ret );
 
+    size_t numOld = vec().size();
     if (useSpikeMode_)
     {
         for ( auto i = ret.begin(); i != ret.end(); ++i )
@@ -269,6 +282,14 @@ void Table::process( const Eref& e, ProcPtr p )
     else
         vec().insert( vec().end(), ret.begin(), ret.end() );
 
+    if( ring_ )
+    {
+        for ( size_t i = numOld; i < vec().size(); ++i )
+        {
+            ring_->push( make_pair( lastTime_, vec()[i] ) );
+        }
+    }
+
     /*  If we are streaming to a file, let's write to a file. And clean the
      *  vector.
      *  Write at every 5 seconds or whenever size of vector is more than 10k.
@@ -278,7 +299,7 @@ void Table::process( const Eref& e, ProcPtr p )
         if( fmod(lastTime_, 5.0) == 0.0 || getVecSize() >= 10000 )
         {
             mergeWithTime( data_ );
-            StreamerBase::writeToOutFile( datafile_, format_, APPEND, data_, columns_ );
+            sink_.write( data_ );
             clearAllVecs();
         }
         }
@@ -327,6 +348,8 @@ void Table::reinit( const Eref& e, ProcPtr p )
     input_ = 0.0;
     vec().resize( 0 );
     lastTime_ = 0;
+    if( ring_ )
+        ring_->clear();
     vector< double > ret;
     requestOut()->send( e, &ret );
 
@@ -338,12 +361,19 @@ void Table::reinit( const Eref& e, ProcPtr p )
     else
         vec().insert( vec().end(), ret.begin(), ret.end() );
 
+    if( ring_ )
+    {
+        for ( double v : vec() )
+            ring_->push( make_pair( lastTime_, v ) );
+    }
+
     tvec_.push_back(lastTime_);
 
     if( useFileStreamer_ )
     {
         mergeWithTime( data_ );
-        StreamerBase::writeToOutFile(datafile_, format_, WRITE, data_, columns_);
+        sink_.open( datafile_, format_, columns_ );
+        sink_.write( data_ );
         clearAllVecs();
     }
 }
@@ -390,12 +420,12 @@ double Table::getThreshold() const
 // Set the format of table to which its data should be written.
 void Table::setFormat( string format )
 {
-    if( format == "csv" )
+    if( format == "csv" || format == "npy" || format == "bin" )
         format_ = format;
     else
         LOG( moose::warning
              , "Unsupported format " << format
-             << " only csv is supported for single table."
+             << " only csv, npy and bin are supported for single table."
            );
 }
 
@@ -438,6 +468,34 @@ bool Table::getUseSpikeMode( void ) const
     return useSpikeMode_;
 }
 
+void Table::setRingSize( unsigned int size )
+{
+    if( size == 0 )
+        ring_.reset();
+    else
+        ring_.reset( new moose::RingBuffer< pair<double, double> >( size ) );
+}
+
+unsigned int Table::getRingSize( void ) const
+{
+    return ring_ ? ring_->capacity() : 0;
+}
+
+size_t Table::pollRing( vector<double>& data )
+{
+    if( !ring_ )
+        return 0;
+    size_t dropped = ring_->dropped();
+    vector< pair<double, double> > pairs;
+    ring_->drain( pairs );
+    for( const auto& p : pairs )
+    {
+        data.push_back( p.first );
+        data.push_back( p.second );
+    }
+    return dropped;
+}
+
 
 /*  set/get datafile_ */
 void Table::setDatafile( string filepath )
@@ -10,6 +10,10 @@
 #ifndef _TABLE_H
 #define _TABLE_H
 
+#include <memory>
+#include "StreamerBase.h"
+#include "../utility/RingBuffer.h"
+
 using namespace std;
 
 /**
@@ -45,6 +49,17 @@ public:
     void setDatafile ( string filepath );
     string getDatafile ( void ) const;
 
+    void setRingSize ( unsigned int size );
+    unsigned int getRingSize ( void ) const;
+
+    /**
+     * Moves the [time, value] pairs recorded since the last call into
+     * data, and returns how many pairs have been dropped since reinit
+     * because the ring was full. Safe to call from another thread
+     * while the table records.
+     */
+    size_t pollRing( vector<double>& data );
+
     // Access the dt_ of table.
     double getDt ( void ) const;
 
@@ -120,6 +135,17 @@ private:
      */
     string format_;
 
+    /**
+     * @brief The open datafile_, when streaming.
+     */
+    StreamSink sink_;
+
+    /**
+     * @brief Copy of the recent [time, value] pairs, for a reader in
+     * another thread. Null unless ringSize is set.
+     */
+    std::unique_ptr< moose::RingBuffer< pair<double, double> > > ring_;
+
 };
 
 #endif	// _TABLE_H
@@ -57,6 +57,7 @@
 #include "../basecode/header.h"
 #include "../utility/utility.h"
 #include "../utility/strutil.h"
+#include "../shell/Shell.h"
 
 #include "HDF5WriterBase.h"
 #include "HDF5DataWriter.h"
@@ -88,16 +89,128 @@ void testCreateStringDataset()
     H5Fclose(file);
 }
 
+/**
+   Jobs given to a BackgroundWriter must run one at a time, in the order
+   they were submitted, and wait() must return only when all are done.
+ */
+void testBackgroundWriter()
+{
+    vector< unsigned int > done;
+    unsigned int running = 0;
+    bool overlap = false;
+    {
+        BackgroundWriter writer;
+        for (unsigned int ii = 0; ii < 100; ++ii){
+            writer.submit([&done, &running, &overlap, ii]{
+                if (running++ > 0){
+                    overlap = true;
+                }
+                done.push_back(ii);
+                --running;
+            });
+        }
+        writer.wait();
+        assert(done.size() == 100);
+        // A copy gets a writer of its own.
+        BackgroundWriter other(writer);
+        other.submit([&done]{ done.push_back(100); });
+        other.wait();
+    }
+    assert(!overlap);
+    assert(done.size() == 101);
+    for (unsigned int ii = 0; ii < done.size(); ++ii){
+        assert(done[ii] == ii);
+    }
+    cout << "." << flush;
+}
+
+/// Reads the uniform outputValue data of PulseGens from an NSDF file.
+static vector< double > readPulseData(const string& filename, hsize_t dims[2])
+{
+    hid_t file = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    assert(file >= 0);
+    hid_t dset = H5Dopen2(file, "/data/uniform/PulseGen/outputValue",
+                          H5P_DEFAULT);
+    assert(dset >= 0);
+    hid_t space = H5Dget_space(dset);
+    H5Sget_simple_extent_dims(space, dims, NULL);
+    vector< double > ret(dims[0] * dims[1]);
+    herr_t status = H5Dread(dset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL,
+                            H5P_DEFAULT, ret.data());
+    assert(status >= 0);
+    H5Sclose(space);
+    H5Dclose(dset);
+    H5Fclose(file);
+    return ret;
+}
+
+/**
+   An NSDFWriter with asyncWrite must write the same data as one that
+   writes on the simulation thread, including the last partial buffer.
+ */
+void testNSDFWriterAsync()
+{
+    Shell* shell = reinterpret_cast< Shell* >( Id().eref().data() );
+    Id model = shell->doCreate("Neutral", Id(), "nsdfAsync", 1);
+    Id pulse = shell->doCreate("PulseGen", model, "pulse", 3);
+    for (unsigned int ii = 0; ii < 3; ++ii){
+        ObjId p(pulse, ii);
+        LookupField< unsigned int, double >::set(p, "delay", 0, 1e-3 * (ii + 1));
+        LookupField< unsigned int, double >::set(p, "width", 0, 2e-3);
+        LookupField< unsigned int, double >::set(p, "level", 0, 1.0 + ii);
+    }
+    string filename[2];
+    for (unsigned int kk = 0; kk < 2; ++kk){
+        filename[kk] = moose::random_string(10) + ".h5";
+        Id writer = shell->doCreate("NSDFWriter", model, kk ? "async" : "sync", 1);
+        Field< string >::set(writer, "filename", filename[kk]);
+        Field< unsigned int >::set(writer, "flushLimit", 7);
+        Field< bool >::set(writer, "asyncWrite", kk == 1);
+        for (unsigned int ii = 0; ii < 3; ++ii){
+            shell->doAddMsg("Single", writer, "requestOut", ObjId(pulse, ii),
+                            "getOutputValue");
+        }
+    }
+    shell->doSetClock(0, 1e-4);
+    shell->doUseClock("/nsdfAsync/##", "process", 0);
+    shell->doReinit();
+    shell->doStart(0.1003);
+    shell->doDelete(model); // Closes the files.
+
+    hsize_t dims[2];
+    hsize_t asyncDims[2];
+    vector< double > data = readPulseData(filename[0], dims);
+    vector< double > asyncData = readPulseData(filename[1], asyncDims);
+    assert(dims[0] == 3 && dims[1] > 1000);
+    assert(asyncDims[0] == dims[0] && asyncDims[1] == dims[1]);
+    assert(asyncData == data);
+    std::remove(filename[0].c_str());
+    std::remove(filename[1].c_str());
+    cout << "." << flush;
+}
+
 #else // dummy function
 void testCreateStringDataset()
 {
     ;
 }
+
+void testBackgroundWriter()
+{
+    ;
+}
+
+void testNSDFWriterAsync()
+{
+    ;
+}
 #endif // USE_HDF5
 
 void testNSDF()
 {
     testCreateStringDataset();
+    testBackgroundWriter();
+    testNSDFWriterAsync();
 }
 
 //
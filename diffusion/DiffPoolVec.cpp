@@ -15,6 +15,7 @@
 using namespace std;
 
 #include "../basecode/SparseMatrix.h"
+#include "StencilDiffusion.h"
 #include "DiffPoolVec.h"
 
 /**
@@ -24,7 +25,8 @@ using namespace std;
  */
 DiffPoolVec::DiffPoolVec()
     : id_( 0 ), n_( 1, 0.0 ), concInit_( 1, 0.0 ),
-      diffConst_( 1.0e-12 ), motorConst_( 0.0 )
+      diffConst_( 1.0e-12 ), motorConst_( 0.0 ),
+      voxelS_( 0 ), column_( 0 )
 {
     ;
 }
@@ -44,13 +46,18 @@ void DiffPoolVec::setConcInit( unsigned int voxel, double v )
 double DiffPoolVec::getN( unsigned int voxel ) const
 {
     assert( voxel < n_.size() );
+    if ( voxelS_ )
+        return voxelS_[ voxel ][ column_ ];
     return n_[ voxel ];
 }
 
 void DiffPoolVec::setN( unsigned int voxel, double v )
 {
     assert( voxel < n_.size() );
-    n_[ voxel ] = v;
+    if ( voxelS_ )
+        voxelS_[ voxel ][ column_ ] = v;
+    else
+        n_[ voxel ] = v;
 }
 
 double DiffPoolVec::getPrev( unsigned int voxel ) const
@@ -59,21 +66,45 @@ double DiffPoolVec::getPrev( unsigned int voxel ) const
     return prev_[ voxel ];
 }
 
-const vector< double >& DiffPoolVec::getNvec() const
+vector< double > DiffPoolVec::getNvec() const
+{
+    if ( !voxelS_ )
+        return n_;
+    vector< double > ret( n_.size() );
+    for ( unsigned int i = 0; i < ret.size(); ++i )
+        ret[i] = voxelS_[i][ column_ ];
+    return ret;
+}
+
+void DiffPoolVec::getNvec( unsigned int start, unsigned int num,
+        vector< double >& ret ) const
 {
-    return n_;
+    assert( start + num <= n_.size() );
+    if ( !voxelS_ )
+    {
+        ret.insert( ret.end(), n_.begin() + start, n_.begin() + start + num );
+        return;
+    }
+    for ( unsigned int i = start; i < start + num; ++i )
+        ret.push_back( voxelS_[i][ column_ ] );
 }
 
 void DiffPoolVec::setNvec( const vector< double >& vec )
 {
     assert( vec.size() == n_.size() );
-    n_ = vec;
+    setNvec( 0, vec.size(), vec.begin() );
 }
 
 void DiffPoolVec::setNvec( unsigned int start, unsigned int num,
         vector< double >::const_iterator q )
 {
     assert( start + num <= n_.size() );
+    if ( voxelS_ )
+    {
+        for ( unsigned int i = start; i < start + num; ++i )
+            voxelS_[i][ column_ ] = *q++;
+        return;
+    }
     vector< double >::iterator p = n_.begin() + start;
     for ( unsigned int i = 0; i < num; ++i )
         *p++ = *q++;
@@ -81,7 +112,34 @@ void DiffPoolVec::setNvec( unsigned int start, unsigned int num,
 
 void DiffPoolVec::setPrevVec()
 {
-    prev_ = n_;
+    if ( !voxelS_ )
+    {
+        prev_ = n_;
+        return;
+    }
+    prev_.resize( n_.size() );
+    for ( unsigned int i = 0; i < prev_.size(); ++i )
+        prev_[i] = voxelS_[i][ column_ ];
+}
+
+void DiffPoolVec::setView( double* const* voxelS, unsigned int column )
+{
+    clearView();
+    if ( !voxelS )
+        return;
+    for ( unsigned int i = 0; i < n_.size(); ++i )
+        voxelS[i][ column ] = n_[i];
+    voxelS_ = voxelS;
+    column_ = column;
+}
+
+void DiffPoolVec::clearView()
+{
+    if ( !voxelS_ )
+        return;
+    for ( unsigned int i = 0; i < n_.size(); ++i )
+        n_[i] = voxelS_[i][ column_ ];
+    voxelS_ = 0;
 }
 
 double DiffPoolVec::getDiffConst() const
@@ -106,6 +164,7 @@ void DiffPoolVec::setMotorConst( double v )
 
 void DiffPoolVec::setNumVoxels( unsigned int num )
 {
+    clearView();
     concInit_.resize( num, 0.0 );
     n_.resize( num, 0.0 );
 }
@@ -144,17 +203,42 @@ void DiffPoolVec::setOps(const vector< Triplet< double > >& ops,
 void DiffPoolVec::advance( double dt )
 {
     if ( ops_.size() == 0 ) return;
+    assert( n_.size() == diagVal_.size() );
+
+    if ( voxelS_ )
+    {
+        const unsigned int k = column_;
+        for (auto i = ops_.cbegin(); i != ops_.end(); ++i )
+            voxelS_[i->c_][k] -= voxelS_[i->b_][k] * i->a_;
+        for ( unsigned int i = 0; i < diagVal_.size(); ++i )
+            voxelS_[i][k] *= diagVal_[i];
+        return;
+    }
 
     for (auto i = ops_.cbegin(); i != ops_.end(); ++i )
         n_[i->c_] -= n_[i->b_] * i->a_;
 
-    assert( n_.size() == diagVal_.size() );
-
     auto iy = n_.begin();
     for ( auto i = diagVal_.cbegin(); i != diagVal_.end(); ++i )
         *iy++ *= *i;
 }
 
+void DiffPoolVec::advance( const StencilDiffusion& stencil, double dt )
+{
+    // The conjugate gradient wants a contiguous vector, so a shared pool
+    // is gathered into n_ for the step. That is one pass against the
+    // many the iteration makes.
+    if ( voxelS_ )
+    {
+        double* const* voxelS = voxelS_;
+        clearView();
+        stencil.advance( n_, diffConst_, dt );
+        setView( voxelS, column_ );
+        return;
+    }
+    stencil.advance( n_, diffConst_, dt );
+}
+
 void DiffPoolVec::reinit( const vector< double >& vols ) // Not called by the clock, but by parent.
 {
 	const double NA_ = 6.0221415e23;
@@ -165,4 +249,6 @@ void DiffPoolVec::reinit( const vector< double >& vols ) // Not called by the cl
 		nInit[i] = concInit_[i] * NA_ * vols[i];
 
     prev_ = n_ = nInit;
+    if ( voxelS_ )
+        setNvec( nInit );
 }
@@ -10,10 +10,17 @@
 #ifndef _DIFF_POOL_VEC_H
 #define _DIFF_POOL_VEC_H
 
+class StencilDiffusion;
+
 /**
  * This is a FieldElement of the Dsolve class. It manages (ie., zombifies)
  * a specific pool, and the pool maintains a pointer to it. For accessing
  * volumes, this maintains a pointer to the relevant ChemCompt.
+ *
+ * Normally the pool counts live in n_. When the Dsolve shares its state
+ * with a Ksolve, they instead live in the Ksolve's VoxelPools: voxelS_
+ * holds the base of the S array of each voxel and column_ is the index
+ * of this pool within it, so both solvers work on the same numbers.
  */
 class DiffPoolVec
 {
@@ -22,6 +29,8 @@ public:
     void process();
     void reinit( const vector< double >& vols );
     void advance( double dt );
+    /// Advance using the implicit stencil solver instead of ops_.
+    void advance( const StencilDiffusion& stencil, double dt );
     double getConcInit( unsigned int vox ) const;
     void setConcInit( unsigned int vox, double value );
     double getN( unsigned int vox ) const;
@@ -42,7 +51,10 @@ public:
 
     /////////////////////////////////////////////////
     /// Used by parent solver to manipulate 'n'
-    const vector< double >& getNvec() const;
+    vector< double > getNvec() const;
+    /// Appends 'n' of the num voxels from start to ret, without a copy.
+    void getNvec( unsigned int start, unsigned int num,
+                  vector< double >& ret ) const;
     /// Used by parent solver to manipulate 'n'
     void setNvec( const vector< double >& n );
     void setNvec( unsigned int start, unsigned int num,
@@ -51,6 +63,15 @@ public:
     void setOps( const vector< Triplet< double > >& ops_,
                  const vector< double >& diagVal_ ); /// Assign operations.
 
+    /**
+     * Switches to working on column 'column' of the voxel arrays in
+     * voxelS, which must have getNumVoxels() entries and stay valid
+     * until clearView. The current n values are copied in.
+     */
+    void setView( double* const* voxelS, unsigned int column );
+    /// Copies the values back into n_ and stops using the view.
+    void clearView();
+
     // static const Cinfo* initCinfo();
 private:
     unsigned int id_; /// Integer conversion of Id of pool handled.
@@ -61,6 +82,8 @@ private:
     double motorConst_; /// Motor const, ie, transport rate.
     vector< Triplet< double > > ops_;
     vector< double > diagVal_;
+    double* const* voxelS_; /// Voxel arrays of the reac solver, or null.
+    unsigned int column_; /// Index of this pool within each voxel array.
 };
 
 #endif // _DIFF_POOL_VEC_H
@@ -19,6 +19,7 @@
 #include "DiffPoolVec.h"
 #include "ConcChanInfo.h"
 #include "FastMatrixElim.h"
+#include "StencilDiffusion.h"
 #include "../mesh/VoxelJunction.h"
 #include "DiffJunction.h"
 #include "../mesh/Boundary.h"
@@ -90,6 +91,15 @@ const Cinfo* Dsolve::initCinfo()
             &Dsolve::getCompartment
             );
 
+    static ReadOnlyValueFinfo< Dsolve, vector< ObjId > > coupledObjects(
+            "coupledObjects",
+            "Solvers whose state this Dsolve touches when fluxes across "
+            "junctions are computed: the Dsolves it has junctions with, "
+            "and its own Ksolve. Used by the Clock to decide which "
+            "solvers may run on separate threads.",
+            &Dsolve::getCoupledObjects
+            );
+
     static LookupValueFinfo< Dsolve, unsigned int, double > diffVol1 (
             "diffVol1",
             "Volume used to set diffusion scaling: firstVol[ voxel# ] "
@@ -162,6 +172,7 @@ const Cinfo* Dsolve::initCinfo()
         &diffVol1,                  // LookupValue
         &diffVol2,                  // LookupValue
         &diffScale,                 // LookupValue
+        &coupledObjects,            // ReadOnlyValue
         &buildMeshJunctions,        // DestFinfo
         &buildNeuroMeshJunctions,   // DestFinfo
         &proc,                      // SharedFinfo
@@ -550,6 +561,12 @@ void Dsolve::calcJunction( const DiffJunction& jn, double dt )
 
 void Dsolve::process( const Eref& e, ProcPtr p )
 {
+    if ( stencil_.getNumVoxels() > 0 )
+    {
+        for ( auto i = pools_.begin(); i != pools_.end(); ++i )
+            i->advance( stencil_, p->dt );
+        return;
+    }
     for ( auto i = pools_.begin(); i != pools_.end(); ++i )
         i->advance( p->dt );
 }
@@ -558,6 +575,8 @@ void Dsolve::reinit( const Eref& e, ProcPtr p )
 {
 	const MeshCompt* m = reinterpret_cast< const MeshCompt* >(
                               compartment_.eref().data() );
+    // The Ksolve reattaches in its own reinit, which comes later.
+    detachState();
     build( p->dt, m );
     for (auto i = pools_.begin(); i != pools_.end(); ++i )
 		i->reinit( m->vGetVoxelVolume() );
@@ -695,28 +714,31 @@ Id Dsolve::getStoich() const
     return stoich_;
 }
 
+vector< ObjId > Dsolve::getCoupledObjects() const
+{
+    vector< ObjId > ret;
+    for ( const DiffJunction& jn : junctions_ )
+        ret.push_back( ObjId( Id( jn.otherDsolve ) ) );
+    if ( stoich_ != Id() )
+    {
+        Id ksolve = Field< Id >::get( stoich_, "ksolve" );
+        if ( ksolve != Id() )
+            ret.push_back( ksolve );
+    }
+    return ret;
+}
+
 /// Inherited, defining dummy function here.
 void Dsolve::setDsolve( Id dsolve )
 {;}
 
 void Dsolve::setCompartment( Id id )
 {
-    const Cinfo* c = id.element()->cinfo();
+    // Multi-dimensional CubeMeshes are handled in build(), through the
+    // mesh stencil.
+    detachState();
     compartment_ = id;
     numVoxels_ = Field< unsigned int >::get( id, "numMesh" );
-    if ( c->isA( "CubeMesh" ) )   // we do only linear diffusion for now
-    {
-        unsigned int nx = Field< unsigned int >::get( id, "nx" );
-        unsigned int ny = Field< unsigned int >::get( id, "nx" );
-        unsigned int nz = Field< unsigned int >::get( id, "nx" );
-        if ( !( nx*ny == 1 || nx*nz == 1 || ny*nz == 1 ) )
-        {
-            cout << "Warning: Dsolve::setCompartment:: Cube mesh: " <<
-                 c->name() << " found with >1 dimension of voxels. " <<
-                 "Only 1-D diffusion supported for now.\n";
-            return;
-        }
-    }
 }
 
 void Dsolve::makePoolMapFromElist( const vector< ObjId >& elist,
@@ -829,6 +851,27 @@ void Dsolve::build( double dt, const MeshCompt *m )
     dt_ = dt;
     unsigned int numVoxels = m->getNumEntries();
 
+    // The parentVoxel tree of a CubeMesh is just the voxels in index
+    // order, which is only right for a 1-D line. Anything else, including
+    // a line with holes from spaceToMesh, goes through the stencil.
+    stencil_.clear();
+    if ( compartment_.element()->cinfo()->isA( "CubeMesh" ) &&
+            !StencilDiffusion::isLinearChain( m->getStencil() ) )
+    {
+        vector< double > vols( numVoxels );
+        for ( unsigned int i = 0; i < numVoxels; ++i )
+            vols[i] = m->getMeshEntryVolume( i );
+        stencil_.build( m->getStencil(), vols );
+        vector< Triplet< double > > noOps;
+        vector< double > noDiag;
+        for ( unsigned int i = 0; i < numLocalPools_; ++i )
+        {
+            pools_[i].setNumVoxels( numVoxels_ );
+            pools_[i].setOps( noOps, noDiag );
+        }
+        return;
+    }
+
     for ( unsigned int i = 0; i < numLocalPools_; ++i )
     {
         bool debugFlag = false;
@@ -1101,6 +1144,7 @@ unsigned int Dsolve::getNumVoxels() const
 
 void Dsolve::setNumAllVoxels( unsigned int num )
 {
+    detachState();
     numVoxels_ = num;
     for ( unsigned int i = 0 ; i < numLocalPools_; ++i )
         pools_[i].setNumVoxels( numVoxels_ );
@@ -1227,6 +1271,7 @@ void Dsolve::setMotorConst( const Eref& e, double v )
 
 void Dsolve::setNumVarTotPools( unsigned int var, unsigned int tot )
 {
+    detachState();
     // Decompose numPoolSpecies here, assigning some to each node.
     numTotPools_ = tot;
     numLocalPools_ = var;
@@ -1243,6 +1288,7 @@ void Dsolve::setNumVarTotPools( unsigned int var, unsigned int tot )
 
 void Dsolve::setNumPools( unsigned int numVarPoolSpecies )
 {
+    detachState();
     // Decompose numPoolSpecies here, assigning some to each node.
     numTotPools_ = numVarPoolSpecies;
     numLocalPools_ = numVarPoolSpecies;
@@ -1274,18 +1320,14 @@ void Dsolve::getBlock( vector< double >& values ) const
     assert( startPool >= poolStartIndex_ );
     assert( numPools + startPool <= numLocalPools_ );
     values.resize( 4 );
+    values.reserve( 4 + numPools * numVoxels );
 
     for ( unsigned int i = 0; i < numPools; ++i )
     {
         unsigned int j = i + startPool;
         if ( j >= poolStartIndex_ && j < poolStartIndex_ + numLocalPools_ )
-        {
-            vector< double >::const_iterator q =
-                pools_[ j - poolStartIndex_ ].getNvec().begin();
-
-            values.insert( values.end(),
-                           q + startVoxel, q + startVoxel + numVoxels );
-        }
+            pools_[ j - poolStartIndex_ ].getNvec( startVoxel, numVoxels,
+                                                   values );
     }
 }
 
@@ -1299,6 +1341,36 @@ void Dsolve::setPrev()
     }
 }
 
+bool Dsolve::attachState( const vector< double* >& voxelS,
+                          unsigned int numPools )
+{
+    detachState();
+    if ( voxelS.size() != numVoxels_ || numPools > numLocalPools_ ||
+            poolStartIndex_ != 0 )
+        return false;
+    voxelS_ = voxelS;
+    for ( unsigned int i = 0; i < numPools; ++i )
+    {
+        assert( pools_[i].getNumVoxels() == numVoxels_ );
+        pools_[i].setView( &voxelS_[0], i );
+    }
+    return true;
+}
+
+void Dsolve::detachState()
+{
+    if ( voxelS_.empty() )
+        return;
+    for ( auto i = pools_.begin(); i != pools_.end(); ++i )
+        i->clearView();
+    voxelS_.clear();
+}
+
+bool Dsolve::isStateShared() const
+{
+    return !voxelS_.empty();
+}
+
 void Dsolve::setBlock( const vector< double >& values )
 {
     unsigned int startVoxel = values[0];
@@ -43,6 +43,13 @@ public:
     // Defined in base class. Id getCompartment() const;
     void setDsolve( Id id ); /// Dummy, inherited but not used.
 
+    /**
+     * Inherited. Returns the Dsolves on the other side of each junction
+     * and the Ksolve of this reaction system, which all share state
+     * through updateJunctions.
+     */
+    vector< ObjId > getCoupledObjects() const;
+
     void setPath( const Eref& e, string path );
     string getPath( const Eref& e ) const;
 
@@ -147,6 +154,10 @@ public:
     void getBlock( vector< double >& values ) const;
     void setBlock( const vector< double >& values );
     void setPrev();
+    bool attachState( const vector< double* >& voxelS,
+                      unsigned int numPools );
+    void detachState();
+    bool isStateShared() const;
 
     // This one isn't used in Dsolve, but is defined as a dummy.
     void setupCrossSolverReacs(
@@ -214,6 +225,19 @@ private:
 
     /// Internal vector, one for each pool species managed by Dsolve.
     vector< DiffPoolVec > pools_;
+
+    /**
+     * Implicit solver over the mesh stencil. Used instead of the Hines
+     * ops in each DiffPoolVec when the mesh is a CubeMesh that is not a
+     * simple 1-D chain. Empty otherwise.
+     */
+    StencilDiffusion stencil_;
+
+    /**
+     * S arrays of the Ksolve voxels when the two solvers share state,
+     * see attachState. Empty otherwise. The DiffPoolVecs point into it.
+     */
+    vector< double* > voxelS_;
     /// Internal vector, one for each ConcChan managed by Dsolve.
     vector< ConcChanInfo > channels_;
 
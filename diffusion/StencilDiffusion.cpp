@@ -0,0 +1,207 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2026 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include <cmath>
+#include "../basecode/header.h"
+#include "../basecode/SparseMatrix.h"
+#include "../utility/ThreadPool.h"
+#include "StencilDiffusion.h"
+
+const double StencilDiffusion::tolerance = 1.0e-10;
+const unsigned int StencilDiffusion::maxIterations = 10000;
+
+// Rows per chunk. Partial sums are kept per chunk, so this also fixes
+// the order of floating point additions independent of thread count.
+static const size_t GRAIN = 4096;
+
+StencilDiffusion::StencilDiffusion()
+{;}
+
+void StencilDiffusion::build( const SparseMatrix< double >& stencil,
+                              const vector< double >& vols )
+{
+    unsigned int numVoxels = stencil.nRows();
+    assert( vols.size() >= numVoxels );
+    clear();
+    rowStart_.resize( numVoxels + 1, 0 );
+    degree_.resize( numVoxels, 0.0 );
+    vol_.assign( vols.begin(), vols.begin() + numVoxels );
+    for ( unsigned int i = 0; i < numVoxels; ++i )
+    {
+        const double* entry;
+        const unsigned int* colIndex;
+        unsigned int num = stencil.getRow( i, &entry, &colIndex );
+        for ( unsigned int j = 0; j < num; ++j )
+        {
+            if ( colIndex[j] == i || colIndex[j] >= numVoxels )
+                continue;
+            colIndex_.push_back( colIndex[j] );
+            coupling_.push_back( entry[j] );
+            degree_[i] += entry[j];
+        }
+        rowStart_[i + 1] = colIndex_.size();
+    }
+}
+
+void StencilDiffusion::clear()
+{
+    rowStart_.clear();
+    colIndex_.clear();
+    coupling_.clear();
+    vol_.clear();
+    degree_.clear();
+}
+
+unsigned int StencilDiffusion::getNumVoxels() const
+{
+    return vol_.size();
+}
+
+bool StencilDiffusion::isLinearChain( const SparseMatrix< double >& stencil )
+{
+    unsigned int numVoxels = stencil.nRows();
+    for ( unsigned int i = 0; i < numVoxels; ++i )
+    {
+        const double* entry;
+        const unsigned int* colIndex;
+        unsigned int num = stencil.getRow( i, &entry, &colIndex );
+        unsigned int expected = ( i > 0 ) + ( i + 1 < numVoxels );
+        if ( num != expected )
+            return false;
+        for ( unsigned int j = 0; j < num; ++j )
+            if ( colIndex[j] + 1 != i && colIndex[j] != i + 1 )
+                return false;
+    }
+    return true;
+}
+
+unsigned int StencilDiffusion::advance( vector< double >& n,
+                                        double diffConst, double dt ) const
+{
+    const size_t num = vol_.size();
+    if ( num == 0 || diffConst <= 0.0 || dt <= 0.0 )
+        return 0;
+    assert( n.size() == num );
+
+    const double a = dt * diffConst;
+    const size_t numChunks = ( num + GRAIN - 1 ) / GRAIN;
+    moose::ThreadPool& pool = moose::ThreadPool::global();
+    x_.resize( num );
+    r_.resize( num );
+    z_.resize( num );
+    p_.resize( num );
+    q_.resize( num );
+    partial_.resize( 2 * numChunks );
+
+    // y = ( V + a.L ) x over rows [begin, end).
+    auto multiply = [&]( const vector< double >& x, vector< double >& y,
+                         size_t begin, size_t end )
+    {
+        for ( size_t i = begin; i < end; ++i )
+        {
+            double sum = ( vol_[i] + a * degree_[i] ) * x[i];
+            for ( unsigned int k = rowStart_[i]; k < rowStart_[i+1]; ++k )
+                sum -= a * coupling_[k] * x[ colIndex_[k] ];
+            y[i] = sum;
+        }
+    };
+    auto reduce = [&]( size_t offset ) {
+        double sum = 0.0;
+        for ( size_t c = 0; c < numChunks; ++c )
+            sum += partial_[ 2 * c + offset ];
+        return sum;
+    };
+
+    // Warm start from the current concentrations. The right hand side
+    // is n itself, so with a flat profile the residual is already zero.
+    // The product needs x_ from the neighbouring chunks, so x_ is filled
+    // in a pass of its own.
+    pool.parallelFor( num, GRAIN, [&]( size_t begin, size_t end ) {
+        double bb = 0.0;
+        for ( size_t i = begin; i < end; ++i )
+        {
+            x_[i] = n[i] / vol_[i];
+            bb += n[i] * n[i];
+        }
+        partial_[ 2 * ( begin / GRAIN ) ] = bb;
+    } );
+    pool.parallelFor( num, GRAIN, [&]( size_t begin, size_t end ) {
+        multiply( x_, q_, begin, end );
+        double rz = 0.0;
+        for ( size_t i = begin; i < end; ++i )
+        {
+            r_[i] = n[i] - q_[i];
+            z_[i] = r_[i] / ( vol_[i] + a * degree_[i] );
+            p_[i] = z_[i];
+            rz += r_[i] * z_[i];
+        }
+        partial_[ 2 * ( begin / GRAIN ) + 1 ] = rz;
+    } );
+    const double bnorm = sqrt( reduce( 0 ) );
+    double rz = reduce( 1 );
+    if ( bnorm == 0.0 )
+        return 0;
+
+    unsigned int iter = 0;
+    for ( ; iter < maxIterations; ++iter )
+    {
+        // Residual of zero means we are done; also guards 0/0 below.
+        if ( rz <= 0.0 )
+            break;
+        pool.parallelFor( num, GRAIN, [&]( size_t begin, size_t end ) {
+            multiply( p_, q_, begin, end );
+            double pq = 0.0;
+            for ( size_t i = begin; i < end; ++i )
+                pq += p_[i] * q_[i];
+            partial_[ 2 * ( begin / GRAIN ) ] = pq;
+        } );
+        const double alpha = rz / reduce( 0 );
+        pool.parallelFor( num, GRAIN, [&]( size_t begin, size_t end ) {
+            double rrChunk = 0.0;
+            double rzChunk = 0.0;
+            for ( size_t i = begin; i < end; ++i )
+            {
+                x_[i] += alpha * p_[i];
+                r_[i] -= alpha * q_[i];
+                z_[i] = r_[i] / ( vol_[i] + a * degree_[i] );
+                rrChunk += r_[i] * r_[i];
+                rzChunk += r_[i] * z_[i];
+            }
+            partial_[ 2 * ( begin / GRAIN ) ] = rrChunk;
+            partial_[ 2 * ( begin / GRAIN ) + 1 ] = rzChunk;
+        } );
+        const double rr = reduce( 0 );
+        const double rzNew = reduce( 1 );
+        if ( sqrt( rr ) <= tolerance * bnorm )
+        {
+            ++iter;
+            break;
+        }
+        const double beta = rzNew / rz;
+        rz = rzNew;
+        pool.parallelFor( num, GRAIN, [&]( size_t begin, size_t end ) {
+            for ( size_t i = begin; i < end; ++i )
+                p_[i] = z_[i] + beta * p_[i];
+        } );
+    }
+
+    // Written back in flux form, n' = n - dt.D.L c', rather than as V c'.
+    // The columns of L sum to zero, so molecules are conserved to
+    // roundoff whatever residual the iteration stopped at.
+    pool.parallelFor( num, GRAIN, [&]( size_t begin, size_t end ) {
+        for ( size_t i = begin; i < end; ++i )
+        {
+            double flux = degree_[i] * x_[i];
+            for ( unsigned int k = rowStart_[i]; k < rowStart_[i+1]; ++k )
+                flux -= coupling_[k] * x_[ colIndex_[k] ];
+            n[i] -= a * flux;
+        }
+    } );
+    return iter;
+}
@@ -0,0 +1,78 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2026 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _STENCIL_DIFFUSION_H
+#define _STENCIL_DIFFUSION_H
+
+/**
+ * Implicit diffusion on an arbitrary voxel graph, used where the mesh is
+ * not a tree and FastMatrixElim cannot do the job, that is, for 2-D and
+ * 3-D CubeMeshes.
+ *
+ * The coupling between voxels comes straight from the mesh stencil,
+ * whose entries are area/length of the shared face. Since the stencil
+ * only contains voxels present in spaceToMesh, holes and irregular
+ * surfaces are respected. Each step is a backward Euler step
+ *     ( V + dt.D.L ) c' = V c = n
+ * where V is the diagonal of voxel volumes, L the graph Laplacian of the
+ * stencil and c the concentration. The matrix is symmetric positive
+ * definite even for unequal volumes, so it is solved with a Jacobi
+ * preconditioned conjugate gradient, warm started from the current
+ * concentrations. Like the Hines path, the step is unconditionally
+ * stable and conserves the total number of molecules.
+ *
+ * The matrix-vector products and dot products are split over the shared
+ * moose::ThreadPool in fixed-size chunks, so the answer does not depend
+ * on the number of threads.
+ */
+class StencilDiffusion
+{
+public:
+    StencilDiffusion();
+
+    /// Copies the connectivity out of the mesh stencil.
+    void build( const SparseMatrix< double >& stencil,
+                const vector< double >& vols );
+    void clear();
+    unsigned int getNumVoxels() const;
+
+    /**
+     * Advances the pool counts in n by one implicit step of length dt.
+     * Returns the number of conjugate gradient iterations used.
+     */
+    unsigned int advance( vector< double >& n, double diffConst,
+                          double dt ) const;
+
+    /**
+     * True if the stencil connects voxel i only to i-1 and i+1, with no
+     * gaps. This is the case the parentVoxel chain handles exactly.
+     */
+    static bool isLinearChain( const SparseMatrix< double >& stencil );
+
+    /// Relative residual at which the iteration stops.
+    static const double tolerance;
+    static const unsigned int maxIterations;
+
+private:
+    vector< unsigned int > rowStart_;
+    vector< unsigned int > colIndex_;
+    vector< double > coupling_; /// area/length for each neighbour
+    vector< double > vol_;
+    vector< double > degree_; /// Sum of couplings on each row
+
+    /// Work space for the iteration, kept to avoid reallocation.
+    mutable vector< double > x_;
+    mutable vector< double > r_;
+    mutable vector< double > z_;
+    mutable vector< double > p_;
+    mutable vector< double > q_;
+    mutable vector< double > partial_;
+};
+
+#endif // _STENCIL_DIFFUSION_H
@@ -22,6 +22,7 @@ using namespace std;
 #include "../basecode/header.h"
 #include "../basecode/SparseMatrix.h"
 #include "FastMatrixElim.h"
+#include "DiffPoolVec.h"
 #include "../shell/Shell.h"
 
 
@@ -932,15 +933,138 @@ void testCalcJunction()
     cout << "." << flush;
 }
 
+/**
+ * Point source in the middle of a 2-D CubeMesh. Checks the spread against
+ * the analytic 2-D solution, that the profile is symmetric in x and y,
+ * and that no molecules are lost.
+ */
+void testCubeDiffn2D()
+{
+    Shell* s = reinterpret_cast< Shell* >( Id().eref().data() );
+    const unsigned int side = 21;
+    const unsigned int mid = side / 2;
+    double dx = 1e-6;
+    double runtime = 4.0;
+    double dt = 0.1;
+    double diffConst = 1.0e-12;
+    Id model = s->doCreate( "Neutral", Id(), "model", 1 );
+    Id cube = s->doCreate( "CubeMesh", model, "cube", 1 );
+    vector< double > coords( 9, dx );
+    coords[0] = coords[1] = coords[2] = 0.0;
+    coords[3] = coords[4] = side * dx;
+    Field< vector< double > >::set( cube, "coords", coords );
+    unsigned int ndc = Field< unsigned int >::get( cube, "numMesh" );
+    assert( ndc == side * side );
+    Id pool = s->doCreate( "Pool", cube, "pool", 1 );
+    Field< double >::set( pool, "diffConst", diffConst );
+
+    Id dsolve = s->doCreate( "Dsolve", model, "dsolve", 1 );
+    Field< Id >::set( dsolve, "compartment", cube );
+    s->doUseClock( "/model/dsolve", "process", 1 );
+    s->doSetClock( 1, dt );
+    Field< string >::set( dsolve, "path", "/model/cube/pool" );
+    Field< double >::set( ObjId( pool, mid * side + mid ), "nInit", 1.0 );
+
+    s->doReinit();
+    s->doStart( runtime );
+
+    vector< double > nvec =
+        LookupField< unsigned int, vector< double > >::get(
+            dsolve, "nVec", 0);
+    assert( nvec.size() == ndc );
+    double err = 0.0;
+    double myTot = 0.0;
+    for ( unsigned int iy = 0; iy < side; ++iy )
+    {
+        for ( unsigned int ix = 0; ix < side; ++ix )
+        {
+            double x = ( double( ix ) - mid ) * dx;
+            double y = ( double( iy ) - mid ) * dx;
+            double ans = dx * dx / ( 4 * PI * diffConst * runtime ) *
+                exp( -( x * x + y * y ) / ( 4 * diffConst * runtime ) );
+            double n = nvec[ iy * side + ix ];
+            err += ( ans - n ) * ( ans - n );
+            myTot += n;
+            assert( doubleApprox( n, nvec[ ix * side + iy ] ) );
+        }
+    }
+    assert( doubleApprox( myTot, 1.0 ) );
+    assert( err < 1.0e-4 );
+
+    s->doDelete( model );
+    cout << "." << flush;
+}
+
+/**
+ * A DiffPoolVec attached to voxel arrays must read and write them in
+ * place, and hand the values back when it is detached.
+ */
+void testDiffPoolVecView()
+{
+    DiffPoolVec dpv;
+    dpv.setNumVoxels( 3 );
+    for ( unsigned int i = 0; i < 3; ++i )
+        dpv.setN( i, i + 1.0 );
+
+    // Three voxels with two pools each; the DiffPoolVec is pool 1.
+    double voxels[3][2] = { { -1, 0 }, { -2, 0 }, { -3, 0 } };
+    double* voxelS[3] = { voxels[0], voxels[1], voxels[2] };
+    dpv.setView( voxelS, 1 );
+    for ( unsigned int i = 0; i < 3; ++i )
+    {
+        assert( doubleEq( voxels[i][1], i + 1.0 ) );
+        assert( doubleEq( voxels[i][0], -( i + 1.0 ) ) );
+    }
+
+    voxels[1][1] = 10.0;
+    assert( doubleEq( dpv.getN( 1 ), 10.0 ) );
+    dpv.setN( 2, 20.0 );
+    assert( doubleEq( voxels[2][1], 20.0 ) );
+    vector< double > n = dpv.getNvec();
+    assert( n.size() == 3 );
+    assert( doubleEq( n[0], 1.0 ) );
+    assert( doubleEq( n[1], 10.0 ) );
+    n.assign( 1, 5.0 );
+    dpv.getNvec( 1, 2, n );
+    assert( n.size() == 3 );
+    assert( doubleEq( n[1], 10.0 ) );
+    assert( doubleEq( n[2], 20.0 ) );
+    dpv.setPrevVec();
+    assert( doubleEq( dpv.getPrev( 2 ), 20.0 ) );
+
+    // One elimination op, n[1] -= 0.5 * n[0], then the diagonal.
+    vector< Triplet< double > > ops( 1, Triplet< double >( 0.5, 0, 1 ) );
+    vector< double > diag( 3, 2.0 );
+    dpv.setOps( ops, diag );
+    dpv.advance( 0.1 );
+    assert( doubleEq( voxels[0][1], 2.0 ) );
+    assert( doubleEq( voxels[1][1], 19.0 ) );
+    assert( doubleEq( voxels[2][1], 40.0 ) );
+    assert( doubleEq( voxels[0][0], -1.0 ) );
+
+    dpv.clearView();
+    voxels[0][1] = 99.0;
+    assert( doubleEq( dpv.getN( 0 ), 2.0 ) );
+    assert( doubleEq( dpv.getN( 1 ), 19.0 ) );
+    n.clear();
+    dpv.getNvec( 0, 2, n );
+    assert( n.size() == 2 );
+    assert( doubleEq( n[0], 2.0 ) );
+    assert( doubleEq( n[1], 19.0 ) );
+    cout << "." << flush;
+}
+
 void testDiffusion()
 {
     testSorting();
     testFastMatrixElim();
+    testDiffPoolVecView();
     testSetDiffusionAndTransport();
     testCylDiffn();
     testTaperingCylDiffn();
     testSmallCellDiffn();
     testCellDiffn();
     testCylDiffnWithStoich();
+    testCubeDiffn2D();
     testCalcJunction();
 }
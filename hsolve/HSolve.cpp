@@ -10,11 +10,13 @@
 #include "../basecode/header.h"
 #include "../basecode/global.h"
 #include "../basecode/ElementValueFinfo.h"
+#include "../utility/utility.h"
 #include "HSolveStruct.h"
 #include "HinesMatrix.h"
 #include "HSolvePassive.h"
 #include "RateLookup.h"
 #include "HSolveActive.h"
+#include "HSolveBatch.h"
 #include "HSolve.h"
 #include "../biophysics/Compartment.h"
 #include "ZombieCompartment.h"
@@ -26,6 +28,12 @@
 #include "../biophysics/HHChannel.h"
 #include "../biophysics/CaConc.h"
 #include "ZombieHHChannel.h"
+#include "../biophysics/SynChan.h"
+#include "ZombieSynChan.h"
+#include "../biophysics/HHChannel2D.h"
+#include "ZombieHHChannel2D.h"
+#include "../biophysics/MarkovChannel.h"
+#include "ZombieMarkovChannel.h"
 #include "../shell/Shell.h"
 
 #include <chrono>
@@ -84,6 +92,49 @@ const Cinfo* HSolve::initCinfo()
         &HSolve::getPath
     );
 
+    static ReadOnlyElementValueFinfo< HSolve, vector< ObjId > > coupledObjects(
+        "coupledObjects",
+        "Objects that receive messages from this solver during process: "
+        "targets of Vm, Ik and Ca outputs and of spikes from SpikeGens in "
+        "the solved cell, and in population mode the other entries of "
+        "this HSolve that are also in population mode. Used by the Clock "
+        "to decide which solvers may run on separate threads.",
+        &HSolve::getCoupledObjects
+    );
+
+    static ReadOnlyValueFinfo< HSolve, vector< Id > > compartments(
+        "compartments",
+        "Compartments taken over by the solver, in the order in which "
+        "it keeps their state.",
+        &HSolve::getCompartments
+    );
+
+    static ValueFinfo< HSolve, bool > population(
+        "population",
+        "Population mode. The entries of an HSolve array that have this "
+        "set, and whose cells have the same compartment tree, channels "
+        "and calcium pools, are integrated together. Their state is "
+        "interleaved so that each stage of the step runs as one "
+        "vectorized loop over cells, and the cells are spread over "
+        "numThreads threads. Cells may differ in their parameters and "
+        "inputs. The results are the same as without population mode. "
+        "Grouping is done on the first step after reinit, so changes to "
+        "channel powers or to 'instant' need another reinit. "
+        "Default is false.",
+        &HSolve::setPopulation,
+        &HSolve::getPopulation
+    );
+
+    static ValueFinfo< HSolve, unsigned int > numThreads(
+        "numThreads",
+        "Number of threads used to integrate a population of cells. "
+        "Only used in population mode, and read from the first cell of "
+        "each population. Defaults to the MOOSE_NUM_THREADS environment "
+        "variable, or 1.",
+        &HSolve::setNumThreads,
+        &HSolve::getNumThreads
+    );
+
     static ValueFinfo< HSolve, double > dt(
         "dt",
         "The time-step for this solver.",
@@ -106,7 +157,8 @@ const Cinfo* HSolve::initCinfo()
     static ValueFinfo< HSolve, int > vDiv(
         "vDiv",
         "Specifies number of divisions for lookup tables of voltage-sensitive "
-        "channels.",
+        "channels. Only used if all these channels have formula gates "
+        "(HHChannelF), otherwise decided from the tables of the channels.",
         &HSolve::setVDiv,
         &HSolve::getVDiv
     );
@@ -115,7 +167,8 @@ const Cinfo* HSolve::initCinfo()
         "vMin",
         "Specifies the lower bound for lookup tables of voltage-sensitive "
         "channels. Default is to automatically decide based on the tables of "
-        "the channels that the solver reads in.",
+        "the channels that the solver reads in. If all these channels have "
+        "formula gates (HHChannelF), the value set here is used.",
         &HSolve::setVMin,
         &HSolve::getVMin
     );
@@ -124,7 +177,8 @@ const Cinfo* HSolve::initCinfo()
         "vMax",
         "Specifies the upper bound for lookup tables of voltage-sensitive "
         "channels. Default is to automatically decide based on the tables of "
-        "the channels that the solver reads in.",
+        "the channels that the solver reads in. If all these channels have "
+        "formula gates (HHChannelF), the value set here is used.",
         &HSolve::setVMax,
         &HSolve::getVMax
     );
@@ -132,7 +186,8 @@ const Cinfo* HSolve::initCinfo()
     static ValueFinfo< HSolve, int > caDiv(
         "caDiv",
         "Specifies number of divisions for lookup tables of calcium-sensitive "
-        "channels.",
+        "channels. Only used if all these channels have formula gates "
+        "(HHChannelF), otherwise decided from the tables of the channels.",
         &HSolve::setCaDiv,
         &HSolve::getCaDiv
     );
@@ -141,7 +196,8 @@ const Cinfo* HSolve::initCinfo()
         "caMin",
         "Specifies the lower bound for lookup tables of calcium-sensitive "
         "channels. Default is to automatically decide based on the tables of "
-        "the channels that the solver reads in.",
+        "the channels that the solver reads in. If all these channels have "
+        "formula gates (HHChannelF), the value set here is used.",
         &HSolve::setCaMin,
         &HSolve::getCaMin
     );
@@ -150,15 +206,32 @@ const Cinfo* HSolve::initCinfo()
         "caMax",
         "Specifies the upper bound for lookup tables of calcium-sensitive "
         "channels. Default is to automatically decide based on the tables of "
-        "the channels that the solver reads in.",
+        "the channels that the solver reads in. If all these channels have "
+        "formula gates (HHChannelF), the value set here is used.",
         &HSolve::setCaMax,
         &HSolve::getCaMax
     );
 
+    static ValueFinfo< HSolve, bool > floatTables(
+        "floatTables",
+        "Hold the lookup tables of channel gate rates in single precision "
+        "and look rates up from them. This halves the memory the tables "
+        "take up, which can speed up large cells, at the cost of rounding "
+        "the rates to float precision. Turning it off again keeps the "
+        "rounded rates until the solver next reads in the cell. Off by "
+        "default.",
+        &HSolve::setFloatTables,
+        &HSolve::getFloatTables
+    );
+
     static Finfo* hsolveFinfos[] =
     {
         &seed,              // Value
         &target,              // Value
+        &coupledObjects,      // ReadOnlyValue
+        &compartments,      // ReadOnlyValue
+        &population,        // Value
+        &numThreads,        // Value
         &dt,                // Value
         &caAdvance,         // Value
         &vDiv,              // Value
@@ -167,6 +240,7 @@ const Cinfo* HSolve::initCinfo()
         &caDiv,             // Value
         &caMin,             // Value
         &caMax,             // Value
+        &floatTables,       // Value
         &proc,              // Shared
     };
 
@@ -195,8 +269,13 @@ const Cinfo* HSolve::initCinfo()
 static const Cinfo* hsolveCinfo = HSolve::initCinfo();
 
 HSolve::HSolve()
-    : dt_( 50e-6 )
+    : dt_( 50e-6 ),
+      population_( false ),
+      numThreads_( 1 ),
+      grouped_( false ),
+      batchLeader_( false )
 {
+    numThreads_ = moose::getEnvInt( "MOOSE_NUM_THREADS", 1 );
 }
 
 HSolve::~HSolve()
@@ -220,8 +299,17 @@ HSolve::~HSolve()
 
 void HSolve::process( const Eref& hsolve, ProcPtr p )
 {
+    if ( population_ && !grouped_ )
+        groupPopulation( hsolve );
+    // Other members of a batch are stepped by its leader.
+    if ( batch_ && !batchLeader_ )
+        return;
+
     t0_ = high_resolution_clock::now();
-    this->HSolveActive::step( p );
+    if ( batch_ )
+        batch_->step( p );
+    else
+        this->HSolveActive::step( p );
     t1_ = high_resolution_clock::now();
     addSolverProf( "HSolve", duration_cast<duration<double>>(t1_ - t0_).count(), 1 );
 }
@@ -229,9 +317,53 @@ void HSolve::process( const Eref& hsolve, ProcPtr p )
 void HSolve::reinit( const Eref& hsolve, ProcPtr p )
 {
     dt_ = p->dt;
+    batch_.reset();
+    batchLeader_ = false;
+    grouped_ = false;
     this->HSolveActive::reinit( p );
 }
 
+void HSolve::groupPopulation( const Eref& hsolve )
+{
+    Element* elm = hsolve.element();
+    unsigned int start = elm->localDataStart();
+    unsigned int end = start + elm->numLocalData();
+
+    vector< vector< HSolve* > > groups;
+    for ( unsigned int i = start; i < end; ++i )
+    {
+        HSolve* h = reinterpret_cast< HSolve* >( Eref( elm, i ).data() );
+        if ( !h->population_ || h->grouped_ )
+            continue;
+        h->grouped_ = true;
+        if ( h->nCompt_ == 0 )
+            continue;
+
+        vector< vector< HSolve* > >::iterator g;
+        for ( g = groups.begin(); g != groups.end(); ++g )
+            if ( HSolveBatch::sameStructure( *g->front(), *h ) )
+                break;
+        if ( g == groups.end() )
+            groups.push_back( vector< HSolve* >( 1, h ) );
+        else
+            g->push_back( h );
+    }
+
+    for ( const vector< HSolve* >& g : groups )
+    {
+        if ( g.size() < 2 )
+            continue;
+        vector< HSolveActive* > cells( g.begin(), g.end() );
+        std::shared_ptr< HSolveBatch > batch =
+            std::make_shared< HSolveBatch >( cells, g.front()->numThreads_ );
+        for ( HSolve* h : g )
+        {
+            h->batch_ = batch;
+            h->batchLeader_ = ( h == g.front() );
+        }
+    }
+}
+
 void HSolve::zombify( Eref hsolve ) const
 {
     vector< Id >::const_iterator i;
@@ -241,7 +373,7 @@ void HSolve::zombify( Eref hsolve ) const
 		temp.push_back( ObjId( *i, 0 ) );
     for ( i = compartmentId_.begin(); i != compartmentId_.end(); ++i ) {
         CompartmentBase::zombify( i->eref().element(),
-					   ZombieCompartment::initCinfo(), hsolve.id() );
+					   ZombieCompartment::initCinfo(), hsolve.objId() );
 	}
 
 	temp.clear();
@@ -249,7 +381,7 @@ void HSolve::zombify( Eref hsolve ) const
 		temp.push_back( ObjId( *i, 0 ) );
 	// Shell::dropClockMsgs( temp, "process" );
     for ( i = caConcId_.begin(); i != caConcId_.end(); ++i ) {
-        CaConcBase::zombify( i->eref().element(), ZombieCaConc::initCinfo(), hsolve.id() );
+        CaConcBase::zombify( i->eref().element(), ZombieCaConc::initCinfo(), hsolve.objId() );
 	}
 
 	temp.clear();
@@ -257,7 +389,21 @@ void HSolve::zombify( Eref hsolve ) const
 		temp.push_back( ObjId( *i, 0 ) );
     for ( i = channelId_.begin(); i != channelId_.end(); ++i ) {
         HHChannelBase::zombify( i->eref().element(),
-						ZombieHHChannel::initCinfo(), hsolve.id() );
+						ZombieHHChannel::initCinfo(), hsolve.objId() );
+	}
+
+    // SynChans, then HHChannel2Ds, then MarkovChannels.
+    unsigned int n2D = synchan_.size() + channel2D_.size();
+    for ( unsigned int k = 0; k < auxChannelId_.size(); ++k ) {
+        Element* elm = auxChannelId_[ k ].element();
+        if ( k < synchan_.size() )
+            SynChan::zombify( elm, ZombieSynChan::initCinfo(), hsolve.objId() );
+        else if ( k < n2D )
+            HHChannel2D::zombify( elm, ZombieHHChannel2D::initCinfo(),
+                                  hsolve.objId() );
+        else
+            MarkovChannel::zombify( elm, ZombieMarkovChannel::initCinfo(),
+                                    hsolve.objId() );
 	}
 }
 
@@ -276,11 +422,24 @@ void HSolve::unzombify() const
         	CaConcBase::zombify( i->eref().element(), CaConc::initCinfo(), Id() );
 		}
 
-    for ( i = channelId_.begin(); i != channelId_.end(); ++i )
-		if ( i->element() ) {
-        	HHChannelBase::zombify( i->eref().element(),
-						HHChannel::initCinfo(), Id() );
+    for ( unsigned int k = 0; k < channelId_.size(); ++k )
+		if ( channelId_[ k ].element() ) {
+        	HHChannelBase::zombify( channelId_[ k ].eref().element(),
+						channelClass_[ k ], Id() );
 		}
+
+    unsigned int n2D = synchan_.size() + channel2D_.size();
+    for ( unsigned int k = 0; k < auxChannelId_.size(); ++k ) {
+        Element* elm = auxChannelId_[ k ].element();
+        if ( !elm )
+            continue;
+        if ( k < synchan_.size() )
+            SynChan::zombify( elm, SynChan::initCinfo(), Id() );
+        else if ( k < n2D )
+            HHChannel2D::zombify( elm, HHChannel2D::initCinfo(), Id() );
+        else
+            MarkovChannel::zombify( elm, MarkovChannel::initCinfo(), Id() );
+	}
 }
 
 void HSolve::setup( Eref hsolve )
@@ -312,6 +471,81 @@ Id HSolve::getSeed() const
     return seed_;
 }
 
+void HSolve::setPopulation( bool population )
+{
+    population_ = population;
+}
+
+bool HSolve::getPopulation() const
+{
+    return population_;
+}
+
+void HSolve::setNumThreads( unsigned int numThreads )
+{
+    numThreads_ = numThreads;
+}
+
+unsigned int HSolve::getNumThreads() const
+{
+    return numThreads_;
+}
+
+/**
+ * Appends the targets of messages from src through the named SrcFinfo.
+ * A target that is a field entry, such as a Synapse, is reported as the
+ * data entry that holds it, since all its fields share that object's
+ * state.
+ */
+static void appendMsgTargets( const Eref& src, const string& field,
+                              vector< ObjId >& ret )
+{
+    const SrcFinfo* sf = dynamic_cast< const SrcFinfo* >(
+                             src.element()->cinfo()->findFinfo( field ) );
+    if ( !sf )
+        return;
+    vector< ObjId > tgts =
+        src.element()->getMsgTargets( src.dataIndex(), sf );
+    for ( const ObjId& tgt : tgts )
+    {
+        if ( tgt.element()->hasFields() )
+            ret.push_back( ObjId( Neutral::parent( tgt ).id,
+                                  tgt.dataIndex ) );
+        else
+            ret.push_back( tgt );
+    }
+}
+
+vector< ObjId > HSolve::getCoupledObjects( const Eref& e ) const
+{
+    vector< ObjId > ret;
+    if ( population_ )
+    {
+        // The leader of a batch steps and sends for all its members.
+        Element* elm = e.element();
+        unsigned int start = elm->localDataStart();
+        unsigned int end = start + elm->numLocalData();
+        for ( unsigned int i = start; i < end; ++i )
+        {
+            const HSolve* h =
+                reinterpret_cast< const HSolve* >( Eref( elm, i ).data() );
+            if ( i != e.dataIndex() && h->population_ )
+                ret.push_back( ObjId( elm->id(), i ) );
+        }
+    }
+    for ( unsigned int i : outVm_ )
+        appendMsgTargets( compartmentId_[ i ].eref(), "VmOut", ret );
+    for ( unsigned int i : outIk_ )
+        appendMsgTargets( channelId_[ i ].eref(), "IkOut", ret );
+    for ( unsigned int i : outAuxIk_ )
+        appendMsgTargets( auxChannelId_[ i ].eref(), "IkOut", ret );
+    for ( unsigned int i : outCa_ )
+        appendMsgTargets( caConcId_[ i ].eref(), "concOut", ret );
+    for ( const SpikeGenStruct& s : spikegen_ )
+        appendMsgTargets( s.e_, "spikeOut", ret );
+    return ret;
+}
+
 void HSolve::setPath( const Eref& hsolve, string path )
 {
     if ( dt_ == 0.0 )
@@ -498,6 +732,19 @@ double HSolve::getCaMax() const
     return caMax_;
 }
 
+void HSolve::setFloatTables( bool floatTables )
+{
+    floatTables_ = floatTables;
+    vTable_.setSinglePrecision( floatTables );
+    caTable_.setSinglePrecision( floatTables );
+    modified_ = true;
+}
+
+bool HSolve::getFloatTables() const
+{
+    return floatTables_;
+}
+
 const set<string>& HSolve::handledClasses()
 {
     static set<string> classes;
@@ -506,7 +753,14 @@ const set<string>& HSolve::handledClasses()
         classes.insert("CaConc");
         classes.insert("ZombieCaConc");
         classes.insert("HHChannel");
+        classes.insert("HHChannelF");
         classes.insert("ZombieHHChannel");
+        classes.insert("SynChan");
+        classes.insert("ZombieSynChan");
+        classes.insert("HHChannel2D");
+        classes.insert("ZombieHHChannel2D");
+        classes.insert("MarkovChannel");
+        classes.insert("ZombieMarkovChannel");
         classes.insert("Compartment");
         classes.insert("SymCompartment");
         classes.insert("ZombieCompartment");
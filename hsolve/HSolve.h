@@ -11,9 +11,12 @@
 #define _HSOLVE_H
 
 #include <set>
+#include <memory>
 #include <chrono>
 using namespace std::chrono;
 
+class HSolveBatch;
+
 /**
  * HSolve adapts the integrator HSolveActive into a MOOSE class.
  */
@@ -34,6 +37,20 @@ public:
     string getPath( const Eref& e ) const;
     /**< Path to the compartments */
 
+    /**
+     * Objects outside the solver that receive messages sent from within
+     * step(): targets of VmOut, IkOut, concOut and of the spikes of
+     * solved SpikeGens. Two HSolves sharing any of these cannot run
+     * on separate threads.
+     */
+    vector< ObjId > getCoupledObjects( const Eref& e ) const;
+
+    void setPopulation( bool population );
+    bool getPopulation() const;
+
+    void setNumThreads( unsigned int numThreads );
+    unsigned int getNumThreads() const;
+
     void setDt( double dt );
     double getDt() const;
 
@@ -58,6 +75,9 @@ public:
     void setCaMax( double caMax );
     double getCaMax() const;
 
+    void setFloatTables( bool floatTables );
+    bool getFloatTables() const;
+
     // Interface functions defined in HSolveInterface.cpp
     double getInitVm( Id id ) const;
     void setInitVm( Id id, double value );
@@ -89,7 +109,10 @@ public:
     void addInject( Id id, double value );
 
     /// Interface to compartments
-    //~ const vector< Id >& getCompartments() const;
+    vector< Id > getCompartments() const;
+
+    /// Vm of the compartments, in the order of getCompartments.
+    const vector< double >& getVmVector() const;
 
     void addGkEk( Id id, double v1, double v2 );
     void addConc( Id id, double conc );
@@ -145,6 +168,34 @@ public:
     double getCaFloor( Id id ) const;
     void setCaFloor( Id id, double floor );
 
+    /// Interface to SynChans, HHChannel2Ds and MarkovChannels
+    double getAuxChannelGk( Id id ) const;
+    void setAuxChannelGk( Id id, double value );
+
+    double getAuxChannelEk( Id id ) const;
+    void setAuxChannelEk( Id id, double value );
+
+    // Ik is read-only
+    double getAuxChannelIk( Id id ) const;
+
+    void setSynChanGbar( Id id, double value );
+    void setSynChanTau1( Id id, double value );
+    void setSynChanTau2( Id id, double value );
+    void setSynChanModulation( Id id, double value );
+    void activateSynChan( Id id, double value );
+
+    void setHHChannel2DGbar( Id id, double value );
+    void setHHChannel2DModulation( Id id, double value );
+    /// Concentration received on the concen (j = 0) or concen2 (j = 1) msg.
+    void setHHChannel2DConc( Id id, unsigned int j, double value );
+    /// State of the X (gate = 0), Y (1) or Z (2) gate.
+    double getHHChannel2DState( Id id, unsigned int gate ) const;
+    void setHHChannel2DState( Id id, unsigned int gate, double value );
+
+    vector< double > getMarkovState( Id id ) const;
+    void setMarkovGbars( Id id, vector< double > value );
+    void setMarkovInitialState( Id id, vector< double > value );
+
     /// Interface to external channels
     //~ const vector< vector< Id > >& getExternalChannels() const;
 
@@ -164,6 +215,13 @@ private:
     void zombify( Eref hsolve ) const;
     void unzombify() const;
 
+    /**
+     * Puts the entries of this HSolve array that are in population mode
+     * and solve identical cells into HSolveBatches. The first entry of
+     * each batch steps all of them.
+     */
+    void groupPopulation( const Eref& hsolve );
+
     // Mapping global Id to local index. Defined in HSolveInterface.cpp.
     void mapIds();
     void mapIds( vector< Id > id );
@@ -174,6 +232,13 @@ private:
     string path_;
     Id seed_;
 
+    bool population_;
+    unsigned int numThreads_;
+    bool grouped_;          ///< groupPopulation has seen this entry since
+                            ///< the last reinit.
+    bool batchLeader_;
+    std::shared_ptr< HSolveBatch > batch_;
+
     double totalTime_ = 0.0;
     high_resolution_clock::time_point t0_, t1_;
 };
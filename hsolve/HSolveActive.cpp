@@ -20,6 +20,12 @@
 #include "../biophysics/CaConcBase.h"
 #include "../biophysics/ChanBase.h"
 #include "ZombieCaConc.h"
+#include "../builtins/Interpol2D.h"
+#include "../biophysics/HHGate2D.h"
+#include "../biophysics/MatrixOps.h"
+#include "../biophysics/VectorTable.h"
+#include "../biophysics/MarkovRateTable.h"
+#include "../biophysics/MarkovSolverBase.h"
 using namespace moose;
 //~ #include "ZombieCompartment.h"
 //~ #include "ZombieCaConc.h"
@@ -33,10 +39,123 @@ const int HSolveActive::INSTANT_Z = 4;
 HSolveActive::HSolveActive()
 {
     caAdvance_ = 1;
+    modified_ = true;
+
+    // Default lookup tables, used for channels with formula gates only.
+    vMin_ = -0.100;
+    vMax_ = 0.050;
+    vDiv_ = 3000;
+    caMin_ = 0.0;
+    caMax_ = 1.0;
+    caDiv_ = 3000;
+    floatTables_ = false;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Checkpoints
+//////////////////////////////////////////////////////////////////////
+
+/// Appends the size of v, then v.
+static void putState( vector< double >& state, const vector< double >& v )
+{
+    state.push_back( v.size() );
+    state.insert( state.end(), v.begin(), v.end() );
+}
+
+/// Reads a vector written by putState into v, which must have its size.
+static bool getState( const vector< double >& state, size_t& pos,
+                      vector< double >& v )
+{
+    if ( pos >= state.size() || state[ pos ] != v.size() ||
+            pos + 1 + v.size() > state.size() )
+        return false;
+    std::copy( state.begin() + pos + 1, state.begin() + pos + 1 + v.size(),
+               v.begin() );
+    pos += 1 + v.size();
+    return true;
+}
+
+void HSolveActive::getCheckpoint( vector< double >& state ) const
+{
+    vector< double > caC( caConc_.size() );
+    for ( unsigned int i = 0; i < caConc_.size(); ++i )
+        caC[ i ] = caConc_[ i ].c_;
+    vector< double > gk( current_.size() );
+    for ( unsigned int i = 0; i < current_.size(); ++i )
+        gk[ i ] = current_[ i ].Gk;
+    vector< double > auxGk( auxCurrent_.size() );
+    for ( unsigned int i = 0; i < auxCurrent_.size(); ++i )
+        auxGk[ i ] = auxCurrent_[ i ].Gk;
+    vector< double > syn( 2 * synchan_.size() );
+    for ( unsigned int i = 0; i < synchan_.size(); ++i )
+    {
+        syn[ 2 * i ] = synchan_[ i ].X_;
+        syn[ 2 * i + 1 ] = synchan_[ i ].Y_;
+    }
 
-    // Default lookup table size
-    //~ vDiv_ = 3000;    // for voltage
-    //~ caDiv_ = 3000;   // for calcium
+    state.clear();
+    state.push_back( stage_ );
+    putState( state, V_ );
+    putState( state, VMid_ );
+    putState( state, state_ );
+    putState( state, ca_ );
+    putState( state, caC );
+    putState( state, gk );
+    putState( state, auxGk );
+    putState( state, syn );
+    putState( state, state2D_ );
+    putState( state, conc2D_ );
+    putState( state, markovState_ );
+    putState( state, prevExtCurr_ );
+}
+
+bool HSolveActive::setCheckpoint( const vector< double >& state )
+{
+    if ( state.empty() )
+        return false;
+    if ( current_.empty() )
+        current_.resize( channel_.size() );
+    vector< double > V( V_.size() ), VMid( VMid_.size() );
+    vector< double > gateState( state_.size() ), ca( ca_.size() );
+    vector< double > caC( caConc_.size() ), gk( current_.size() );
+    vector< double > auxGk( auxCurrent_.size() );
+    vector< double > syn( 2 * synchan_.size() );
+    vector< double > state2D( state2D_.size() ), conc2D( conc2D_.size() );
+    vector< double > markov( markovState_.size() );
+    vector< double > prevExt( prevExtCurr_.size() );
+    size_t pos = 1;
+    if ( !( getState( state, pos, V ) && getState( state, pos, VMid ) &&
+            getState( state, pos, gateState ) && getState( state, pos, ca ) &&
+            getState( state, pos, caC ) && getState( state, pos, gk ) &&
+            getState( state, pos, auxGk ) && getState( state, pos, syn ) &&
+            getState( state, pos, state2D ) &&
+            getState( state, pos, conc2D ) &&
+            getState( state, pos, markov ) &&
+            getState( state, pos, prevExt ) ) )
+        return false;
+
+    stage_ = state[0];
+    V_.swap( V );
+    VMid_.swap( VMid );
+    state_.swap( gateState );
+    ca_.swap( ca );
+    for ( unsigned int i = 0; i < caConc_.size(); ++i )
+        caConc_[ i ].c_ = caC[ i ];
+    for ( unsigned int i = 0; i < current_.size(); ++i )
+        current_[ i ].Gk = gk[ i ];
+    for ( unsigned int i = 0; i < auxCurrent_.size(); ++i )
+        auxCurrent_[ i ].Gk = auxGk[ i ];
+    for ( unsigned int i = 0; i < synchan_.size(); ++i )
+    {
+        synchan_[ i ].X_ = syn[ 2 * i ];
+        synchan_[ i ].Y_ = syn[ 2 * i + 1 ];
+    }
+    state2D_.swap( state2D );
+    conc2D_.swap( conc2D );
+    markovState_.swap( markov );
+    prevExtCurr_.swap( prevExt );
+    modified_ = true;
+    return true;
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -53,12 +172,14 @@ void HSolveActive::step( ProcPtr info )
     }
 
     advanceChannels( info->dt );
+    advanceChannels2D( info->dt );
+    advanceMarkovChannels();
     calculateChannelCurrents();
+    advanceSynChans( info );
     updateMatrix();
     HSolvePassive::forwardEliminate();
     HSolvePassive::backwardSubstitute();
     advanceCalcium();
-    advanceSynChans( info );
     sendValues( info );
     sendSpikes( info );
     prevExtCurr_ = externalCurrent_;
@@ -125,17 +246,14 @@ void HSolveActive::updateMatrix()
         value.injectVarying = 0.0;
     }
 
-    // Synapses are being handled as external channels.
-    //~ double Gk, Ek;
-    //~ vector< SynChanStruct >::iterator isyn;
-    //~ for ( isyn = synchan_.begin(); isyn != synchan_.end(); ++isyn ) {
-    //~ get< double >( isyn->elm_, synGkFinfo, Gk );
-    //~ get< double >( isyn->elm_, synEkFinfo, Ek );
-    //~
-    //~ unsigned int ic = isyn->compt_;
-    //~ HS_[ 4 * ic ] += Gk;
-    //~ HS_[ 4 * ic + 3 ] += Gk * Ek;
-    //~ }
+    // SynChans, HHChannel2Ds and MarkovChannels.
+    for ( unsigned int iaux = 0; iaux < auxCurrent_.size(); ++iaux )
+    {
+        unsigned int ic = auxCompt_[ iaux ];
+        const CurrentStruct& current = auxCurrent_[ iaux ];
+        HS_[ 4 * ic ] += current.Gk;
+        HS_[ 4 * ic + 3 ] += current.Gk * current.Ek;
+    }
 
     ihs = HS_.begin();
     vector< double >::iterator iec;
@@ -203,6 +321,19 @@ void HSolveActive::advanceCalcium()
         }
     }
 
+    for ( unsigned int iaux = 0; iaux < auxCaTarget_.size(); ++iaux )
+    {
+        if ( !auxCaTarget_[ iaux ] )
+            continue;
+
+        unsigned int ic = auxCompt_[ iaux ];
+        double v = VMid_[ ic ];
+        if ( caAdvance_ == 0 )
+            v = 2 * VMid_[ ic ] - V_[ ic ];
+        const CurrentStruct& current = auxCurrent_[ iaux ];
+        *auxCaTarget_[ iaux ] += current.Gk * ( current.Ek - v );
+    }
+
     vector< CaConcStruct >::iterator icaconc;
     vector< double >::iterator icaactivation = caActivation_.begin();
     vector< double >::iterator ica = ca_.begin();
@@ -215,128 +346,149 @@ void HSolveActive::advanceCalcium()
     caActivation_.assign( caActivation_.size(), 0.0 );
 }
 
+/**
+ * Rows are looked up once per compartment and once per calcium pool, and
+ * the gates are then advanced a group at a time, see createGateGroups.
+ */
 void HSolveActive::advanceChannels( double dt )
 {
-    vector< double >::iterator iv;
-    vector< double >::iterator istate = state_.begin();
-    vector< int >::iterator ichannelcount = channelCount_.begin();
-    vector< ChannelStruct >::iterator ichan = channel_.begin();
-    vector< ChannelStruct >::iterator chanBoundary;
-    vector< unsigned int >::iterator icacount = caCount_.begin();
-    vector< double >::iterator ica = ca_.begin();
-    vector< double >::iterator caBoundary;
-    vector< LookupColumn >::iterator icolumn = column_.begin();
-    vector< LookupRow >::iterator icarowcompt;
-    vector< LookupRow* >::iterator icarow = caRow_.begin();
-    vector< double >::iterator iextca = externalCalcium_.begin();
+    for ( unsigned int ic = 0; ic < nCompt_; ++ic )
+        vTable_.row( V_[ ic ], vRow_[ ic ] );
+    for ( unsigned int ica = 0; ica < ca_.size(); ++ica )
+        caTable_.row( ca_[ ica ], caRowPool_[ ica ] );
 
-    LookupRow vRow;
-    LookupRow dRow;
-    double C1 = 0.0, C2 = 0.0;
+    advanceGates( vTable_, vGates_, vRow_, dt );
+    advanceGates( caTable_, caGates_, caRowPool_, dt );
 
-    for ( iv = V_.begin(); iv != V_.end(); ++iv )
+    // Few channels have Z gates without a pool in the solver, so these
+    // are looked up one at a time.
+    LookupRow dRow;
+    LookupColumn column;
+    double C1, C2;
+    for ( unsigned int i = 0; i < extCaGates_.state.size(); ++i )
     {
-        vTable_.row( *iv, vRow );
-        icarowcompt = caRowCompt_.begin();
-        caBoundary = ica + *icacount;
-        for ( ; ica < caBoundary; ++ica )
+        double extCa = externalCalcium_[ extCaIndex_[ i ] ];
+        column.column = extCaGates_.column[ i ];
+        if ( extCa > 0 )
         {
-            caTable_.row( *ica, *icarowcompt );
-
-            ++icarowcompt;
+            caTable_.row( extCa, dRow );
+            caTable_.lookup( column, dRow, C1, C2 );
         }
+        else
+            vTable_.lookup( column, vRow_[ extCaGates_.row[ i ] ], C1, C2 );
 
-        /*
-         * Optimize by moving "if ( instant )" outside the loop, because it is
-         * rarely used. May also be able to avoid "if ( power )".
-         *
-         * Or not: excellent branch predictors these days.
-         *
-         * Will be nice to test these optimizations.
-         */
-        chanBoundary = ichan + *ichannelcount;
-        for ( ; ichan < chanBoundary; ++ichan )
+        double& state = state_[ extCaGates_.state[ i ] ];
+        if ( gateInstant_[ extCaGates_.state[ i ] ] )
+            state = C1 / C2;
+        else
         {
+            double temp = 1.0 + dt / 2.0 * C2;
+            state = ( state * ( 2.0 - temp ) + dt * C1 ) / temp;
+        }
+    }
+}
 
-            caTable_.row( *iextca, dRow );
-
-            if ( ichan->Xpower_ > 0.0 )
-            {
-                vTable_.lookup( *icolumn, vRow, C1, C2 );
-                //~ *istate = *istate * C1 + C2;
-                //~ *istate = ( C1 + ( 2 - C2 ) * *istate ) / C2;
-                if ( ichan->instant_ & INSTANT_X )
-                    *istate = C1 / C2;
-                else
-                {
-                    double temp = 1.0 + dt / 2.0 * C2;
-                    *istate = ( *istate * ( 2.0 - temp ) + dt * C1 ) / temp;
-                }
-
-                ++icolumn, ++istate;
-            }
-
-            if ( ichan->Ypower_ > 0.0 )
-            {
-                vTable_.lookup( *icolumn, vRow, C1, C2 );
-                //~ *istate = *istate * C1 + C2;
-                //~ *istate = ( C1 + ( 2 - C2 ) * *istate ) / C2;
-                if ( ichan->instant_ & INSTANT_Y )
-                    *istate = C1 / C2;
-                else
-                {
-                    double temp = 1.0 + dt / 2.0 * C2;
-                    *istate = ( *istate * ( 2.0 - temp ) + dt * C1 ) / temp;
-
-                }
-                ++icolumn, ++istate;
-            }
-
-            if ( ichan->Zpower_ > 0.0 )
-            {
-                LookupRow* caRow = *icarow;
-
-                if ( caRow )
-                {
-                    caTable_.lookup( *icolumn, *caRow, C1, C2 );
-
-                }
-                else if (*iextca >0)
-                {
-                    caTable_.lookup( *icolumn, dRow, C1, C2 );
-                }
-                else
-                {
-                    vTable_.lookup( *icolumn, vRow, C1, C2 );
+/**
+ * Advances a group of gates with the trapezoidal rule, or sets them to
+ * their steady state if they are instantaneous. Both are computed for
+ * every gate and one of them picked, so that the loop has no branches.
+ */
+void HSolveActive::advanceGates(
+    const LookupTable& table,
+    const GateGroupStruct& gates,
+    const vector< LookupRow >& rows,
+    double dt )
+{
+    unsigned int n = gates.state.size();
+    if ( n == 0 )
+        return;
 
-                }
+    double* C1 = gateC1_.data();
+    double* C2 = gateC2_.data();
+    table.lookup( n, gates.column.data(), gates.row.data(), rows.data(),
+                  C1, C2 );
 
-                //~ *istate = *istate * C1 + C2;
-                //~ *istate = ( C1 + ( 2 - C2 ) * *istate ) / C2;
-                if ( ichan->instant_ & INSTANT_Z )
-                    *istate = C1 / C2;
-                else
-                {
-                    double temp = 1.0 + dt / 2.0 * C2;
-                    *istate = ( *istate * ( 2.0 - temp ) + dt * C1 ) / temp;
-                }
+    double* state = state_.data();
+    const unsigned char* instant = gateInstant_.data();
+    const unsigned int* index = gates.state.data();
+    for ( unsigned int i = 0; i < n; ++i )
+    {
+        double temp = 1.0 + dt / 2.0 * C2[ i ];
+        double next =
+            ( state[ index[ i ] ] * ( 2.0 - temp ) + dt * C1[ i ] ) / temp;
+        double steady = C1[ i ] / C2[ i ];
+        state[ index[ i ] ] = instant[ index[ i ] ] ? steady : next;
+    }
+}
 
-                ++icolumn, ++istate, ++icarow;
+/**
+ * HHChannel2D gates look up their own 2-D tables. The update is the same
+ * as for the HHChannel gates in advanceChannels.
+ */
+void HSolveActive::advanceChannels2D( double dt )
+{
+    if ( state2D_.empty() )
+        return;
 
-            }
-            ++iextca;
+    double A = 0.0, B = 0.0;
+    double* istate = &state2D_[ 0 ];
+    vector< Gate2DStruct >::iterator igate;
+    for ( igate = gate2D_.begin(); igate != gate2D_.end(); ++igate )
+    {
+        igate->gate_->lookupBoth( *igate->dep0_, *igate->dep1_, &A, &B );
+        if ( igate->instant_ )
+            *istate = A / B;
+        else
+        {
+            double temp = 1.0 + dt / 2.0 * B;
+            *istate = ( *istate * ( 2.0 - temp ) + dt * A ) / temp;
         }
+        ++istate;
+    }
 
-        ++ichannelcount, ++icacount;
+    istate = &state2D_[ 0 ];
+    vector< CurrentStruct >::iterator icurrent =
+        auxCurrent_.begin() + synchan_.size();
+    vector< ChannelStruct >::iterator ichan;
+    for ( ichan = channel2D_.begin(); ichan != channel2D_.end(); ++ichan )
+    {
+        ichan->process( istate, *icurrent );
+        ++icurrent;
     }
 }
 
 /**
- * SynChans are currently not under solver's control
+ * Advances the MarkovChannels with their MarkovSolvers' tables, using the
+ * compartment Vm and the ligand concentration last sent to the solver.
+ */
+void HSolveActive::advanceMarkovChannels()
+{
+    unsigned int base = synchan_.size() + channel2D_.size();
+    for ( unsigned int im = 0; im < markov_.size(); ++im )
+    {
+        const MarkovStruct& markov = markov_[ im ];
+        double* state = &markovState_[ markov.state_ ];
+        const double* Gbar = &markovGbar_[ markov.state_ ];
+
+        markov.solver_->advanceState(
+            state, V_[ auxCompt_[ base + im ] ],
+            markov.solver_->getLigandConc() );
+
+        double Gk = 0.0;
+        for ( unsigned int i = 0; i < markov.nOpen_; ++i )
+            Gk += Gbar[ i ] * state[ i ];
+        auxCurrent_[ base + im ].Gk = Gk;
+    }
+}
+
+/**
+ * The activation that the SynChans received during this step, from their
+ * SynHandlers, is turned into conductance as in SynChan::calcGk.
  */
 void HSolveActive::advanceSynChans( ProcPtr info )
 {
-    return;
+    for ( unsigned int isyn = 0; isyn < synchan_.size(); ++isyn )
+        auxCurrent_[ isyn ].Gk = synchan_[ isyn ].process();
 }
 
 void HSolveActive::sendSpikes( ProcPtr info )
@@ -376,6 +528,14 @@ void HSolveActive::sendValues( ProcPtr info )
 
     }
 
+    for ( i = outAuxIk_.begin(); i != outAuxIk_.end(); ++i )
+    {
+        unsigned int comptIndex = auxCompt_[ *i ];
+        ChanBase::IkOut()->send( auxChannelId_[ *i ].eref(),
+                                 ( auxCurrent_[ *i ].Ek - V_[ comptIndex ] ) *
+                                 auxCurrent_[ *i ].Gk );
+    }
+
     for ( i = outCa_.begin(); i != outCa_.end(); ++i )
         //~ CaConc::concOut()->send(
         CaConcBase::concOut()->send(
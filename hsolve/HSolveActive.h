@@ -28,6 +28,8 @@
 
 class HSolveActive: public HSolvePassive
 {
+    friend class HSolveBatch;
+
     typedef vector< CurrentStruct >::iterator currentVecIter;
 
 public:
@@ -37,6 +39,14 @@ public:
     void step( ProcPtr info );			///< Equivalent to process
     void reinit( ProcPtr info );
 
+    /**
+     * Voltages, gate states, calcium and conductances, for checkpoints.
+     * setCheckpoint returns false, and leaves the cell alone, if the
+     * state came from a cell of a different shape.
+     */
+    void getCheckpoint( vector< double >& state ) const;
+    bool setCheckpoint( const vector< double >& state );
+
 protected:
     /**
      * Solver parameters: exposed as fields in MOOSE
@@ -67,6 +77,12 @@ protected:
     double                    caMax_;
     int                       caDiv_;
 
+    /**
+     * floatTables_: Hold the rate tables in single precision, which
+     * halves their memory and cache footprint on large cells.
+     */
+    bool                      floatTables_;
+
     /**
      * Internal data structures. Will also be accessed in derived class HSolve.
      */
@@ -99,12 +115,33 @@ protected:
 		*   channels are loaded into this vector before being used. The vector
 		*   is then reused for the next compartment. This vector therefore has
 		*   a size equal to the maximum number of calcium pools across all
-		*   compartments. This is done in HSolveActive::advanceChannels */
+		*   compartments. This is done in HSolveActive::reinitChannels */
 
     vector< LookupRow* >      caRow_;			/**< Points into caRowCompt.
 		*   For each channel, points to the appropriate pool's LookupRow in the
 		*   caRowCompt vector. This value is then used by the channel. Also
-		*   happens in HSolveActive::advanceChannels */
+		*   happens in HSolveActive::reinitChannels */
+
+    /**
+     * The gates of state_, grouped for HSolveActive::advanceChannels by
+     * what they look up: Vm (vGates_), a calcium pool in the solver
+     * (caGates_), or, for Z gates of channels with no such pool,
+     * externalCalcium_ if it has been set and Vm otherwise
+     * (extCaGates_). Rows are looked up once per step into vRow_, one per
+     * compartment, and caRowPool_, one per pool. extCaIndex_ gives the
+     * externalCalcium_ entry of each extCaGates_ gate, and gateInstant_
+     * is nonzero for each state_ entry whose gate is instantaneous.
+     */
+    GateGroupStruct           vGates_;
+    GateGroupStruct           caGates_;
+    GateGroupStruct           extCaGates_;
+    vector< unsigned int >    extCaIndex_;
+    vector< unsigned char >   gateInstant_;
+    vector< LookupRow >       vRow_;
+    vector< LookupRow >       caRowPool_;
+    vector< double >          gateC1_;			///< Rates looked up for a
+    vector< double >          gateC2_;			///< group of gates.
+
 
     vector< int >             channelCount_;	///< Number of channels in each
     ///< compartment
@@ -135,16 +172,77 @@ protected:
 		*   those compartments. */
      vector< unsigned int >    outIk_;
 
+    /**
+     * Channels other than HHChannels, which are integrated by the solver
+     * with their own state: SynChans, then HHChannel2Ds, then
+     * MarkovChannels. They share the following per-channel vectors, in
+     * that order.
+     */
+    vector< Id >              auxChannelId_;	///< Used for localIndex-ing.
+    vector< CurrentStruct >   auxCurrent_;		///< Gk and Ek
+    vector< unsigned int >    auxCompt_;		///< Compartment index
+    vector< double* >         auxCaTarget_;		///< As caTarget_, for the
+    ///< aux channels.
+    vector< unsigned int >    outAuxIk_;		///< Aux channels with IkOut
+    ///< targets outside the solver.
+
+    /**
+     * HHChannel2Ds. The gates of channel k are gate2D_ entries for its
+     * nonzero powers, starting at chan2state2D_[ k ], with their values
+     * at the same index in state2D_. The two concentrations a channel
+     * receives by message are stored in conc2D_, unless they come from a
+     * calcium pool in the solver, in which case conc2DSource_ points
+     * at that pool.
+     */
+    vector< ChannelStruct >   channel2D_;
+    vector< double >          state2D_;
+    vector< Gate2DStruct >    gate2D_;
+    vector< unsigned int >    chan2state2D_;
+    vector< int >             gate2DDep_;		///< 2 per gate: 0 for Vm, 1
+    ///< and 2 for the concs, -1 if unused. See HHChannel2D::dependency.
+    vector< double >          conc2D_;			///< 2 per channel
+    vector< const double* >   conc2DSource_;	///< 2 per channel
+
+    /**
+     * MarkovChannels. Channel k owns nStates_ entries of markovState_
+     * starting at markov_[ k ].state_. markovGbar_ is laid out the same
+     * way, and is zero beyond the open states.
+     */
+    vector< MarkovStruct >    markov_;
+    vector< double >          markovState_;
+    vector< double >          markovGbar_;
+    vector< double >          markovInitState_;
+    vector< Id >              markovSolverId_;
+
+    /// Class of each HHChannel before it was zombified.
+    vector< const Cinfo* >    channelClass_;
+
+    /**
+     * Set when the state or parameters are changed from outside, through
+     * the zombies or reinit. Tells an HSolveBatch that holds this cell to
+     * read it in again before the next step.
+     */
+    bool                      modified_;
+
+    /// Updates gateInstant_ after the instant_ field of a channel changes.
+    void setGateInstant( unsigned int channel );
+
 private:
     /**
      * Setting up of data structures: Defined in HSolveActiveSetup.cpp
      */
     void readHHChannels();
+    void readAuxChannels();
+    void readSynChans( unsigned int ic );
+    void readHHChannels2D( unsigned int ic );
+    void readMarkovChannels( unsigned int ic );
     void readGates();
     void readCalcium();
+    void readCaConc( Id caConc, unsigned int ic, map< Id, int >& caConcIndex );
     void readSynapses();
     void readExternalChannels();
     void createLookupTables();
+    void createGateGroups();
     void manageOutgoingMessages();
 
     void cleanup();
@@ -166,6 +264,13 @@ private:
     void backwardSubstitute();
     void advanceCalcium();
     void advanceChannels( double dt );
+    void advanceGates(
+        const LookupTable& table,
+        const GateGroupStruct& gates,
+        const vector< LookupRow >& rows,
+        double dt );
+    void advanceChannels2D( double dt );
+    void advanceMarkovChannels();
     void advanceSynChans( ProcPtr info );
     void sendSpikes( ProcPtr info );
     void sendValues( ProcPtr info );
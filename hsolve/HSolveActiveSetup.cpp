@@ -9,6 +9,17 @@
 
 
 #include "HSolveActive.h"
+#include "../biophysics/SynChan.h"
+#include "../biophysics/HHChannel2D.h"
+#include "../builtins/Interpol2D.h"
+#include "../biophysics/HHGate2D.h"
+#include "../biophysics/MatrixOps.h"
+#include "../biophysics/VectorTable.h"
+#include "../biophysics/MarkovRateTable.h"
+#include "../biophysics/MarkovSolverBase.h"
+
+/// Value looked up by a 2D gate along a dimension it does not use.
+static const double noDependency = 0.0;
 
 //////////////////////////////////////////////////////////////////////
 // Setup of data structures
@@ -21,10 +32,12 @@ void HSolveActive::setup( Id seed, double dt )
     this->HSolvePassive::setup( seed, dt );
 
     readHHChannels();
+    readAuxChannels(); // SynChans, HHChannel2Ds and MarkovChannels.
     readGates();
     readCalcium();
     createLookupTables();
-    readSynapses(); // Reads SynChans, SpikeGens. Drops process msg for SpikeGens.
+    createGateGroups();
+    readSynapses(); // Reads SpikeGens. Drops their process msg.
     readExternalChannels();
     manageOutgoingMessages(); // Manages messages going out from the cell's components.
 
@@ -49,6 +62,7 @@ void HSolveActive::reinit( ProcPtr info )
     reinitCalcium();
     reinitChannels();
     sendValues( info );
+    modified_ = true;
 }
 
 void HSolveActive::reinitSpikeGens( ProcPtr info )
@@ -157,6 +171,43 @@ void HSolveActive::reinitChannels()
 
         ++ichannelcount, ++icacount;
     }
+
+    // Channels other than HHChannels.
+    double A, B;
+    vector< Gate2DStruct >::iterator igate;
+    vector< double >::iterator istate2D = state2D_.begin();
+    for ( igate = gate2D_.begin(); igate != gate2D_.end(); ++igate )
+    {
+        igate->gate_->lookupBoth( *igate->dep0_, *igate->dep1_, &A, &B );
+        *istate2D = A / B;
+        ++istate2D;
+    }
+
+    markovState_ = markovInitState_;
+
+    vector< SynChanStruct >::iterator isyn;
+    for ( isyn = synchan_.begin(); isyn != synchan_.end(); ++isyn )
+    {
+        isyn->X_ = 0.0;
+        isyn->Y_ = 0.0;
+        isyn->activation_ = 0.0;
+        isyn->setConstants( dt_ );
+    }
+
+    for ( unsigned int i = 0; i < auxCurrent_.size(); ++i )
+        auxCurrent_[ i ].Gk = 0.0;
+
+    if ( !state2D_.empty() )
+    {
+        double* istate = &state2D_[ 0 ];
+        vector< CurrentStruct >::iterator icurrent =
+            auxCurrent_.begin() + synchan_.size();
+        for ( ichan = channel2D_.begin(); ichan != channel2D_.end(); ++ichan )
+        {
+            ichan->process( istate, *icurrent );
+            ++icurrent;
+        }
+    }
 }
 
 void HSolveActive::readHHChannels()
@@ -194,6 +245,7 @@ void HSolveActive::readHHChannels()
             Ypower    = Field< double >::get( *ichan, "Ypower" );
             Zpower    = Field< double >::get( *ichan, "Zpower" );
             instant    = Field< int >::get( *ichan, "instant" );
+            channelClass_.push_back( ichan->element()->cinfo() );
             double modulation = Field< double >::get( *ichan, "modulation");
 
             current.Ek = Ek;
@@ -234,6 +286,206 @@ void HSolveActive::readHHChannels()
     }
 }
 
+/**
+ * Reads in the channels other than HHChannels that the solver integrates
+ * itself: SynChans, HHChannel2Ds and MarkovChannels, in that order.
+ */
+void HSolveActive::readAuxChannels()
+{
+    for ( unsigned int ic = 0; ic < nCompt_; ++ic )
+        readSynChans( ic );
+    for ( unsigned int ic = 0; ic < nCompt_; ++ic )
+        readHHChannels2D( ic );
+    for ( unsigned int ic = 0; ic < nCompt_; ++ic )
+        readMarkovChannels( ic );
+}
+
+void HSolveActive::readSynChans( unsigned int ic )
+{
+    vector< Id > synId;
+    vector< Id >::iterator isyn;
+
+    HSolveUtils::synchans( compartmentId_[ ic ], synId );
+    for ( isyn = synId.begin(); isyn != synId.end(); ++isyn )
+    {
+        SynChanStruct synchan;
+        synchan.compt_ = ic;
+        synchan.elm_ = *isyn;
+        synchan.Gbar_ = Field< double >::get( *isyn, "Gbar" );
+        synchan.tau1_ = Field< double >::get( *isyn, "tau1" );
+        synchan.tau2_ = Field< double >::get( *isyn, "tau2" );
+        synchan.modulation_ = Field< double >::get( *isyn, "modulation" );
+        synchan.setConstants( dt_ );
+        synchan_.push_back( synchan );
+
+        CurrentStruct current;
+        current.Gk = Field< double >::get( *isyn, "Gk" );
+        current.Ek = Field< double >::get( *isyn, "Ek" );
+        auxCurrent_.push_back( current );
+        auxCompt_.push_back( ic );
+        auxChannelId_.push_back( *isyn );
+    }
+}
+
+/**
+ * HHChannel2D gates look up 2-D tables, which do not fit in the solver's
+ * 1-D lookup tables, so they are kept as they are and looked up through
+ * the gate. Which inputs each gate uses is resolved in readCalcium, once
+ * the calcium pools are known.
+ */
+void HSolveActive::readHHChannels2D( unsigned int ic )
+{
+    vector< Id > chanId;
+    vector< Id >::iterator ichan;
+
+    HSolveUtils::hhchannels2D( compartmentId_[ ic ], chanId );
+    for ( ichan = chanId.begin(); ichan != chanId.end(); ++ichan )
+    {
+        Eref er = ichan->eref();
+        HHChannel2D* chan = reinterpret_cast< HHChannel2D* >( er.data() );
+
+        const HHGate2D* gate[] =
+            { chan->getXgate( 0 ), chan->getYgate( 0 ), chan->getZgate( 0 ) };
+        double power[] =
+            { chan->getXpower( er ), chan->getYpower( er ), chan->getZpower( er ) };
+        double value[] = { chan->getX( er ), chan->getY( er ), chan->getZ( er ) };
+        string index[] =
+            { chan->getXindex(), chan->getYindex(), chan->getZindex() };
+        int instant = chan->getInstant( er );
+
+        bool complete = true;
+        for ( unsigned int i = 0; i < 3; ++i )
+            if ( power[ i ] > 0.0 && !gate[ i ] )
+                complete = false;
+        if ( !complete )
+        {
+            cerr << "Warning: HSolve: HHChannel2D '" << ichan->path()
+                 << "' has a gate with nonzero power but no table. "
+                 "Leaving it outside the solver.\n";
+            continue;
+        }
+
+        ChannelStruct channel;
+        channel.Gbar_ = Field< double >::get( *ichan, "Gbar" );
+        channel.setPowers( power[ 0 ], power[ 1 ], power[ 2 ] );
+        channel.instant_ = instant;
+        channel.modulation_ = Field< double >::get( *ichan, "modulation" );
+        channel2D_.push_back( channel );
+        chan2state2D_.push_back( state2D_.size() );
+
+        for ( unsigned int i = 0; i < 3; ++i )
+        {
+            if ( power[ i ] <= 0.0 )
+                continue;
+            Gate2DStruct g;
+            g.gate_ = gate[ i ];
+            g.dep0_ = 0;
+            g.dep1_ = 0;
+            g.instant_ = ( instant & ( 1 << i ) ) != 0;
+            gate2D_.push_back( g );
+            gate2DDep_.push_back( HHChannel2D::dependency( index[ i ], 0 ) );
+            gate2DDep_.push_back( HHChannel2D::dependency( index[ i ], 1 ) );
+            state2D_.push_back( value[ i ] );
+        }
+
+        conc2D_.push_back( 0.0 );
+        conc2D_.push_back( 0.0 );
+
+        CurrentStruct current;
+        current.Gk = Field< double >::get( *ichan, "Gk" );
+        current.Ek = Field< double >::get( *ichan, "Ek" );
+        auxCurrent_.push_back( current );
+        auxCompt_.push_back( ic );
+        auxChannelId_.push_back( *ichan );
+    }
+}
+
+/**
+ * A MarkovChannel receives its state from a MarkovSolver, which holds the
+ * exponentials of the rate matrix for its time step. The solver keeps
+ * using these tables to advance the channel's state, and the process
+ * message of the MarkovSolver is dropped, as for SpikeGens.
+ */
+void HSolveActive::readMarkovChannels( unsigned int ic )
+{
+    vector< Id > chanId;
+    vector< Id >::iterator ichan;
+
+    HSolveUtils::markovchannels( compartmentId_[ ic ], chanId );
+    for ( ichan = chanId.begin(); ichan != chanId.end(); ++ichan )
+    {
+        vector< Id > solverId;
+        HSolveUtils::targets( *ichan, "handleState", solverId );
+        if ( solverId.size() != 1 ||
+                !solverId[ 0 ].element()->cinfo()->isA( "MarkovSolverBase" ) )
+        {
+            cerr << "Warning: HSolve: MarkovChannel '" << ichan->path()
+                 << "' does not get its state from a single MarkovSolver. "
+                 "Leaving it outside the solver.\n";
+            continue;
+        }
+
+        const MarkovSolverBase* solver =
+            reinterpret_cast< const MarkovSolverBase* >(
+                solverId[ 0 ].eref().data() );
+        unsigned int nStates = Field< unsigned int >::get( *ichan, "numStates" );
+        if ( solver->getSize() != nStates || !doubleEq( solver->getDt(), dt_ ) )
+        {
+            cerr << "Warning: HSolve: MarkovSolver '" << solverId[ 0 ].path()
+                 << "' is not initialized for " << nStates
+                 << " states and dt = " << dt_
+                 << ". Leaving MarkovChannel '" << ichan->path()
+                 << "' outside the solver.\n";
+            continue;
+        }
+
+        MarkovStruct markov;
+        markov.solver_ = solver;
+        markov.state_ = markovState_.size();
+        markov.nStates_ = nStates;
+        markov.nOpen_ =
+            Field< unsigned int >::get( *ichan, "numOpenStates" );
+        markov_.push_back( markov );
+
+        vector< double > state =
+            Field< vector< double > >::get( *ichan, "state" );
+        vector< double > initState =
+            Field< vector< double > >::get( *ichan, "initialState" );
+        vector< double > Gbar = Field< vector< double > >::get( *ichan, "gbar" );
+        if ( state.size() != nStates )
+            state = initState;
+        state.resize( nStates, 0.0 );
+        initState.resize( nStates, 0.0 );
+        Gbar.resize( markov.nOpen_, 0.0 );
+        Gbar.resize( nStates, 0.0 );
+        markovState_.insert( markovState_.end(), state.begin(), state.end() );
+        markovInitState_.insert( markovInitState_.end(),
+                                 initState.begin(), initState.end() );
+        markovGbar_.insert( markovGbar_.end(), Gbar.begin(), Gbar.end() );
+
+        if ( find( markovSolverId_.begin(), markovSolverId_.end(),
+                   solverId[ 0 ] ) == markovSolverId_.end() )
+        {
+            markovSolverId_.push_back( solverId[ 0 ] );
+
+            Element* elm = solverId[ 0 ].element();
+            const DestFinfo* df = dynamic_cast< const DestFinfo* >(
+                                      elm->cinfo()->findFinfo( "process" ) );
+            assert( df );
+            ObjId mid = elm->findCaller( df->getFid() );
+            if ( ! mid.bad() )
+                Msg::deleteMsg( mid );
+        }
+
+        CurrentStruct current;
+        current.Gk = Field< double >::get( *ichan, "Gk" );
+        current.Ek = Field< double >::get( *ichan, "Ek" );
+        auxCurrent_.push_back( current );
+        auxCompt_.push_back( ic );
+        auxChannelId_.push_back( *ichan );
+    }
+}
+
 void HSolveActive::readGates()
 {
     vector< Id >::iterator ichan;
@@ -249,9 +501,35 @@ void HSolveActive::readGates()
     }
 }
 
+void HSolveActive::readCaConc( Id caConc, unsigned int ic,
+                               map< Id, int >& caConcIndex )
+{
+    if ( caConcIndex.find( caConc ) != caConcIndex.end() )
+        return;
+
+    caConcIndex[ caConc ] = caCount_[ ic ];
+    ++caCount_[ ic ];
+
+    double Ca = Field< double >::get( caConc, "Ca" );
+    double CaBasal = Field< double >::get( caConc, "CaBasal" );
+    double tau = Field< double >::get( caConc, "tau" );
+    double B = Field< double >::get( caConc, "B" );
+    double ceiling = Field< double >::get( caConc, "ceiling" );
+    double floor = Field< double >::get( caConc, "floor" );
+
+    caConc_.push_back(
+        CaConcStruct(
+            Ca, CaBasal,
+            tau, B,
+            ceiling, floor,
+            dt_
+        )
+    );
+    caConcId_.push_back( caConc );
+}
+
 void HSolveActive::readCalcium()
 {
-    double Ca, CaBasal, tau, B, ceiling, floor;
     vector< Id > caConcId;
     vector< int > caTargetIndex;
     map< Id, int > caConcIndex;
@@ -287,28 +565,7 @@ void HSolveActive::readCalcium()
 	    externalCalcium_.push_back(0);
 
             for ( iconc = caConcId.begin(); iconc != caConcId.end(); ++iconc )
-                if ( caConcIndex.find( *iconc ) == caConcIndex.end() )
-                {
-                    caConcIndex[ *iconc ] = caCount_[ ic ];
-                    ++caCount_[ ic ];
-
-                    Ca = Field< double >::get( *iconc, "Ca" );
-                    CaBasal = Field< double >::get( *iconc, "CaBasal" );
-                    tau = Field< double >::get( *iconc, "tau" );
-                    B = Field< double >::get( *iconc, "B" );
-                    ceiling = Field< double >::get( *iconc, "ceiling" );
-                    floor = Field< double >::get( *iconc, "floor" );
-
-                    caConc_.push_back(
-                        CaConcStruct(
-                            Ca, CaBasal,
-                            tau, B,
-                            ceiling, floor,
-                            dt_
-                        )
-                    );
-                    caConcId_.push_back( *iconc );
-                }
+                readCaConc( *iconc, ic, caConcIndex );
 
             if ( nTarget != 0 )
                 caTargetIndex.push_back( caConcIndex[ caConcId.front() ] + nCa );
@@ -317,6 +574,22 @@ void HSolveActive::readCalcium()
 
 
         }
+
+        // Pools fed by the other channels, and those that HHChannel2Ds
+        // look up.
+        for ( unsigned int iaux = 0; iaux < auxChannelId_.size(); ++iaux )
+        {
+            if ( auxCompt_[ iaux ] != ic )
+                continue;
+            caConcId.clear();
+            HSolveUtils::caTarget( auxChannelId_[ iaux ], caConcId );
+            HSolveUtils::targets( auxChannelId_[ iaux ], "concen",
+                                  caConcId, "CaConc" );
+            HSolveUtils::targets( auxChannelId_[ iaux ], "concen2",
+                                  caConcId, "CaConc" );
+            for ( iconc = caConcId.begin(); iconc != caConcId.end(); ++iconc )
+                readCaConc( *iconc, ic, caConcIndex );
+        }
     }
 
 
@@ -333,7 +606,59 @@ void HSolveActive::readCalcium()
             caTarget_[ ichan ] = &caActivation_[ caTargetIndex[ ichan ] ];
     }
 
+    /*
+     * Now that the pools are in place, point the other channels at the
+     * pools they feed, and the HHChannel2D gates at their inputs.
+     */
+    map< Id, unsigned int > caGlobalIndex;
+    for ( unsigned int ica = 0; ica < caConcId_.size(); ++ica )
+        caGlobalIndex[ caConcId_[ ica ] ] = ica;
 
+    auxCaTarget_.assign( auxChannelId_.size(), 0 );
+    for ( unsigned int iaux = 0; iaux < auxChannelId_.size(); ++iaux )
+    {
+        caConcId.clear();
+        if ( HSolveUtils::caTarget( auxChannelId_[ iaux ], caConcId ) )
+            auxCaTarget_[ iaux ] =
+                &caActivation_[ caGlobalIndex[ caConcId.front() ] ];
+    }
+
+    static const string concMsg[] = { "concen", "concen2" };
+    conc2DSource_.resize( conc2D_.size() );
+    for ( unsigned int k = 0; k < channel2D_.size(); ++k )
+    {
+        Id chan = auxChannelId_[ synchan_.size() + k ];
+        for ( unsigned int j = 0; j < 2; ++j )
+        {
+            caConcId.clear();
+            if ( HSolveUtils::targets( chan, concMsg[ j ], caConcId, "CaConc" ) )
+                conc2DSource_[ 2 * k + j ] =
+                    &ca_[ caGlobalIndex[ caConcId.front() ] ];
+            else
+                conc2DSource_[ 2 * k + j ] = &conc2D_[ 2 * k + j ];
+        }
+
+        unsigned int ic = auxCompt_[ synchan_.size() + k ];
+        unsigned int igate = chan2state2D_[ k ];
+        unsigned int gateEnd = ( k + 1 < channel2D_.size() ) ?
+                               chan2state2D_[ k + 1 ] : gate2D_.size();
+        for ( ; igate < gateEnd; ++igate )
+        {
+            const double* dep[ 2 ];
+            for ( unsigned int j = 0; j < 2; ++j )
+            {
+                int d = gate2DDep_[ 2 * igate + j ];
+                if ( d == 0 )
+                    dep[ j ] = &V_[ ic ];
+                else if ( d == 1 || d == 2 )
+                    dep[ j ] = conc2DSource_[ 2 * k + d - 1 ];
+                else
+                    dep[ j ] = &noDependency;
+            }
+            gate2D_[ igate ].dep0_ = dep[ 0 ];
+            gate2D_[ igate ].dep1_ = dep[ 1 ];
+        }
+    }
 }
 
 void HSolveActive::createLookupTables()
@@ -363,21 +688,44 @@ void HSolveActive::createLookupTables()
      * tables.
      *
      * # of divs is determined by finding the smallest dx (highest density).
+     *
+     * Formula gates (HHGateF) have no table, and are tabulated on the grid
+     * that the table gates give. If there are only formula gates, the
+     * vMin, vMax, vDiv (or caMin, caMax, caDiv) fields are used as set.
      */
-    vMin_ = numeric_limits< double >::max();
-    vMax_ = numeric_limits< double >::min();
-    double vDx = numeric_limits< double >::max();
-    caMin_ = numeric_limits< double >::max();
-    caMax_ = numeric_limits< double >::min();
-    double caDx = numeric_limits< double >::max();
+    bool caTabulated = false;
+    bool vTabulated = false;
+    for ( unsigned int ig = 0; ig < caGate.size(); ++ig )
+        if ( !caGate[ ig ].element()->cinfo()->isA( "HHGateF" ) )
+            caTabulated = true;
+    for ( unsigned int ig = 0; ig < vGate.size(); ++ig )
+        if ( !vGate[ ig ].element()->cinfo()->isA( "HHGateF" ) )
+            vTabulated = true;
 
     double min;
     double max;
     unsigned int divs;
     double dx;
 
+    double vDx = ( vMax_ - vMin_ ) / vDiv_;
+    double caDx = ( caMax_ - caMin_ ) / caDiv_;
+    if ( vTabulated || vGate.empty() )
+    {
+        vMin_ = numeric_limits< double >::max();
+        vMax_ = numeric_limits< double >::min();
+        vDx = numeric_limits< double >::max();
+    }
+    if ( caTabulated || caGate.empty() )
+    {
+        caMin_ = numeric_limits< double >::max();
+        caMax_ = numeric_limits< double >::min();
+        caDx = numeric_limits< double >::max();
+    }
+
     for ( unsigned int ig = 0; ig < caGate.size(); ++ig )
     {
+        if ( caGate[ ig ].element()->cinfo()->isA( "HHGateF" ) )
+            continue;
         min = Field< double >::get( caGate[ ig ], "min" );
         max = Field< double >::get( caGate[ ig ], "max" );
         divs = Field< unsigned int >::get( caGate[ ig ], "divs" );
@@ -395,6 +743,8 @@ void HSolveActive::createLookupTables()
 
     for ( unsigned int ig = 0; ig < vGate.size(); ++ig )
     {
+        if ( vGate[ ig ].element()->cinfo()->isA( "HHGateF" ) )
+            continue;
         min = Field< double >::get( vGate[ ig ], "min" );
         max = Field< double >::get( vGate[ ig ], "max" );
         divs = Field< unsigned int >::get( vGate[ ig ], "divs" );
@@ -522,38 +872,99 @@ void HSolveActive::createLookupTables()
         }
     }
 
+    caTable_.setSinglePrecision( floatTables_ );
+    vTable_.setSinglePrecision( floatTables_ );
+}
+
+/**
+ * Sorts the gates into the groups that advanceChannels updates, in the
+ * order of their states.
+ */
+void HSolveActive::createGateGroups()
+{
+    vGates_ = GateGroupStruct();
+    caGates_ = GateGroupStruct();
+    extCaGates_ = GateGroupStruct();
+    extCaIndex_.clear();
+
+    unsigned int istate = 0;
+    unsigned int ichan = 0;
+    unsigned int caBase = 0;
+    for ( unsigned int ic = 0; ic < nCompt_; ++ic )
+    {
+        unsigned int chanBoundary = ichan + channelCount_[ ic ];
+        for ( ; ichan < chanBoundary; ++ichan )
+        {
+            const ChannelStruct& chan = channel_[ ichan ];
+            const double power[] = { chan.Xpower_, chan.Ypower_ };
+            for ( double p : power )
+                if ( p > 0.0 )
+                {
+                    vGates_.state.push_back( istate );
+                    vGates_.column.push_back( column_[ istate ].column );
+                    vGates_.row.push_back( ic );
+                    ++istate;
+                }
+
+            if ( chan.Zpower_ > 0.0 )
+            {
+                int index = caDependIndex_[ ichan ];
+                GateGroupStruct& gates =
+                    index == -1 ? extCaGates_ : caGates_;
+                gates.state.push_back( istate );
+                gates.column.push_back( column_[ istate ].column );
+                if ( index == -1 )
+                {
+                    gates.row.push_back( ic );
+                    extCaIndex_.push_back( ichan );
+                }
+                else
+                    gates.row.push_back( caBase + index );
+                ++istate;
+            }
+        }
+        caBase += caCount_[ ic ];
+    }
+    assert( istate == state_.size() );
+
+    gateInstant_.assign( state_.size(), 0 );
+    for ( unsigned int i = 0; i < channel_.size(); ++i )
+        setGateInstant( i );
 
+    vRow_.resize( nCompt_ );
+    caRowPool_.resize( ca_.size() );
+    unsigned int n = max( vGates_.state.size(), caGates_.state.size() );
+    gateC1_.resize( n );
+    gateC2_.resize( n );
+}
+
+void HSolveActive::setGateInstant( unsigned int channel )
+{
+    const ChannelStruct& chan = channel_[ channel ];
+    unsigned int istate = chan2state_[ channel ];
+    if ( chan.Xpower_ > 0.0 )
+        gateInstant_[ istate++ ] = ( chan.instant_ & INSTANT_X ) != 0;
+    if ( chan.Ypower_ > 0.0 )
+        gateInstant_[ istate++ ] = ( chan.instant_ & INSTANT_Y ) != 0;
+    if ( chan.Zpower_ > 0.0 )
+        gateInstant_[ istate ] = ( chan.instant_ & INSTANT_Z ) != 0;
 }
 
 /**
- * Reads in SynChans and SpikeGens.
+ * Reads in SpikeGens. (SynChans are read in readAuxChannels.)
  *
-* Unlike Compartments, HHChannels, etc., neither of these are zombified.
- * In other words, their fields are not managed by HSolve, and their "process"
- * functions are invoked to do their calculations. For SynChans, the process
- * calls are made by their respective clocks, and hence the process message is
- * not dropped. On the other hand, we drop the SpikeGen process messages here,
- * and explicitly call the SpikeGen process() from the HSolve via a pointer.
+ * SpikeGens are not zombified. In other words, their fields are not managed
+ * by HSolve, and their "process" functions are invoked to do their
+ * calculations. We drop the SpikeGen process messages here, and explicitly
+ * call the SpikeGen process() from the HSolve via a pointer.
  */
 void HSolveActive::readSynapses()
 {
     vector< Id > spikeId;
-    vector< Id > synId;
-    vector< Id >::iterator syn;
     vector< Id >::iterator spike;
-    SynChanStruct synchan;
 
     for ( unsigned int ic = 0; ic < nCompt_; ++ic )
     {
-        synId.clear();
-        HSolveUtils::synchans( compartmentId_[ ic ], synId );
-        for ( syn = synId.begin(); syn != synId.end(); ++syn )
-        {
-            synchan.compt_ = ic;
-            synchan.elm_ = *syn;
-            synchan_.push_back( synchan );
-        }
-
         static const Finfo* procDest = SpikeGen::initCinfo()->findFinfo( "process");
         assert( procDest );
         const DestFinfo* df = dynamic_cast< const DestFinfo* >( procDest );
@@ -610,18 +1021,29 @@ void HSolveActive::manageOutgoingMessages()
      * the original objects.
      */
     filter.push_back( "HHChannel" );
+    filter.push_back( "HHChannelF" );
     filter.push_back( "SpikeGen" );
     for ( unsigned int ic = 0; ic < compartmentId_.size(); ++ic )
     {
         targets.clear();
 
-        int nTargets = HSolveUtils::targets(
-                           compartmentId_[ ic ],
-                           "VmOut",
-                           targets,
-                           filter,
-                           false    // include = false. That is, use filter to exclude.
-                       );
+        HSolveUtils::targets(
+            compartmentId_[ ic ],
+            "VmOut",
+            targets,
+            filter,
+            false    // include = false. That is, use filter to exclude.
+        );
+
+        // The other channels are excluded only if the solver took them in,
+        // and so are the MarkovSolvers, whose process is dropped.
+        unsigned int nTargets = 0;
+        for ( unsigned int i = 0; i < targets.size(); ++i )
+            if ( find( auxChannelId_.begin(), auxChannelId_.end(),
+                       targets[ i ] ) == auxChannelId_.end() &&
+                    find( markovSolverId_.begin(), markovSolverId_.end(),
+                          targets[ i ] ) == markovSolverId_.end() )
+                ++nTargets;
 
         if ( nTargets )
             outVm_.push_back( ic );
@@ -633,17 +1055,24 @@ void HSolveActive::manageOutgoingMessages()
      */
     filter.clear();
     filter.push_back( "HHChannel" );
+    filter.push_back( "HHChannelF" );
     for ( unsigned int ica = 0; ica < caConcId_.size(); ++ica )
     {
         targets.clear();
 
-        int nTargets = HSolveUtils::targets(
-                           caConcId_[ ica ],
-                           "concOut",
-                           targets,
-                           filter,
-                           false    // include = false. That is, use filter to exclude.
-                       );
+        HSolveUtils::targets(
+            caConcId_[ ica ],
+            "concOut",
+            targets,
+            filter,
+            false    // include = false. That is, use filter to exclude.
+        );
+
+        unsigned int nTargets = 0;
+        for ( unsigned int i = 0; i < targets.size(); ++i )
+            if ( find( auxChannelId_.begin(), auxChannelId_.end(),
+                       targets[ i ] ) == auxChannelId_.end() )
+                ++nTargets;
 
         if ( nTargets )
             outCa_.push_back( ica );
@@ -666,12 +1095,23 @@ void HSolveActive::manageOutgoingMessages()
 
         if ( nTargets )
             outIk_.push_back( ik );
-
-
     }
 
+    for ( unsigned int ik = 0; ik < auxChannelId_.size(); ++ik )
+    {
+        targets.clear();
 
+        int nTargets = HSolveUtils::targets(
+                           auxChannelId_[ ik ],
+                           "IkOut",
+                           targets,
+                           filter,
+                           false    // include = false. That is, use filter to exclude.
+                       );
 
+        if ( nTargets )
+            outAuxIk_.push_back( ik );
+    }
 }
 
 void HSolveActive::cleanup()
@@ -0,0 +1,729 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2026 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include <cmath>
+#include <cstring>
+#include "HSolveActive.h"
+#include "HSolveBatch.h"
+#include "../utility/ThreadPool.h"
+
+/// Scratch space for the cells advanced on one thread.
+struct HSolveBatchWork
+{
+    vector< LookupRow > vRow;
+    vector< LookupRow > caRow;
+    vector< double > GkSum;
+    vector< double > GkEkSum;
+};
+
+static thread_local HSolveBatchWork work_;
+
+HSolveBatch::HSolveBatch( const vector< HSolveActive* >& cells,
+                          unsigned int numThreads )
+    :
+    cells_( cells ),
+    n_( cells.size() ),
+    numThreads_( numThreads )
+{
+    assert( n_ > 0 );
+    const HSolveActive& first = *cells_[ 0 ];
+
+    nCompt_ = first.nCompt_;
+    caAdvance_ = first.caAdvance_;
+    junction_ = first.junction_;
+    channelCount_ = first.channelCount_;
+    caCount_ = first.caCount_;
+    column_ = first.column_;
+    maxCaCount_ = first.caRowCompt_.size();
+    vTable_ = &first.vTable_;
+    caTable_ = &first.caTable_;
+
+    for ( const ChannelStruct& chan : first.channel_ )
+    {
+        Xpower_.push_back( chan.Xpower_ );
+        Ypower_.push_back( chan.Ypower_ );
+        Zpower_.push_back( chan.Zpower_ );
+        instant_.push_back( chan.instant_ );
+    }
+    for ( const LookupRow* row : first.caRow_ )
+        caRow_.push_back( row ? row - first.caRowCompt_.data() : -1 );
+    for ( const double* target : first.caTarget_ )
+        caTarget_.push_back(
+            target ? target - first.caActivation_.data() : -1 );
+
+    unsigned int nChan = first.channel_.size();
+    unsigned int nCa = first.caConc_.size();
+    V_.resize( nCompt_ * n_ );
+    VMid_.resize( nCompt_ * n_ );
+    HS_.resize( 4 * nCompt_ * n_ );
+    HJ_.resize( first.HJ_.size() * n_ );
+    HJCopy_.resize( first.HJCopy_.size() * n_ );
+    CmByDt_.resize( nCompt_ * n_ );
+    EmByRm_.resize( nCompt_ * n_ );
+    inject_.resize( nCompt_ * n_ );
+    externalCurrent_.resize( 2 * nCompt_ * n_ );
+    Gbar_.resize( nChan * n_ );
+    modulation_.resize( nChan * n_ );
+    Gk_.resize( nChan * n_ );
+    Ek_.resize( nChan * n_ );
+    state_.resize( first.state_.size() * n_ );
+    externalCalcium_.resize( first.externalCalcium_.size() * n_ );
+    ca_.resize( nCa * n_ );
+    caActivation_.resize( nCa * n_ );
+    caConc_.resize( nCa * n_ );
+
+    // The operands point into the arrays of the first cell. Since the
+    // batch arrays are not resized after this, they can hold plain
+    // pointers too.
+    for ( HSolveActive::vdIterator i : first.operand_ )
+        operand_.push_back( batchAddress( &*i ) );
+    for ( HSolveActive::vdIterator i : first.backOperand_ )
+        backOperand_.push_back( batchAddress( &*i ) );
+
+    if ( numThreads_ > n_ )
+        numThreads_ = n_;
+    if ( numThreads_ < 1 )
+        numThreads_ = 1;
+    grainSize_ = moose::ThreadPool::grainSize( n_, numThreads_ );
+    if ( numThreads_ > 1 )
+        moose::ThreadPool::global().reserve( numThreads_ );
+}
+
+double* HSolveBatch::batchAddress( const double* p )
+{
+    const HSolveActive& first = *cells_[ 0 ];
+    const double* hs = first.HS_.data();
+    const double* hj = first.HJ_.data();
+    const double* vmid = first.VMid_.data();
+
+    if ( p >= hs && p < hs + first.HS_.size() )
+        return HS_.data() + ( p - hs ) * n_;
+    if ( p >= hj && p < hj + first.HJ_.size() )
+        return HJ_.data() + ( p - hj ) * n_;
+    assert( p >= vmid && p < vmid + first.VMid_.size() );
+    return VMid_.data() + ( p - vmid ) * n_;
+}
+
+bool HSolveBatch::sameStructure( const HSolveActive& a,
+                                 const HSolveActive& b )
+{
+    if ( a.nCompt_ == 0 || a.nCompt_ != b.nCompt_ )
+        return false;
+    if ( a.dt_ != b.dt_ || a.caAdvance_ != b.caAdvance_ )
+        return false;
+    // SynChans, HHChannel2Ds and MarkovChannels are integrated per cell.
+    if ( !a.auxChannelId_.empty() || !b.auxChannelId_.empty() )
+        return false;
+    for ( unsigned int ic = 0; ic < a.nCompt_; ++ic )
+        if ( a.tree_[ ic ].children != b.tree_[ ic ].children )
+            return false;
+
+    if ( a.channelCount_ != b.channelCount_ ||
+            a.caCount_ != b.caCount_ ||
+            a.state_.size() != b.state_.size() ||
+            a.caConc_.size() != b.caConc_.size() ||
+            a.externalCalcium_.size() != b.externalCalcium_.size() ||
+            a.caRow_.size() != b.caRow_.size() )
+        return false;
+
+    for ( unsigned int i = 0; i < a.channel_.size(); ++i )
+    {
+        const ChannelStruct& x = a.channel_[ i ];
+        const ChannelStruct& y = b.channel_[ i ];
+        if ( x.Xpower_ != y.Xpower_ || x.Ypower_ != y.Ypower_ ||
+                x.Zpower_ != y.Zpower_ || x.instant_ != y.instant_ )
+            return false;
+
+        const double* ta = a.caTarget_[ i ];
+        const double* tb = b.caTarget_[ i ];
+        if ( ( ta == 0 ) != ( tb == 0 ) )
+            return false;
+        if ( ta && ta - a.caActivation_.data() !=
+                tb - b.caActivation_.data() )
+            return false;
+    }
+
+    for ( unsigned int i = 0; i < a.caRow_.size(); ++i )
+    {
+        const LookupRow* ra = a.caRow_[ i ];
+        const LookupRow* rb = b.caRow_[ i ];
+        if ( ( ra == 0 ) != ( rb == 0 ) )
+            return false;
+        if ( ra && ra - a.caRowCompt_.data() != rb - b.caRowCompt_.data() )
+            return false;
+    }
+
+    for ( unsigned int i = 0; i < a.column_.size(); ++i )
+        if ( a.column_[ i ].column != b.column_[ i ].column )
+            return false;
+
+    // Cells made from the same channel prototypes share their gates, and
+    // so their lookup tables.
+    if ( a.gateId_ == b.gateId_ )
+        return true;
+    return a.vTable_ == b.vTable_ && a.caTable_ == b.caTable_;
+}
+
+unsigned int HSolveBatch::getNumCells() const
+{
+    return n_;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Moving data between the cells and the batch
+//////////////////////////////////////////////////////////////////////
+
+void HSolveBatch::load( unsigned int c )
+{
+    HSolveActive& cell = *cells_[ c ];
+    const size_t n = n_;
+
+    for ( unsigned int ic = 0; ic < nCompt_; ++ic )
+    {
+        V_[ ic * n + c ] = cell.V_[ ic ];
+        VMid_[ ic * n + c ] = cell.VMid_[ ic ];
+        CmByDt_[ ic * n + c ] = cell.compartment_[ ic ].CmByDt;
+        EmByRm_[ ic * n + c ] = cell.compartment_[ ic ].EmByRm;
+    }
+    for ( unsigned int i = 0; i < cell.HS_.size(); ++i )
+        HS_[ i * n + c ] = cell.HS_[ i ];
+    for ( unsigned int i = 0; i < cell.HJCopy_.size(); ++i )
+        HJCopy_[ i * n + c ] = cell.HJCopy_[ i ];
+
+    for ( unsigned int i = 0; i < cell.channel_.size(); ++i )
+    {
+        Gbar_[ i * n + c ] = cell.channel_[ i ].Gbar_;
+        modulation_[ i * n + c ] = cell.channel_[ i ].modulation_;
+        Gk_[ i * n + c ] = cell.current_[ i ].Gk;
+        Ek_[ i * n + c ] = cell.current_[ i ].Ek;
+    }
+    for ( unsigned int i = 0; i < cell.state_.size(); ++i )
+        state_[ i * n + c ] = cell.state_[ i ];
+    for ( unsigned int i = 0; i < cell.caConc_.size(); ++i )
+    {
+        ca_[ i * n + c ] = cell.ca_[ i ];
+        caConc_[ i * n + c ] = cell.caConc_[ i ];
+    }
+
+    cell.modified_ = false;
+}
+
+void HSolveBatch::loadInputs( unsigned int c )
+{
+    HSolveActive& cell = *cells_[ c ];
+    const size_t n = n_;
+
+    for ( unsigned int ic = 0; ic < nCompt_; ++ic )
+        inject_[ ic * n + c ] = 0.0;
+    map< unsigned int, InjectStruct >::const_iterator inject;
+    for ( inject = cell.inject_.begin(); inject != cell.inject_.end(); ++inject )
+        inject_[ inject->first * n + c ] =
+            inject->second.injectVarying + inject->second.injectBasal;
+
+    for ( unsigned int i = 0; i < cell.externalCurrent_.size(); ++i )
+        externalCurrent_[ i * n + c ] = cell.externalCurrent_[ i ];
+    for ( unsigned int i = 0; i < cell.externalCalcium_.size(); ++i )
+        externalCalcium_[ i * n + c ] = cell.externalCalcium_[ i ];
+    for ( unsigned int i = 0; i < cell.caActivation_.size(); ++i )
+        caActivation_[ i * n + c ] = cell.caActivation_[ i ];
+}
+
+void HSolveBatch::store( unsigned int c )
+{
+    HSolveActive& cell = *cells_[ c ];
+    const size_t n = n_;
+
+    for ( unsigned int ic = 0; ic < nCompt_; ++ic )
+    {
+        cell.V_[ ic ] = V_[ ic * n + c ];
+        cell.VMid_[ ic ] = VMid_[ ic * n + c ];
+    }
+    for ( unsigned int i = 0; i < cell.current_.size(); ++i )
+        cell.current_[ i ].Gk = Gk_[ i * n + c ];
+    for ( unsigned int i = 0; i < cell.state_.size(); ++i )
+        cell.state_[ i ] = state_[ i * n + c ];
+    for ( unsigned int i = 0; i < cell.caConc_.size(); ++i )
+    {
+        cell.ca_[ i ] = ca_[ i * n + c ];
+        cell.caConc_[ i ] = caConc_[ i * n + c ];
+    }
+
+    cell.stage_ = 2;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Integration
+//////////////////////////////////////////////////////////////////////
+
+void HSolveBatch::step( ProcPtr info )
+{
+    const double dt = info->dt;
+    auto run = [this, dt]( size_t begin, size_t end )
+    {
+        for ( size_t c = begin; c < end; ++c )
+        {
+            if ( cells_[ c ]->modified_ )
+                load( c );
+            loadInputs( c );
+        }
+        advance( dt, begin, end );
+        for ( size_t c = begin; c < end; ++c )
+            store( c );
+    };
+
+    if ( numThreads_ > 1 )
+        moose::ThreadPool::global().parallelFor(
+            n_, grainSize_, run, numThreads_ );
+    else
+        run( 0, n_ );
+
+    // Messages go out one cell at a time, as in HSolveActive::step.
+    for ( HSolveActive* cell : cells_ )
+    {
+        map< unsigned int, InjectStruct >::iterator inject;
+        for ( inject = cell->inject_.begin(); inject != cell->inject_.end(); ++inject )
+            inject->second.injectVarying = 0.0;
+        cell->caActivation_.assign( cell->caActivation_.size(), 0.0 );
+
+        cell->sendValues( info );
+        cell->sendSpikes( info );
+        cell->prevExtCurr_ = cell->externalCurrent_;
+        cell->externalCurrent_.assign( cell->externalCurrent_.size(), 0.0 );
+    }
+}
+
+void HSolveBatch::advance( double dt, size_t begin, size_t end )
+{
+    advanceChannels( dt, begin, end );
+    calculateChannelCurrents( begin, end );
+    updateMatrix( begin, end );
+    forwardEliminate( begin, end );
+    backwardSubstitute( begin, end );
+    advanceCalcium( begin, end );
+}
+
+/// The gate update of HSolveActive::advanceChannels.
+static inline void updateGate( double& state, double C1, double C2,
+                               bool instant, double dt )
+{
+    if ( instant )
+        state = C1 / C2;
+    else
+    {
+        double temp = 1.0 + dt / 2.0 * C2;
+        state = ( state * ( 2.0 - temp ) + dt * C1 ) / temp;
+    }
+}
+
+void HSolveBatch::advanceChannels( double dt, size_t begin, size_t end )
+{
+    const size_t n = n_;
+    const size_t width = end - begin;
+    HSolveBatchWork& ws = work_;
+    ws.vRow.resize( width );
+    ws.caRow.resize( maxCaCount_ * width );
+    LookupRow* vRow = ws.vRow.data();
+    LookupRow* caRow = ws.caRow.data();
+
+    unsigned int ichan = 0;
+    unsigned int igate = 0;
+    unsigned int ica = 0;
+    unsigned int icarow = 0;
+    double C1, C2;
+    for ( unsigned int ic = 0; ic < nCompt_; ++ic )
+    {
+        const double* v = &V_[ ic * n + begin ];
+        for ( size_t i = 0; i < width; ++i )
+            vTable_->row( v[ i ], vRow[ i ] );
+
+        for ( unsigned int j = 0; j < caCount_[ ic ]; ++j, ++ica )
+        {
+            const double* ca = &ca_[ ica * n + begin ];
+            for ( size_t i = 0; i < width; ++i )
+                caTable_->row( ca[ i ], caRow[ j * width + i ] );
+        }
+
+        for ( int k = 0; k < channelCount_[ ic ]; ++k, ++ichan )
+        {
+            const int instant = instant_[ ichan ];
+
+            if ( Xpower_[ ichan ] > 0.0 )
+            {
+                const bool inst = instant & HSolveActive::INSTANT_X;
+                const LookupColumn& column = column_[ igate ];
+                double* state = &state_[ igate * n + begin ];
+                for ( size_t i = 0; i < width; ++i )
+                {
+                    vTable_->lookup( column, vRow[ i ], C1, C2 );
+                    updateGate( state[ i ], C1, C2, inst, dt );
+                }
+                ++igate;
+            }
+
+            if ( Ypower_[ ichan ] > 0.0 )
+            {
+                const bool inst = instant & HSolveActive::INSTANT_Y;
+                const LookupColumn& column = column_[ igate ];
+                double* state = &state_[ igate * n + begin ];
+                for ( size_t i = 0; i < width; ++i )
+                {
+                    vTable_->lookup( column, vRow[ i ], C1, C2 );
+                    updateGate( state[ i ], C1, C2, inst, dt );
+                }
+                ++igate;
+            }
+
+            if ( Zpower_[ ichan ] > 0.0 )
+            {
+                const bool inst = instant & HSolveActive::INSTANT_Z;
+                const LookupColumn& column = column_[ igate ];
+                double* state = &state_[ igate * n + begin ];
+                const double* extca = &externalCalcium_[ ichan * n + begin ];
+                const int row = caRow_[ icarow ];
+                LookupRow dRow;
+                for ( size_t i = 0; i < width; ++i )
+                {
+                    if ( row >= 0 )
+                        caTable_->lookup( column, caRow[ row * width + i ],
+                                          C1, C2 );
+                    else if ( extca[ i ] > 0 )
+                    {
+                        caTable_->row( extca[ i ], dRow );
+                        caTable_->lookup( column, dRow, C1, C2 );
+                    }
+                    else
+                        vTable_->lookup( column, vRow[ i ], C1, C2 );
+                    updateGate( state[ i ], C1, C2, inst, dt );
+                }
+                ++igate, ++icarow;
+            }
+        }
+    }
+}
+
+/// Multiplies f by x raised to p, as ChannelStruct::selectPower does.
+static void multiplyPower( double* f, const double* x, size_t width,
+                           double p )
+{
+    if ( p == 1.0 )
+        for ( size_t i = 0; i < width; ++i )
+            f[ i ] *= x[ i ];
+    else if ( p == 2.0 )
+        for ( size_t i = 0; i < width; ++i )
+            f[ i ] *= x[ i ] * x[ i ];
+    else if ( p == 3.0 )
+        for ( size_t i = 0; i < width; ++i )
+            f[ i ] *= x[ i ] * x[ i ] * x[ i ];
+    else if ( p == 4.0 )
+        for ( size_t i = 0; i < width; ++i )
+        {
+            double x2 = x[ i ] * x[ i ];
+            f[ i ] *= x2 * x2;
+        }
+    else
+        for ( size_t i = 0; i < width; ++i )
+            f[ i ] *= x[ i ] > 0.0 ? exp( p * log( x[ i ] ) ) : 0.0;
+}
+
+void HSolveBatch::calculateChannelCurrents( size_t begin, size_t end )
+{
+    const size_t n = n_;
+    const size_t width = end - begin;
+    unsigned int istate = 0;
+    for ( unsigned int ichan = 0; ichan < Xpower_.size(); ++ichan )
+    {
+        double* Gk = &Gk_[ ichan * n + begin ];
+        const double* Gbar = &Gbar_[ ichan * n + begin ];
+        const double* modulation = &modulation_[ ichan * n + begin ];
+
+        for ( size_t i = 0; i < width; ++i )
+            Gk[ i ] = modulation[ i ];
+        if ( Xpower_[ ichan ] > 0.0 )
+            multiplyPower( Gk, &state_[ istate++ * n + begin ], width,
+                           Xpower_[ ichan ] );
+        if ( Ypower_[ ichan ] > 0.0 )
+            multiplyPower( Gk, &state_[ istate++ * n + begin ], width,
+                           Ypower_[ ichan ] );
+        if ( Zpower_[ ichan ] > 0.0 )
+            multiplyPower( Gk, &state_[ istate++ * n + begin ], width,
+                           Zpower_[ ichan ] );
+        for ( size_t i = 0; i < width; ++i )
+            Gk[ i ] = Gbar[ i ] * Gk[ i ];
+    }
+}
+
+void HSolveBatch::updateMatrix( size_t begin, size_t end )
+{
+    const size_t n = n_;
+    const size_t width = end - begin;
+    HSolveBatchWork& ws = work_;
+    ws.GkSum.resize( width );
+    ws.GkEkSum.resize( width );
+    double* GkSum = ws.GkSum.data();
+    double* GkEkSum = ws.GkEkSum.data();
+
+    for ( size_t i = 0; i < HJ_.size(); i += n )
+        memcpy( &HJ_[ i + begin ], &HJCopy_[ i + begin ],
+                sizeof( double ) * width );
+
+    unsigned int ichan = 0;
+    for ( unsigned int ic = 0; ic < nCompt_; ++ic )
+    {
+        for ( size_t i = 0; i < width; ++i )
+        {
+            GkSum[ i ] = 0.0;
+            GkEkSum[ i ] = 0.0;
+        }
+        for ( int k = 0; k < channelCount_[ ic ]; ++k, ++ichan )
+        {
+            const double* Gk = &Gk_[ ichan * n + begin ];
+            const double* Ek = &Ek_[ ichan * n + begin ];
+            for ( size_t i = 0; i < width; ++i )
+            {
+                GkSum[ i ] += Gk[ i ];
+                GkEkSum[ i ] += Gk[ i ] * Ek[ i ];
+            }
+        }
+
+        double* hs = HS_.data() + 4 * ic * n + begin;
+        const double* v = &V_[ ic * n + begin ];
+        const double* CmByDt = &CmByDt_[ ic * n + begin ];
+        const double* EmByRm = &EmByRm_[ ic * n + begin ];
+        const double* inject = &inject_[ ic * n + begin ];
+        const double* ext = &externalCurrent_[ 2 * ic * n + begin ];
+        for ( size_t i = 0; i < width; ++i )
+        {
+            hs[ i ] = hs[ 2 * n + i ] + GkSum[ i ];
+            hs[ 3 * n + i ] = v[ i ] * CmByDt[ i ] + EmByRm[ i ] + GkEkSum[ i ];
+            hs[ 3 * n + i ] += inject[ i ];
+            hs[ i ] += ext[ i ];
+            hs[ 3 * n + i ] += ext[ n + i ];
+        }
+    }
+}
+
+void HSolveBatch::forwardEliminate( size_t begin, size_t end )
+{
+    const size_t n = n_;
+    const size_t width = end - begin;
+    vector< double* >::const_iterator iop = operand_.begin();
+    vector< JunctionStruct >::const_iterator junction;
+    unsigned int ic = 0;
+    double* hs = HS_.data() + begin;
+
+    for ( junction = junction_.begin(); junction != junction_.end(); ++junction )
+    {
+        unsigned int index = junction->index;
+        unsigned int rank = junction->rank;
+
+        for ( ; ic < index; ++ic, hs += 4 * n )
+            for ( size_t i = 0; i < width; ++i )
+            {
+                hs[ 4 * n + i ] -= hs[ n + i ] / hs[ i ] * hs[ n + i ];
+                hs[ 7 * n + i ] -= hs[ n + i ] / hs[ i ] * hs[ 3 * n + i ];
+            }
+
+        if ( rank == 1 )
+        {
+            double* j = *iop + begin;
+            double* s = *( iop + 1 ) + begin;
+            for ( size_t i = 0; i < width; ++i )
+            {
+                double division = j[ n + i ] / hs[ i ];
+                s[ i ] -= division * j[ i ];
+                s[ 3 * n + i ] -= division * hs[ 3 * n + i ];
+            }
+
+            iop += 3;
+        }
+        else if ( rank == 2 )
+        {
+            double* j = *iop + begin;
+            double* s1 = *( iop + 1 ) + begin;
+            double* s2 = *( iop + 3 ) + begin;
+            for ( size_t i = 0; i < width; ++i )
+            {
+                double pivot = hs[ i ];
+                double division = j[ n + i ] / pivot;
+                s1[ i ] -= division * j[ i ];
+                j[ 4 * n + i ] -= division * j[ 2 * n + i ];
+                s1[ 3 * n + i ] -= division * hs[ 3 * n + i ];
+
+                division = j[ 3 * n + i ] / pivot;
+                j[ 5 * n + i ] -= division * j[ i ];
+                s2[ i ] -= division * j[ 2 * n + i ];
+                s2[ 3 * n + i ] -= division * hs[ 3 * n + i ];
+            }
+
+            iop += 5;
+        }
+        else
+        {
+            vector< double* >::const_iterator last =
+                iop + 3 * rank * ( rank + 1 );
+            for ( ; iop < last; iop += 3 )
+            {
+                double* target = *iop + begin;
+                const double* a = *( iop + 1 ) + begin;
+                const double* b = *( iop + 2 ) + begin;
+                for ( size_t i = 0; i < width; ++i )
+                    target[ i ] -= b[ i ] / hs[ i ] * a[ i ];
+            }
+        }
+
+        ++ic, hs += 4 * n;
+    }
+
+    for ( ; ic < nCompt_ - 1; ++ic, hs += 4 * n )
+        for ( size_t i = 0; i < width; ++i )
+        {
+            hs[ 4 * n + i ] -= hs[ n + i ] / hs[ i ] * hs[ n + i ];
+            hs[ 7 * n + i ] -= hs[ n + i ] / hs[ i ] * hs[ 3 * n + i ];
+        }
+}
+
+void HSolveBatch::backwardSubstitute( size_t begin, size_t end )
+{
+    const size_t n = n_;
+    const size_t width = end - begin;
+    // Operands are read from the back, as in HSolvePassive.
+    size_t iop = operand_.size();
+    size_t ibop = backOperand_.size();
+    vector< JunctionStruct >::const_reverse_iterator junction;
+    int ic = nCompt_ - 1;
+
+    double* hs = HS_.data() + 4 * ic * n + begin;
+    double* vmid = VMid_.data() + ic * n + begin;
+    double* v = V_.data() + ic * n + begin;
+    for ( size_t i = 0; i < width; ++i )
+    {
+        vmid[ i ] = hs[ 3 * n + i ] / hs[ i ];
+        v[ i ] = 2 * vmid[ i ] - v[ i ];
+    }
+    --ic;
+
+    for ( junction = junction_.rbegin(); junction != junction_.rend(); ++junction )
+    {
+        int index = junction->index;
+        int rank = junction->rank;
+
+        for ( ; ic > index; --ic )
+        {
+            hs = HS_.data() + 4 * ic * n + begin;
+            vmid = VMid_.data() + ic * n + begin;
+            v = V_.data() + ic * n + begin;
+            for ( size_t i = 0; i < width; ++i )
+            {
+                vmid[ i ] = ( hs[ 3 * n + i ] - hs[ n + i ] * vmid[ n + i ] ) /
+                            hs[ i ];
+                v[ i ] = 2 * vmid[ i ] - v[ i ];
+            }
+        }
+
+        hs = HS_.data() + 4 * ic * n + begin;
+        vmid = VMid_.data() + ic * n + begin;
+        v = V_.data() + ic * n + begin;
+        if ( rank == 1 )
+        {
+            const double* vfar = operand_[ iop - 1 ] + begin;
+            const double* j = operand_[ iop - 3 ] + begin;
+            for ( size_t i = 0; i < width; ++i )
+                vmid[ i ] = ( hs[ 3 * n + i ] - vfar[ i ] * j[ i ] ) / hs[ i ];
+
+            iop -= 3;
+        }
+        else if ( rank == 2 )
+        {
+            const double* v0 = operand_[ iop - 1 ] + begin;
+            const double* v1 = operand_[ iop - 3 ] + begin;
+            const double* j = operand_[ iop - 5 ] + begin;
+            for ( size_t i = 0; i < width; ++i )
+                vmid[ i ] = ( hs[ 3 * n + i ]
+                              - v0[ i ] * j[ 2 * n + i ]
+                              - v1[ i ] * j[ i ]
+                            ) / hs[ i ];
+
+            iop -= 5;
+        }
+        else
+        {
+            for ( size_t i = 0; i < width; ++i )
+                vmid[ i ] = hs[ 3 * n + i ];
+            for ( int r = 0; r < rank; ++r )
+            {
+                const double* vfar = backOperand_[ ibop - 1 ] + begin;
+                const double* j = backOperand_[ ibop - 2 ] + begin;
+                for ( size_t i = 0; i < width; ++i )
+                    vmid[ i ] -= vfar[ i ] * j[ i ];
+                ibop -= 2;
+            }
+            for ( size_t i = 0; i < width; ++i )
+                vmid[ i ] /= hs[ i ];
+
+            iop -= 3 * rank * ( rank + 1 );
+        }
+
+        for ( size_t i = 0; i < width; ++i )
+            v[ i ] = 2 * vmid[ i ] - v[ i ];
+        --ic;
+    }
+
+    for ( ; ic >= 0; --ic )
+    {
+        hs = HS_.data() + 4 * ic * n + begin;
+        vmid = VMid_.data() + ic * n + begin;
+        v = V_.data() + ic * n + begin;
+        for ( size_t i = 0; i < width; ++i )
+        {
+            vmid[ i ] = ( hs[ 3 * n + i ] - hs[ n + i ] * vmid[ n + i ] ) /
+                        hs[ i ];
+            v[ i ] = 2 * vmid[ i ] - v[ i ];
+        }
+    }
+}
+
+void HSolveBatch::advanceCalcium( size_t begin, size_t end )
+{
+    const size_t n = n_;
+    const size_t width = end - begin;
+
+    unsigned int ichan = 0;
+    for ( unsigned int ic = 0; ic < nCompt_; ++ic )
+    {
+        const double* vmid = &VMid_[ ic * n + begin ];
+        const double* v = &V_[ ic * n + begin ];
+        for ( int k = 0; k < channelCount_[ ic ]; ++k, ++ichan )
+        {
+            int target = caTarget_[ ichan ];
+            if ( target < 0 )
+                continue;
+
+            double* activation = &caActivation_[ target * n + begin ];
+            const double* Gk = &Gk_[ ichan * n + begin ];
+            const double* Ek = &Ek_[ ichan * n + begin ];
+            // See HSolveActive::caAdvance_.
+            if ( caAdvance_ == 1 )
+                for ( size_t i = 0; i < width; ++i )
+                    activation[ i ] += Gk[ i ] * ( Ek[ i ] - vmid[ i ] );
+            else if ( caAdvance_ == 0 )
+                for ( size_t i = 0; i < width; ++i )
+                {
+                    double v0 = ( 2 * vmid[ i ] - v[ i ] );
+                    activation[ i ] += Gk[ i ] * ( Ek[ i ] - v0 );
+                }
+        }
+    }
+
+    for ( size_t i = 0; i < ca_.size(); i += n )
+        for ( size_t c = begin; c < end; ++c )
+        {
+            ca_[ i + c ] = caConc_[ i + c ].process( caActivation_[ i + c ] );
+            caActivation_[ i + c ] = 0.0;
+        }
+}
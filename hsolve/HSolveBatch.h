@@ -0,0 +1,121 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2026 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _HSOLVE_BATCH_H
+#define _HSOLVE_BATCH_H
+
+/**
+ * Integrates a population of cells that have the same compartment tree,
+ * channels, gates and calcium pools, as one system. The cells are set up
+ * by their own HSolves as usual. The batch then keeps a copy of their
+ * state with the cell index innermost: entry k of cell c is at
+ * [ k * numCells + c ]. Each stage of HSolveActive::step becomes a loop
+ * over the structure of the cell, the same for all cells, around a loop
+ * over cells that the compiler can vectorize. Disjoint ranges of cells
+ * are handed to the shared thread pool.
+ *
+ * The arithmetic is done in the same order as in HSolveActive, so each
+ * cell gets the same result as it would on its own.
+ *
+ * After each step the state is copied back into the HSolves, which then
+ * send their outgoing messages, so that field access through the zombies
+ * and the messages behave as before. Inputs that arrive by message
+ * (injections, external channels and calcium) are read from the HSolves
+ * before each step. Any other change made to an HSolve from outside sets
+ * its modified_ flag, and that cell is read in again.
+ */
+class HSolveBatch
+{
+public:
+    HSolveBatch( const vector< HSolveActive* >& cells,
+                 unsigned int numThreads );
+
+    /// True if the two cells can be integrated in one batch.
+    static bool sameStructure( const HSolveActive& a,
+                               const HSolveActive& b );
+
+    void step( ProcPtr info );
+
+    unsigned int getNumCells() const;
+
+private:
+    /// Reads the full state of cell c, for reinit and after a change.
+    void load( unsigned int c );
+    /// Reads this step's inputs from message targets of cell c.
+    void loadInputs( unsigned int c );
+    /// Writes the state of cell c back after a step.
+    void store( unsigned int c );
+
+    /// One time step for cells [begin, end).
+    void advance( double dt, size_t begin, size_t end );
+
+    void advanceChannels( double dt, size_t begin, size_t end );
+    void calculateChannelCurrents( size_t begin, size_t end );
+    void updateMatrix( size_t begin, size_t end );
+    void forwardEliminate( size_t begin, size_t end );
+    void backwardSubstitute( size_t begin, size_t end );
+    void advanceCalcium( size_t begin, size_t end );
+
+    /// Maps an iterator into one of the matrix arrays of the first cell
+    /// to the same entry of cell 0 in the batch arrays.
+    double* batchAddress( const double* p );
+
+    vector< HSolveActive* > cells_;
+    unsigned int n_;            ///< Number of cells.
+    unsigned int numThreads_;
+    size_t grainSize_;
+
+    /**
+     * Structure, shared by all cells. Taken from the first cell.
+     */
+    unsigned int nCompt_;
+    int caAdvance_;
+    vector< JunctionStruct > junction_;
+    vector< double* > operand_;         ///< As in HinesMatrix, but into
+    vector< double* > backOperand_;     ///< the batch arrays.
+    vector< int > channelCount_;
+    vector< unsigned int > caCount_;
+    vector< double > Xpower_;
+    vector< double > Ypower_;
+    vector< double > Zpower_;
+    vector< int > instant_;
+    vector< LookupColumn > column_;
+    vector< int > caRow_;               ///< Index of the pool in the
+                                        ///< compartment, or -1.
+    vector< int > caTarget_;            ///< Index into caActivation_,
+                                        ///< or -1.
+    unsigned int maxCaCount_;
+    const LookupTable* vTable_;
+    const LookupTable* caTable_;
+
+    /**
+     * Per cell values, interleaved.
+     */
+    vector< double > V_;
+    vector< double > VMid_;
+    vector< double > HS_;
+    vector< double > HJ_;
+    vector< double > HJCopy_;
+    vector< double > CmByDt_;
+    vector< double > EmByRm_;
+    vector< double > inject_;           ///< Basal plus varying, per
+                                        ///< compartment.
+    vector< double > externalCurrent_;  ///< Gk and GkEk per compartment.
+    vector< double > Gbar_;
+    vector< double > modulation_;
+    vector< double > Gk_;
+    vector< double > Ek_;
+    vector< double > state_;
+    vector< double > externalCalcium_;
+    vector< double > ca_;
+    vector< double > caActivation_;
+    vector< CaConcStruct > caConc_;
+};
+
+#endif // _HSOLVE_BATCH_H
@@ -51,6 +51,7 @@ void HSolve::mapIds()
     mapIds( compartmentId_ );
     mapIds( caConcId_ );
     mapIds( channelId_ );
+    mapIds( auxChannelId_ );
     //~ mapIds( gateId_ );
 
     // Doesn't seem to be needed. Perhaps even the externalChannelId_ vector
@@ -76,6 +77,7 @@ void HSolve::setVm( Id id, double value )
     unsigned int index = localIndex( id );
     assert( index < V_.size() );
     V_[ index ] = value;
+    modified_ = true;
 }
 
 double HSolve::getCm( Id id ) const
@@ -93,6 +95,7 @@ void HSolve::setCm( Id id, double value )
     // Also update data structures used for calculations.
 	assert( tree_.size() == compartment_.size() );
 	compartment_[index].CmByDt = 2.0 * value / dt_;
+    modified_ = true;
 }
 
 double HSolve::getEm( Id id ) const
@@ -110,6 +113,7 @@ void HSolve::setEm( Id id, double value )
     // Also update data structures used for calculations.
 	assert( tree_.size() == compartment_.size() );
 	compartment_[index].EmByRm = value / tree_[index].Rm;
+    modified_ = true;
 }
 
 double HSolve::getRm( Id id ) const
@@ -127,6 +131,7 @@ void HSolve::setRm( Id id, double value )
     // Also update data structures used for calculations.
 	assert( tree_.size() == compartment_.size() );
 	compartment_[index].EmByRm = tree_[index].Em / value;
+    modified_ = true;
 }
 
 double HSolve::getRa( Id id ) const
@@ -178,6 +183,11 @@ double HSolve::getIm( Id id ) const
 
     assert( 2 * index + 1 < externalCurrent_.size() );
 	Im += prevExtCurr_[2*index+1] - prevExtCurr_[2*index]*V_[index];
+
+    for ( unsigned int iaux = 0; iaux < auxCurrent_.size(); ++iaux )
+        if ( auxCompt_[ iaux ] == index )
+            Im += ( auxCurrent_[ iaux ].Ek - V_[ index ] ) *
+                  auxCurrent_[ iaux ].Gk;
     return Im;
 }
 
@@ -223,11 +233,16 @@ void HSolve::addInject( Id id, double value )
 // HSolveActive interface.
 //////////////////////////////////////////////////////////////////////
 
-//~ const vector< Id >& HSolve::getCompartments() const
-//~ {
-//~ return compartmentId_;
-//~ }
-//~
+vector< Id > HSolve::getCompartments() const
+{
+    return compartmentId_;
+}
+
+const vector< double >& HSolve::getVmVector() const
+{
+    return V_;
+}
+
 //~ const vector< Id >& HSolve::getHHChannels() const
 //~ {
 //~ return channelId_;
@@ -268,6 +283,7 @@ void HSolve::setPowers(
     unsigned int index = localIndex( id );
     assert( index < channel_.size() );
     channel_[ index ].setPowers( Xpower, Ypower, Zpower );
+    modified_ = true;
 }
 
 int HSolve::getInstant( Id id ) const
@@ -282,6 +298,8 @@ void HSolve::setInstant( Id id, int instant )
     unsigned int index = localIndex( id );
     assert( index < channel_.size() );
     channel_[ index ].instant_ = instant;
+    setGateInstant( index );
+    modified_ = true;
 }
 
 double HSolve::getHHChannelGbar( Id id ) const
@@ -296,7 +314,7 @@ void HSolve::setHHChannelGbar( Id id, double value )
     unsigned int index = localIndex( id );
     assert( index < channel_.size() );
     channel_[ index ].Gbar_ = value;
-
+    modified_ = true;
 }
 
 double HSolve::getEk( Id id ) const
@@ -311,6 +329,7 @@ void HSolve::setEk( Id id, double value )
     unsigned int index = localIndex( id );
     assert( index < current_.size() );
     current_[ index ].Ek = value;
+    modified_ = true;
 }
 
 double HSolve::getGk( Id id ) const
@@ -325,6 +344,7 @@ void HSolve::setGk( Id id, double value )
     unsigned int index = localIndex( id );
     assert( index < current_.size() );
     current_[ index ].Gk = value;
+    modified_ = true;
 }
 
 double HSolve::getIk( Id id ) const
@@ -364,6 +384,7 @@ void HSolve::setX( Id id, double value )
     assert( stateIndex < state_.size() );
 
     state_[ stateIndex ] = value;
+    modified_ = true;
 }
 
 double HSolve::getY( Id id ) const
@@ -400,6 +421,7 @@ void HSolve::setY( Id id, double value )
     assert( stateIndex < state_.size() );
 
     state_[ stateIndex ] = value;
+    modified_ = true;
 }
 
 double HSolve::getZ( Id id ) const
@@ -440,6 +462,7 @@ void HSolve::setZ( Id id, double value )
     assert( stateIndex < state_.size() );
 
     state_[ stateIndex ] = value;
+    modified_ = true;
 }
 
 void HSolve::setHHmodulation( Id id, double value )
@@ -448,6 +471,7 @@ void HSolve::setHHmodulation( Id id, double value )
     assert( index < channel_.size() );
 	if ( value > 0.0 )
 			channel_[index].modulation_ = value;
+    modified_ = true;
 }
 
 double HSolve::getCa( Id id ) const
@@ -464,6 +488,7 @@ void HSolve::setCa( Id id, double Ca )
 
     ca_[ index ] = Ca;
     caConc_[ index ].setCa( Ca );
+    modified_ = true;
 }
 
 void HSolve::iCa( Id id, double iCa )
@@ -492,6 +517,7 @@ void HSolve::setCaBasal( Id id, double CaBasal )
     assert( index < caConc_.size() );
 
     caConc_[ index ].setCaBasal( CaBasal );
+    modified_ = true;
 }
 
 void HSolve::setTauB( Id id, double tau, double B )
@@ -500,6 +526,7 @@ void HSolve::setTauB( Id id, double tau, double B )
     assert( index < caConc_.size() );
 
     caConc_[ index ].setTauB( tau, B, dt_ );
+    modified_ = true;
 }
 
 double HSolve::getCaCeiling( Id id ) const
@@ -515,6 +542,7 @@ void HSolve::setCaCeiling( Id id, double ceiling )
     assert( index < caConc_.size() );
 
     caConc_[ index ].ceiling_ = ceiling;
+    modified_ = true;
 }
 
 double HSolve::getCaFloor( Id id ) const
@@ -530,4 +558,200 @@ void HSolve::setCaFloor( Id id, double floor )
     assert( index < caConc_.size() );
 
     caConc_[ index ].floor_ = floor;
+    modified_ = true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// SynChan, HHChannel2D and MarkovChannel interface. The local index of
+// these runs over auxChannelId_: SynChans, then HHChannel2Ds, then
+// MarkovChannels.
+//////////////////////////////////////////////////////////////////////
+
+double HSolve::getAuxChannelGk( Id id ) const
+{
+    unsigned int index = localIndex( id );
+    assert( index < auxCurrent_.size() );
+    return auxCurrent_[ index ].Gk;
+}
+
+void HSolve::setAuxChannelGk( Id id, double value )
+{
+    unsigned int index = localIndex( id );
+    assert( index < auxCurrent_.size() );
+    auxCurrent_[ index ].Gk = value;
+    modified_ = true;
+}
+
+double HSolve::getAuxChannelEk( Id id ) const
+{
+    unsigned int index = localIndex( id );
+    assert( index < auxCurrent_.size() );
+    return auxCurrent_[ index ].Ek;
+}
+
+void HSolve::setAuxChannelEk( Id id, double value )
+{
+    unsigned int index = localIndex( id );
+    assert( index < auxCurrent_.size() );
+    auxCurrent_[ index ].Ek = value;
+    modified_ = true;
+}
+
+double HSolve::getAuxChannelIk( Id id ) const
+{
+    unsigned int index = localIndex( id );
+    assert( index < auxCurrent_.size() );
+
+    unsigned int comptIndex = auxCompt_[ index ];
+    assert( comptIndex < V_.size() );
+
+    return ( auxCurrent_[ index ].Ek - V_[ comptIndex ] ) *
+           auxCurrent_[ index ].Gk;
+}
+
+void HSolve::setSynChanGbar( Id id, double value )
+{
+    unsigned int index = localIndex( id );
+    assert( index < synchan_.size() );
+    synchan_[ index ].Gbar_ = value;
+    synchan_[ index ].setConstants( dt_ );
+    modified_ = true;
+}
+
+void HSolve::setSynChanTau1( Id id, double value )
+{
+    unsigned int index = localIndex( id );
+    assert( index < synchan_.size() );
+    synchan_[ index ].tau1_ = value;
+    synchan_[ index ].setConstants( dt_ );
+    modified_ = true;
+}
+
+void HSolve::setSynChanTau2( Id id, double value )
+{
+    unsigned int index = localIndex( id );
+    assert( index < synchan_.size() );
+    synchan_[ index ].tau2_ = value;
+    synchan_[ index ].setConstants( dt_ );
+    modified_ = true;
+}
+
+void HSolve::setSynChanModulation( Id id, double value )
+{
+    unsigned int index = localIndex( id );
+    assert( index < synchan_.size() );
+    synchan_[ index ].modulation_ = value;
+    modified_ = true;
+}
+
+void HSolve::activateSynChan( Id id, double value )
+{
+    unsigned int index = localIndex( id );
+    assert( index < synchan_.size() );
+    synchan_[ index ].activation_ += value;
+}
+
+void HSolve::setHHChannel2DGbar( Id id, double value )
+{
+    unsigned int index = localIndex( id ) - synchan_.size();
+    assert( index < channel2D_.size() );
+    channel2D_[ index ].Gbar_ = value;
+    modified_ = true;
+}
+
+void HSolve::setHHChannel2DModulation( Id id, double value )
+{
+    unsigned int index = localIndex( id ) - synchan_.size();
+    assert( index < channel2D_.size() );
+    if ( value > 0.0 )
+        channel2D_[ index ].modulation_ = value;
+    modified_ = true;
+}
+
+void HSolve::setHHChannel2DConc( Id id, unsigned int j, double value )
+{
+    unsigned int index = localIndex( id ) - synchan_.size();
+    assert( index < channel2D_.size() && j < 2 );
+    conc2D_[ 2 * index + j ] = value;
+}
+
+/**
+ * Index into state2D_ of a gate of an HHChannel2D, or -1 if the gate has
+ * zero power.
+ */
+static int gate2DStateIndex( const ChannelStruct& channel,
+                             unsigned int start, unsigned int gate )
+{
+    const double power[] =
+        { channel.Xpower_, channel.Ypower_, channel.Zpower_ };
+    if ( gate > 2 || power[ gate ] == 0.0 )
+        return -1;
+    for ( unsigned int i = 0; i < gate; ++i )
+        if ( power[ i ] > 0.0 )
+            ++start;
+    return start;
+}
+
+double HSolve::getHHChannel2DState( Id id, unsigned int gate ) const
+{
+    unsigned int index = localIndex( id ) - synchan_.size();
+    assert( index < channel2D_.size() );
+
+    int stateIndex = gate2DStateIndex(
+                         channel2D_[ index ], chan2state2D_[ index ], gate );
+    if ( stateIndex < 0 )
+        return 0.0;
+    return state2D_[ stateIndex ];
+}
+
+void HSolve::setHHChannel2DState( Id id, unsigned int gate, double value )
+{
+    unsigned int index = localIndex( id ) - synchan_.size();
+    assert( index < channel2D_.size() );
+
+    int stateIndex = gate2DStateIndex(
+                         channel2D_[ index ], chan2state2D_[ index ], gate );
+    if ( stateIndex < 0 )
+        return;
+    state2D_[ stateIndex ] = value;
+    modified_ = true;
+}
+
+vector< double > HSolve::getMarkovState( Id id ) const
+{
+    unsigned int index =
+        localIndex( id ) - synchan_.size() - channel2D_.size();
+    assert( index < markov_.size() );
+
+    vector< double >::const_iterator begin =
+        markovState_.begin() + markov_[ index ].state_;
+    return vector< double >( begin, begin + markov_[ index ].nStates_ );
+}
+
+void HSolve::setMarkovGbars( Id id, vector< double > value )
+{
+    unsigned int index =
+        localIndex( id ) - synchan_.size() - channel2D_.size();
+    assert( index < markov_.size() );
+
+    const MarkovStruct& markov = markov_[ index ];
+    value.resize( markov.nOpen_, 0.0 );
+    value.resize( markov.nStates_, 0.0 );
+    copy( value.begin(), value.end(), markovGbar_.begin() + markov.state_ );
+    modified_ = true;
+}
+
+void HSolve::setMarkovInitialState( Id id, vector< double > value )
+{
+    unsigned int index =
+        localIndex( id ) - synchan_.size() - channel2D_.size();
+    assert( index < markov_.size() );
+
+    const MarkovStruct& markov = markov_[ index ];
+    value.resize( markov.nStates_, 0.0 );
+    copy( value.begin(), value.end(),
+          markovInitState_.begin() + markov.state_ );
+    // As in MarkovChannel, the state is reset too.
+    copy( value.begin(), value.end(), markovState_.begin() + markov.state_ );
+    modified_ = true;
 }
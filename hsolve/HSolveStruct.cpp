@@ -10,6 +10,9 @@
 #include <cmath>
 #include "../basecode/header.h"
 #include "../biophysics/SpikeGen.h"
+#include "../biophysics/ChanBase.h"
+#include "../biophysics/ChanCommon.h"
+#include "../biophysics/SynChan.h"
 #include "HSolveStruct.h"
 
 void ChannelStruct::setPowers(
@@ -79,6 +82,47 @@ void SpikeGenStruct::send( ProcPtr info  )
 	spike->process( e_, info );
 }
 
+SynChanStruct::SynChanStruct()
+	:
+		compt_( 0 ),
+		Gbar_( 0.0 ),
+		tau1_( 1.0e-3 ),
+		tau2_( 1.0e-3 ),
+		modulation_( 1.0 ),
+		xconst1_( 0.0 ),
+		xconst2_( 0.0 ),
+		yconst1_( 0.0 ),
+		yconst2_( 0.0 ),
+		norm_( 0.0 ),
+		X_( 0.0 ),
+		Y_( 0.0 ),
+		activation_( 0.0 )
+{ ; }
+
+void SynChanStruct::setConstants( double dt )
+{
+	xconst1_ = tau1_ * ( 1.0 - exp( -dt / tau1_ ) );
+	xconst2_ = exp( -dt / tau1_ );
+
+	if ( doubleEq( tau2_, 0.0 ) ) {
+		yconst1_ = 1.0;
+		yconst2_ = 0.0;
+	} else {
+		yconst1_ = tau2_ * ( 1.0 - exp( -dt / tau2_ ) );
+		yconst2_ = exp( -dt / tau2_ );
+	}
+
+	norm_ = SynChan::normalization( Gbar_, tau1_, tau2_ );
+}
+
+double SynChanStruct::process()
+{
+	X_ = activation_ * xconst1_ + X_ * xconst2_;
+	Y_ = X_ * yconst1_ + Y_ * yconst2_;
+	activation_ = 0.0;
+	return Y_ * norm_ * modulation_;
+}
+
 CaConcStruct::CaConcStruct()
 	:
 		c_( 0.0 ),
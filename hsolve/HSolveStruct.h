@@ -12,6 +12,9 @@
 
 typedef double ( *PFDD )( double, double );
 
+class HHGate2D;
+class MarkovSolverBase;
+
 struct CompartmentStruct
 {
 	double CmByDt;
@@ -127,11 +130,76 @@ struct SpikeGenStruct
 	void send( ProcPtr info );
 };
 
+/**
+ * State of a SynChan. Follows SynChan::calcGk: the activation that
+ * arrived during a step is passed through two first order filters with
+ * time constants tau1 and tau2.
+ */
 struct SynChanStruct
 {
+	SynChanStruct();
+
 	// Index of parent compartment
 	unsigned int compt_;
 	Id elm_;
+
+	double Gbar_;
+	double tau1_;
+	double tau2_;
+	double modulation_;
+	double xconst1_;
+	double xconst2_;
+	double yconst1_;
+	double yconst2_;
+	double norm_;
+	double X_;
+	double Y_;
+	double activation_;		///> Summed over the current step.
+
+	/** Sets the filter constants and normalization for time step dt. */
+	void setConstants( double dt );
+
+	/** Advances X_ and Y_ by a step, and returns the conductance. */
+	double process();
+};
+
+/**
+ * HHChannel gates of one kind, as parallel arrays for the vectorized
+ * update in HSolveActive::advanceChannels. Gate i advances
+ * state_[ state[ i ] ], looking up column[ i ] of the table on the
+ * row[ i ]'th entry of the row buffer for its kind.
+ */
+struct GateGroupStruct
+{
+	vector< unsigned int > state;
+	vector< unsigned int > column;
+	vector< unsigned int > row;
+};
+
+/**
+ * A gate of an HHChannel2D. The gate looks up its 2-D table using two of
+ * the compartment Vm and the channel's two concentrations. dep0_ and
+ * dep1_ point to these, or to a constant zero if the gate uses only one.
+ */
+struct Gate2DStruct
+{
+	const HHGate2D* gate_;
+	const double* dep0_;
+	const double* dep1_;
+	bool instant_;
+};
+
+/**
+ * A MarkovChannel. Its state occupancies are kept at state_ in
+ * HSolveActive::markovState_, and advanced with the exponential tables of
+ * the MarkovSolver that served the channel before it was taken over.
+ */
+struct MarkovStruct
+{
+	const MarkovSolverBase* solver_;
+	unsigned int state_;		///> Offset into markovState_
+	unsigned int nStates_;
+	unsigned int nOpen_;
 };
 
 struct CaConcStruct
@@ -63,9 +63,22 @@ int HSolveUtils::channels( Id compartment, vector< Id >& ret )
 
 int HSolveUtils::hhchannels( Id compartment, vector< Id >& ret )
 {
-	// Request for elements of type "HHChannel" only since
+	// Request for elements of type "HHChannel" and "HHChannelF" only since
 	// channel messages can lead to synchans as well.
-	return targets( compartment, "channel", ret, "HHChannel" );
+	vector< string > filter;
+	filter.push_back( "HHChannel" );
+	filter.push_back( "HHChannelF" );
+	return targets( compartment, "channel", ret, filter );
+}
+
+int HSolveUtils::hhchannels2D( Id compartment, vector< Id >& ret )
+{
+	return targets( compartment, "channel", ret, "HHChannel2D" );
+}
+
+int HSolveUtils::markovchannels( Id compartment, vector< Id >& ret )
+{
+	return targets( compartment, "channel", ret, "MarkovChannel" );
 }
 
 /**
@@ -108,7 +121,8 @@ int HSolveUtils::gates(
                 SIMPLE_ASSERT_MSG(gPath == gatePath, errorSS.str().c_str());
 
                 if ( getOriginals ) {
-                    HHGate* g = reinterpret_cast< HHGate* >( gate.eref().data() );
+                    // HHChannelF has HHGateFs, so go through the common base.
+                    HHGateBase* g = reinterpret_cast< HHGateBase* >( gate.eref().data() );
                     gate = g->originalGateId();
                 }
 
@@ -209,6 +223,19 @@ void HSolveUtils::rates(
 	vector< double >& B )
 {
     // dump("HSolveUtils::rates() has not been tested yet.", "WARN");
+    if ( gateId.element()->cinfo()->isA( "HHGateF" ) ) {
+        // Formula gates have no table of their own: evaluate them on the
+        // grid.
+        A.resize( grid.size() );
+        B.resize( grid.size() );
+        for ( unsigned int igrid = 0; igrid < grid.size(); ++igrid ) {
+            double x = grid.entry( igrid );
+            A[ igrid ] = LookupField< double, double >::get( gateId, "A", x );
+            B[ igrid ] = LookupField< double, double >::get( gateId, "B", x );
+        }
+        return;
+    }
+
     double min = Field< double >::get( gateId, "min" );
     double max = Field< double >::get( gateId, "max" );
     unsigned int divs = Field< unsigned int >::get( gateId, "divs" );
@@ -32,6 +32,8 @@ public:
     static int children( Id compartment, vector< Id >& ret );
     static int channels( Id compartment, vector< Id >& ret );
     static int hhchannels( Id compartment, vector< Id >& ret );
+    static int hhchannels2D( Id compartment, vector< Id >& ret );
+    static int markovchannels( Id compartment, vector< Id >& ret );
     static int gates( Id channel, vector< Id >& ret, bool getOriginals = true );
     static int spikegens( Id compartment, vector< Id >& ret );
     static int synchans( Id compartment, vector< Id >& ret );
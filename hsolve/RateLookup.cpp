@@ -14,6 +14,8 @@ using namespace std;
 
 LookupTable::LookupTable(
 	double min, double max, unsigned int nDivs, unsigned int nSpecies )
+	:
+	single_( false )
 {
 	min_ = min;
 	max_ = max;
@@ -35,6 +37,11 @@ void LookupTable::addColumns(
 	//~ const vector< double >& C2,
 	//~ bool interpolate )
 {
+	// Columns are filled in double precision. Widening the other columns
+	// and narrowing them back again leaves them unchanged.
+	const bool single = single_;
+	setSinglePrecision( false );
+
 	vector< double >::const_iterator ic1 = C1.begin();
 	vector< double >::const_iterator ic2 = C2.begin();
 	vector< double >::iterator iTable = table_.begin() + 2 * species;
@@ -51,6 +58,8 @@ void LookupTable::addColumns(
 	*( iTable + 1 ) = C2.back();
 
 	//~ interpolate_[ species ] = interpolate;
+
+	setSinglePrecision( single );
 }
 
 void LookupTable::column( unsigned int species, LookupColumn& column )
@@ -59,45 +68,25 @@ void LookupTable::column( unsigned int species, LookupColumn& column )
 	//~ column.interpolate = interpolate_[ species ];
 }
 
-void LookupTable::row( double x, LookupRow& row )
+void LookupTable::setSinglePrecision( bool single )
 {
-	if ( x < min_ )
-		x = min_;
-	else if ( x > max_ )
-		x = max_;
-
-	double div = ( x - min_ ) / dx_;
-	unsigned int integer = ( unsigned int )( div );
-
-	row.fraction = div - integer;
-	row.row = &( table_.front() ) + integer * nColumns_;
+	if ( single == single_ )
+		return;
+	single_ = single;
+	// Only one copy of the table is kept.
+	if ( single_ ) {
+		tableF_.assign( table_.begin(), table_.end() );
+		vector< double >().swap( table_ );
+	} else {
+		table_.assign( tableF_.begin(), tableF_.end() );
+		vector< float >().swap( tableF_ );
+	}
 }
 
-void LookupTable::lookup(
-	const LookupColumn& column,
-	const LookupRow& row,
-	double& C1,
-	double& C2 )
+bool LookupTable::operator==( const LookupTable& other ) const
 {
-	double a, b;
-	double *ap, *bp;
-
-	ap = row.row + column.column;
-
-	//~ if ( ! column.interpolate ) {
-		//~ C1 = *ap;
-		//~ C2 = *( ap + 1 );
-		//~
-		//~ return;
-	//~ }
-
-	bp = ap + nColumns_;
-
-	a = *ap;
-	b = *bp;
-	C1 = a + ( b - a ) * row.fraction;
-
-	a = *( ap + 1 );
-	b = *( bp + 1 );
-	C2 = a + ( b - a ) * row.fraction;
+	return min_ == other.min_ && max_ == other.max_ &&
+		nPts_ == other.nPts_ && nColumns_ == other.nColumns_ &&
+		single_ == other.single_ && table_ == other.table_ &&
+		tableF_ == other.tableF_;
 }
@@ -12,7 +12,7 @@
 
 struct LookupRow
 {
-	double* row;		///< Pointer to the first column on a row
+	unsigned int row;	///< Index of the first column on a row
 	double fraction;	///< Fraction of V or Ca over and above the division
 						///< boundary for interpolation.
 };
@@ -27,7 +27,10 @@ struct LookupColumn
 class LookupTable
 {
 public:
-	LookupTable() { ; }
+	LookupTable()
+		:
+		single_( false )
+	{ ; }
 
 	LookupTable(
 		double min,					///< min of range
@@ -50,21 +53,59 @@ public:
 	/**
 	 * Returns the row corresponding to x in the "row" parameter.
 	 * i.e., returns the leftover fraction and the row's start address.
+	 * Defined inline below, as are lookup(), so that HSolveBatch can run
+	 * them in loops over cells.
 	 */
 	void row(
 		double x,
-		LookupRow& row );
+		LookupRow& row ) const;
 
 	/// Actually performs the lookup and the linear interpolation
 	void lookup(
 		const LookupColumn& column,
 		const LookupRow& row,
 		double& C1,
-		double& C2 );
+		double& C2 ) const;
+
+	/**
+	 * Looks up n entries at once: entry i reads column[ i ] on the row
+	 * rows[ rowIndex[ i ] ]. Written as a plain loop over arrays so that
+	 * the compiler can vectorize it.
+	 */
+	void lookup(
+		unsigned int n,
+		const unsigned int* column,
+		const unsigned int* rowIndex,
+		const LookupRow* rows,
+		double* C1,
+		double* C2 ) const;
+
+	/**
+	 * In single precision mode the table is held, and read, as floats
+	 * only, which halves its memory and cache footprint on large cells.
+	 * Rows are still found, and values interpolated, in double precision.
+	 * Going back to double precision widens the float values; it does not
+	 * bring back the rounded-off digits.
+	 */
+	void setSinglePrecision( bool single );
+	bool singlePrecision() const { return single_; }
+
+	/// True if both tables hold the same grid and values.
+	bool operator==( const LookupTable& other ) const;
 
 private:
+	template< class T >
+	void lookup(
+		const T* table,
+		unsigned int n,
+		const unsigned int* column,
+		const unsigned int* rowIndex,
+		const LookupRow* rows,
+		double* C1,
+		double* C2 ) const;
+
 	//~ vector< bool >       interpolate_;
-	vector< double >     table_;		///< Flattened table
+	vector< double >     table_;		///< Flattened table, unless single_
 	double               min_;			///< min of the voltage / caConc range
 	double               max_;			///< max of the voltage / caConc range
 	unsigned int         nPts_;			///< Number of rows in the table.
@@ -73,6 +114,71 @@ private:
 	double               dx_;			///< This is the smallest difference:
 										///< (max - min) / nDivs
 	unsigned int         nColumns_;		///< (# columns) = 2 * (# species)
+	bool                 single_;		///< Look up in tableF_?
+	vector< float >      tableF_;		///< Flattened table, if single_
 };
 
+inline void LookupTable::row( double x, LookupRow& row ) const
+{
+	if ( x < min_ )
+		x = min_;
+	else if ( x > max_ )
+		x = max_;
+
+	double div = ( x - min_ ) / dx_;
+	unsigned int integer = ( unsigned int )( div );
+
+	row.fraction = div - integer;
+	row.row = integer * nColumns_;
+}
+
+template< class T >
+inline void LookupTable::lookup(
+	const T* table,
+	unsigned int n,
+	const unsigned int* column,
+	const unsigned int* rowIndex,
+	const LookupRow* rows,
+	double* C1,
+	double* C2 ) const
+{
+	for ( unsigned int i = 0; i < n; ++i ) {
+		const LookupRow& row = rows[ rowIndex[ i ] ];
+		const T* ap = table + row.row + column[ i ];
+		const T* bp = ap + nColumns_;
+
+		double a = ap[ 0 ];
+		double b = bp[ 0 ];
+		C1[ i ] = a + ( b - a ) * row.fraction;
+
+		a = ap[ 1 ];
+		b = bp[ 1 ];
+		C2[ i ] = a + ( b - a ) * row.fraction;
+	}
+}
+
+inline void LookupTable::lookup(
+	unsigned int n,
+	const unsigned int* column,
+	const unsigned int* rowIndex,
+	const LookupRow* rows,
+	double* C1,
+	double* C2 ) const
+{
+	if ( single_ )
+		lookup( tableF_.data(), n, column, rowIndex, rows, C1, C2 );
+	else
+		lookup( table_.data(), n, column, rowIndex, rows, C1, C2 );
+}
+
+inline void LookupTable::lookup(
+	const LookupColumn& column,
+	const LookupRow& row,
+	double& C1,
+	double& C2 ) const
+{
+	const unsigned int index = 0;
+	lookup( 1, &column.column, &index, &row, &C1, &C2 );
+}
+
 #endif // _RATE_LOOKUP_H
@@ -147,7 +147,7 @@ void ZombieCaConc::vDecrease( const Eref& e, double I )
 }
 
 ///////////////////////////////////////////////////
-void ZombieCaConc::vSetSolver( const Eref& e, Id hsolve )
+void ZombieCaConc::vSetSolver( const Eref& e, ObjId hsolve )
 {
 	if ( !hsolve.element()->cinfo()->isA( "HSolve" ) ) {
 		cout << "Error: ZombieCaConc::vSetSolver: Object: " <<
@@ -155,5 +155,5 @@ void ZombieCaConc::vSetSolver( const Eref& e, Id hsolve )
 		hsolve_ = 0;
 		return;
 	}
-	hsolve_ = reinterpret_cast< HSolve* >( hsolve.eref().data() );
+	hsolve_ = reinterpret_cast< HSolve* >( hsolve.data() );
 }
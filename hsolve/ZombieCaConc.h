@@ -55,7 +55,7 @@ public:
     double vGetFloor( const Eref& e ) const;
 
     ///////////////////////////////////////////////////////////////
-	void vSetSolver( const Eref& e, Id hsolve );
+	void vSetSolver( const Eref& e, ObjId hsolve );
     ///////////////////////////////////////////////////////////////
     static const Cinfo* initCinfo();
 
@@ -125,7 +125,7 @@ public:
     void vRandInject( const Eref& e , double prob, double current);
 
 	/// Assigns the solver to the zombie
-	void vSetSolver( const Eref& e, Id hsolve );
+	void vSetSolver( const Eref& e, ObjId hsolve );
 
     /**
      * Initializes the class info.
@@ -212,7 +212,7 @@ void ZombieHHChannel::vCreateGate(const Eref& e, string name)
 void ZombieHHChannel::vHandleVm( double Vm )
 {;}
 
-void ZombieHHChannel::vSetSolver( const Eref& e , Id hsolve )
+void ZombieHHChannel::vSetSolver( const Eref& e , ObjId hsolve )
 {
 	if ( !hsolve.element()->cinfo()->isA( "HSolve" ) ) {
 		cout << "Error: ZombieHHChannel::vSetSolver: Object: " <<
@@ -221,5 +221,5 @@ void ZombieHHChannel::vSetSolver( const Eref& e , Id hsolve )
 		assert( 0 );
 		return;
 	}
-	hsolve_ = reinterpret_cast< HSolve* >( hsolve.eref().data() );
+	hsolve_ = reinterpret_cast< HSolve* >( hsolve.data() );
 }
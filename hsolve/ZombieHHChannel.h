@@ -114,7 +114,7 @@ public:
     //  */
     // HHGate* vGetZgate( unsigned int i ) const override;
     /////////////////////////////////////////////////////////////
-	void vSetSolver( const Eref& e , Id hsolve ) override;
+	void vSetSolver( const Eref& e , ObjId hsolve ) override;
 
     static const Cinfo* initCinfo();
 
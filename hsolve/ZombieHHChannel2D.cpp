@@ -0,0 +1,186 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**		   Copyright (C) 2003-2014 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include "ZombieHHChannel2D.h"
+
+const Cinfo* ZombieHHChannel2D::initCinfo()
+{
+    static string doc[] =
+    {
+        "Name", "ZombieHHChannel2D",
+        "Author", "Upinder S. Bhalla, 2014 NCBS",
+        "Description", "ZombieHHChannel2D: HHChannel2D whose gates are "
+        "advanced by the HSolve of its cell.",
+    };
+
+	static Dinfo< ZombieHHChannel2D > dinfo;
+    static Cinfo zombieHHChannel2DCinfo(
+        "ZombieHHChannel2D",
+        HHChannel2D::initCinfo(),
+        0,
+        0,
+		&dinfo,
+		doc,
+		sizeof( doc ) / sizeof( string )
+    );
+
+    return &zombieHHChannel2DCinfo;
+}
+
+static const Cinfo* zombieHHChannel2DCinfo = ZombieHHChannel2D::initCinfo();
+//////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////
+// Constructor
+///////////////////////////////////////////////////
+ZombieHHChannel2D::ZombieHHChannel2D()
+    : hsolve_( 0 )
+{ ; }
+
+///////////////////////////////////////////////////
+// Field function definitions
+///////////////////////////////////////////////////
+
+void ZombieHHChannel2D::vSetGbar( const Eref& e , double Gbar )
+{
+    ChanCommon::vSetGbar( e, Gbar );
+    hsolve_->setHHChannel2DGbar( e.id(), Gbar );
+}
+
+void ZombieHHChannel2D::vSetGk( const Eref& e , double Gk )
+{
+    hsolve_->setAuxChannelGk( e.id(), Gk );
+}
+
+double ZombieHHChannel2D::vGetGk( const Eref& e  ) const
+{
+    return hsolve_->getAuxChannelGk( e.id() );
+}
+
+void ZombieHHChannel2D::vSetEk( const Eref& e , double Ek )
+{
+    ChanCommon::vSetEk( e, Ek );
+    hsolve_->setAuxChannelEk( e.id(), Ek );
+}
+
+void ZombieHHChannel2D::vSetIk( const Eref& e , double Ik )
+{
+	;	// dummy
+}
+
+double ZombieHHChannel2D::vGetIk( const Eref& e  ) const
+{
+    return hsolve_->getAuxChannelIk( e.id() );
+}
+
+void ZombieHHChannel2D::vSetModulation( const Eref& e , double modulation )
+{
+	if ( modulation > 0.0 ) {
+            ChanCommon::vSetModulation( e, modulation );
+            hsolve_->setHHChannel2DModulation( e.id(), modulation );
+	}
+}
+
+void ZombieHHChannel2D::vSetX( const Eref& e , double X )
+{
+    hsolve_->setHHChannel2DState( e.id(), 0, X );
+}
+
+double ZombieHHChannel2D::vGetX( const Eref& e  ) const
+{
+    return hsolve_->getHHChannel2DState( e.id(), 0 );
+}
+
+void ZombieHHChannel2D::vSetY( const Eref& e , double Y )
+{
+    hsolve_->setHHChannel2DState( e.id(), 1, Y );
+}
+
+double ZombieHHChannel2D::vGetY( const Eref& e  ) const
+{
+    return hsolve_->getHHChannel2DState( e.id(), 1 );
+}
+
+void ZombieHHChannel2D::vSetZ( const Eref& e , double Z )
+{
+    hsolve_->setHHChannel2DState( e.id(), 2, Z );
+}
+
+double ZombieHHChannel2D::vGetZ( const Eref& e  ) const
+{
+    return hsolve_->getHHChannel2DState( e.id(), 2 );
+}
+
+void ZombieHHChannel2D::vSetXpower( const Eref& e , double Xpower )
+{
+    cerr << "Error: HSolve: Cannot change 'Xpower' of an HHChannel2D "
+         "once HSolve has been setup.\n";
+}
+
+void ZombieHHChannel2D::vSetYpower( const Eref& e , double Ypower )
+{
+    cerr << "Error: HSolve: Cannot change 'Ypower' of an HHChannel2D "
+         "once HSolve has been setup.\n";
+}
+
+void ZombieHHChannel2D::vSetZpower( const Eref& e , double Zpower )
+{
+    cerr << "Error: HSolve: Cannot change 'Zpower' of an HHChannel2D "
+         "once HSolve has been setup.\n";
+}
+
+void ZombieHHChannel2D::vSetInstant( const Eref& e , int instant )
+{
+    cerr << "Error: HSolve: Cannot change 'instant' of an HHChannel2D "
+         "once HSolve has been setup.\n";
+}
+
+///////////////////////////////////////////////////
+// Dest function definitions
+///////////////////////////////////////////////////
+
+void ZombieHHChannel2D::vProcess( const Eref& e, ProcPtr info )
+{
+    ;
+}
+
+void ZombieHHChannel2D::vReinit( const Eref& er, ProcPtr info )
+{
+    ;
+}
+
+void ZombieHHChannel2D::conc1( double conc )
+{
+    hsolve_->setHHChannel2DConc( id_, 0, conc );
+}
+
+void ZombieHHChannel2D::conc2( double conc )
+{
+    hsolve_->setHHChannel2DConc( id_, 1, conc );
+}
+
+///////////////////////////////////////////////////
+// Assign solver
+///////////////////////////////////////////////////
+void ZombieHHChannel2D::vHandleVm( double Vm )
+{;}
+
+void ZombieHHChannel2D::vSetSolver( const Eref& e , ObjId hsolve )
+{
+	if ( !hsolve.element()->cinfo()->isA( "HSolve" ) ) {
+		cout << "Error: ZombieHHChannel2D::vSetSolver: Object: " <<
+				hsolve.path() << " is not an HSolve. Aborted\n";
+		hsolve_ = 0;
+		assert( 0 );
+		return;
+	}
+	hsolve_ = reinterpret_cast< HSolve* >( hsolve.data() );
+	id_ = e.id();
+}
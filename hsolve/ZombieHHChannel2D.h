@@ -0,0 +1,92 @@
+#ifndef _Zombie_HHChannel2D_h
+#define _Zombie_HHChannel2D_h
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment,
+** also known as GENESIS 3 base code.
+**           copyright (C) 2003-2014 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+*********************************************************************
+*/
+
+/**
+ * Zombie object that lets HSolve do its calculations, while letting the user
+ * interact with this object as if it were the original object.
+ *
+ * ZombieHHChannel2D derives from HHChannel2D, so that the gates and their
+ * indices stay where the HSolve and the user expect them. Parameters are
+ * kept in the HHChannel2D part as well, for when the channel is given
+ * back.
+ */
+
+#include "../basecode/header.h"
+#include "HinesMatrix.h"
+#include "HSolveStruct.h"
+#include "HSolvePassive.h"
+#include "RateLookup.h"
+#include "HSolveActive.h"
+#include "HSolve.h"
+#include "../biophysics/ChanBase.h"
+#include "../biophysics/ChanCommon.h"
+#include "../biophysics/HHChannelBase.h"
+#include "../biophysics/HHChannel2D.h"
+
+class ZombieHHChannel2D: public HHChannel2D
+{
+public:
+    ZombieHHChannel2D();
+
+    /////////////////////////////////////////////////////////////
+    // Value field access function definitions
+    /////////////////////////////////////////////////////////////
+
+    void vSetGbar( const Eref& e , double Gbar ) override;
+    void vSetGk( const Eref& e , double Gk ) override;
+    double vGetGk( const Eref& e  ) const override;
+    void vSetEk( const Eref& e , double Ek ) override;
+    void vSetIk( const Eref& e, double Ik ) override;
+    double vGetIk( const Eref& e  ) const override;
+    void vSetModulation( const Eref& e, double value ) override;
+    void vSetX( const Eref& e , double X ) override;
+    double vGetX( const Eref& e  ) const override;
+    void vSetY( const Eref& e , double Y ) override;
+    double vGetY( const Eref& e  ) const override;
+    void vSetZ( const Eref& e , double Z ) override;
+    double vGetZ( const Eref& e  ) const override;
+    /**
+     * The solver lays out its state by the gate powers, so these are
+     * read-only once HSolve has been set up.
+     */
+    void vSetXpower( const Eref& e , double Xpower ) override;
+    void vSetYpower( const Eref& e , double Ypower ) override;
+    void vSetZpower( const Eref& e , double Zpower ) override;
+    void vSetInstant( const Eref& e , int instant ) override;
+
+    /////////////////////////////////////////////////////////////
+    // Dest function definitions
+    /////////////////////////////////////////////////////////////
+
+    void vProcess( const Eref& e, ProcPtr p ) override;
+    void vReinit( const Eref& e, ProcPtr p ) override;
+    void conc1( double conc ) override;
+    void conc2( double conc ) override;
+
+    /////////////////////////////////////////////////////////////
+	// Dummy function, not needed in Zombie.
+	void vHandleVm( double Vm ) override;
+
+    /////////////////////////////////////////////////////////////
+	void vSetSolver( const Eref& e , ObjId hsolve ) override;
+
+    static const Cinfo* initCinfo();
+
+private:
+    HSolve* hsolve_;
+    /// conc1 and conc2 do not get an Eref.
+    Id id_;
+};
+
+
+#endif // _Zombie_HHChannel2D_h
@@ -0,0 +1,131 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**		   Copyright (C) 2003-2014 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include "ZombieMarkovChannel.h"
+
+const Cinfo* ZombieMarkovChannel::initCinfo()
+{
+    static string doc[] =
+    {
+        "Name", "ZombieMarkovChannel",
+        "Author", "Upinder S. Bhalla, 2014 NCBS",
+        "Description", "ZombieMarkovChannel: MarkovChannel whose state is "
+        "advanced by the HSolve of its cell.",
+    };
+
+	static Dinfo< ZombieMarkovChannel > dinfo;
+    static Cinfo zombieMarkovChannelCinfo(
+        "ZombieMarkovChannel",
+        MarkovChannel::initCinfo(),
+        0,
+        0,
+		&dinfo,
+		doc,
+		sizeof( doc ) / sizeof( string )
+    );
+
+    return &zombieMarkovChannelCinfo;
+}
+
+static const Cinfo* zombieMarkovChannelCinfo =
+    ZombieMarkovChannel::initCinfo();
+//////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////
+// Constructor
+///////////////////////////////////////////////////
+ZombieMarkovChannel::ZombieMarkovChannel()
+    : hsolve_( 0 )
+{ ; }
+
+///////////////////////////////////////////////////
+// Field function definitions
+///////////////////////////////////////////////////
+
+void ZombieMarkovChannel::vSetGk( const Eref& e , double Gk )
+{
+    hsolve_->setAuxChannelGk( e.id(), Gk );
+}
+
+double ZombieMarkovChannel::vGetGk( const Eref& e  ) const
+{
+    return hsolve_->getAuxChannelGk( e.id() );
+}
+
+void ZombieMarkovChannel::vSetEk( const Eref& e , double Ek )
+{
+    ChanCommon::vSetEk( e, Ek );
+    hsolve_->setAuxChannelEk( e.id(), Ek );
+}
+
+void ZombieMarkovChannel::vSetIk( const Eref& e , double Ik )
+{
+	;	// dummy
+}
+
+double ZombieMarkovChannel::vGetIk( const Eref& e  ) const
+{
+    return hsolve_->getAuxChannelIk( e.id() );
+}
+
+vector< double > ZombieMarkovChannel::getState() const
+{
+    return hsolve_->getMarkovState( id_ );
+}
+
+void ZombieMarkovChannel::setInitialState( vector< double > state )
+{
+    MarkovChannel::setInitialState( state );
+    hsolve_->setMarkovInitialState( id_, state );
+}
+
+void ZombieMarkovChannel::setGbars( vector< double > Gbars )
+{
+    MarkovChannel::setGbars( Gbars );
+    hsolve_->setMarkovGbars( id_, Gbars );
+}
+
+///////////////////////////////////////////////////
+// Dest function definitions
+///////////////////////////////////////////////////
+
+void ZombieMarkovChannel::vProcess( const Eref& e, ProcPtr info )
+{
+    ;
+}
+
+void ZombieMarkovChannel::vReinit( const Eref& er, ProcPtr info )
+{
+    ;
+}
+
+void ZombieMarkovChannel::handleState( vector< double > state )
+{
+    ;
+}
+
+///////////////////////////////////////////////////
+// Assign solver
+///////////////////////////////////////////////////
+void ZombieMarkovChannel::vHandleVm( double Vm )
+{;}
+
+void ZombieMarkovChannel::vSetSolver( const Eref& e , ObjId hsolve )
+{
+	if ( !hsolve.element()->cinfo()->isA( "HSolve" ) ) {
+		cout << "Error: ZombieMarkovChannel::vSetSolver: Object: " <<
+				hsolve.path() << " is not an HSolve. Aborted\n";
+		hsolve_ = 0;
+		assert( 0 );
+		return;
+	}
+	hsolve_ = reinterpret_cast< HSolve* >( hsolve.data() );
+	id_ = e.id();
+}
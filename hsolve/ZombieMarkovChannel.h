@@ -0,0 +1,76 @@
+#ifndef _Zombie_MarkovChannel_h
+#define _Zombie_MarkovChannel_h
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment,
+** also known as GENESIS 3 base code.
+**           copyright (C) 2003-2014 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+*********************************************************************
+*/
+
+/**
+ * Zombie object that lets HSolve do its calculations, while letting the user
+ * interact with this object as if it were the original object.
+ *
+ * ZombieMarkovChannel derives from MarkovChannel. The HSolve advances the
+ * state occupancies with the tables of the channel's MarkovSolver, so the
+ * state messages from that solver stop, and are ignored if they arrive.
+ */
+
+#include "../basecode/header.h"
+#include "HinesMatrix.h"
+#include "HSolveStruct.h"
+#include "HSolvePassive.h"
+#include "RateLookup.h"
+#include "HSolveActive.h"
+#include "HSolve.h"
+#include "../biophysics/ChanBase.h"
+#include "../biophysics/ChanCommon.h"
+#include "../biophysics/MarkovChannel.h"
+
+class ZombieMarkovChannel: public MarkovChannel
+{
+public:
+    ZombieMarkovChannel();
+
+    /////////////////////////////////////////////////////////////
+    // Value field access function definitions
+    /////////////////////////////////////////////////////////////
+
+    void vSetGk( const Eref& e , double Gk ) override;
+    double vGetGk( const Eref& e  ) const override;
+    void vSetEk( const Eref& e , double Ek ) override;
+    void vSetIk( const Eref& e, double Ik ) override;
+    double vGetIk( const Eref& e  ) const override;
+    vector< double > getState() const override;
+    void setInitialState( vector< double > state ) override;
+    void setGbars( vector< double > Gbars ) override;
+
+    /////////////////////////////////////////////////////////////
+    // Dest function definitions
+    /////////////////////////////////////////////////////////////
+
+    void vProcess( const Eref& e, ProcPtr p ) override;
+    void vReinit( const Eref& e, ProcPtr p ) override;
+    void handleState( vector< double > state ) override;
+
+    /////////////////////////////////////////////////////////////
+	// Dummy function, not needed in Zombie.
+	void vHandleVm( double Vm ) override;
+
+    /////////////////////////////////////////////////////////////
+	void vSetSolver( const Eref& e , ObjId hsolve ) override;
+
+    static const Cinfo* initCinfo();
+
+private:
+    HSolve* hsolve_;
+    /// The state and Gbar fields do not get an Eref.
+    Id id_;
+};
+
+
+#endif // _Zombie_MarkovChannel_h
@@ -0,0 +1,137 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**		   Copyright (C) 2003-2014 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include "ZombieSynChan.h"
+
+const Cinfo* ZombieSynChan::initCinfo()
+{
+    static string doc[] =
+    {
+        "Name", "ZombieSynChan",
+        "Author", "Upinder S. Bhalla, 2014 NCBS",
+        "Description", "ZombieSynChan: SynChan whose conductance is "
+        "computed by the HSolve of its cell.",
+    };
+
+	static Dinfo< ZombieSynChan > dinfo;
+    static Cinfo zombieSynChanCinfo(
+        "ZombieSynChan",
+        SynChan::initCinfo(),
+        0,
+        0,
+		&dinfo,
+		doc,
+		sizeof( doc ) / sizeof( string )
+    );
+
+    return &zombieSynChanCinfo;
+}
+
+static const Cinfo* zombieSynChanCinfo = ZombieSynChan::initCinfo();
+//////////////////////////////////////////////////////////////////////
+
+
+///////////////////////////////////////////////////
+// Constructor
+///////////////////////////////////////////////////
+ZombieSynChan::ZombieSynChan()
+    : hsolve_( 0 )
+{ ; }
+
+///////////////////////////////////////////////////
+// Field function definitions
+///////////////////////////////////////////////////
+
+void ZombieSynChan::vSetGbar( const Eref& e , double Gbar )
+{
+    SynChan::vSetGbar( e, Gbar );
+    hsolve_->setSynChanGbar( e.id(), Gbar );
+}
+
+void ZombieSynChan::vSetGk( const Eref& e , double Gk )
+{
+    hsolve_->setAuxChannelGk( e.id(), Gk );
+}
+
+double ZombieSynChan::vGetGk( const Eref& e  ) const
+{
+    return hsolve_->getAuxChannelGk( e.id() );
+}
+
+void ZombieSynChan::vSetEk( const Eref& e , double Ek )
+{
+    ChanCommon::vSetEk( e, Ek );
+    hsolve_->setAuxChannelEk( e.id(), Ek );
+}
+
+void ZombieSynChan::vSetIk( const Eref& e , double Ik )
+{
+	;	// dummy
+}
+
+double ZombieSynChan::vGetIk( const Eref& e  ) const
+{
+    return hsolve_->getAuxChannelIk( e.id() );
+}
+
+void ZombieSynChan::vSetModulation( const Eref& e , double modulation )
+{
+    ChanCommon::vSetModulation( e, modulation );
+    hsolve_->setSynChanModulation( e.id(), modulation );
+}
+
+void ZombieSynChan::setTau1( double tau1 )
+{
+    SynChan::setTau1( tau1 );
+    hsolve_->setSynChanTau1( id_, tau1 );
+}
+
+void ZombieSynChan::setTau2( double tau2 )
+{
+    SynChan::setTau2( tau2 );
+    hsolve_->setSynChanTau2( id_, tau2 );
+}
+
+///////////////////////////////////////////////////
+// Dest function definitions
+///////////////////////////////////////////////////
+
+void ZombieSynChan::vProcess( const Eref& e, ProcPtr info )
+{
+    ;
+}
+
+void ZombieSynChan::vReinit( const Eref& er, ProcPtr info )
+{
+    ;
+}
+
+void ZombieSynChan::activation( double val )
+{
+    hsolve_->activateSynChan( id_, val );
+}
+
+///////////////////////////////////////////////////
+// Assign solver
+///////////////////////////////////////////////////
+void ZombieSynChan::vHandleVm( double Vm )
+{;}
+
+void ZombieSynChan::vSetSolver( const Eref& e , ObjId hsolve )
+{
+	if ( !hsolve.element()->cinfo()->isA( "HSolve" ) ) {
+		cout << "Error: ZombieSynChan::vSetSolver: Object: " <<
+				hsolve.path() << " is not an HSolve. Aborted\n";
+		hsolve_ = 0;
+		assert( 0 );
+		return;
+	}
+	hsolve_ = reinterpret_cast< HSolve* >( hsolve.data() );
+	id_ = e.id();
+}
@@ -0,0 +1,78 @@
+#ifndef _Zombie_SynChan_h
+#define _Zombie_SynChan_h
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment,
+** also known as GENESIS 3 base code.
+**           copyright (C) 2003-2014 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+*********************************************************************
+*/
+
+/**
+ * Zombie object that lets HSolve do its calculations, while letting the user
+ * interact with this object as if it were the original object.
+ *
+ * ZombieSynChan derives from SynChan, and keeps the parameters in its
+ * SynChan part as well, so that they are in place when the SynChan is
+ * given back. The conductance is computed by the HSolve from the
+ * activation that this object passes on.
+ */
+
+#include "../basecode/header.h"
+#include "HinesMatrix.h"
+#include "HSolveStruct.h"
+#include "HSolvePassive.h"
+#include "RateLookup.h"
+#include "HSolveActive.h"
+#include "HSolve.h"
+#include "../biophysics/ChanBase.h"
+#include "../biophysics/ChanCommon.h"
+#include "../biophysics/SynChan.h"
+
+class ZombieSynChan: public SynChan
+{
+public:
+    ZombieSynChan();
+
+    /////////////////////////////////////////////////////////////
+    // Value field access function definitions
+    /////////////////////////////////////////////////////////////
+
+    void vSetGbar( const Eref& e , double Gbar ) override;
+    void vSetGk( const Eref& e , double Gk ) override;
+    double vGetGk( const Eref& e  ) const override;
+    void vSetEk( const Eref& e , double Ek ) override;
+    void vSetIk( const Eref& e, double Ik ) override;
+    double vGetIk( const Eref& e  ) const override;
+    void vSetModulation( const Eref& e, double value ) override;
+    void setTau1( double tau1 ) override;
+    void setTau2( double tau2 ) override;
+
+    /////////////////////////////////////////////////////////////
+    // Dest function definitions
+    /////////////////////////////////////////////////////////////
+
+    void vProcess( const Eref& e, ProcPtr p ) override;
+    void vReinit( const Eref& e, ProcPtr p ) override;
+    void activation( double val ) override;
+
+    /////////////////////////////////////////////////////////////
+	// Dummy function, not needed in Zombie.
+	void vHandleVm( double Vm ) override;
+
+    /////////////////////////////////////////////////////////////
+	void vSetSolver( const Eref& e , ObjId hsolve ) override;
+
+    static const Cinfo* initCinfo();
+
+private:
+    HSolve* hsolve_;
+    /// tau1, tau2 and activation do not get an Eref.
+    Id id_;
+};
+
+
+#endif // _Zombie_SynChan_h
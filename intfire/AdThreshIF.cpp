@@ -100,35 +100,37 @@ AdThreshIF::~AdThreshIF()
 //////////////////////////////////////////////////////////////////
 
 void AdThreshIF::vProcess( const Eref& e, ProcPtr p )
+{
+	process< AdThreshIF >( e, p );
+}
+
+bool AdThreshIF::advance( double t, double dt )
 {
 	fired_ = false;
-	if ( p->currTime < lastEvent_ + refractT_ ) {
+	if ( t < lastEvent_ + refractT_ ) {
 		Vm_ = vReset_;
 		A_ = 0.0;
 		B_ = 1.0 / Rm_;
 		sumInject_ = 0.0;
-		VmOut()->send( e, Vm_ );
 	} else {
         // activation can be a continous variable (graded synapse).
         // So integrate it at every time step, thus *dt.
         // For a delta-fn synapse, SynHandler-s divide by dt and send activation.
         // See: http://www.genesis-sim.org/GENESIS/Hyperdoc/Manual-26.html#synchan
         //          for this continuous definition of activation.
-		Vm_ += activation_ * p->dt;
+		Vm_ += activation_ * dt;
 		activation_ = 0.0;
 		if ( Vm_ > (threshold_+threshAdaptive_) ) {
 			Vm_ = vReset_;
             threshAdaptive_ += threshJump_;
-			lastEvent_ = p->currTime;
+			lastEvent_ = t;
 			fired_ = true;
-			spikeOut()->send( e, p->currTime );
-			VmOut()->send( e, Vm_ );
 		} else {
-            threshAdaptive_ += (-threshAdaptive_ + a0_*(Vm_-Em_)) * p->dt/tauThresh_;
-			Compartment::vProcess( e, p );  // this sends out Vm message also,
-                                            // so do Vm_ calculations before
+            threshAdaptive_ += (-threshAdaptive_ + a0_*(Vm_-Em_)) * dt/tauThresh_;
+			integrate( dt );
 		}
 	}
+	return fired_;
 }
 
 void AdThreshIF::vReinit(  const Eref& e, ProcPtr p )
@@ -79,34 +79,36 @@ ExIF::~ExIF()
 //////////////////////////////////////////////////////////////////
 
 void ExIF::vProcess( const Eref& e, ProcPtr p )
+{
+	process< ExIF >( e, p );
+}
+
+bool ExIF::advance( double t, double dt )
 {
 	fired_ = false;
-	if ( p->currTime < lastEvent_ + refractT_ ) {
+	if ( t < lastEvent_ + refractT_ ) {
 		Vm_ = vReset_;
 		A_ = 0.0;
 		B_ = 1.0 / Rm_;
 		sumInject_ = 0.0;
-		VmOut()->send( e, Vm_ );
 	} else {
         // activation can be a continous variable (graded synapse).
         // So integrate it at every time step, thus *dt.
         // For a delta-fn synapse, SynHandler-s divide by dt and send activation.
         // See: http://www.genesis-sim.org/GENESIS/Hyperdoc/Manual-26.html#synchan
         //          for this continuous definition of activation.
-		Vm_ += activation_ * p->dt;
+		Vm_ += activation_ * dt;
 		activation_ = 0.0;
 		if ( Vm_ >= vPeak_ ) {
 			Vm_ = vReset_;
-			lastEvent_ = p->currTime;
+			lastEvent_ = t;
 			fired_ = true;
-			spikeOut()->send( e, p->currTime );
-			VmOut()->send( e, Vm_ );
 		} else {
-            Vm_ += deltaThresh_ * exp((Vm_-threshold_)/deltaThresh_) *p->dt/Rm_/Cm_;
-			Compartment::vProcess( e, p );  // this sends out Vm message also,
-                                            // so do calculations before
+            Vm_ += deltaThresh_ * exp((Vm_-threshold_)/deltaThresh_) *dt/Rm_/Cm_;
+			integrate( dt );
 		}
 	}
+	return fired_;
 }
 
 void ExIF::vReinit(  const Eref& e, ProcPtr p )
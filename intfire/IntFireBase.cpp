@@ -9,6 +9,7 @@
 
 #include "../basecode/header.h"
 #include "../basecode/ElementValueFinfo.h"
+#include "../utility/utility.h"
 #include "../biophysics/CompartmentBase.h"
 #include "../biophysics/Compartment.h"
 #include "IntFireBase.h"
@@ -61,6 +62,25 @@ const Cinfo* IntFireBase::initCinfo()
         "The object has fired within the last timestep",
         &IntFireBase::hasFired
     );
+    static ElementValueFinfo< IntFireBase, bool > population(
+        "population",
+        "When set on entry 0, all entries of this object are advanced "
+        "together in one loop, and VmOut is sent only if it has targets. "
+        "Only entry 0's value is used. Needs all the entries to be on "
+        "the same clock tick.",
+        &IntFireBase::setPopulation,
+        &IntFireBase::getPopulation
+    );
+
+    static ElementValueFinfo< IntFireBase, unsigned int > numThreads(
+        "numThreads",
+        "Number of threads used to advance the entries in population "
+        "mode. Only entry 0's value is used. Defaults to the "
+        "MOOSE_NUM_THREADS environment variable, or 1.",
+        &IntFireBase::setNumThreads,
+        &IntFireBase::getNumThreads
+    );
+
     //////////////////////////////////////////////////////////////
     // MsgDest Definitions
     //////////////////////////////////////////////////////////////
@@ -78,6 +98,8 @@ const Cinfo* IntFireBase::initCinfo()
         &refractoryPeriod,		// Value
         &hasFired,				// ReadOnlyValue
         &lastEventTime,			// ReadOnlyValue
+        &population,			// Value
+        &numThreads,			// Value
         &activation,			// DestFinfo
         IntFireBase::spikeOut() // MsgSrc
     };
@@ -115,7 +137,9 @@ IntFireBase::IntFireBase()
     activation_( 0.0 ),
     refractT_( 0.0 ),
     lastEvent_( 0.0 ),
-    fired_( false )
+    fired_( false ),
+    population_( false ),
+    numThreads_( moose::getEnvInt( "MOOSE_NUM_THREADS", 1 ) )
 {;}
 
 IntFireBase::~IntFireBase()
@@ -164,6 +188,40 @@ bool IntFireBase::hasFired( const Eref& e ) const
     return fired_;
 }
 
+void IntFireBase::getCheckpoint( vector< double >& state ) const
+{
+    state.assign( { activation_, lastEvent_, double( fired_ ) } );
+}
+
+void IntFireBase::setCheckpoint( const vector< double >& state )
+{
+    if ( state.size() != 3 )
+        return;
+    activation_ = state[0];
+    lastEvent_ = state[1];
+    fired_ = state[2] != 0.0;
+}
+
+void IntFireBase::setPopulation( const Eref& e, bool val )
+{
+    population_ = val;
+}
+
+bool IntFireBase::getPopulation( const Eref& e ) const
+{
+    return population_;
+}
+
+void IntFireBase::setNumThreads( const Eref& e, unsigned int val )
+{
+    numThreads_ = val < 1 ? 1 : val;
+}
+
+unsigned int IntFireBase::getNumThreads( const Eref& e ) const
+{
+    return numThreads_;
+}
+
 //////////////////////////////////////////////////////////////////
 // IntFireBase::Dest function definitions.
 //////////////////////////////////////////////////////////////////
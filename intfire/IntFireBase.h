@@ -11,6 +11,8 @@
 #ifndef _INT_FIRE_BASE_H
 #define _INT_FIRE_BASE_H
 
+#include "../utility/ThreadPool.h"
+
 namespace moose
 {
 /**
@@ -31,6 +33,14 @@ public:
     double getRefractoryPeriod( const Eref& e  ) const;
     double getLastEventTime( const Eref& e  ) const;
     bool hasFired( const Eref& e ) const;
+    void setPopulation( const Eref& e, bool val );
+    bool getPopulation( const Eref& e ) const;
+    void setNumThreads( const Eref& e, unsigned int val );
+    unsigned int getNumThreads( const Eref& e ) const;
+
+    /// State for checkpoints that is not in the fields.
+    void getCheckpoint( vector< double >& state ) const;
+    void setCheckpoint( const vector< double >& state );
 
     // Dest function definitions.
     /**
@@ -58,13 +68,80 @@ public:
      */
     static const Cinfo* initCinfo();
 protected:
+    /**
+     * Does the process step of a T, the derived class, which advances
+     * itself by T::advance without sending any messages. If entry 0 of
+     * the Element is in population mode, it advances all the entries at
+     * once instead, and the process calls on the others do nothing.
+     */
+    template< class T > void process( const Eref& e, ProcPtr p );
+
     double threshold_;
     double vReset_;
     double activation_;
     double refractT_;
     double lastEvent_;
     bool fired_;
+    bool population_;
+    unsigned int numThreads_;
+
+private:
+    template< class T > void processPopulation( const Eref& e, ProcPtr p );
 };
+
+template< class T > void IntFireBase::process( const Eref& e, ProcPtr p )
+{
+    Element* elm = e.element();
+    if ( elm->cinfo() == T::initCinfo() && elm->numLocalData() > 0 &&
+            reinterpret_cast< T* >( elm->data( 0 ) )->population_ )
+    {
+        if ( elm->rawIndex( e.dataIndex() ) == 0 )
+            processPopulation< T >( e, p );
+        return;
+    }
+
+    if ( static_cast< T* >( this )->advance( p->currTime, p->dt ) )
+        spikeOut()->send( e, p->currTime );
+    VmOut()->send( e, Vm_ );
+}
+
+/**
+ * The entries are advanced in one loop over the data array, spread over
+ * numThreads threads of the worker pool. Only then are spikes sent, and
+ * Vm is sent only if something receives it.
+ */
+template< class T >
+void IntFireBase::processPopulation( const Eref& e, ProcPtr p )
+{
+    Element* elm = e.element();
+    T* data = reinterpret_cast< T* >( elm->data( 0 ) );
+    const unsigned int n = elm->numLocalData();
+    const double t = p->currTime;
+    const double dt = p->dt;
+    auto run = [data, t, dt]( size_t begin, size_t end ) {
+        for ( size_t i = begin; i < end; ++i )
+            data[ i ].advance( t, dt );
+    };
+
+    size_t numThreads = std::min< size_t >( numThreads_, n );
+    if ( numThreads > 1 )
+    {
+        ThreadPool& pool = ThreadPool::global();
+        pool.reserve( numThreads );
+        pool.parallelFor( n, ThreadPool::grainSize( n, numThreads ), run,
+                numThreads );
+    }
+    else
+        run( 0, n );
+
+    const unsigned int start = elm->localDataStart();
+    for ( unsigned int i = 0; i < n; ++i )
+        if ( data[ i ].fired_ )
+            spikeOut()->send( Eref( elm, start + i ), t );
+    if ( elm->hasMsgs( VmOut()->getBindIndex() ) )
+        for ( unsigned int i = 0; i < n; ++i )
+            VmOut()->send( Eref( elm, start + i ), data[ i ].Vm_ );
+}
 } // namespace
 
 #endif // _INT_FIRE_BASE_H
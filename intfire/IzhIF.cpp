@@ -155,40 +155,41 @@ IzhIF::~IzhIF()
 //////////////////////////////////////////////////////////////////
 
 void IzhIF::vProcess( const Eref& e, ProcPtr p )
+{
+	process< IzhIF >( e, p );
+}
+
+bool IzhIF::advance( double t, double dt )
 {
     // fully taking over Compartment's vProcess due to quadratic term in Vm
     // we no longer care about A and B
 	fired_ = false;
-	if ( p->currTime < lastEvent_ + refractT_ ) {
+	if ( t < lastEvent_ + refractT_ ) {
 		Vm_ = vReset_;
 		sumInject_ = 0.0;
-		VmOut()->send( e, Vm_ );
 	} else {
         // activation can be a continous variable (graded synapse).
         // So integrate it at every time step, thus *dt.
         // For a delta-fn synapse, SynHandler-s divide by dt and send activation.
         // See: http://www.genesis-sim.org/GENESIS/Hyperdoc/Manual-26.html#synchan
         //          for this continuous definition of activation.
-		Vm_ += activation_ * p->dt;
+		Vm_ += activation_ * dt;
 		activation_ = 0.0;
 		if ( Vm_ > vPeak_ ) {
 			Vm_ = vReset_;
             u_ += d_;
-			lastEvent_ = p->currTime;
+			lastEvent_ = t;
 			fired_ = true;
-			spikeOut()->send( e, p->currTime );
-			VmOut()->send( e, Vm_ );
 		} else {
             Vm_ += ( (inject_+sumInject_) / Cm_
-                    + a0_*pow(Vm_,2.0) + b0_*Vm_ + c0_ - u_ ) * p->dt;
-            u_ += a_ * (b_*Vm_ - u_) * p->dt;
+                    + a0_*pow(Vm_,2.0) + b0_*Vm_ + c0_ - u_ ) * dt;
+            u_ += a_ * (b_*Vm_ - u_) * dt;
             lastIm_ = Im_;
             Im_ = 0.0;
             sumInject_ = 0.0;
-            // Send out Vm to channels, SpikeGens, etc.
-            VmOut()->send( e, Vm_ );
 		}
 	}
+	return fired_;
 }
 
 void IzhIF::vReinit(  const Eref& e, ProcPtr p )
@@ -58,15 +58,19 @@ LIF::~LIF()
 //////////////////////////////////////////////////////////////////
 
 void LIF::vProcess( const Eref& e, ProcPtr p )
+{
+    process< LIF >( e, p );
+}
+
+bool LIF::advance( double t, double dt )
 {
     fired_ = false;
-    if ( p->currTime < lastEvent_ + refractT_ )
+    if ( t < lastEvent_ + refractT_ )
     {
         Vm_ = vReset_;
         A_ = 0.0;
         B_ = 1.0 / Rm_;
         sumInject_ = 0.0;
-        VmOut()->send( e, Vm_ );
     }
     else
     {
@@ -75,21 +79,20 @@ void LIF::vProcess( const Eref& e, ProcPtr p )
         // For a delta-fn synapse, SynHandler-s divide by dt and send activation.
         // See: http://www.genesis-sim.org/GENESIS/Hyperdoc/Manual-26.html#synchan
         //          for this continuous definition of activation.
-        Vm_ += activation_ * p->dt;
+        Vm_ += activation_ * dt;
         activation_ = 0.0;
         if ( Vm_ > threshold_ )
         {
             Vm_ = vReset_;
-            lastEvent_ = p->currTime;
+            lastEvent_ = t;
             fired_ = true;
-            spikeOut()->send( e, p->currTime );
-            VmOut()->send( e, Vm_ );
         }
         else
         {
-            Compartment::vProcess( e, p );
+            integrate( dt );
         }
     }
+    return fired_;
 }
 
 void LIF::vReinit(  const Eref& e, ProcPtr p )
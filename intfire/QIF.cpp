@@ -79,38 +79,39 @@ QIF::~QIF()
 //////////////////////////////////////////////////////////////////
 
 void QIF::vProcess( const Eref& e, ProcPtr p )
+{
+	process< QIF >( e, p );
+}
+
+bool QIF::advance( double t, double dt )
 {
     // fully taking over Compartment's vProcess due to quadratic term in Vm
     // we no longer care about A and B
 	fired_ = false;
-	if ( p->currTime < lastEvent_ + refractT_ ) {
+	if ( t < lastEvent_ + refractT_ ) {
 		Vm_ = vReset_;
 		sumInject_ = 0.0;
-		VmOut()->send( e, Vm_ );
 	} else {
         // activation can be a continous variable (graded synapse).
         // So integrate it at every time step, thus *dt.
         // For a delta-fn synapse, SynHandler-s divide by dt and send activation.
         // See: http://www.genesis-sim.org/GENESIS/Hyperdoc/Manual-26.html#synchan
         //          for this continuous definition of activation.
-		Vm_ += activation_ * p->dt;
+		Vm_ += activation_ * dt;
 		activation_ = 0.0;
 		if ( Vm_ > threshold_ ) {
 			Vm_ = vReset_;
-			lastEvent_ = p->currTime;
+			lastEvent_ = t;
 			fired_ = true;
-			spikeOut()->send( e, p->currTime );
-			VmOut()->send( e, Vm_ );
 		} else {
             Vm_ += ( (inject_+sumInject_)
-                    + a0_*(Vm_-Em_)*(Vm_-vCritical_)/Rm_ ) * p->dt / Cm_;
+                    + a0_*(Vm_-Em_)*(Vm_-vCritical_)/Rm_ ) * dt / Cm_;
             lastIm_ = Im_;
             Im_ = 0.0;
             sumInject_ = 0.0;
-            // Send out Vm to channels, SpikeGens, etc.
-            VmOut()->send( e, Vm_ );
 		}
 	}
+	return fired_;
 }
 
 void QIF::vReinit(  const Eref& e, ProcPtr p )
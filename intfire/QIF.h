@@ -35,6 +35,12 @@ class QIF: public IntFireBase
 			 */
 			void vProcess( const Eref& e, ProcPtr p );
 
+			/**
+			 * Advances the state by one step of dt ending at t, without
+			 * sending any messages. Returns true if it fired.
+			 */
+			bool advance( double t, double dt );
+
 			/**
 			 * The reinit function reinitializes all fields.
 			 */
@@ -21,18 +21,57 @@
 
 #include <vector>
 #include <sstream>
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
 using namespace std;
 
 #include "FuncTerm.h"
 #include "../utility/numutil.h"
 
+/**
+ * Serials of the FuncTerms that exist, and the number retired so far.
+ * A thread prunes its cache of contexts whenever the count has changed
+ * since it last looked, so it never keeps pointers to contexts that are
+ * gone.
+ */
+static mutex serialMutex;
+static unsigned long nextSerial = 1;
+static unordered_set< unsigned long > liveSerials;
+static std::atomic< unsigned long > numRetired( 0 );
+
+/// Contexts used by one thread, by serial. FuncTerm::Context is private,
+/// so they are kept as void pointers.
+struct ContextCache
+{
+    unsigned long numRetired = 0;
+    unordered_map< unsigned long, void* > contexts;
+};
+static thread_local ContextCache contextCache;
+
+static unsigned long newSerial()
+{
+    lock_guard< mutex > lock( serialMutex );
+    liveSerials.insert( nextSerial );
+    return nextSerial++;
+}
+
+static void retireSerial( unsigned long serial )
+{
+    lock_guard< mutex > lock( serialMutex );
+    liveSerials.erase( serial );
+    ++numRetired;
+}
+
 FuncTerm::FuncTerm():
     reactantIndex_(1, 0) , volScale_(1.0) , target_(~0U) , args_(nullptr)
+    , serial_( newSerial() )
 {
 }
 
 FuncTerm::~FuncTerm()
 {
+    retireSerial( serial_ );
     if(args_)
         delete[] args_;
 }
@@ -57,6 +96,7 @@ void FuncTerm::setReactantIndex( const vector< unsigned int >& mol )
     args_[mol.size()] = 0.0;
     parser_.DefineVar( "t", &args_[mol.size()] );
     setExpr(expr_);
+    resetContexts();
 }
 
 const vector< unsigned int >& FuncTerm::getReactantIndex() const
@@ -90,6 +130,7 @@ void FuncTerm::setExpr( const string& expr )
         if(! parser_.SetExpr(expr))
             MOOSE_WARN("Failed to set expression: '" << expr << "'");
         expr_ = expr;
+        resetContexts();
     }
     catch(moose::Parser::exception_type &e)
     {
@@ -135,6 +176,66 @@ const FuncTerm& FuncTerm::operator=( const FuncTerm& other )
     return *this;
 }
 
+void FuncTerm::resetContexts()
+{
+    lock_guard< mutex > lock( contextMutex_ );
+    retireSerial( serial_ );
+    serial_ = newSerial();
+    contexts_.clear();
+}
+
+unsigned int FuncTerm::numCachedContexts()
+{
+    return contextCache.contexts.size();
+}
+
+FuncTerm::Context* FuncTerm::getContext() const
+{
+    ContextCache& cache = contextCache;
+    unsigned long retired = numRetired.load();
+    if ( retired != cache.numRetired )
+    {
+        lock_guard< mutex > lock( serialMutex );
+        for ( auto i = cache.contexts.begin(); i != cache.contexts.end(); )
+        {
+            if ( liveSerials.count( i->first ) )
+                ++i;
+            else
+                i = cache.contexts.erase( i );
+        }
+        cache.numRetired = retired;
+    }
+    auto i = cache.contexts.find( serial_ );
+    if ( i != cache.contexts.end() )
+        return static_cast< Context* >( i->second );
+
+    unique_ptr< Context > c( new Context );
+    unsigned int n = reactantIndex_.size();
+    c->args.assign( n + 1, 0.0 );
+    for ( unsigned int j = 0; j < n; ++j )
+        c->parser.DefineVar( 'x'+to_string(j), &c->args[j] );
+    c->parser.DefineVar( "t", &c->args[n] );
+    if ( !expr_.empty() )
+    {
+        try
+        {
+            c->parser.SetExpr( expr_ );
+        }
+        catch ( moose::Parser::exception_type& e )
+        {
+            // Already reported by setExpr. Evaluates to 0 like it did.
+        }
+    }
+
+    Context* ret = c.get();
+    {
+        lock_guard< mutex > lock( contextMutex_ );
+        contexts_.push_back( std::move( c ) );
+    }
+    cache.contexts[ serial_ ] = ret;
+    return ret;
+}
+
 /**
  * This computes the value. The time t is an argument needed by
  * some functions.
@@ -144,14 +245,15 @@ double FuncTerm::operator() ( const double* S, double t ) const
     if ( ! args_ )
         return 0.0;
 
+    Context* c = getContext();
     unsigned int i = 0;
     for ( i = 0; i < reactantIndex_.size(); ++i )
-        args_[i] = S[reactantIndex_[i]];
-    args_[i] = t;
+        c->args[i] = S[reactantIndex_[i]];
+    c->args[i] = t;
 
     try
     {
-        return parser_.Eval() * volScale_;
+        return c->parser.Eval() * volScale_;
     }
     catch (moose::Parser::exception_type &e )
     {
@@ -165,14 +267,15 @@ void FuncTerm::evalPool( double* S, double t ) const
     if ( !args_ || target_ == ~0U )
         return;
 
+    Context* c = getContext();
     unsigned int i;
     for ( i = 0; i < reactantIndex_.size(); ++i )
-        args_[i] = S[reactantIndex_[i]];
-    args_[i] = t;
+        c->args[i] = S[reactantIndex_[i]];
+    c->args[i] = t;
 
     try
     {
-        S[ target_] = parser_.Eval() * volScale_;
+        S[ target_] = c->parser.Eval() * volScale_;
         //assert(! std::isnan(S[target_]));
     }
     catch ( moose::Parser::exception_type & e )
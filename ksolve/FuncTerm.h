@@ -10,8 +10,20 @@
 #ifndef _FUNC_TERM_H
 #define _FUNC_TERM_H
 
+#include <mutex>
 #include "../builtins/MooseParser.h"
 
+/**
+ * A FuncTerm is shared by all the voxels of a solver, which may be
+ * advanced on several threads at once. The parser reads its arguments
+ * from memory bound at DefineVar, so evaluation cannot go through one
+ * shared argument array. Each thread that evaluates the term instead
+ * gets its own Context, a copy of the argument array with a parser
+ * compiled against it. Contexts are built on first use in a thread and
+ * dropped whenever the expression or the argument list changes. Each
+ * thread finds its contexts through a cache of its own, from which the
+ * entries of changed or deleted terms are pruned on its next lookup.
+ */
 class FuncTerm
 {
 public:
@@ -41,7 +53,23 @@ public:
     void setVolScale( double vs );
     double getVolScale() const;
 
+    /// Number of contexts in the calling thread's cache. Used in tests.
+    static unsigned int numCachedContexts();
+
 private:
+    /// Argument array and the parser bound to it, for one thread.
+    struct Context
+    {
+        vector< double > args;
+        moose::MooseParser parser;
+    };
+
+    /// Returns the calling thread's context, building it if needed.
+    Context* getContext() const;
+
+    /// Invalidates all contexts after a change of expression or args.
+    void resetContexts();
+
     // Look up reactants in the S vec.
     vector< unsigned int > reactantIndex_;
 
@@ -56,7 +84,19 @@ private:
     double* args_;
 
     string expr_;
+
+    /// Used to check the expression when it is set.
     moose::MooseParser parser_;
+
+    /**
+     * Key of this term in the per-thread context caches. It is never
+     * reused, and changes on resetContexts. The old key is retired, so
+     * that the caches drop its entry.
+     */
+    unsigned long serial_;
+
+    mutable std::mutex contextMutex_; /// Guards contexts_.
+    mutable vector< std::unique_ptr< Context > > contexts_;
 };
 
 #endif // _FUNC_TERM_H
@@ -30,27 +30,12 @@
 #include <chrono>
 #include <algorithm>
 
-#ifdef USE_BOOST_ASYNC
-#define BOOST_THREAD_PROVIDES_FUTURE
-#include <boost/thread.hpp>
-#include <boost/thread/future.hpp>
-#endif
-
-#include <future>
 #include <atomic>
-#include <thread>
-#include <functional>
 
+#include "../utility/ThreadPool.h"
 
 #define SIMPLE_ROUNDING 0
 
-// When set use std::async rather than std::thread. This is slightly faster
-// (roughly 3% with gcc7).
-#define USING_ASYNC 1
-#if USING_ASYNC
-#define THREAD_LAUNCH_POLICY std::launch::async
-#endif
-
 const unsigned int OFFNODE = ~0;
 
 const Cinfo* Gsolve::initCinfo()
@@ -139,6 +124,33 @@ const Cinfo* Gsolve::initCinfo()
         &Gsolve::setClockedUpdate,
         &Gsolve::getClockedUpdate
     );
+    static ValueFinfo< Gsolve, string > selectionMethod(
+        "selectionMethod",
+        "How the next reaction event is picked in each voxel.\n"
+        "linear: (default) scan the propensities in order, which takes "
+        "time proportional to the number of reactions.\n"
+        "tree: descend a sum tree of the propensities, which takes time "
+        "proportional to log(number of reactions). Faster for systems "
+        "with more than a few dozen reactions.\n"
+        "Both methods pick reactions with the same probabilities. They "
+        "add up the propensities in a different order, so a random "
+        "number within roundoff of a boundary between two reactions "
+        "may pick either, and runs with a fixed seed can differ "
+        "between the methods. The default keeps the results of seeded "
+        "runs as they were.",
+        &Gsolve::setSelectionMethod,
+        &Gsolve::getSelectionMethod
+    );
+
+    static ReadOnlyValueFinfo< Gsolve, vector< ObjId > > coupledObjects(
+        "coupledObjects",
+        "Solvers whose state this Gsolve touches during process, "
+        "that is, its Dsolve if any, the Dsolves joined to that by "
+        "junctions and their reac solvers. Used by the Clock to decide which "
+        "solvers may run on separate threads.",
+        &Gsolve::getCoupledObjects
+    );
+
     static ReadOnlyLookupValueFinfo<
     Gsolve, unsigned int, vector< unsigned int > > numFire(
         "numFire",
@@ -207,7 +219,9 @@ const Cinfo* Gsolve::initCinfo()
         // Here we put new fields that were not there in the Ksolve.
         &useRandInit,      // Value
         &useClockedUpdate, // Value
+        &selectionMethod,  // Value
         &numFire,          // ReadOnlyLookupValue
+        &coupledObjects,   // ReadOnlyValue
     };
 
     static Dinfo< Gsolve > dinfo;
@@ -230,6 +244,7 @@ static const Cinfo* gsolveCinfo = Gsolve::initCinfo();
 
 Gsolve::Gsolve() :
     numThreads_ ( 1 ),
+    grainSize_ ( 1 ),
     pools_( 1 ),
     startVoxel_( 0 ),
     dsolve_(),
@@ -248,7 +263,7 @@ Gsolve& Gsolve::operator=(const Gsolve& )
 
 Gsolve::~Gsolve()
 {
-    ;
+    detachDsolveState();
 }
 
 //////////////////////////////////////////////////////////////
@@ -268,6 +283,7 @@ void Gsolve::setCompartment( Id compt )
         vector< double > vols = Field< vector< double > >::get( compt, "voxelVolume" );
         if ( vols.size() > 0 )
         {
+            detachDsolveState();
             pools_.resize( vols.size() );
             for ( unsigned int i = 0; i < vols.size(); ++i )
             {
@@ -316,10 +332,23 @@ void Gsolve::setNumAllVoxels( unsigned int numVoxels )
     {
         return;
     }
+    detachDsolveState();
     pools_.resize( numVoxels );
     sys_.isReady = false;
 }
 
+void Gsolve::setLocalVoxels( unsigned int start, unsigned int num )
+{
+    assert( start >= startVoxel_ );
+    assert( start + num <= startVoxel_ + pools_.size() );
+    detachDsolveState();
+    unsigned int first = start - startVoxel_;
+    pools_.erase( pools_.begin() + first + num, pools_.end() );
+    pools_.erase( pools_.begin(), pools_.begin() + first );
+    startVoxel_ = start;
+    sys_.isReady = false;
+}
+
 vector< double > Gsolve::getNvec( unsigned int voxel) const
 {
     static vector< double > dummy;
@@ -373,6 +402,23 @@ void Gsolve::setRandInit( bool val )
     sys_.useRandInit = val;
 }
 
+string Gsolve::getSelectionMethod() const
+{
+    return sys_.useSumTree ? "tree" : "linear";
+}
+
+void Gsolve::setSelectionMethod( string method )
+{
+    if ( method == "tree" )
+        sys_.useSumTree = true;
+    else if ( method == "linear" )
+        sys_.useSumTree = false;
+    else
+        cout << "Warning: Gsolve::setSelectionMethod: '" << method
+             << "' not known, using '" << getSelectionMethod() << "'. "
+             << "Options are 'tree' and 'linear'." << endl;
+}
+
 bool Gsolve::getClockedUpdate() const
 {
     return useClockedUpdate_;
@@ -395,7 +441,24 @@ void Gsolve::process( const Eref& e, ProcPtr p )
 
     // First, handle incoming diffusion values. Note potential for
     // issues with roundoff if diffusion is not integral.
-    if ( dsolvePtr_ )
+    const bool sharedState = dsolvePtr_ && dsolvePtr_->isStateShared();
+    if ( sharedState )
+    {
+        // The Dsolve has diffused straight into our voxels. Round them
+        // in place, pool by pool as the block used to be laid out, so
+        // the random number sequence is the same as with the copy.
+        dsolvePtr_->setPrev();
+        const unsigned int numVarPools = stoichPtr_->getNumVarPools();
+        for ( unsigned int j = 0; j < numVarPools; ++j )
+        {
+            for ( auto i = pools_.begin(); i != pools_.end(); ++i )
+            {
+                double* s = i->varS();
+                s[j] = approximateWithInteger( s[j], rng_ );
+            }
+        }
+    }
+    else if ( dsolvePtr_ )
     {
         vector< double > dvalues( 4 );
         dvalues[0] = 0;
@@ -440,41 +503,15 @@ void Gsolve::process( const Eref& e, ProcPtr p )
     }
     else
     {
-        /*-----------------------------------------------------------------------------
-         *  Somewhat complicated computation to compute the number of threads. 1
-         *  thread per (at least) voxel pool is ideal situation.
-         *-----------------------------------------------------------------------------*/
-#if USING_ASYNC
-        vector<std::future<size_t>> vecFutures;
-        for (size_t i = 0; i < numThreads_; i++) 
-            vecFutures.push_back( 
-                std::async( THREAD_LAUNCH_POLICY
-                    , [this, i, p](){ 
-                        return this->advance_chunk(i*this->grainSize_, (i+1)*this->grainSize_, p); 
-                    })
-                );
-        // Block in same order
-        size_t tot = 0;
-        for (auto& fut : vecFutures) tot += fut.get();
-        // We have processed all the pools.
-        assert( tot >= pools_.size() );
-#else
-        vector<std::thread> vecThreads;
-        for (size_t i = 0; i < numThreads_; i++)
-        {
-            // Use lambda. It is roughly 10% faster than std::bind and does not
-            // involve copying data.
-            vecThreads.push_back( 
-                std::thread( 
-                    [this, i, p](){ this->advance_chunk(i*this->grainSize_, (i+1)*this->grainSize_, p); }
-                    )
-                );
-        }
-
-        for( auto &v : vecThreads )
-            v.join();
-#endif
-
+        // Voxel chunks go to the persistent worker pool shared with Ksolve.
+        // Chunks are claimed dynamically, so busy voxels do not hold up
+        // threads that finish early.
+        std::atomic<size_t> tot( 0 );
+        moose::ThreadPool::global().parallelFor( pools_.size(), grainSize_,
+                [this, p, &tot]( size_t begin, size_t end ) {
+                    tot += this->advance_chunk( begin, end, p );
+                }, numThreads_ );
+        assert( tot == pools_.size() );
     }
 
     if ( useClockedUpdate_ )   // Check if a clocked stim is to be updated
@@ -486,43 +523,19 @@ void Gsolve::process( const Eref& e, ProcPtr p )
         }
         else
         {
-#if USING_ASYNC
-        vector<std::future<size_t>> vecFutures;
-        for (size_t i = 0; i < numThreads_; i++) 
-            vecFutures.push_back( 
-                std::async( THREAD_LAUNCH_POLICY
-                    , [this, i, p](){ 
-                        return this->recalcTimeChunk(i*this->grainSize_, (i+1)*this->grainSize_, p); 
-                    })
-                );
-        // Block in same order
-        size_t tot = 0;
-        for (auto& fut : vecFutures) tot += fut.get();
-        assert( tot >= pools_.size() ); // We have processed all the pools.
-#else
-            vector<std::thread> vecThreads;
-
-            for (size_t i = 0; i < numThreads_; i++)
-            {
-                // Use lambda. It is roughly 10% faster than std::bind and does not
-                // involve copying data.
-                vecThreads.push_back( 
-                        std::thread( 
-                            [this, i, p](){ 
-                                this->recalcTimeChunk(i*this->grainSize_, (i+1)*this->grainSize_, p); 
-                            }
-                        )
-                    );
-            }
-            for( auto &v : vecThreads )
-                v.join();
-#endif
-
+            moose::ThreadPool::global().parallelFor( pools_.size(), grainSize_,
+                    [this, p]( size_t begin, size_t end ) {
+                        this->recalcTimeChunk( begin, end, p );
+                    }, numThreads_ );
         }
     }
 
     // Finally, assemble and send the integrated values off for the Dsolve.
-    if ( dsolvePtr_ )
+    if ( sharedState )
+    {
+        dsolvePtr_->updateJunctions( p->dt );
+    }
+    else if ( dsolvePtr_ )
     {
         vector< double > kvalues( 4 );
         kvalues[0] = 0;
@@ -541,7 +554,7 @@ void Gsolve::process( const Eref& e, ProcPtr p )
 
 size_t Gsolve::recalcTimeChunk( const size_t begin, const size_t end, ProcPtr p)
 {
-    assert( begin >= std::min(pools_.size(), end));
+    assert( begin <= std::min(pools_.size(), end));
 
     size_t tot = 0;
     for (size_t i = begin; i < std::min(pools_.size(), end); i++)  {
@@ -580,17 +593,39 @@ void Gsolve::reinit( const Eref& e, ProcPtr p )
         i->refreshAtot( &sys_ );
 
 
-    // LoadBalancing. Recompute the optimal number of threads.
+    // LoadBalancing. There is no point in more threads than voxels.
     size_t nvPools = pools_.size( );
-    grainSize_ = (size_t) std::ceil((double)nvPools / (double)numThreads_);
-    assert( grainSize_ * numThreads_ >= nvPools);
-    numThreads_ = (size_t) std::ceil((double)nvPools / (double)grainSize_);
-    // MOOSE_DEBUG( "Grain size is " << grainSize_ << ". Num threads " << numThreads_);
+    if( numThreads_ > nvPools )
+        numThreads_ = std::max<size_t>( 1, nvPools );
+    grainSize_ = moose::ThreadPool::grainSize( nvPools, numThreads_ );
 
     if(1 < numThreads_)
+    {
+        moose::ThreadPool::global().reserve( numThreads_ );
         cout << "Info: Setting up threaded gsolve with " << getNumThreads( )
              << " threads. " << endl;
+    }
 
+    // The Dsolve has been reinited by now, on its earlier tick.
+    attachDsolveState();
+}
+
+/// See Ksolve::attachDsolveState.
+void Gsolve::attachDsolveState()
+{
+    detachDsolveState();
+    if ( !dsolvePtr_ || !stoichPtr_ || pools_.size() == 0 )
+        return;
+    vector< double* > voxelS( pools_.size() );
+    for ( unsigned int i = 0; i < pools_.size(); ++i )
+        voxelS[i] = pools_[i].varS();
+    dsolvePtr_->attachState( voxelS, stoichPtr_->getNumVarPools() );
+}
+
+void Gsolve::detachDsolveState()
+{
+    if ( dsolvePtr_ && dsolve_.element() )
+        dsolvePtr_->detachState();
 }
 
 //////////////////////////////////////////////////////////////
@@ -918,6 +953,7 @@ unsigned int Gsolve::getVoxelIndex( const Eref& e ) const
 
 void Gsolve::setDsolve( Id dsolve )
 {
+    detachDsolveState();
     if ( dsolve == Id () )
     {
         dsolvePtr_ = 0;
@@ -936,6 +972,11 @@ void Gsolve::setDsolve( Id dsolve )
     }
 }
 
+vector< ObjId > Gsolve::getCoupledObjects() const
+{
+    return dsolveCoupledObjects( dsolve_ );
+}
+
 
 //////////////////////////////////////////////////////////////
 // Pool Access functions
@@ -1018,6 +1059,7 @@ double Gsolve::getDiffConst( const Eref& e ) const
 
 void Gsolve::setNumPools( unsigned int numPoolSpecies )
 {
+    detachDsolveState();
     sys_.isReady = false;
     unsigned int numVoxels = pools_.size();
     for ( unsigned int i = 0 ; i < numVoxels; ++i )
@@ -1082,6 +1124,23 @@ void Gsolve::setBlock( const vector< double >& values )
     }
 }
 
+void Gsolve::getCheckpoint( vector< double >& state ) const
+{
+    KsolveBase::getCheckpoint( state );
+    for ( const GssaVoxelPools& vp : pools_ )
+        vp.getCheckpoint( state );
+}
+
+void Gsolve::setCheckpoint( const vector< double >& state )
+{
+    KsolveBase::setCheckpoint( state );
+    if ( state.size() < 4 )
+        return;
+    size_t pos = 4 + state[1] * state[3];
+    for ( GssaVoxelPools& vp : pools_ )
+        pos = vp.setCheckpoint( state, pos );
+}
+
 //////////////////////////////////////////////////////////////////////////
 void Gsolve::updateVoxelVol( vector< double > vols )
 {
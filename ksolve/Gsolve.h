@@ -39,6 +39,8 @@ public:
      * system. Note that fewer than this may be used on any given node.
      */
     void setNumAllVoxels( unsigned int num );
+    /// Inherited from KsolveBase.
+    void setLocalVoxels( unsigned int start, unsigned int num );
 
     /**
      * Assigns number of different pools (chemical species) present in
@@ -92,6 +94,9 @@ public:
      */
     void setDsolve( Id dsolve );
 
+    /// Inherited from KsolveBase. Returns the Dsolve, if any.
+    vector< ObjId > getCoupledObjects() const;
+
     //////////////////////////////////////////////////////////////////
     // KsolveBase inherited functions
     //////////////////////////////////////////////////////////////////
@@ -108,6 +113,10 @@ public:
     void getBlock( vector< double >& values ) const;
     void setBlock( const vector< double >& values );
 
+    /// Adds the event time, propensities and RNG of each voxel.
+    void getCheckpoint( vector< double >& state ) const;
+    void setCheckpoint( const vector< double >& state );
+
     /**
      * Rescale specified voxel rate term following rate constant change
      * or volume change. If index == ~0U then does all terms.
@@ -118,12 +127,21 @@ public:
     size_t advance_chunk( const size_t begin, const size_t end, ProcPtr p );
     size_t recalcTimeChunk( const size_t begin, const size_t end, ProcPtr p);
 
+    /// Shares the voxel S arrays with the Dsolve, if there is one.
+    void attachDsolveState();
+    /// Undoes attachDsolveState.
+    void detachDsolveState();
+
     //////////////////////////////////////////////////////////////////
     /// Flag: returns true if randomized round to integers is done.
     bool getRandInit() const;
     /// Flag: set true if randomized round to integers is to be done.
     void setRandInit( bool val );
 
+    /// Reaction selection method: "linear" (default) or "tree".
+    string getSelectionMethod() const;
+    void setSelectionMethod( string method );
+
     /// Flag: returns true if randomized round to integers is done.
     bool getClockedUpdate() const;
     /// Flag: set true if randomized round to integers is to be done.
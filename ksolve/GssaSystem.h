@@ -20,7 +20,8 @@ class GssaSystem
 {
 public:
     GssaSystem()
-        : stoich(0), useRandInit(true), isReady(false), honorMassConservation(true)
+        : stoich(0), useRandInit(true), isReady(false), honorMassConservation(true),
+          useSumTree(true)
     {;}
     vector< vector< unsigned int > > dependency;
     vector< vector< unsigned int > > dependentMathExpn;
@@ -53,6 +54,13 @@ public:
      * the sum of molecules is does not differ more than 1.0 molecules.
      */
     bool honorMassConservation = true;
+
+    /**
+     * Flag: True to pick reactions by descending a sum tree of the
+     * propensities (O(log R) per event). False uses the original linear
+     * scan (O(R) per event), which keeps seeded runs as they were.
+     */
+    bool useSumTree = false;
 };
 
 #endif	// _GSSA_SYSTEM_H
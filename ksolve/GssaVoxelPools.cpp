@@ -19,6 +19,7 @@
 #include "KsolveBase.h"
 #include "Stoich.h"
 #include "GssaSystem.h"
+#include "PropensityTree.h"
 #include "GssaVoxelPools.h"
 
 /**
@@ -40,7 +41,8 @@ const double SAFETY_FACTOR = 1.0 + 1.0e-9;
 
 
 // Class definitions
-GssaVoxelPools::GssaVoxelPools(): VoxelPoolsBase(), t_( 0.0 ), atot_( 0.0 )
+GssaVoxelPools::GssaVoxelPools():
+    VoxelPoolsBase(), t_( 0.0 ), atot_( 0.0 ), useSumTree_( false )
 {;}
 
 GssaVoxelPools::~GssaVoxelPools()
@@ -88,21 +90,37 @@ void GssaVoxelPools::updateDependentRates(
     {
         atot_ -= fabs( v_[ *i ] );
         atot_ += fabs( v_[ *i ] = getReacVelocity( *i, S() ) );
+        if ( useSumTree_ )
+            tree_.update( *i, v_[ *i ] );
     }
 }
 
+void GssaVoxelPools::setUseSumTree( bool val )
+{
+    useSumTree_ = val;
+    if ( val )
+        tree_.assign( v_ );
+}
+
 
 unsigned int GssaVoxelPools::pickReac()
 {
     double r = rng_.uniform( ) * atot_;
-    double sum = 0.0;
 
-    // This is an inefficient way to do it. Can easily get to
-    // log time or thereabouts by doing one or two levels of
-    // subsidiary tables. Too many levels causes slow-down because
-    // of overhead in managing the tree.
-    // Slepoy, Thompson and Plimpton 2008
-    // report a linear time version.
+    // Descend the sum tree in log time. It picks the same reaction as
+    // the scan below except when r is within roundoff of a boundary
+    // between two reactions. The scan remains as the fallback for the
+    // rare case where roundoff puts r at the very edge of the total.
+    if ( useSumTree_ )
+    {
+        unsigned int i = tree_.pick( r );
+        if ( i < v_.size() )
+            return i;
+    }
+
+    // Linear scan. Slepoy, Thompson and Plimpton 2008
+    // report a constant time version.
+    double sum = 0.0;
     for ( auto i = v_.cbegin(); i != v_.end(); ++i )
     {
         if ( r < ( sum += fabs( *i ) ) )
@@ -120,6 +138,8 @@ void GssaVoxelPools::setNumReac( unsigned int n )
     v_.clear();
     v_.resize( n, 0.0 );
     numFire_.resize( n, 0 );
+    if ( useSumTree_ )
+        tree_.assign( v_ );
 }
 
 /**
@@ -131,6 +151,9 @@ bool GssaVoxelPools::refreshAtot( const GssaSystem* g )
 {
     g->stoich->updateFuncs( varS(), t_ );
     updateReacVelocities( g, S(), v_ );
+    useSumTree_ = g->useSumTree;
+    if ( useSumTree_ )
+        tree_.assign( v_ );
     atot_ = 0;
     for ( auto i = v_.cbegin(); i != v_.cend(); ++i )
         atot_ += fabs(*i);
@@ -162,6 +185,8 @@ void GssaVoxelPools::recalcTime( const GssaSystem* g, double currTime )
 void GssaVoxelPools::advance( const ProcInfo* p, const GssaSystem* g )
 {
     double nextt = p->currTime;
+    if ( useSumTree_ != g->useSumTree )
+        setUseSumTree( g->useSumTree );
     while ( t_ < nextt )
     {
         if ( atot_ <= 0.0 )   // reac system is stuck, will not advance.
@@ -329,6 +354,45 @@ void GssaVoxelPools::setStoich( const Stoich* stoichPtr )
     stoichPtr_ = stoichPtr;
 }
 
+void GssaVoxelPools::getCheckpoint( vector< double >& state ) const
+{
+    state.push_back( t_ );
+    state.push_back( atot_ );
+    state.push_back( v_.size() );
+    state.insert( state.end(), v_.begin(), v_.end() );
+    state.insert( state.end(), numFire_.begin(), numFire_.end() );
+    string rng = rng_.getState();
+    size_t pos = state.size();
+    state.resize( pos + Conv< string >::size( rng ) );
+    double* buf = &state[ pos ];
+    Conv< string >::val2buf( rng, &buf );
+}
+
+size_t GssaVoxelPools::setCheckpoint( const vector< double >& state,
+        size_t pos )
+{
+    if ( pos + 3 > state.size() )
+        return state.size();
+    double t = state[ pos ];
+    double atot = state[ pos + 1 ];
+    size_t n = state[ pos + 2 ];
+    pos += 3;
+    if ( n != v_.size() || pos + 2 * n >= state.size() )
+        return state.size();
+    t_ = t;
+    atot_ = atot;
+    v_.assign( state.begin() + pos, state.begin() + pos + n );
+    pos += n;
+    numFire_.assign( state.begin() + pos, state.begin() + pos + n );
+    pos += n;
+    double* buf = const_cast< double* >( &state[ pos ] );
+    const double* start = buf;
+    rng_.setState( Conv< string >::buf2val( &buf ) );
+    if ( useSumTree_ )
+        tree_.assign( v_ );
+    return pos + ( buf - start );
+}
+
 // Handle volume updates. Inherited virtual func.
 void GssaVoxelPools::setVolumeAndDependencies( double vol )
 {
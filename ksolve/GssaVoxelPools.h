@@ -11,6 +11,7 @@
 #define _GSSA_VOXEL_POOLS_BASE_H
 
 #include "../randnum/RNG.h"
+#include "PropensityTree.h"
 
 class Stoich;
 
@@ -32,6 +33,9 @@ public:
 
     unsigned int pickReac();
 
+    /// Turns the sum tree for reaction picking on or off.
+    void setUseSumTree( bool val );
+
     void setNumReac( unsigned int n );
 
     void advance( const ProcInfo* p, const GssaSystem* g );
@@ -74,6 +78,14 @@ public:
 
     void setStoich( const Stoich* stoichPtr );
 
+    /**
+     * Appends the time of the next event, the propensities and the RNG
+     * state, for checkpoints. setCheckpoint reads them back from pos on
+     * and returns the position after them.
+     */
+    void getCheckpoint( vector< double >& state ) const;
+    size_t setCheckpoint( const vector< double >& state, size_t pos );
+
 private:
     /// Time at which next event will occur.
     double t_;
@@ -90,6 +102,12 @@ private:
     vector< double > v_;
     // Possibly we should put independent RNGS, so save one here.
 
+    /// Flag: True when tree_ is kept in step with v_ and used by pickReac.
+    bool useSumTree_;
+
+    /// Sum tree over |v_|, for O(log R) reaction picking.
+    PropensityTree tree_;
+
     // Count how many times each reaction has fired.
     vector< unsigned int > numFire_;
 
@@ -37,10 +37,9 @@
 #include <chrono>
 #include <algorithm>
 
-#include <future>
-#include <functional>
 #include <atomic>
-#include <thread>
+
+#include "../utility/ThreadPool.h"
 
 using namespace std::chrono;
 map< Id, unsigned int > Ksolve::defaultPoolLookup_;
@@ -61,7 +60,9 @@ const Cinfo* Ksolve::initCinfo()
         "rk2: The Runge-Kutta 2,3 embedded fixed dt method"
         "rkck: The Runge-Kutta Cash-Karp (4,5) method"
         "rk8: The Runge-Kutta Prince-Dormand (8,9) method"
-        "lsoda: LSODA method",
+        "lsoda: LSODA method"
+        "rosenbrock: Implicit 2nd order Rosenbrock (ROS2) adaptive dt "
+        "method with a sparse analytical Jacobian, for stiff models",
         &Ksolve::setMethod,
         &Ksolve::getMethod
     );
@@ -143,6 +144,15 @@ const Cinfo* Ksolve::initCinfo()
         &Ksolve::getStoich
     );
 
+    static ReadOnlyValueFinfo< Ksolve, vector< ObjId > > coupledObjects(
+        "coupledObjects",
+        "Solvers whose state this Ksolve touches during process, "
+        "that is, its Dsolve if any, the Dsolves joined to that by "
+        "junctions and their reac solvers. Used by the Clock to decide which "
+        "solvers may run on separate threads.",
+        &Ksolve::getCoupledObjects
+    );
+
 
     // DestFinfo definitions
     static DestFinfo process( "process",
@@ -212,6 +222,7 @@ const Cinfo* Ksolve::initCinfo()
         &numPools,                       // Value
         &estimatedDt,                    // ReadOnlyValue
         &stoich,                         // ReadOnlyValue
+        &coupledObjects,                 // ReadOnlyValue
         &voxelVol,                       // DestFinfo
         &proc,                           // SharedFinfo
         &init,                           // SharedFinfo
@@ -241,6 +252,7 @@ Ksolve::Ksolve()
     epsAbs_( 1e-7 ),
     epsRel_( 1e-7 ),
     numThreads_( 1 ),
+    grainSize_( 1 ),
     pools_( 1 ),
     startVoxel_( 0 ),
     dsolve_(),
@@ -252,7 +264,7 @@ Ksolve::Ksolve()
 
 Ksolve::~Ksolve()
 {
-    ;
+    detachDsolveState();
 }
 
 //////////////////////////////////////////////////////////////
@@ -285,7 +297,8 @@ void Ksolve::setMethod( string method )
         method_ = "rk5";
     }
     else if ( method == "rk4"  || method == "rk2" ||
-              method == "rk8" || method == "rkck" || method == "lsoda" )
+              method == "rk8" || method == "rkck" || method == "lsoda" ||
+              method == "rosenbrock" )
     {
         method_ = method;
     }
@@ -431,8 +444,14 @@ Id Ksolve::getDsolve() const
     return dsolve_;
 }
 
+vector< ObjId > Ksolve::getCoupledObjects() const
+{
+    return dsolveCoupledObjects( dsolve_ );
+}
+
 void Ksolve::setDsolve( Id dsolve )
 {
+    detachDsolveState();
     if ( dsolve == Id () )
     {
         dsolvePtr_ = nullptr;
@@ -468,9 +487,21 @@ void Ksolve::setNumAllVoxels( unsigned int numVoxels )
     {
         return;
     }
+    detachDsolveState();
     pools_.resize( numVoxels );
 }
 
+void Ksolve::setLocalVoxels( unsigned int start, unsigned int num )
+{
+    assert( start >= startVoxel_ );
+    assert( start + num <= startVoxel_ + pools_.size() );
+    detachDsolveState();
+    unsigned int first = start - startVoxel_;
+    pools_.erase( pools_.begin() + first + num, pools_.end() );
+    pools_.erase( pools_.begin(), pools_.begin() + first );
+    startVoxel_ = start;
+}
+
 vector< double > Ksolve::getNvec( unsigned int voxel) const
 {
     static vector< double > dummy;
@@ -567,7 +598,14 @@ void Ksolve::process( const Eref& e, ProcPtr p )
     //t0_ = high_resolution_clock::now();
 
     // First, handle incoming diffusion values, update S with those.
-    if ( dsolvePtr_ )
+    // If the Dsolve works directly on our voxel arrays, they already
+    // hold the diffused values and only 'prev' needs to be set.
+    const bool sharedState = dsolvePtr_ && dsolvePtr_->isStateShared();
+    if ( sharedState )
+    {
+        dsolvePtr_->setPrev();
+    }
+    else if ( dsolvePtr_ )
     {
         vector< double > dvalues( 4 );
         dvalues[0] = 0;
@@ -595,28 +633,22 @@ void Ksolve::process( const Eref& e, ProcPtr p )
     }
     else
     {
-        std::vector<std::future<size_t>> vecFutures;
-
-        // lambdas is faster than std::bind
-        for (auto interval : intervals_)
-        {
-            vecFutures.push_back( 
-                    std::async( std::launch::async
-                        , &Ksolve::advance_chunk
-                        , this
-                        , interval.first
-                        , interval.second, p 
-                        )
-                    );
-        }
-        size_t tot = 0;
-        for (auto &v : vecFutures )
-            tot += v.get();
+        // Voxel chunks are handed out to the persistent worker pool, which
+        // is shared with Gsolve and lives across clock steps.
+        std::atomic<size_t> tot( 0 );
+        moose::ThreadPool::global().parallelFor( pools_.size(), grainSize_,
+                [this, p, &tot]( size_t begin, size_t end ) {
+                    tot += this->advance_chunk( begin, end, p );
+                }, numThreads_ );
         assert(tot == pools_.size());
     }
 
     // Assemble and send the integrated values off for the Dsolve.
-    if ( dsolvePtr_ )
+    if ( sharedState )
+    {
+        dsolvePtr_->updateJunctions( p->dt );
+    }
+    else if ( dsolvePtr_ )
     {
         vector< double > kvalues( 4 );
         kvalues[0] = 0;
@@ -659,8 +691,16 @@ void Ksolve::reinit( const Eref& e, ProcPtr p )
 
     if ( isBuilt_ )
     {
+        // The reaction system may have been rebuilt since the last reinit.
+        stiff_.clear();
+        if ( method_ == "rosenbrock" )
+            stiff_.build( stoichPtr_->getRateTerms(),
+                          stoichPtr_->getStoichiometryMatrix(),
+                          stoichPtr_->getNumVarPools() +
+                          stoichPtr_->getNumProxyPools() );
         for ( unsigned int i = 0 ; i < pools_.size(); ++i ) {
             pools_[i].setNumVoxels( pools_.size() );
+            pools_[i].setStiffSystem( &stiff_ );
             pools_[i].reinit( p->dt );
 		}
     }
@@ -677,9 +717,39 @@ void Ksolve::reinit( const Eref& e, ProcPtr p )
         cout << "Info: Multi-threaded Ksolve (" << numThreads_ << " threads)."
             << endl;
 
-    // Recompute the partition of interval.
-    intervals_.clear();
-    moose::splitIntervalInNParts(pools_.size(), numThreads_, intervals_);
+    // Recompute the chunk size and make sure the shared pool is big enough.
+    grainSize_ = moose::ThreadPool::grainSize( pools_.size(), numThreads_ );
+    if(numThreads_ > 1)
+        moose::ThreadPool::global().reserve( numThreads_ );
+
+    // The Dsolve has been reinited by now, on its earlier tick.
+    attachDsolveState();
+}
+
+/**
+ * Lets the Dsolve diffuse directly in the S arrays of our voxels, so that
+ * process does not have to copy and transpose the whole state into and
+ * out of the Dsolve on every step. The Dsolve copies its own values in
+ * as it attaches, which is what the first getBlock used to do.
+ */
+void Ksolve::attachDsolveState()
+{
+    detachDsolveState();
+    if ( !dsolvePtr_ || !stoichPtr_ || pools_.size() == 0 )
+        return;
+    vector< double* > voxelS( pools_.size() );
+    for ( unsigned int i = 0; i < pools_.size(); ++i )
+        voxelS[i] = pools_[i].varS();
+    dsolvePtr_->attachState( voxelS, stoichPtr_->getNumVarPools() );
+}
+
+/// Must be called before anything that could move our S arrays.
+void Ksolve::detachDsolveState()
+{
+    // The Dsolve may have been deleted already, in which case its Id
+    // no longer leads to an Element.
+    if ( dsolvePtr_ && dsolve_.element() )
+        dsolvePtr_->detachState();
 }
 
 //////////////////////////////////////////////////////////////
@@ -802,6 +872,7 @@ double Ksolve::getDiffConst( const Eref& e ) const
 
 void Ksolve::setNumPools( unsigned int numPoolSpecies )
 {
+    detachDsolveState();
     unsigned int numVoxels = pools_.size();
     for ( unsigned int i = 0 ; i < numVoxels; ++i )
     {
@@ -811,6 +882,7 @@ void Ksolve::setNumPools( unsigned int numPoolSpecies )
 
 void Ksolve::setNumVarTotPools( unsigned int var, unsigned int tot )
 {
+    detachDsolveState();
     unsigned int numVoxels = pools_.size();
     for ( unsigned int i = 0 ; i < numVoxels; ++i )
     {
@@ -921,6 +993,25 @@ void Ksolve::setBlock( const vector< double >& values )
     }
 }
 
+void Ksolve::getCheckpoint( vector< double >& state ) const
+{
+    KsolveBase::getCheckpoint( state );
+    for ( const VoxelPools& vp : pools_ )
+        state.push_back( vp.getStepSize() );
+}
+
+void Ksolve::setCheckpoint( const vector< double >& state )
+{
+    KsolveBase::setCheckpoint( state );
+    if ( state.size() < 4 )
+        return;
+    size_t pos = 4 + state[1] * state[3];
+    if ( pos + pools_.size() > state.size() )
+        return;
+    for ( VoxelPools& vp : pools_ )
+        vp.setStepSize( state[ pos++ ] );
+}
+
 void Ksolve::updateVoxelVol( vector< double > vols )
 {
     // For now we assume identical numbers of voxels. Also assume
@@ -11,6 +11,7 @@
 #define _KSOLVE_H
 
 #include <chrono>
+#include "StiffSystem.h"
 
 using namespace std::chrono;
 
@@ -49,6 +50,9 @@ public:
     Id getDsolve() const;
     void setDsolve( Id dsolve ); /// Inherited from KsolveBase.
 
+    /// Inherited from KsolveBase. Returns the Dsolve, if any.
+    vector< ObjId > getCoupledObjects() const;
+
     unsigned int getNumLocalVoxels() const;
     unsigned int getNumAllVoxels() const;
     /**
@@ -56,6 +60,8 @@ public:
      * system. Note that fewer than this may be used on any given node.
      */
     void setNumAllVoxels( unsigned int num );
+    /// Inherited from KsolveBase.
+    void setLocalVoxels( unsigned int start, unsigned int num );
 
     /// Returns the vector of pool Num at the specified voxel.
     vector< double > getNvec( unsigned int voxel) const;
@@ -69,6 +75,11 @@ public:
 
     void advance_pool( const size_t i, ProcPtr p );
 
+    /// Shares the voxel S arrays with the Dsolve, if there is one.
+    void attachDsolveState();
+    /// Undoes attachDsolveState.
+    void detachDsolveState();
+
     /**
      * This does a quick and dirty estimate of the timestep suitable
      * for this sytem
@@ -125,6 +136,10 @@ public:
     void getBlock( vector< double >& values ) const;
     void setBlock( const vector< double >& values );
 
+    /// Adds the step size of each voxel to the pool numbers.
+    void getCheckpoint( vector< double >& state ) const;
+    void setCheckpoint( const vector< double >& state );
+
     void matchJunctionVols( vector< double >& vols, Id otherCompt )
     const;
 
@@ -160,6 +175,10 @@ private:
      * @brief Number of threads to use. Only applicable for deterministic case.
      */
     size_t numThreads_;
+
+    /**
+     * @brief Number of voxels per chunk handed to the shared thread pool.
+     */
     size_t grainSize_;
 
     /**
@@ -171,6 +190,9 @@ private:
      */
     vector< VoxelPools > pools_;
 
+    /// Jacobian layout shared by all voxels for the "rosenbrock" method.
+    StiffSystem stiff_;
+
     /// First voxel indexed on the current node.
     unsigned int startVoxel_;
 
@@ -191,8 +213,6 @@ private:
     // Time taken in all process function in us.
     double totalTime_ = 0.0;
 
-    vector<std::pair<size_t, size_t>> intervals_;
-
     //high_resolution_clock::time_point t0_, t1_;
 	
 	static map< Id, unsigned int > defaultPoolLookup_;
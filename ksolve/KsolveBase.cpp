@@ -39,6 +39,48 @@ void KsolveBase::updateJunctions( double dt )
 void KsolveBase::setPrev()
 {;}
 
+bool KsolveBase::attachState( const vector< double* >& voxelS,
+                              unsigned int numPools )
+{
+    return false;
+}
+
+void KsolveBase::detachState()
+{;}
+
+bool KsolveBase::isStateShared() const
+{
+    return false;
+}
+
+vector< ObjId > KsolveBase::getCoupledObjects() const
+{
+    return vector< ObjId >();
+}
+
+vector< ObjId > KsolveBase::dsolveCoupledObjects( Id dsolve )
+{
+    vector< ObjId > ret;
+    if ( dsolve == Id() )
+        return ret;
+    ret.push_back( dsolve );
+    // The junctions of the Dsolve write into the pools of the Dsolves
+    // across them, which are the arrays of their reac solvers.
+    vector< ObjId > partners = Field< vector< ObjId > >::get(
+                dsolve, "coupledObjects" );
+    for ( const ObjId& obj : partners )
+    {
+        ret.push_back( obj );
+        if ( obj.element()->cinfo()->isA( "Dsolve" ) )
+        {
+            vector< ObjId > other = Field< vector< ObjId > >::get(
+                        obj, "coupledObjects" );
+            ret.insert( ret.end(), other.begin(), other.end() );
+        }
+    }
+    return ret;
+}
+
 /////////////////////////////////////////////////////////////////////
 
 Id KsolveBase::getCompartment() const
@@ -78,3 +120,26 @@ void KsolveBase::notifyAddMsgSrcPool( const Eref& e, ObjId msgId )
 void KsolveBase::notifyAddMsgDestPool( const Eref& e, ObjId msgId )
 {;}
 
+void KsolveBase::getCheckpoint( vector< double >& state ) const
+{
+    state.assign( 4, 0.0 );
+    state[1] = getNumLocalVoxels();
+    state[3] = getNumPools();
+    if ( state[1] > 0 && state[3] > 0 )
+        getBlock( state );
+}
+
+void KsolveBase::setCheckpoint( const vector< double >& state )
+{
+    if ( state.size() < 4 || state[1] != getNumLocalVoxels() ||
+            state[3] != getNumPools() )
+        return;
+    // Derived solvers append their own state after the block.
+    size_t n = 4 + state[1] * state[3];
+    if ( state.size() < n || n == 4 )
+        return;
+    if ( state.size() == n )
+        setBlock( state );
+    else
+        setBlock( vector< double >( state.begin(), state.begin() + n ) );
+}
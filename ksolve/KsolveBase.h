@@ -61,6 +61,13 @@ public:
     virtual void setNumAllVoxels( unsigned int numVoxels ) = 0;
     /// Number of voxels here. pools_.size() == getNumLocalVoxels
     virtual unsigned int getNumLocalVoxels() const = 0;
+    /**
+     * Keeps only voxels start to start + num on this node, out of the
+     * ones here now. Used by Shell::loadBalance. Solvers that cannot
+     * split their voxels over nodes ignore it.
+     */
+    virtual void setLocalVoxels( unsigned int start, unsigned int num )
+    {;}
     /// Return a pointer to the specified VoxelPool.
     virtual VoxelPoolsBase* pools( unsigned int i ) = 0;
 
@@ -125,6 +132,37 @@ public:
 
     /// Used to tell Dsolver to assign 'prev' values.
     virtual void setPrev();
+
+    /**
+     * Asks the Dsolver to work directly on the reac solver's state
+     * instead of its own copy. voxelS[i] is the S array of local voxel
+     * i, and pool j of the Dsolver is entry j of each array, for
+     * j < numPools. The arrays must stay put until detachState.
+     * Returns false if the layouts do not match, in which case the
+     * caller must go on using getBlock and setBlock.
+     */
+    virtual bool attachState( const vector< double* >& voxelS,
+                              unsigned int numPools );
+
+    /// Stops sharing state. The Dsolver keeps the current values.
+    virtual void detachState();
+
+    /// True while attachState is in effect.
+    virtual bool isStateShared() const;
+
+    /**
+     * Returns the other solvers whose state is read or written during
+     * this solver's process call. The Clock uses this to decide which
+     * solvers on a tick can safely run on different threads.
+     */
+    virtual vector< ObjId > getCoupledObjects() const;
+
+    /**
+     * The Dsolve, the Dsolves it has junctions with, and their reac
+     * solvers. A reac solver that updates the junctions of its Dsolve
+     * touches all of these.
+     */
+    static vector< ObjId > dsolveCoupledObjects( Id dsolve );
     /**
      * Informs the solver that the rate terms or volumes have changed
      * and that the parameters must be updated.
@@ -136,6 +174,14 @@ public:
     /// Return pool index, using Stoich ptr to do lookup.
     virtual unsigned int getPoolIndex( const Eref& er ) const = 0;
 
+    /**
+     * State of the solver for checkpoints. The default is the block of
+     * all pools in all local voxels. Solvers with more state than that
+     * append it, and setCheckpoint reads back what getCheckpoint wrote.
+     */
+    virtual void getCheckpoint( vector< double >& state ) const;
+    virtual void setCheckpoint( const vector< double >& state );
+
     //////////////////////////////////////////////////////////////
 protected:
     /**
@@ -0,0 +1,72 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2026 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include <vector>
+#include <cmath>
+#include <cassert>
+
+using namespace std;
+
+#include "PropensityTree.h"
+
+PropensityTree::PropensityTree()
+    : n_( 0 ), base_( 1 ), node_( 2, 0.0 )
+{;}
+
+void PropensityTree::assign( const vector< double >& v )
+{
+    n_ = v.size();
+    base_ = 1;
+    while ( base_ < n_ )
+        base_ <<= 1;
+    node_.assign( 2 * base_, 0.0 );
+    for ( unsigned int i = 0; i < n_; ++i )
+        node_[ base_ + i ] = fabs( v[i] );
+    for ( unsigned int k = base_ - 1; k > 0; --k )
+        node_[k] = node_[ 2 * k ] + node_[ 2 * k + 1 ];
+}
+
+void PropensityTree::update( unsigned int i, double v )
+{
+    assert( i < n_ );
+    unsigned int k = base_ + i;
+    node_[k] = fabs( v );
+    for ( k >>= 1; k > 0; k >>= 1 )
+        node_[k] = node_[ 2 * k ] + node_[ 2 * k + 1 ];
+}
+
+unsigned int PropensityTree::pick( double r ) const
+{
+    if ( !( r < node_[1] ) )
+        return n_;
+    unsigned int k = 1;
+    while ( k < base_ )
+    {
+        k <<= 1;
+        if ( !( r < node_[k] ) )
+        {
+            r -= node_[k];
+            ++k;
+        }
+    }
+    unsigned int i = k - base_;
+    if ( i >= n_ || node_[k] <= 0.0 )
+        return n_;
+    return i;
+}
+
+double PropensityTree::total() const
+{
+    return node_[1];
+}
+
+unsigned int PropensityTree::size() const
+{
+    return n_;
+}
@@ -0,0 +1,60 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2026 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _PROPENSITY_TREE_H
+#define _PROPENSITY_TREE_H
+
+/**
+ * Binary sum tree over the absolute reaction propensities of one
+ * voxel, used by the GSSA to pick the next reaction in O(log R) time
+ * instead of a linear scan.
+ * Leaves hold |v[i]|, every internal node holds the sum of its two
+ * children. Internal nodes are recomputed from their children rather
+ * than adjusted by differences, so the tree does not accumulate drift.
+ */
+class PropensityTree
+{
+public:
+    PropensityTree();
+
+    /// Rebuilds the whole tree from the propensity vector.
+    void assign( const vector< double >& v );
+
+    /// Sets leaf i to |v| and refreshes its ancestors.
+    void update( unsigned int i, double v );
+
+    /**
+     * Returns the smallest index i for which r < sum_{j<=i} |v[j]|.
+     * The sums are added up pairwise down the tree rather than left to
+     * right as in the linear scan, so the two can pick neighbouring
+     * reactions when r lies within roundoff of a boundary. The choice
+     * is statistically the same, but runs with a fixed seed may differ
+     * between the two methods. Returns size() if r is not below the
+     * total, or if roundoff steers the descent onto an empty leaf. The
+     * caller should then fall back to the linear scan.
+     */
+    unsigned int pick( double r ) const;
+
+    /// Sum of all leaves.
+    double total() const;
+
+    unsigned int size() const;
+
+private:
+    /// Number of reactions.
+    unsigned int n_;
+
+    /// Index of the first leaf. A power of two >= n_.
+    unsigned int base_;
+
+    /// node_[1] is the root; children of k are 2k and 2k+1.
+    vector< double > node_;
+};
+
+#endif // _PROPENSITY_TREE_H
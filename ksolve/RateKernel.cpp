@@ -0,0 +1,245 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2026 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include <typeinfo>
+#include <limits>
+#include <cmath>
+#include "../basecode/header.h"
+#include "RateTerm.h"
+#include "RateKernel.h"
+
+RateKernel::RateKernel()
+    : numRates_( 0 )
+{;}
+
+/// Returns the number of reactants, used to place the backward term.
+unsigned int RateKernel::addMassAction( const ZeroOrder* term,
+                                        unsigned int reac, bool backward,
+                                        unsigned int pos )
+{
+    const std::type_info& t = typeid( *term );
+    vector< unsigned int > mol;
+    term->getReactants( mol );
+    if ( t == typeid( ZeroOrder ) || t == typeid( FirstOrder ) ||
+            t == typeid( SecondOrder ) )
+    {
+        assert( mol.size() <= 2 );
+        Fixed& f = order_[ backward ][ mol.size() ];
+        f.reac.push_back( reac );
+        f.k.push_back( term->getR1() );
+        f.pos.push_back( pos );
+        if ( mol.size() > 0 )
+            f.s1.push_back( mol[0] );
+        if ( mol.size() > 1 )
+            f.s2.push_back( mol[1] );
+    }
+    else
+    {
+        assert( t == typeid( NOrder ) );
+        Variable& n = nOrder_[ backward ];
+        if ( n.start.empty() )
+            n.start.push_back( 0 );
+        n.reac.push_back( reac );
+        n.k.push_back( term->getR1() );
+        n.pos.push_back( pos );
+        n.mol.insert( n.mol.end(), mol.begin(), mol.end() );
+        n.start.push_back( n.mol.size() );
+    }
+    return mol.size();
+}
+
+/// Returns the term if it is one of the plain mass-action classes.
+static const ZeroOrder* massAction( const RateTerm* term )
+{
+    const std::type_info& t = typeid( *term );
+    if ( t == typeid( ZeroOrder ) || t == typeid( FirstOrder ) ||
+            t == typeid( SecondOrder ) || t == typeid( NOrder ) )
+        return static_cast< const ZeroOrder* >( term );
+    return 0;
+}
+
+void RateKernel::build( const vector< RateTerm* >& rates )
+{
+    *this = RateKernel();
+    numRates_ = rates.size();
+    genericStart_.push_back( 0 );
+    for ( unsigned int r = 0; r < rates.size(); ++r )
+    {
+        const RateTerm* term = rates[r];
+        if ( !term )
+        {
+            genericReac_.push_back( r );
+            generic_.push_back( 0 );
+            genericStart_.push_back( genericMol_.size() );
+            continue;
+        }
+        if ( const ZeroOrder* f = massAction( term ) )
+        {
+            addMassAction( f, r, false, 0 );
+            continue;
+        }
+        if ( typeid( *term ) == typeid( BidirectionalReaction ) )
+        {
+            const BidirectionalReaction* b =
+                static_cast< const BidirectionalReaction* >( term );
+            const ZeroOrder* f = massAction( b->getForward() );
+            const ZeroOrder* g = massAction( b->getBackward() );
+            if ( f && g )
+            {
+                unsigned int numFwd = addMassAction( f, r, false, 0 );
+                addMassAction( g, r, true, numFwd );
+                continue;
+            }
+        }
+        genericReac_.push_back( r );
+        generic_.push_back( term );
+        vector< unsigned int > mol;
+        term->getReactants( mol );
+        genericMol_.insert( genericMol_.end(), mol.begin(), mol.end() );
+        genericStart_.push_back( genericMol_.size() );
+    }
+}
+
+/// v[r] = x on the forward pass, v[r] -= x on the backward one.
+template< bool BACKWARD > static inline void store( double& v, double x )
+{
+    if ( BACKWARD )
+        v -= x;
+    else
+        v = x;
+}
+
+template< bool BACKWARD >
+void RateKernel::pass( const double* S, double* v ) const
+{
+    const Fixed& f0 = order_[BACKWARD][0];
+    for ( unsigned int i = 0; i < f0.k.size(); ++i )
+        store< BACKWARD >( v[ f0.reac[i] ], f0.k[i] );
+
+    const Fixed& f1 = order_[BACKWARD][1];
+    const unsigned int n1 = f1.k.size();
+    const double* k1 = f1.k.data();
+    const unsigned int* a1 = f1.s1.data();
+    const unsigned int* r1 = f1.reac.data();
+    for ( unsigned int i = 0; i < n1; ++i )
+        store< BACKWARD >( v[ r1[i] ], k1[i] * S[ a1[i] ] );
+
+    const Fixed& f2 = order_[BACKWARD][2];
+    const unsigned int n2 = f2.k.size();
+    const double* k2 = f2.k.data();
+    const unsigned int* a2 = f2.s1.data();
+    const unsigned int* b2 = f2.s2.data();
+    const unsigned int* r2 = f2.reac.data();
+    for ( unsigned int i = 0; i < n2; ++i )
+        store< BACKWARD >( v[ r2[i] ], k2[i] * S[ a2[i] ] * S[ b2[i] ] );
+
+    const Variable& fn = nOrder_[BACKWARD];
+    for ( unsigned int i = 0; i < fn.k.size(); ++i )
+    {
+        double rate = fn.k[i];
+        for ( unsigned int j = fn.start[i]; j < fn.start[i+1]; ++j )
+            rate *= S[ fn.mol[j] ];
+        store< BACKWARD >( v[ fn.reac[i] ], rate );
+    }
+}
+
+void RateKernel::velocities( const double* S, double* v ) const
+{
+    // Every BidirectionalReaction has its forward term in the first
+    // pass, so the second pass always subtracts from an assigned value.
+    pass< false >( S, v );
+    pass< true >( S, v );
+
+    for ( unsigned int i = 0; i < generic_.size(); ++i )
+        v[ genericReac_[i] ] = generic_[i] ? ( *generic_[i] )( S ) : 0.0;
+}
+
+/// dv = x on the forward pass, dv = -x on the backward one.
+template< bool BACKWARD > static inline void storePartial( double& dv, double x )
+{
+    dv = BACKWARD ? -x : x;
+}
+
+template< bool BACKWARD >
+void RateKernel::partialPass( const double* S, const unsigned int* start,
+                              double* dv ) const
+{
+    const Fixed& f1 = order_[BACKWARD][1];
+    for ( unsigned int i = 0; i < f1.k.size(); ++i )
+        storePartial< BACKWARD >( dv[ start[ f1.reac[i] ] + f1.pos[i] ],
+                                  f1.k[i] );
+
+    const Fixed& f2 = order_[BACKWARD][2];
+    for ( unsigned int i = 0; i < f2.k.size(); ++i )
+    {
+        double* d = dv + start[ f2.reac[i] ] + f2.pos[i];
+        storePartial< BACKWARD >( d[0], f2.k[i] * S[ f2.s2[i] ] );
+        storePartial< BACKWARD >( d[1], f2.k[i] * S[ f2.s1[i] ] );
+    }
+
+    const Variable& fn = nOrder_[BACKWARD];
+    for ( unsigned int i = 0; i < fn.k.size(); ++i )
+    {
+        double* d = dv + start[ fn.reac[i] ] + fn.pos[i];
+        for ( unsigned int j = fn.start[i]; j < fn.start[i+1]; ++j )
+        {
+            double x = fn.k[i];
+            for ( unsigned int m = fn.start[i]; m < fn.start[i+1]; ++m )
+                if ( m != j )
+                    x *= S[ fn.mol[m] ];
+            storePartial< BACKWARD >( d[ j - fn.start[i] ], x );
+        }
+    }
+}
+
+void RateKernel::partials( double* S, const unsigned int* start,
+                           double* dv ) const
+{
+    partialPass< false >( S, start, dv );
+    partialPass< true >( S, start, dv );
+
+    // Forward differences for the rest. A pool that appears twice in the
+    // reactant list gets the whole derivative in its first slot.
+    static const double sqrtEps = sqrt( std::numeric_limits< double >::epsilon() );
+    for ( unsigned int i = 0; i < generic_.size(); ++i )
+    {
+        if ( !generic_[i] )
+            continue;
+        const RateTerm& term = *generic_[i];
+        double* d = dv + start[ genericReac_[i] ];
+        const unsigned int begin = genericStart_[i];
+        const unsigned int end = genericStart_[i+1];
+        const double v0 = term( S );
+        for ( unsigned int j = begin; j < end; ++j )
+        {
+            const unsigned int mol = genericMol_[j];
+            if ( find( genericMol_.begin() + begin, genericMol_.begin() + j,
+                       mol ) != genericMol_.begin() + j )
+            {
+                d[ j - begin ] = 0.0;
+                continue;
+            }
+            const double orig = S[ mol ];
+            const double h = sqrtEps * std::max( fabs( orig ), 1.0 );
+            S[ mol ] = orig + h;
+            d[ j - begin ] = ( term( S ) - v0 ) / h;
+            S[ mol ] = orig;
+        }
+    }
+}
+
+unsigned int RateKernel::numRates() const
+{
+    return numRates_;
+}
+
+unsigned int RateKernel::numGeneric() const
+{
+    return generic_.size();
+}
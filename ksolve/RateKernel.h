@@ -0,0 +1,95 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2026 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _RATE_KERNEL_H
+#define _RATE_KERNEL_H
+
+class RateTerm;
+class ZeroOrder;
+
+/**
+ * Flattened form of the RateTerm vector of one voxel, used by
+ * VoxelPools::updateRates to compute reaction velocities without a
+ * virtual call and a pointer chase per reaction.
+ *
+ * Mass-action terms (ZeroOrder, FirstOrder, SecondOrder, NOrder and
+ * BidirectionalReactions made of them) are split by direction and order
+ * into structure-of-arrays groups: contiguous rate constants and
+ * substrate indices, one loop per group, which the compiler can turn
+ * into gathered SIMD loops. Forward groups assign v[r] and backward
+ * groups then subtract from it, so the velocities are bit for bit what
+ * the RateTerms compute. Anything else (enzymes, functions, externals)
+ * is kept as a pointer into the voxel's rates_ vector and evaluated
+ * through the virtual call as before.
+ */
+class RateKernel
+{
+public:
+    RateKernel();
+
+    /// Rebuilds from the voxel's rate terms. Must be redone whenever
+    /// any entry of rates is replaced or rescaled.
+    void build( const vector< RateTerm* >& rates );
+
+    /// Fills v[0..numRates) with the velocity of each rate term.
+    void velocities( const double* S, double* v ) const;
+
+    /**
+     * Fills the partial derivatives of each velocity with respect to its
+     * reactants: dv[ start[r] + k ] is d v_r / d S[ mol_k ], where mol is
+     * the getReactants list of the reference term r. Slots of terms with
+     * fewer reactants here, such as cross-compartment terms replaced by
+     * ExternReac, are left alone, so dv should be zeroed first. Mass
+     * action terms are differentiated analytically, the others by
+     * finite differences, which is why S is perturbed and restored.
+     */
+    void partials( double* S, const unsigned int* start, double* dv ) const;
+
+    unsigned int numRates() const;
+    /// Number of terms that still go through RateTerm::operator().
+    unsigned int numGeneric() const;
+
+private:
+    /// Terms of one direction, order 0, 1 or 2.
+    struct Fixed
+    {
+        vector< unsigned int > reac;
+        vector< double > k;
+        vector< unsigned int > s1;
+        vector< unsigned int > s2;
+        vector< unsigned int > pos; /// First reactant slot within the term.
+    };
+    /// Terms of one direction and arbitrary order.
+    struct Variable
+    {
+        vector< unsigned int > reac;
+        vector< double > k;
+        vector< unsigned int > start; /// Offset into mol, size+1 entries.
+        vector< unsigned int > mol;
+        vector< unsigned int > pos;
+    };
+
+    unsigned int addMassAction( const ZeroOrder* term, unsigned int reac,
+                                bool backward, unsigned int pos );
+    template< bool BACKWARD >
+    void pass( const double* S, double* v ) const;
+    template< bool BACKWARD >
+    void partialPass( const double* S, const unsigned int* start,
+                      double* dv ) const;
+
+    unsigned int numRates_;
+    Fixed order_[2][3]; /// [backward][order]
+    Variable nOrder_[2]; /// [backward]
+    vector< unsigned int > genericReac_;
+    vector< const RateTerm* > generic_;
+    vector< unsigned int > genericStart_; /// Offset into genericMol_.
+    vector< unsigned int > genericMol_;
+};
+
+#endif // _RATE_KERNEL_H
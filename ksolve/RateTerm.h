@@ -657,6 +657,16 @@ public:
         return new BidirectionalReaction( f, b );
     }
 
+    const ZeroOrder* getForward() const
+    {
+        return forward_;
+    }
+
+    const ZeroOrder* getBackward() const
+    {
+        return backward_;
+    }
+
 private:
     ZeroOrder* forward_;
     ZeroOrder* backward_;
@@ -0,0 +1,174 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2026 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include <cmath>
+#include "../basecode/header.h"
+#include "StiffSystem.h"
+#include "Rosenbrock.h"
+
+// ROS2 coefficients, in the form used by KPP.
+static const double GAMMA = 1.0 + 1.0 / sqrt( 2.0 );
+static const double A21 = 1.0 / GAMMA;
+static const double C21 = -2.0 / GAMMA;
+static const double M1 = 3.0 / ( 2.0 * GAMMA );
+static const double M2 = 1.0 / ( 2.0 * GAMMA );
+static const double E1 = 1.0 / ( 2.0 * GAMMA );
+static const double E2 = 1.0 / ( 2.0 * GAMMA );
+
+// Step size control.
+static const double SAFETY = 0.9;
+static const double FAC_MIN = 0.2;
+static const double FAC_MAX = 6.0;
+static const double H_MIN = 1.0e-14;
+
+/// Scratch space, shared by all voxels advanced on one thread.
+struct RosenbrockWork
+{
+    vector< double > f;
+    vector< double > k1;
+    vector< double > k2;
+    vector< double > ytmp;
+    vector< double > dv;
+    vector< double > jac;
+    vector< double > w;
+    vector< double > lu;
+
+    void resize( const StiffSystem& sys, unsigned int numAll )
+    {
+        f.resize( numAll );
+        k1.resize( numAll );
+        k2.resize( numAll );
+        ytmp.resize( numAll );
+        dv.resize( sys.numPartials() );
+        jac.resize( sys.numEntries() );
+        w.resize( sys.numEntries() );
+        lu.resize( sys.size() );
+    }
+};
+
+static thread_local RosenbrockWork work_;
+
+Rosenbrock::Rosenbrock()
+    : h_( 0.0 ), numSteps_( 0 ), numRejected_( 0 )
+{;}
+
+void Rosenbrock::reinit( double h )
+{
+    h_ = h;
+    numSteps_ = 0;
+    numRejected_ = 0;
+}
+
+bool Rosenbrock::advance( const StiffSystem& sys, double* y,
+                          unsigned int numAll, double t, double tEnd,
+                          double epsAbs, double epsRel,
+                          RosenbrockRates rates, RosenbrockPartials partials,
+                          void* params )
+{
+    const unsigned int n = sys.size();
+    assert( n <= numAll );
+    RosenbrockWork& ws = work_;
+    ws.resize( sys, numAll );
+    if ( h_ <= 0.0 )
+        h_ = ( tEnd - t ) / 10.0;
+
+    while ( t < tEnd )
+    {
+        // Don't leave a sliver of a step at the end. A step shortened to
+        // land on tEnd says nothing about the natural step size.
+        const double remaining = tEnd - t;
+        bool truncated = h_ >= remaining * ( 1.0 - 1e-12 );
+        double h = truncated ? remaining : h_;
+        bool rejected = false;
+        if ( h < H_MIN * std::max( 1.0, fabs( t ) ) )
+            return false;
+
+        rates( t, y, ws.f.data(), params );
+        std::fill( ws.dv.begin(), ws.dv.end(), 0.0 );
+        partials( t, y, ws.dv.data(), params );
+        sys.assemble( ws.dv.data(), ws.jac.data() );
+
+        for ( ; ; )
+        {
+            if ( !sys.factor( ws.jac.data(), 1.0 / ( h * GAMMA ),
+                              ws.w.data(), ws.lu.data() ) )
+            {
+                h *= FAC_MIN;
+                h_ = h;
+                ++numRejected_;
+                rejected = true;
+                truncated = false;
+                if ( h < H_MIN * std::max( 1.0, fabs( t ) ) )
+                    return false;
+                continue;
+            }
+            sys.solve( ws.w.data(), ws.f.data(), ws.k1.data(), ws.lu.data() );
+
+            std::copy( y, y + numAll, ws.ytmp.begin() );
+            for ( unsigned int i = 0; i < n; ++i )
+                ws.ytmp[i] += A21 * ws.k1[i];
+            rates( t + h, ws.ytmp.data(), ws.k2.data(), params );
+            for ( unsigned int i = 0; i < n; ++i )
+                ws.k2[i] += ( C21 / h ) * ws.k1[i];
+            sys.solve( ws.w.data(), ws.k2.data(), ws.k2.data(),
+                       ws.lu.data() );
+
+            // Scaled RMS norm of the embedded error estimate.
+            double err = 0.0;
+            for ( unsigned int i = 0; i < n; ++i )
+            {
+                double ynew = y[i] + M1 * ws.k1[i] + M2 * ws.k2[i];
+                ws.ytmp[i] = ynew;
+                double scale = epsAbs +
+                               epsRel * std::max( fabs( y[i] ), fabs( ynew ) );
+                double e = ( E1 * ws.k1[i] + E2 * ws.k2[i] ) / scale;
+                err += e * e;
+            }
+            err = n > 0 ? sqrt( err / n ) : 0.0;
+
+            double fac = std::isfinite( err ) ?
+                         SAFETY / sqrt( std::max( err, 1.0e-10 ) ) : FAC_MIN;
+            fac = std::min( FAC_MAX, std::max( FAC_MIN, fac ) );
+            if ( err <= 1.0 )
+            {
+                std::copy( ws.ytmp.begin(), ws.ytmp.begin() + n, y );
+                t = truncated ? tEnd : t + h;
+                ++numSteps_;
+                // Don't grow straight after a rejection.
+                double hNew = h * ( rejected ? std::min( fac, 1.0 ) : fac );
+                if ( !truncated || hNew < h_ )
+                    h_ = hNew;
+                break;
+            }
+            h *= fac;
+            h_ = h;
+            ++numRejected_;
+            rejected = true;
+            truncated = false;
+            if ( h < H_MIN * std::max( 1.0, fabs( t ) ) )
+                return false;
+        }
+    }
+    return true;
+}
+
+double Rosenbrock::getStepSize() const
+{
+    return h_;
+}
+
+unsigned int Rosenbrock::getNumSteps() const
+{
+    return numSteps_;
+}
+
+unsigned int Rosenbrock::getNumRejected() const
+{
+    return numRejected_;
+}
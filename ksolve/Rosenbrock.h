@@ -0,0 +1,65 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2026 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _ROSENBROCK_H
+#define _ROSENBROCK_H
+
+class StiffSystem;
+
+/// Fills dydt from y at time t. y may be updated for function pools.
+typedef void ( *RosenbrockRates )( double t, double* y, double* dydt,
+                                   void* params );
+/// Fills the rate term partials dv, laid out as in StiffSystem.
+typedef void ( *RosenbrockPartials )( double t, double* y, double* dv,
+                                      void* params );
+
+/**
+ * Adaptive linearly implicit integrator for stiff reaction systems,
+ * used by the Ksolve "rosenbrock" method. One of these lives in each
+ * voxel and only holds the step size, which carries over from one
+ * clock tick to the next. Work space is per thread.
+ *
+ * This is the two stage, second order, L-stable ROS2 scheme of Verwer
+ * et al. (1999), with gamma = 1 + 1/sqrt(2) and an embedded first order
+ * error estimate. ROS2 keeps its order for any approximation of the
+ * Jacobian, which matters here since rates that depend on function
+ * pools only enter J through their reactants. Each step needs two rate
+ * evaluations, one Jacobian and one sparse LU factorization of
+ *     W = I / ( h.gamma ) - J
+ * whose symbolic part is shared through the StiffSystem.
+ */
+class Rosenbrock
+{
+public:
+    Rosenbrock();
+
+    /// Sets the first trial step size.
+    void reinit( double h );
+
+    /**
+     * Advances y from t to tEnd. y has numAll entries, of which the
+     * first sys.size() are integrated and the rest are passed through.
+     * Returns false if the step size underflows.
+     */
+    bool advance( const StiffSystem& sys, double* y, unsigned int numAll,
+                  double t, double tEnd, double epsAbs, double epsRel,
+                  RosenbrockRates rates, RosenbrockPartials partials,
+                  void* params );
+
+    double getStepSize() const;
+    unsigned int getNumSteps() const;
+    unsigned int getNumRejected() const;
+
+private:
+    double h_;
+    unsigned int numSteps_;
+    unsigned int numRejected_;
+};
+
+#endif // _ROSENBROCK_H
@@ -0,0 +1,251 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2026 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include <set>
+#include <cmath>
+#include "../basecode/header.h"
+#include "../basecode/SparseMatrix.h"
+#include "KinSparseMatrix.h"
+#include "RateTerm.h"
+#include "StiffSystem.h"
+
+StiffSystem::StiffSystem()
+    : isReady_( false ), n_( 0 )
+{;}
+
+void StiffSystem::clear()
+{
+    isReady_ = false;
+    n_ = 0;
+    partialStart_.clear();
+    jacPartial_.clear();
+    jacSlot_.clear();
+    jacCoeff_.clear();
+    perm_.clear();
+    pos_.clear();
+    rowStart_.clear();
+    col_.clear();
+    diag_.clear();
+}
+
+void StiffSystem::build( const vector< RateTerm* >& rates,
+                         const KinSparseMatrix& N, unsigned int numVar )
+{
+    clear();
+    n_ = numVar;
+    assert( N.nColumns() == 0 || N.nRows() >= numVar );
+
+    // Reactant lists give the partial derivative slots. Entries of N are
+    // collected per rate term, as the columns of N.
+    vector< unsigned int > partialMol;
+    partialStart_.push_back( 0 );
+    for ( unsigned int r = 0; r < rates.size(); ++r )
+    {
+        vector< unsigned int > mol;
+        if ( rates[r] )
+            rates[r]->getReactants( mol );
+        partialMol.insert( partialMol.end(), mol.begin(), mol.end() );
+        partialStart_.push_back( partialMol.size() );
+    }
+    vector< vector< pair< unsigned int, int > > > column( rates.size() );
+    for ( unsigned int i = 0; i < numVar && i < N.nRows(); ++i )
+    {
+        const int* entry;
+        const unsigned int* colIndex;
+        unsigned int num = N.getRow( i, &entry, &colIndex );
+        for ( unsigned int j = 0; j < num; ++j )
+            if ( colIndex[j] < rates.size() && entry[j] != 0 )
+                column[ colIndex[j] ].push_back(
+                        pair< unsigned int, int >( i, entry[j] ) );
+    }
+
+    // Structural pattern of J, symmetrized, without the diagonal.
+    vector< std::set< unsigned int > > adj( n_ );
+    vector< pair< unsigned int, unsigned int > > jacEntry;
+    for ( unsigned int r = 0; r < rates.size(); ++r )
+    {
+        for ( unsigned int p = partialStart_[r]; p < partialStart_[r+1]; ++p )
+        {
+            unsigned int j = partialMol[p];
+            if ( j >= n_ )
+                continue; // Buffered or function pool, not integrated.
+            for ( unsigned int k = 0; k < column[r].size(); ++k )
+            {
+                unsigned int i = column[r][k].first;
+                jacEntry.push_back( pair< unsigned int, unsigned int >( i, j ) );
+                jacPartial_.push_back( p );
+                jacCoeff_.push_back( column[r][k].second );
+                if ( i != j )
+                {
+                    adj[i].insert( j );
+                    adj[j].insert( i );
+                }
+            }
+        }
+    }
+
+    // Minimum degree ordering. Eliminating a pool connects all its
+    // remaining neighbours, which is exactly the fill of the LU factors.
+    vector< vector< unsigned int > > later( n_ );
+    vector< bool > done( n_, false );
+    for ( unsigned int step = 0; step < n_; ++step )
+    {
+        unsigned int best = ~0U;
+        for ( unsigned int i = 0; i < n_; ++i )
+            if ( !done[i] && ( best == ~0U || adj[i].size() < adj[best].size() ) )
+                best = i;
+        perm_.push_back( best );
+        done[ best ] = true;
+        later[ best ].assign( adj[ best ].begin(), adj[ best ].end() );
+        for ( unsigned int a : later[ best ] )
+        {
+            adj[a].erase( best );
+            for ( unsigned int b : later[ best ] )
+                if ( b != a )
+                    adj[a].insert( b );
+        }
+        adj[ best ].clear();
+    }
+    pos_.resize( n_ );
+    for ( unsigned int k = 0; k < n_; ++k )
+        pos_[ perm_[k] ] = k;
+
+    // Filled pattern in elimination order: for each pivot its later
+    // neighbours go into both its row (U) and their rows (L).
+    vector< vector< unsigned int > > rows( n_ );
+    for ( unsigned int k = 0; k < n_; ++k )
+    {
+        rows[k].push_back( k );
+        for ( unsigned int a : later[ perm_[k] ] )
+        {
+            rows[k].push_back( pos_[a] );
+            rows[ pos_[a] ].push_back( k );
+        }
+    }
+    rowStart_.push_back( 0 );
+    for ( unsigned int k = 0; k < n_; ++k )
+    {
+        sort( rows[k].begin(), rows[k].end() );
+        for ( unsigned int c : rows[k] )
+        {
+            if ( c == k )
+                diag_.push_back( col_.size() );
+            col_.push_back( c );
+        }
+        rowStart_.push_back( col_.size() );
+    }
+
+    for ( unsigned int k = 0; k < jacEntry.size(); ++k )
+    {
+        jacSlot_.push_back( getSlot( jacEntry[k].first, jacEntry[k].second ) );
+        assert( jacSlot_.back() != ~0U );
+    }
+    isReady_ = true;
+}
+
+bool StiffSystem::isReady() const
+{
+    return isReady_;
+}
+
+unsigned int StiffSystem::size() const
+{
+    return n_;
+}
+
+unsigned int StiffSystem::numEntries() const
+{
+    return col_.size();
+}
+
+unsigned int StiffSystem::numPartials() const
+{
+    return partialStart_.empty() ? 0 : partialStart_.back();
+}
+
+const unsigned int* StiffSystem::partialStart() const
+{
+    return partialStart_.data();
+}
+
+unsigned int StiffSystem::getSlot( unsigned int row, unsigned int col ) const
+{
+    if ( row >= n_ || col >= n_ )
+        return ~0U;
+    unsigned int k = pos_[ row ];
+    unsigned int c = pos_[ col ];
+    vector< unsigned int >::const_iterator begin = col_.begin() + rowStart_[k];
+    vector< unsigned int >::const_iterator end = col_.begin() + rowStart_[k+1];
+    vector< unsigned int >::const_iterator i = lower_bound( begin, end, c );
+    if ( i == end || *i != c )
+        return ~0U;
+    return i - col_.begin();
+}
+
+void StiffSystem::assemble( const double* dv, double* jac ) const
+{
+    for ( unsigned int k = 0; k < col_.size(); ++k )
+        jac[k] = 0.0;
+    for ( unsigned int k = 0; k < jacSlot_.size(); ++k )
+        jac[ jacSlot_[k] ] += jacCoeff_[k] * dv[ jacPartial_[k] ];
+}
+
+bool StiffSystem::factor( const double* jac, double shift, double* w,
+                          double* work ) const
+{
+    for ( unsigned int k = 0; k < col_.size(); ++k )
+        w[k] = -jac[k];
+    for ( unsigned int i = 0; i < n_; ++i )
+        w[ diag_[i] ] += shift;
+
+    // Row by row Doolittle. The symbolic fill guarantees that every
+    // column touched while eliminating row i is in the pattern of row i.
+    for ( unsigned int i = 0; i < n_; ++i )
+    {
+        for ( unsigned int p = rowStart_[i]; p < rowStart_[i+1]; ++p )
+            work[ col_[p] ] = w[p];
+        for ( unsigned int p = rowStart_[i]; p < diag_[i]; ++p )
+        {
+            unsigned int k = col_[p];
+            double m = work[k] / w[ diag_[k] ];
+            work[k] = m;
+            if ( m == 0.0 )
+                continue;
+            for ( unsigned int q = diag_[k] + 1; q < rowStart_[k+1]; ++q )
+                work[ col_[q] ] -= m * w[q];
+        }
+        for ( unsigned int p = rowStart_[i]; p < rowStart_[i+1]; ++p )
+            w[p] = work[ col_[p] ];
+        double pivot = w[ diag_[i] ];
+        if ( pivot == 0.0 || !std::isfinite( pivot ) )
+            return false;
+    }
+    return true;
+}
+
+void StiffSystem::solve( const double* w, const double* b, double* x,
+                         double* work ) const
+{
+    for ( unsigned int i = 0; i < n_; ++i )
+    {
+        double y = b[ perm_[i] ];
+        for ( unsigned int p = rowStart_[i]; p < diag_[i]; ++p )
+            y -= w[p] * work[ col_[p] ];
+        work[i] = y;
+    }
+    for ( unsigned int i = n_; i-- > 0; )
+    {
+        double y = work[i];
+        for ( unsigned int p = diag_[i] + 1; p < rowStart_[i+1]; ++p )
+            y -= w[p] * work[ col_[p] ];
+        work[i] = y / w[ diag_[i] ];
+    }
+    for ( unsigned int i = 0; i < n_; ++i )
+        x[ perm_[i] ] = work[i];
+}
@@ -0,0 +1,99 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2026 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _STIFF_SYSTEM_H
+#define _STIFF_SYSTEM_H
+
+class RateTerm;
+class KinSparseMatrix;
+
+/**
+ * This class stores the common data needed across all voxels for the
+ * implicit "rosenbrock" method of the Ksolve: how to assemble the
+ * Jacobian from the partial derivatives of the rate terms, and the
+ * symbolic LU factorization of the Newton matrix
+ *     W = I / ( h.gamma ) - J
+ * All voxels of a Ksolve share one reaction system, so this is built
+ * once at reinit and reused for every step of every voxel. Only the
+ * numerical factorization is redone per step.
+ *
+ * The partial derivatives come in one slot per reactant entry of each
+ * rate term, in the order given by RateTerm::getReactants, so that
+ * slot partialStart()[r] + k holds d v_r / d S[ mol_k ]. The Jacobian
+ * is then J = N . dv/dS, with N the stoichiometry matrix.
+ *
+ * The sparsity pattern of W is that of J plus the diagonal. Rows and
+ * columns are reordered by minimum degree on the symmetrized pattern
+ * to keep fill-in low, and the factorization is done without pivoting,
+ * which is safe here because W is dominated by its diagonal at the
+ * step sizes where the method is accurate. A failed pivot is reported
+ * so that the caller can retry with a smaller step.
+ */
+class StiffSystem
+{
+public:
+    StiffSystem();
+
+    /**
+     * Builds the layout from the reference rate terms of the Stoich and
+     * its stoichiometry matrix. Only the first numVar pools are
+     * integrated; entries for buffered and function pools are dropped.
+     */
+    void build( const vector< RateTerm* >& rates, const KinSparseMatrix& N,
+                unsigned int numVar );
+    void clear();
+    bool isReady() const;
+
+    /// Number of integrated pools.
+    unsigned int size() const;
+    /// Number of stored entries of W, including fill.
+    unsigned int numEntries() const;
+    /// Number of partial derivative slots.
+    unsigned int numPartials() const;
+    /// Offset of the partials of each rate term, with an end entry.
+    const unsigned int* partialStart() const;
+
+    /// Looks up the slot of entry (row, col) of J, or ~0U if absent.
+    unsigned int getSlot( unsigned int row, unsigned int col ) const;
+
+    /// Assembles J = N . dv/dS into jac[ numEntries() ].
+    void assemble( const double* dv, double* jac ) const;
+
+    /**
+     * Forms W = shift.I - J in w and factors it in place. The work
+     * array needs size() entries. Returns false on a zero pivot.
+     */
+    bool factor( const double* jac, double shift, double* w,
+                 double* work ) const;
+
+    /// Solves W x = b using the factors from factor(). b may be x.
+    void solve( const double* w, const double* b, double* x,
+                double* work ) const;
+
+private:
+    bool isReady_;
+    unsigned int n_;
+    vector< unsigned int > partialStart_;
+
+    /// jac[ jacSlot_[k] ] += jacCoeff_[k] * dv[ jacPartial_[k] ]
+    vector< unsigned int > jacPartial_;
+    vector< unsigned int > jacSlot_;
+    vector< double > jacCoeff_;
+
+    /// Elimination order: pool perm_[k] is pivot k.
+    vector< unsigned int > perm_;
+    vector< unsigned int > pos_; /// Inverse of perm_.
+
+    /// Filled pattern of W in elimination order, columns ascending.
+    vector< unsigned int > rowStart_;
+    vector< unsigned int > col_;
+    vector< unsigned int > diag_;
+};
+
+#endif // _STIFF_SYSTEM_H
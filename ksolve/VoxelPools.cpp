@@ -30,11 +30,13 @@ using namespace boost::numeric;
 #include "KsolveBase.h"
 #include "Ksolve.h"
 #include "Stoich.h"
+#include "StiffSystem.h"
+#include "Rosenbrock.h"
 
 //////////////////////////////////////////////////////////////
 // Class definitions
 
-VoxelPools::VoxelPools() : pLSODA(nullptr)
+VoxelPools::VoxelPools() : pLSODA(nullptr), stiffSys_( nullptr )
 {
 	lsodaState_ = 1;
 #ifdef USE_GSL
@@ -59,6 +61,7 @@ void VoxelPools::reinit( double dt )
 {
     VoxelPoolsBase::reinit();
 	lsodaState_ = 1;
+    stiff_.reinit( dt / 10.0 );
 #ifdef USE_GSL
     if ( !driver_ )
         return;
@@ -136,6 +139,19 @@ void VoxelPools::advance( const ProcInfo* p )
             assert(0);
         }
     }
+    else if( method_ == "rosenbrock" )
+    {
+        assert( stiffSys_ && stiffSys_->isReady() );
+        bool ok = stiff_.advance( *stiffSys_, &Svec()[0], size(), t,
+                p->currTime, epsAbs_, epsRel_, &VoxelPools::stiffRates,
+                &VoxelPools::stiffPartials, this );
+        if ( !ok )
+        {
+            cerr << "Error: VoxelPools::advance: Rosenbrock step size "
+                "underflow at time " << t << "\n";
+            assert( 0 );
+        }
+    }
     else
     {
 
@@ -317,6 +333,29 @@ void VoxelPools::setInitDt( double dt )
 #endif
 }
 
+double VoxelPools::getStepSize() const
+{
+    if ( method_ == "rosenbrock" )
+        return stiff_.getStepSize();
+#ifdef USE_GSL
+    if ( driver_ )
+        return driver_->h;
+#endif
+    return 0.0;
+}
+
+void VoxelPools::setStepSize( double h )
+{
+    lsodaState_ = 1;
+    if ( h <= 0.0 )
+        return;
+    stiff_.reinit( h );
+#ifdef USE_GSL
+    if ( driver_ )
+        gsl_odeiv2_driver_reset_hstart( driver_, h );
+#endif
+}
+
 #ifdef USE_GSL
 // static func. This is the function that goes into the Gsl solver.
 int VoxelPools::gslFunc( double t, const double* y, double *dydt, void* params )
@@ -362,6 +401,28 @@ void VoxelPools::lsodaSys( double t, double* y, double* dydt, void* param)
     vp->updateRates( y, dydt );
 }
 
+void VoxelPools::setStiffSystem( const StiffSystem* sys )
+{
+    stiffSys_ = sys;
+}
+
+void VoxelPools::stiffRates( double t, double* y, double* dydt, void* params )
+{
+    VoxelPools* vp = reinterpret_cast< VoxelPools* >( params );
+    vp->stoichPtr_->updateFuncs( y, t );
+    vp->updateRates( y, dydt );
+}
+
+/**
+ * Rosenbrock calls this right after stiffRates on the same y, so the
+ * function pools in y are already up to date.
+ */
+void VoxelPools::stiffPartials( double t, double* y, double* dv, void* params )
+{
+    VoxelPools* vp = reinterpret_cast< VoxelPools* >( params );
+    vp->kernel_.partials( y, vp->stiffSys_->partialStart(), dv );
+}
+
 ///////////////////////////////////////////////////////////////////////
 // Here are the internal reaction rate calculation functions
 ///////////////////////////////////////////////////////////////////////
@@ -387,6 +448,7 @@ void VoxelPools::updateAllRateTerms( const vector< RateTerm* >& rates,
                 getXreacScaleProducts(i-numCoreRates) 
                 );
     }
+    ratesChanged();
 }
 
 void VoxelPools::updateRateTerms( const vector< RateTerm* >& rates,
@@ -406,25 +468,31 @@ void VoxelPools::updateRateTerms( const vector< RateTerm* >& rates,
     }
     else
         rates_[index] = rates[index]->copyWithVolScaling(getVolume(), 1.0, 1.0);
+    ratesChanged();
+}
+
+void VoxelPools::ratesChanged()
+{
+    kernel_.build( rates_ );
+    v_.assign( rates_.size(), 0.0 );
 }
 
 void VoxelPools::updateRates( const double* s, double* yprime ) const
 {
     const KinSparseMatrix& N = stoichPtr_->getStoichiometryMatrix();
-    vector< double > v( N.nColumns(), 0.0 );
-    vector< double >::iterator j = v.begin();
     // totVar should include proxyPools only if this voxel uses them
     unsigned int totVar = stoichPtr_->getNumVarPools() + stoichPtr_->getNumProxyPools();
     // totVar should include proxyPools if this voxel does not use them
     unsigned int totInvar = stoichPtr_->getNumBufPools();
     assert( N.nColumns() == 0 || N.nRows() == stoichPtr_->getNumAllPools() );
     assert( N.nColumns() == rates_.size() );
+    assert( kernel_.numRates() == rates_.size() );
+    assert( v_.size() == rates_.size() );
 
-    for ( auto i = rates_.cbegin(); i != rates_.end(); i++)
-        *j++ = (**i)( s );
+    kernel_.velocities( s, v_.data() );
     for (unsigned int i = 0; i < totVar; ++i)
     {
-        auto rate = N.computeRowRate( i, v );
+        auto rate = N.computeRowRate( i, v_ );
         assert(! std::isnan(rate));
         *yprime++ = rate;
     }
@@ -12,6 +12,8 @@
 
 #include "OdeSystem.h"
 #include "VoxelPoolsBase.h"
+#include "RateKernel.h"
+#include "Rosenbrock.h"
 #include "../external/libsoda/LSODA.h"
 
 #ifdef USE_BOOST_ODE
@@ -20,6 +22,7 @@
 
 class Stoich;
 class ProcInfo;
+class StiffSystem;
 
 /**
  * This is the class for handling reac-diff voxels used for deterministic
@@ -53,6 +56,16 @@ public:
     /// Set initial timestep to use by the solver.
     void setInitDt( double dt );
 
+    /**
+     * Step size the integrator will try next, for checkpoints. LSODA
+     * keeps more history than this, so it restarts after setStepSize.
+     */
+    double getStepSize() const;
+    void setStepSize( double h );
+
+    /// Assigns the shared Jacobian layout for the "rosenbrock" method.
+    void setStiffSystem( const StiffSystem* sys );
+
 #ifdef USE_GSL      /* -----  not USE_BOOST  ----- */
     static int gslFunc( double t, const double* y, double *dydt, void* params);
 #elif  USE_BOOST_ODE
@@ -62,6 +75,10 @@ public:
     // System of LSODA.
     static void lsodaSys( double t, double* y, double* dydt, void* params);
 
+    // Rates and rate term partials for the Rosenbrock method.
+    static void stiffRates( double t, double* y, double* dydt, void* params );
+    static void stiffPartials( double t, double* y, double* dv, void* params );
+
     //////////////////////////////////////////////////////////////////
     // Rate manipulation and calculation functions
     //////////////////////////////////////////////////////////////////
@@ -80,6 +97,9 @@ public:
     void updateRateTerms( const vector< RateTerm* >& rates,
                           unsigned int numCoreRates, unsigned int index );
 
+    /// Rebuilds kernel_ from rates_.
+    void ratesChanged();
+
     /**
      * Core computation function. Updates the reaction velocities
      * vector yprime given the current mol 'n' vector s.
@@ -112,6 +132,16 @@ private:
     double epsRel_;
     string method_;
 
+    /// Flattened copy of rates_ used by updateRates.
+    RateKernel kernel_;
+
+    /// Reaction velocities, kept to avoid an allocation per RHS call.
+    mutable vector< double > v_;
+
+    /// Step size control for the "rosenbrock" method.
+    Rosenbrock stiff_;
+    const StiffSystem* stiffSys_;
+
 };
 
 #endif	// _VOXEL_POOLS_H
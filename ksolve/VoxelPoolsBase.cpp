@@ -137,6 +137,7 @@ void VoxelPoolsBase::scaleVolsBufsRates(double ratio, const Stoich* stoichPtr)
                     getXreacScaleSubstrates(i - numCoreRates),
                     getXreacScaleProducts(i - numCoreRates ) );
     }
+    ratesChanged();
 }
 
 void VoxelPoolsBase::setNumVoxels( unsigned int n )
@@ -375,8 +376,12 @@ void VoxelPoolsBase::filterCrossRateTerms(
             }
         }
     }
+    ratesChanged();
 }
 
+void VoxelPoolsBase::ratesChanged()
+{;}
+
 ////////////////////////////////////////////////////////////////////////
 void VoxelPoolsBase::print() const
 {
@@ -121,6 +121,13 @@ public:
      */
     void filterCrossRateTerms( const vector< Id >& offSolverReacs, const vector< pair< Id, Id > >& offSolverReacCompts );
 
+    /**
+     * Called after entries of rates_ have been replaced or rescaled
+     * here in the base class, so that derived classes can refresh
+     * anything they derived from them.
+     */
+    virtual void ratesChanged();
+
     //////////////////////////////////////////////////////////////////
     // Functions to handle cross-compartment reactions.
     //////////////////////////////////////////////////////////////////
@@ -6,6 +6,7 @@
 ** GNU Lesser General Public License version 2.1
 ** See the file COPYING.LIB for the full notice.
 **********************************************************************/
+#include <thread>
 #include "../basecode/header.h"
 #include "../shell/Shell.h"
 
@@ -20,6 +21,10 @@
 #include "KsolveBase.h"
 #include "Stoich.h"
 #include "../mesh/VoxelJunction.h"
+#include "PropensityTree.h"
+#include "RateKernel.h"
+#include "StiffSystem.h"
+#include "Rosenbrock.h"
 
 #include "../builtins/MooseParser.h"
 #include "../utility/testing_macros.hpp"
@@ -367,6 +372,272 @@ void testFuncTerm()
     cout << "." << flush;
 }
 
+/// Several threads evaluating one shared FuncTerm on their own S vectors.
+void testFuncTermThreads()
+{
+    FuncTerm ft;
+    ft.setReactantIndex( vector< unsigned int >{ 0, 1 } );
+    ft.setExpr( "x0*x1 + t" );
+    ft.setTarget( 2 );
+
+    const unsigned int numThreads = 4;
+    const unsigned int numEvals = 20000;
+    vector< unsigned int > numWrong( numThreads, 0 );
+    vector< std::thread > threads;
+    for ( unsigned int k = 0; k < numThreads; ++k )
+    {
+        threads.push_back( std::thread( [&ft, &numWrong, k, numEvals]() {
+            for ( unsigned int i = 0; i < numEvals; ++i )
+            {
+                double S[] = { double( k + 1 ), double( i ), 0.0 };
+                double t = 0.5 * k;
+                double expected = ( k + 1 ) * double( i ) + t;
+                if ( ft( S, t ) != expected )
+                    numWrong[k]++;
+                ft.evalPool( S, t );
+                if ( S[2] != expected )
+                    numWrong[k]++;
+            }
+        } ) );
+    }
+    for ( unsigned int k = 0; k < numThreads; ++k )
+    {
+        threads[k].join();
+        ASSERT_EQ( numWrong[k], 0, "testFuncTermThreads" );
+    }
+
+    // A new expression is picked up by threads that already evaluated.
+    ft.setExpr( "x0 - x1" );
+    double S[] = { 5.0, 3.0, 0.0 };
+    ASSERT_EQ( ft( S, 0.0 ), 2.0, "testFuncTermThreads" );
+
+    // Terms that are changed or deleted leave no entries in the cache.
+    for ( unsigned int i = 0; i < 100; ++i )
+    {
+        FuncTerm temp;
+        temp.setReactantIndex( vector< unsigned int >{ 0 } );
+        temp.setExpr( "x0 + " + to_string( i ) );
+        ASSERT_EQ( temp( S, 0.0 ), 5.0 + i, "testFuncTermThreads" );
+    }
+    ASSERT_EQ( ft( S, 0.0 ), 2.0, "testFuncTermThreads" );
+    ASSERT_EQ( FuncTerm::numCachedContexts(), 1, "testFuncTermThreads" );
+    cout << "." << flush;
+}
+
+/// The sum tree must pick the reaction the linear GSSA scan would.
+void testPropensityTree()
+{
+    vector< double > v = { 0.5, 0.0, -2.0, 1.25, 0.0, 3.0, 0.75 };
+    PropensityTree tree;
+    tree.assign( v );
+    ASSERT_DOUBLE_EQ( tree.total(), 7.5, "testPropensityTree" );
+
+    for ( unsigned int trial = 0; trial < 2; ++trial )
+    {
+        double tot = 0.0;
+        for ( double x : v )
+            tot += fabs( x );
+        for ( double r = 0.0; r < tot + 0.5; r += 0.0625 )
+        {
+            unsigned int expected = v.size();
+            double sum = 0.0;
+            for ( unsigned int i = 0; i < v.size(); ++i )
+            {
+                if ( r < ( sum += fabs( v[i] ) ) )
+                {
+                    expected = i;
+                    break;
+                }
+            }
+            ASSERT_EQ( tree.pick( r ), expected, "testPropensityTree" );
+        }
+        // Change a few entries and check again.
+        v[1] = 4.0;
+        tree.update( 1, v[1] );
+        v[5] = 0.0;
+        tree.update( 5, v[5] );
+    }
+
+    // Values that are not dyadic round differently when summed pairwise
+    // down the tree and left to right in the scan. The picks may then
+    // differ, but only for r within roundoff of a boundary between the
+    // two reactions picked.
+    v.clear();
+    for ( unsigned int i = 0; i < 37; ++i )
+        v.push_back( ( i % 5 == 3 ) ? 0.0 : 0.1 * ( i % 7 ) + 1.0 / ( i + 3.0 ) );
+    tree.assign( v );
+    vector< double > prefix( 1, 0.0 );
+    for ( double x : v )
+        prefix.push_back( prefix.back() + fabs( x ) );
+    double tot = prefix.back();
+    vector< double > rs;
+    for ( unsigned int k = 0; k < 10000; ++k )
+        rs.push_back( tot * k / 10000.0 );
+    for ( unsigned int i = 1; i < prefix.size(); ++i )
+    {
+        rs.push_back( prefix[i] );
+        rs.push_back( nextafter( prefix[i], 0.0 ) );
+        rs.push_back( nextafter( prefix[i], tot ) );
+    }
+    for ( double r : rs )
+    {
+        unsigned int expected = upper_bound( prefix.begin() + 1, prefix.end(), r ) -
+                                prefix.begin() - 1;
+        unsigned int got = tree.pick( r );
+        if ( got == v.size() || got == expected )
+            continue;
+        ASSERT_TRUE( v[got] != 0.0, "testPropensityTree" );
+        double edge = prefix[ max( got, expected ) ];
+        ASSERT_TRUE( fabs( r - edge ) <= 64 * tot * 1e-16, "testPropensityTree" );
+    }
+    cout << "." << flush;
+}
+
+void testRateKernel()
+{
+    vector< RateTerm* > rates;
+    rates.push_back( new FirstOrder( 0.5, 0 ) );
+    rates.push_back( new BidirectionalReaction(
+                         new SecondOrder( 2.0, 0, 1 ),
+                         new FirstOrder( 0.25, 2 ) ) );
+    rates.push_back( new ZeroOrder( 3.0 ) );
+    rates.push_back( new BidirectionalReaction(
+                         new NOrder( 0.125, { 0, 1, 2 } ),
+                         new ZeroOrder( 0.75 ) ) );
+    rates.push_back( new MMEnzyme1( 1.5, 4.0, 3, 1 ) );
+    rates.push_back( new BidirectionalReaction(
+                         new FirstOrder( 1.0, 3 ),
+                         new StochNOrder( 0.5, { 1, 1 } ) ) );
+
+    RateKernel kernel;
+    kernel.build( rates );
+    ASSERT_EQ( kernel.numRates(), rates.size(), "testRateKernel" );
+    // The enzyme and the reaction with a stochastic term stay virtual.
+    ASSERT_EQ( kernel.numGeneric(), 2, "testRateKernel" );
+
+    double S[] = { 1.5, 2.0, 0.5, 3.0 };
+    vector< double > v( rates.size(), -1.0 );
+    kernel.velocities( S, v.data() );
+    for ( unsigned int i = 0; i < rates.size(); ++i )
+    {
+        // Same arithmetic in the same order, so equal to the last bit.
+        ASSERT_EQ( v[i], ( *rates[i] )( S ), "testRateKernel" );
+        delete rates[i];
+    }
+    cout << "." << flush;
+}
+
+/// Robertson's problem, the classic stiff chemical system.
+struct RobertsonTest
+{
+    vector< RateTerm* > rates;
+    KinSparseMatrix N;
+    RateKernel kernel;
+    const StiffSystem* sys;
+    vector< double > v;
+};
+
+static void robertsonRates( double t, double* y, double* dydt, void* params )
+{
+    RobertsonTest* r = reinterpret_cast< RobertsonTest* >( params );
+    r->kernel.velocities( y, r->v.data() );
+    for ( unsigned int i = 0; i < 3; ++i )
+        dydt[i] = r->N.computeRowRate( i, r->v );
+}
+
+static void robertsonPartials( double t, double* y, double* dv, void* params )
+{
+    RobertsonTest* r = reinterpret_cast< RobertsonTest* >( params );
+    r->kernel.partials( y, r->sys->partialStart(), dv );
+}
+
+void testRosenbrock()
+{
+    // A -> B, 2B -> B + C, B + C -> A + C. The last one is written as
+    // an enzyme with a huge Km so that a term without analytical partials
+    // is covered.
+    RobertsonTest r;
+    r.rates.push_back( new FirstOrder( 0.04, 0 ) );
+    r.rates.push_back( new SecondOrder( 3.0e7, 1, 1 ) );
+    r.rates.push_back( new MMEnzyme1( 1.0e6, 1.0e10, 2, 1 ) );
+    r.N.setSize( 3, 3 );
+    r.N.set( 0, 0, -1 );
+    r.N.set( 1, 0, 1 );
+    r.N.set( 1, 1, -1 );
+    r.N.set( 2, 1, 1 );
+    r.N.set( 0, 2, 1 );
+    r.N.set( 1, 2, -1 );
+    r.kernel.build( r.rates );
+    r.v.resize( 3 );
+    StiffSystem sys;
+    sys.build( r.rates, r.N, 3 );
+    r.sys = &sys;
+    ASSERT_EQ( sys.size(), 3, "testRosenbrock" );
+    ASSERT_EQ( sys.numPartials(), 5, "testRosenbrock" );
+
+    // Analytical partials against finite differences. The kernel also
+    // differentiates the enzyme numerically, so the check is loose.
+    double y[] = { 0.7, 2.0e-5, 0.3 };
+    vector< double > dv( sys.numPartials(), 0.0 );
+    vector< double > jac( sys.numEntries() );
+    robertsonPartials( 0, y, dv.data(), &r );
+    sys.assemble( dv.data(), jac.data() );
+    for ( unsigned int j = 0; j < 3; ++j )
+    {
+        double f0[3], f1[3];
+        double h = 1e-6 * max( y[j], 1e-6 );
+        robertsonRates( 0, y, f0, &r );
+        y[j] += h;
+        robertsonRates( 0, y, f1, &r );
+        y[j] -= h;
+        for ( unsigned int i = 0; i < 3; ++i )
+        {
+            unsigned int slot = sys.getSlot( i, j );
+            double expected = ( f1[i] - f0[i] ) / h;
+            double got = slot == ~0U ? 0.0 : jac[ slot ];
+            assert( fabs( got - expected ) <= 1e-4 * ( 1.0 + fabs( expected ) ) );
+        }
+    }
+
+    // W x = b against a dense solve of the same matrix.
+    vector< double > w( sys.numEntries() );
+    vector< double > work( sys.size() );
+    double shift = 1.0e3;
+    assert( sys.factor( jac.data(), shift, w.data(), work.data() ) );
+    double b[] = { 1.0, -2.0, 0.5 };
+    double x[3];
+    sys.solve( w.data(), b, x, work.data() );
+    for ( unsigned int i = 0; i < 3; ++i )
+    {
+        double Wx = shift * x[i];
+        for ( unsigned int j = 0; j < 3; ++j )
+        {
+            unsigned int slot = sys.getSlot( i, j );
+            if ( slot != ~0U )
+                Wx -= jac[ slot ] * x[j];
+        }
+        assert( doubleApprox( Wx, b[i] ) );
+    }
+
+    // Reference values at t = 40 from Hairer and Wanner.
+    double S[] = { 1.0, 0.0, 0.0 };
+    Rosenbrock ros;
+    ros.reinit( 1.0e-6 );
+    assert( ros.advance( sys, S, 3, 0.0, 40.0, 1e-10, 1e-6,
+                         &robertsonRates, &robertsonPartials, &r ) );
+    assert( fabs( S[0] - 0.7158271 ) < 1e-4 );
+    assert( fabs( S[1] - 9.185535e-6 ) < 1e-8 );
+    assert( fabs( S[2] - 0.2841637 ) < 1e-4 );
+    assert( fabs( S[0] + S[1] + S[2] - 1.0 ) < 1e-10 );
+    // Stability alone holds an explicit method to tens of thousands of
+    // steps here.
+    assert( ros.getNumSteps() < 10000 );
+
+    for ( unsigned int i = 0; i < r.rates.size(); ++i )
+        delete r.rates[i];
+    cout << "." << flush;
+}
+
 void testKsolve()
 {
     testSetupReac();
@@ -374,6 +645,10 @@ void testKsolve()
     testRunKsolve();
     testRunGsolve();
     testFuncTerm();
+    testFuncTermThreads();
+    testPropensityTree();
+    testRateKernel();
+    testRosenbrock();
 }
 
 void testKsolveProcess()
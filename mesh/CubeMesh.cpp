@@ -1127,9 +1127,9 @@ void CubeMesh::buildStencil()
             assert( q >= nx_ * ny_ );
             e.push_back( Ecol( dx_ * dy_ / dz_, s2m_[q - nx_ * ny_] ) );
         }
-        if ( iz < nz_ - 1 && s2m_[ q + nx_*ny_ ] )
+        if ( iz < nz_ - 1 && s2m_[ q + nx_*ny_ ] != flag )
         {
-            assert( q+nx_ < s2m_.size() );
+            assert( q + nx_*ny_ < s2m_.size() );
             e.push_back( Ecol( dx_ * dy_ / dz_, s2m_[q + nx_ * ny_] ) );
         }
         sort( e.begin(), e.end() );
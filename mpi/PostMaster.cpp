@@ -13,6 +13,8 @@
 
 const unsigned int TgtInfo::headerSize =
 		1 + ( sizeof( TgtInfo ) - 1 )/sizeof( double );
+const unsigned int SpikeRecord::headerSize =
+		1 + ( sizeof( SpikeRecord ) - 1 )/sizeof( double );
 
 const unsigned int PostMaster::reserveBufSize = 1048576;
 const unsigned int PostMaster::setRecvBufSize = 1048576;
@@ -35,7 +37,13 @@ PostMaster::PostMaster()
 				isSetSent_( 1 ), // Flag. Have any pending 'set' gone?
 				isSetRecv_( 0 ), // Flag. Has some data come in?
 				setSendSize_( 0 ),
-				numRecvDone_( 0 )
+				numRecvDone_( 0 ),
+				spikeBatch_( false ),
+				isBatching_( false ),
+				minDelay_( 0.0 ),
+				batchSteps_( 1 ),
+				stepsInBatch_( 0 ),
+				spikeBuf_( Shell::numNodes() )
 {
 	for ( unsigned int i = 0; i < Shell::numNodes(); ++i ) {
 		sendBuf_[i].resize( reserveBufSize, 0 );
@@ -100,6 +108,32 @@ const Cinfo* PostMaster::initCinfo()
 			&PostMaster::setBufferSize,
 			&PostMaster::getBufferSize
 		);
+		static ValueFinfo< PostMaster, bool > spikeBatch(
+			"spikeBatch",
+			"Flag. When set, cross-node messages are exchanged once every "
+			"batchSteps steps instead of on every step, in a single "
+			"collective call without a barrier. Every cross-node message "
+			"is delayed by up to minDelay, so this is only for models in "
+			"which the cross-node messages are spikes into synapses. "
+			"Takes effect at the next reinit.",
+			&PostMaster::setSpikeBatch,
+			&PostMaster::getSpikeBatch
+		);
+		static ValueFinfo< PostMaster, double > minDelay(
+			"minDelay",
+			"Smallest synaptic delay of the spikes that go across nodes. "
+			"If zero, the smallest delay of any Synapse on any node is "
+			"used. Read at reinit when spikeBatch is set.",
+			&PostMaster::setMinDelay,
+			&PostMaster::getMinDelay
+		);
+		static ReadOnlyValueFinfo< PostMaster, unsigned int > batchSteps(
+			"batchSteps",
+			"Number of steps between exchanges when spikeBatch is set. "
+			"It is the largest number of steps that fit into minDelay, "
+			"and at least 1.",
+			&PostMaster::getBatchSteps
+		);
 		//////////////////////////////////////////////////////////////
 		// MsgDest Definitions
 		//////////////////////////////////////////////////////////////
@@ -125,6 +159,9 @@ const Cinfo* PostMaster::initCinfo()
 		&numNodes,	// ReadOnlyValue
 		&myNode,	// ReadOnlyValue
 		&bufferSize,	// ReadOnlyValue
+		&spikeBatch,	// Value
+		&minDelay,	// Value
+		&batchSteps,	// ReadOnlyValue
 		&proc		// SharedFinfo
 	};
 
@@ -163,32 +200,60 @@ void PostMaster::finalizeSends()
  */
 void PostMaster::reinit( const Eref& e, ProcPtr p )
 {
+	// The messages sent during reinit go out the way the last run did.
+	if ( isBatching_ ) {
+		// Spikes still waiting from the last run would reach synapses
+		// that have just been cleared, so they are dropped.
+		for ( unsigned int i = 0; i < spikeBuf_.size(); ++i )
+			spikeBuf_[i].clear();
+		exchangeBatch();
+	} else {
 #ifdef USE_MPI
-	// MPI_Barrier( MPI_COMM_WORLD );
-	unsigned int reqIndex = 0;
-	for ( unsigned int i = 0; i < Shell::numNodes(); ++i )
-	{
-		if ( i == Shell::myNode() ) continue;
-		// MPI_scatter would have been better but it doesn't allow
-		// one to post larger recvs than the actual data sent.
-		MPI_Isend(
-			&sendBuf_[i][0], sendSize_[i], MPI_DOUBLE,
-			i, 		// Where to send to.
-			MSGTAG, MPI_COMM_WORLD,
-			&sendReq_[ reqIndex++ ]
-		);
-		clearPending(); // Try to interleave communications.
-	}
-	while ( numRecvDone_ < Shell::numNodes() -1 )
-		clearPending();
-	finalizeSends();
-	MPI_Barrier( MPI_COMM_WORLD );
-	numRecvDone_ = 0;
+		// MPI_Barrier( MPI_COMM_WORLD );
+		unsigned int reqIndex = 0;
+		for ( unsigned int i = 0; i < Shell::numNodes(); ++i )
+		{
+			if ( i == Shell::myNode() ) continue;
+			// MPI_scatter would have been better but it doesn't allow
+			// one to post larger recvs than the actual data sent.
+			MPI_Isend(
+				&sendBuf_[i][0], sendSize_[i], MPI_DOUBLE,
+				i, 		// Where to send to.
+				MSGTAG, MPI_COMM_WORLD,
+				&sendReq_[ reqIndex++ ]
+			);
+			clearPending(); // Try to interleave communications.
+		}
+		while ( numRecvDone_ < Shell::numNodes() -1 )
+			clearPending();
+		finalizeSends();
+		MPI_Barrier( MPI_COMM_WORLD );
+		numRecvDone_ = 0;
 #endif
+	}
+
+	isBatching_ = spikeBatch_;
+	stepsInBatch_ = 0;
+	batchSteps_ = 1;
+	if ( isBatching_ ) {
+		double delay = minDelay_ > 0.0 ? minDelay_ : findMinSynDelay();
+		// Allow for roundoff when the delay is a multiple of dt.
+		unsigned int steps = floor( delay / p->dt + 1.0e-6 );
+		if ( steps > 1 )
+			batchSteps_ = steps;
+	}
 }
 
 void PostMaster::process( const Eref& e, ProcPtr p )
 {
+	if ( isBatching_ ) {
+		clearPendingSetGet();
+		if ( ++stepsInBatch_ >= batchSteps_ ) {
+			exchangeBatch();
+			stepsInBatch_ = 0;
+		}
+		return;
+	}
 #ifdef USE_MPI
 	unsigned int reqIndex = 0;
 	for ( unsigned int i = 0; i < Shell::numNodes(); ++i )
@@ -396,7 +461,6 @@ void PostMaster::clearPendingRecv()
 			recvNode += 1; // Skip myNode
 		int recvSize = 0;
 		MPI_Get_count( &doneStatus_[i], MPI_DOUBLE, &recvSize );
-		int j = 0;
 		assert( recvSize <= static_cast< int >( recvBufSize_ ) );
 		double* buf = &recvBuf_[ recvNode ][0];
 		if ( report ) {
@@ -406,19 +470,7 @@ void PostMaster::clearPendingRecv()
 					   	buf[j+3] << endl;
 			}
 		}
-		while ( j < recvSize ) {
-			const TgtInfo* tgt = reinterpret_cast< const TgtInfo * >( buf );
-			const Eref& e = tgt->eref();
-			const Finfo *f =
-				e.element()->cinfo()->getSrcFinfo( tgt->bindIndex() );
-			buf += TgtInfo::headerSize;
-			const SrcFinfo* sf = dynamic_cast< const SrcFinfo* >( f );
-			assert( sf );
-			sf->sendBuffer( e, buf );
-			buf += tgt->dataSize();
-			j += TgtInfo::headerSize + tgt->dataSize();
-			assert( buf - &recvBuf_[recvNode][0] == j );
-		}
+		handleMessages( buf, recvSize );
 		// Post the next Irecv.
 		unsigned int k = recvNode;
 		if ( recvNode > Shell::myNode() )
@@ -435,6 +487,134 @@ void PostMaster::clearPendingRecv()
 #endif
 }
 
+void PostMaster::handleMessages( double* buf, unsigned int size )
+{
+	unsigned int j = 0;
+	while ( j < size ) {
+		const TgtInfo* tgt = reinterpret_cast< const TgtInfo * >( buf + j );
+		const Eref& e = tgt->eref();
+		const Finfo *f =
+			e.element()->cinfo()->getSrcFinfo( tgt->bindIndex() );
+		const SrcFinfo* sf = dynamic_cast< const SrcFinfo* >( f );
+		assert( sf );
+		sf->sendBuffer( e, buf + j + TgtInfo::headerSize );
+		j += TgtInfo::headerSize + tgt->dataSize();
+	}
+	assert( j == size );
+}
+
+void PostMaster::handleSpikes( double* buf, unsigned int numSpikes )
+{
+	for ( unsigned int i = 0; i < numSpikes; ++i ) {
+		const SpikeRecord* rec =
+			reinterpret_cast< const SpikeRecord* >( buf );
+		const Eref& e = rec->eref();
+		const Finfo *f =
+			e.element()->cinfo()->getSrcFinfo( rec->bindIndex() );
+		const SrcFinfo* sf = dynamic_cast< const SrcFinfo* >( f );
+		assert( sf );
+		sf->sendBuffer( e, buf + SpikeRecord::headerSize );
+		buf += SpikeRecord::headerSize + 1;
+	}
+}
+
+/**
+ * Sends each node the batch of messages for it: the number of
+ * SpikeRecords, the SpikeRecords, and then the other messages in the
+ * usual format. The sizes and then the batches go to all nodes in one
+ * collective call each. Then the batches from all the other nodes are
+ * handled.
+ */
+void PostMaster::exchangeBatch()
+{
+#ifdef USE_MPI
+	unsigned int numNodes = Shell::numNodes();
+	vector< int > sendCount( numNodes, 0 );
+	vector< int > sendOffset( numNodes, 0 );
+	vector< int > recvCount( numNodes, 0 );
+	vector< int > recvOffset( numNodes, 0 );
+	batchSendBuf_.clear();
+	for ( unsigned int i = 0; i < numNodes; ++i ) {
+		sendOffset[i] = batchSendBuf_.size();
+		if ( i == Shell::myNode() )
+			continue;
+		const vector< double >& spikes = spikeBuf_[i];
+		batchSendBuf_.push_back(
+			spikes.size() / ( SpikeRecord::headerSize + 1 ) );
+		batchSendBuf_.insert( batchSendBuf_.end(),
+			spikes.begin(), spikes.end() );
+		batchSendBuf_.insert( batchSendBuf_.end(),
+			sendBuf_[i].begin(), sendBuf_[i].begin() + sendSize_[i] );
+		sendCount[i] = batchSendBuf_.size() - sendOffset[i];
+		spikeBuf_[i].clear();
+		sendSize_[i] = 0;
+	}
+	MPI_Alltoall( &sendCount[0], 1, MPI_INT,
+		&recvCount[0], 1, MPI_INT, MPI_COMM_WORLD );
+	unsigned int recvSize = 0;
+	for ( unsigned int i = 0; i < numNodes; ++i ) {
+		recvOffset[i] = recvSize;
+		recvSize += recvCount[i];
+	}
+	// Keep the pointers valid even if nothing is sent anywhere.
+	batchSendBuf_.push_back( 0 );
+	batchRecvBuf_.resize( recvSize + 1 );
+	MPI_Alltoallv( &batchSendBuf_[0], &sendCount[0], &sendOffset[0],
+		MPI_DOUBLE, &batchRecvBuf_[0], &recvCount[0], &recvOffset[0],
+		MPI_DOUBLE, MPI_COMM_WORLD );
+
+	for ( unsigned int i = 0; i < numNodes; ++i ) {
+		if ( recvCount[i] == 0 )
+			continue;
+		double* buf = &batchRecvBuf_[ recvOffset[i] ];
+		unsigned int numSpikes = buf[0];
+		unsigned int spikeSize = numSpikes * ( SpikeRecord::headerSize + 1 );
+		handleSpikes( buf + 1, numSpikes );
+		handleMessages( buf + 1 + spikeSize,
+			recvCount[i] - 1 - spikeSize );
+	}
+#endif
+}
+
+double PostMaster::findMinSynDelay()
+{
+	double ret = 0.0;
+	bool found = false;
+	const Cinfo* synCinfo = Cinfo::find( "Synapse" );
+	const Element::ClassIndex& classIndex = Element::classIndex();
+	Element::ClassIndex::const_iterator elms = classIndex.find( synCinfo );
+	if ( synCinfo && elms != classIndex.end() ) {
+		const DestFinfo* df = dynamic_cast< const DestFinfo* >(
+			synCinfo->findFinfo( "getDelay" ) );
+		assert( df );
+		const GetOpFuncBase< double >* op =
+			dynamic_cast< const GetOpFuncBase< double >* >( df->getOpFunc() );
+		assert( op );
+		for ( unordered_set< Id >::const_iterator
+				i = elms->second.begin(); i != elms->second.end(); ++i ) {
+			Element* elm = i->element();
+			unsigned int start = elm->localDataStart();
+			for ( unsigned int j = 0; j < elm->numLocalData(); ++j ) {
+				unsigned int numField = elm->numField( j );
+				for ( unsigned int k = 0; k < numField; ++k ) {
+					double delay = op->returnOp( Eref( elm, start + j, k ) );
+					if ( !found || delay < ret )
+						ret = delay;
+					found = true;
+				}
+			}
+		}
+	}
+#ifdef USE_MPI
+	// Nodes without synapses do not limit the delay.
+	double local = found ? ret : numeric_limits< double >::max();
+	MPI_Allreduce( &local, &ret, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD );
+	if ( ret == numeric_limits< double >::max() )
+		ret = 0.0;
+#endif
+	return ret;
+}
+
 ///////////////////////////////////////////////////////////////
 // Data transfer and fillup operations.
 ///////////////////////////////////////////////////////////////
@@ -443,6 +623,14 @@ double* PostMaster::addToSendBuf( const Eref& e, unsigned int bindIndex,
 		unsigned int size )
 {
 	unsigned int node = e.fieldIndex(); // nasty evil wicked hack
+	if ( isBatching_ && size == 1 ) {
+		vector< double >& buf = spikeBuf_[node];
+		unsigned int end = buf.size();
+		buf.resize( end + SpikeRecord::headerSize + 1, 0 );
+		SpikeRecord* rec = reinterpret_cast< SpikeRecord* >( &buf[end] );
+		rec->set( e.objId(), bindIndex );
+		return &buf[ end + SpikeRecord::headerSize ];
+	}
 	unsigned int end = sendSize_[node];
 	if ( end + TgtInfo::headerSize + size > recvBufSize_ ) {
 		// Here we need to activate the fallback second send which will
@@ -724,3 +912,32 @@ void PostMaster::setBufferSize( unsigned int size )
 	for ( unsigned int i =0; i < sendBuf_.size(); ++i )
 		sendBuf_[i].resize( size );
 }
+
+bool PostMaster::getSpikeBatch() const
+{
+	return spikeBatch_;
+}
+
+void PostMaster::setSpikeBatch( bool val )
+{
+	spikeBatch_ = val;
+}
+
+double PostMaster::getMinDelay() const
+{
+	return minDelay_;
+}
+
+void PostMaster::setMinDelay( double val )
+{
+	if ( val < 0.0 ) {
+		cout << "Warning: PostMaster::setMinDelay: delay must be >= 0\n";
+		return;
+	}
+	minDelay_ = val;
+}
+
+unsigned int PostMaster::getBatchSteps() const
+{
+	return batchSteps_;
+}
@@ -60,6 +60,18 @@
  * that was filled when the digestMessages detected that a majority of
  * target nodes received a given message. A setup time complication, not
  * a runtime problem.
+ *
+ * Level 3. Batched exchange.
+ * Spikes usually reach synapses that hold them back for a delay of a few
+ * ms. If spikeBatch is set, the PostMaster only exchanges data once every
+ * batchSteps steps, where batchSteps * dt does not exceed the smallest
+ * synaptic delay on any node. A spike delivered late is then still in
+ * time for its synapse. Messages with a single double argument, such as
+ * spikes, are packed as a SpikeRecord with the argument, and the rest as
+ * usual. All nodes swap their batches in one MPI_Alltoallv, and there is
+ * no barrier. All cross-node messages are delayed in this mode, so it is
+ * only for models that send nothing but spikes into synapses across
+ * nodes.
  */
 
 #ifndef _POST_MASTER_H
@@ -101,6 +113,36 @@ class TgtInfo {
 		unsigned int dataSize_; // Does double duty for SetGet operations as a flag to indicate type of operation.
 };
 
+/**
+ * Header for a message with a single double argument in a batched
+ * exchange. Unlike TgtInfo, it does not need the size of the arguments,
+ * so the header and argument fit in three doubles rather than four.
+ */
+class SpikeRecord {
+	public:
+		SpikeRecord()
+				: id_(), bindIndex_( 0 )
+		{;}
+
+		Eref eref() const {
+			return Eref( id_.eref() );
+		}
+
+		void set( ObjId id, unsigned int bindIndex ) {
+			id_ = id;
+			bindIndex_ = bindIndex;
+		}
+
+		unsigned int bindIndex() const {
+			return bindIndex_;
+		}
+
+		static const unsigned int headerSize;
+	private:
+		ObjId id_;
+		unsigned int bindIndex_;
+};
+
 class PostMaster {
 	public:
 		PostMaster();
@@ -108,6 +150,11 @@ class PostMaster {
 		unsigned int getMyNode() const;
 		unsigned int getBufferSize() const;
 		void setBufferSize( unsigned int size );
+		bool getSpikeBatch() const;
+		void setSpikeBatch( bool val );
+		double getMinDelay() const;
+		void setMinDelay( double val );
+		unsigned int getBatchSteps() const;
 		void reinit( const Eref& e, ProcPtr p );
 		void process( const Eref& e, ProcPtr p );
 
@@ -119,6 +166,15 @@ class PostMaster {
 		void clearPendingRecv();
 		/// Checks that all sends have gone out
 		void finalizeSends();
+		/// Swaps batched messages with all other nodes, and handles them.
+		void exchangeBatch();
+		/// Handles size doubles of messages that arrived from another node.
+		void handleMessages( double* buf, unsigned int size );
+		/// Handles numSpikes messages packed as SpikeRecords.
+		void handleSpikes( double* buf, unsigned int numSpikes );
+
+		/// Returns the smallest delay of any Synapse on any node.
+		static double findMinSynDelay();
 
 		/// Handles 'get' calls from another node, to an object on mynode.
 		void handleRemoteGet( const Eref& e,
@@ -177,6 +233,15 @@ class PostMaster {
 		int isSetRecv_;
 		int setSendSize_;
 		unsigned int numRecvDone_;
+
+		bool spikeBatch_; /// Batched exchange from the next reinit.
+		bool isBatching_; /// Batched exchange in use since the last reinit.
+		double minDelay_; /// Smallest cross-node delay. Found if zero.
+		unsigned int batchSteps_;
+		unsigned int stepsInBatch_;
+		vector< vector< double > > spikeBuf_;
+		vector< double > batchSendBuf_;
+		vector< double > batchRecvBuf_;
 };
 
 #endif	// _POST_MASTER_H
@@ -7,7 +7,60 @@
 ** See the file COPYING.LIB for the full notice.
 **********************************************************************/
 
+#include "../basecode/header.h"
+#include "../shell/Shell.h"
+#include "PostMaster.h"
+
+void testSpikeBatchSteps()
+{
+	// The reinit calls below are collective on many nodes.
+	if ( Shell::numNodes() > 1 )
+		return;
+	Shell* shell = reinterpret_cast< Shell* >( Id().eref().data() );
+	Id synh = shell->doCreate( "SimpleSynHandler", Id(), "synh", 2 );
+	Id synId( synh.value() + 1 );
+	Field< unsigned int >::set( ObjId( synh, 0 ), "numSynapses", 3 );
+	Field< unsigned int >::set( ObjId( synh, 1 ), "numSynapses", 2 );
+	for ( unsigned int i = 0; i < 2; ++i )
+		for ( unsigned int j = 0; j < 3 - i; ++j )
+			Field< double >::set( ObjId( synId, i, j ), "delay",
+				0.0025 + 0.001 * ( i + j ) );
+	Field< double >::set( ObjId( synId, 1, 1 ), "delay", 0.0015 );
+
+	// Other tests may have left synapses with smaller delays.
+	double delay = PostMaster::findMinSynDelay();
+	assert( delay <= 0.0015 );
+	if ( Element::classIndex().find( synId.element()->cinfo() )->second.size()
+			== 1 )
+		assert( doubleEq( delay, 0.0015 ) );
+
+	ObjId pmId( 3 );
+	PostMaster* pm = reinterpret_cast< PostMaster* >( pmId.data() );
+	ProcInfo p;
+	p.dt = 1.0e-4;
+	Field< bool >::set( pmId, "spikeBatch", true );
+	Field< double >::set( pmId, "minDelay", 0.0025 );
+	pm->reinit( pmId.eref(), &p );
+	assert( Field< unsigned int >::get( pmId, "batchSteps" ) == 25 );
+	p.dt = 1.0e-3;
+	pm->reinit( pmId.eref(), &p );
+	assert( pm->getBatchSteps() == 2 );
+	p.dt = 1.0e-2; // Longer than the delay: exchange every step.
+	pm->reinit( pmId.eref(), &p );
+	assert( pm->getBatchSteps() == 1 );
+	for ( unsigned int i = 0; i < 5; ++i )
+		pm->process( pmId.eref(), &p );
+
+	Field< bool >::set( pmId, "spikeBatch", false );
+	Field< double >::set( pmId, "minDelay", 0.0 );
+	pm->reinit( pmId.eref(), &p );
+	assert( pm->getBatchSteps() == 1 );
+
+	shell->doDelete( synh );
+	cout << "." << flush;
+}
+
 void testMpi()
 {
-		;
+	testSpikeBatchSteps();
 }
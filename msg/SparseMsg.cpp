@@ -12,7 +12,9 @@
 #include "../randnum/randnum.h"
 #include "../shell/Shell.h"
 #include "../basecode/SparseMatrix.h"
+#include "../utility/ThreadPool.h"
 #include "SparseMsg.h"
+#include <random>
 
 // Initializing static variables
 Id SparseMsg::managerId_;
@@ -91,6 +93,22 @@ const Cinfo* SparseMsg::initCinfo()
         &SparseMsg::getSeed
     );
 
+    static ValueFinfo< SparseMsg, string > sampling(
+        "sampling",
+        "How random connectivity is drawn.\n"
+        "dense: (default) one random number for every (source, target) "
+        "pair, which gives the same connections as earlier versions for "
+        "a given seed.\n"
+        "skip: draw the gap from each synapse on a target to the next "
+        "from the geometric distribution, so that the time taken goes "
+        "with the number of synapses rather than the size of the matrix. "
+        "Targets are filled in parallel on the worker pool, each from a "
+        "random stream of its own, so the result for a given seed does "
+        "not depend on the number of threads.",
+        &SparseMsg::setSampling,
+        &SparseMsg::getSampling
+    );
+
 ////////////////////////////////////////////////////////////////////////
 // DestFinfos
 ////////////////////////////////////////////////////////////////////////
@@ -156,6 +174,7 @@ const Cinfo* SparseMsg::initCinfo()
         &rowStart,              // ReadOnlyValue
         &probability,           // value
         &seed,                  // value
+        &sampling,              // value
         &setRandomConnectivity, // dest
         &setEntry,              // dest
         &unsetEntry,            // dest
@@ -205,6 +224,23 @@ int SparseMsg::getSeed () const
     return seed_;
 }
 
+void SparseMsg::setSampling( string value )
+{
+    if ( value == "dense" )
+        skipSampling_ = false;
+    else if ( value == "skip" )
+        skipSampling_ = true;
+    else
+        cout << "Warning: SparseMsg::setSampling: '" << value
+             << "' not known, using '" << getSampling() << "'. "
+             << "Options are 'dense' and 'skip'." << endl;
+}
+
+string SparseMsg::getSampling() const
+{
+    return skipSampling_ ? "skip" : "dense";
+}
+
 unsigned int SparseMsg::getNumRows() const
 {
     return matrix_.nRows();
@@ -385,7 +421,8 @@ SparseMsg::SparseMsg( Element* e1, Element* e2, unsigned int msgIndex )
       numThreads_( 1 ),
       nrows_( 0 ),
       p_( 0.0 ),
-      seed_(-1)
+      seed_(-1),
+      skipSampling_( false )
 {
     unsigned int nrows = 0;
     unsigned int ncolumns = 0;
@@ -448,74 +485,131 @@ Eref SparseMsg::firstTgt( const Eref& src ) const
     return Eref( 0, 0 );
 }
 
+/**
+ * Fills sources with the rows, in increasing order, that connect to one
+ * column when each does so with the given probability. Rather than
+ * testing every row, it draws the gap to the next connected row from the
+ * geometric distribution, so the cost is that of the connections made.
+ */
+static void sampleSources( vector< unsigned int >& sources,
+                           unsigned int nRows, double probability, uint64_t seed )
+{
+    sources.clear();
+    if ( probability <= 0.0 )
+        return;
+    if ( probability >= 1.0 )
+    {
+        sources.resize( nRows );
+        for ( unsigned int j = 0; j < nRows; ++j )
+            sources[j] = j;
+        return;
+    }
+    sources.reserve( nRows * probability * 1.1 + 8 );
+    std::mt19937_64 gen( seed );
+    const double logQ = std::log1p( -probability );
+    double j = -1.0;
+    while ( true )
+    {
+        // Uniform in (0,1), never 0.
+        double u = ( ( gen() >> 11 ) + 0.5 ) * ( 1.0 / 9007199254740992.0 );
+        j += 1.0 + std::floor( std::log( u ) / logQ );
+        if ( j >= nRows )
+            break;
+        sources.push_back( static_cast< unsigned int >( j ) );
+    }
+}
+
+/// Spreads a seed over 64 bits (splitmix64), so that columns with
+/// neighbouring seeds get unrelated streams.
+static uint64_t mixSeed( uint64_t x )
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = ( x ^ ( x >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+    x = ( x ^ ( x >> 27 ) ) * 0x94D049BB133111EBULL;
+    return x ^ ( x >> 31 );
+}
+
 /**
  * Returns number of synapses formed.
- * Fills it in transpose form, because we need to count and index the
- * number of synapses on the target, so we need to iterate over the sources
- * in the inner loop. Once full, does the transpose.
- * Should really have a seed argument for the random number.
- * Later need a way to fast-forward mtrand to just the entries we
- * need to fill.
+ * First draws the sources of each column (target), then builds the rows
+ * of the matrix directly with a counting sort on the source: one pass
+ * counts the entries of each row, a prefix sum turns the counts into row
+ * starts, and a second pass over the columns in order drops each entry
+ * into place. No dense nRows x nCols pass or transpose is needed, and the
+ * synapses on each target are numbered in source order.
  */
 unsigned int SparseMsg::randomConnect( double probability )
 {
-    unsigned int nRows = matrix_.nRows(); // Sources
-    unsigned int nCols = matrix_.nColumns();	// Destinations
-    matrix_.clear();
-    unsigned int totalSynapses = 0;
-    vector< unsigned int > sizes( nCols, 0 );
-    unsigned int totSynNum = 0;
+    const unsigned int nRows = matrix_.nRows(); // Sources
+    const unsigned int nCols = matrix_.nColumns();	// Destinations
     Element* syn = e2_;
     unsigned int startData = syn->localDataStart();
     unsigned int endData = startData + syn->numLocalData();
 
     assert( nCols == syn->numData() );
 
-    matrix_.transpose();
-    for ( unsigned int i = 0; i < nCols; ++i )
+    // The sources of each column, in increasing order. Every node fills
+    // all the columns, as the source side needs the whole matrix.
+    vector< vector< unsigned int > > sources( nCols );
+    if ( skipSampling_ )
     {
-        vector< unsigned int > synIndex;
-        // This needs to be obtained from current size of syn array.
-        // unsigned int synNum = sizes[ i ];
-        unsigned int synNum = 0;
-        for ( unsigned int j = 0; j < nRows; ++j )
+        // Each column draws from a stream of its own, seeded from rng_,
+        // so the columns can be filled on any number of threads and still
+        // come out the same for a given seed.
+        const uint64_t seed = static_cast< uint64_t >(
+                rng_.uniform() * 9007199254740992.0 );
+        moose::ThreadPool& pool = moose::ThreadPool::global();
+        pool.parallelFor( nCols,
+            moose::ThreadPool::grainSize( nCols, pool.size() ),
+            [&]( size_t begin, size_t end ) {
+                for ( size_t i = begin; i < end; ++i )
+                    sampleSources( sources[i], nRows, probability,
+                                   mixSeed( seed ^ mixSeed( i ) ) );
+            } );
+    }
+    else
+    {
+        for ( unsigned int i = 0; i < nCols; ++i )
         {
-            double r = rng_.uniform(); // Want to ensure it is called each time round the loop.
-            if ( r < probability )
+            for ( unsigned int j = 0; j < nRows; ++j )
             {
-                synIndex.push_back( synNum );
-                ++synNum;
-                ++totSynNum;
-            }
-            else
-            {
-                synIndex.push_back( ~0 );
+                // Want to ensure it is called each time round the loop.
+                double r = rng_.uniform();
+                if ( r < probability )
+                    sources[i].push_back( j );
             }
         }
+    }
 
-        if ( i >= startData && i < endData )
+    // Build the rows directly by a counting sort on the source. Going
+    // through the columns in order keeps the column indices of each row
+    // sorted. The synapses on each column are numbered in source order.
+    vector< unsigned int > rowStart( nRows + 1, 0 );
+    for ( unsigned int i = 0; i < nCols; ++i )
+        for ( unsigned int j : sources[i] )
+            ++rowStart[ j + 1 ];
+    for ( unsigned int j = 0; j < nRows; ++j )
+        rowStart[ j + 1 ] += rowStart[ j ];
+    const unsigned int totalSynapses = rowStart[ nRows ];
+
+    vector< unsigned int > next( rowStart.begin(), rowStart.end() - 1 );
+    vector< unsigned int > synIndex( totalSynapses );
+    vector< unsigned int > colIndex( totalSynapses );
+    for ( unsigned int i = 0; i < nCols; ++i )
+    {
+        const vector< unsigned int >& src = sources[i];
+        for ( unsigned int k = 0; k < src.size(); ++k )
         {
-            e2_->resizeField( i - startData, synNum );
-        }
-        totalSynapses += synNum;
-        matrix_.addRow( i, synIndex );
-        /*
-         * This is the correct form, but I need to implement something
-         * to check up for target nodes in order to use this.
-        if ( i >= startData && i < endData ) {
-        	e2_->resizeField( i - startData, synNum );
-        	totalSynapses += synNum;
-        	matrix_.addRow( i, synIndex );
-        } else {
-        	synIndex.resize( 0 );
-        	synIndex.assign( nRows, ~0 );
-        	matrix_.addRow( i, synIndex );
+            unsigned int pos = next[ src[k] ]++;
+            synIndex[ pos ] = k;
+            colIndex[ pos ] = i;
         }
-        */
+        if ( i >= startData && i < endData )
+            e2_->resizeField( i - startData, src.size() );
+        vector< unsigned int >().swap( sources[i] );
     }
+    matrix_.swapRows( synIndex, colIndex, rowStart );
 
-    matrix_.transpose();
-    // cout << Shell::myNode() << ": sizes.size() = " << sizes.size() << ", ncols = " << nCols << ", startSynapse = " << startSynapse << endl;
     e1()->markRewired();
     e2()->markRewired();
     return totalSynapses;
@@ -585,6 +679,7 @@ Msg* SparseMsg::copy( Id origSrc, Id newSrc, Id newTgt,
         }
         ret->setMatrix( matrix_ );
         ret->nrows_ = nrows_;
+        ret->skipSampling_ = skipSampling_;
         return ret;
     }
     else
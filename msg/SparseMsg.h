@@ -90,6 +90,9 @@ public:
     int getSeed() const;
     void setSeed( int value );
 
+    string getSampling() const;
+    void setSampling( string value );
+
     vector< unsigned int > getEntryPairs() const;
     void setEntryPairs( vector< unsigned int > entries );
 
@@ -151,6 +154,9 @@ private:
     // RNG.
     int seed_;
     moose::RNG rng_;
+
+    /// True to sample random connectivity by the gaps between synapses.
+    bool skipSampling_;
 };
 
 #endif // _SPARSE_MSG_H
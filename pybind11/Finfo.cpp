@@ -14,6 +14,7 @@
 #include "pymoose.h"
 
 #include "../basecode/header.h"
+#include "../shell/Shell.h"
 #include "../builtins/Variable.h"
 #include "../utility/print_function.hpp"
 #include "../utility/strutil.h"
@@ -34,8 +35,21 @@ std::function<bool(T)> getSetGetFunc1(const ObjId &oid, const string &fname)
 }
 
 
+// A background run may resize vectors as they are read, so they are only
+// read when no run is going on.
+static void checkVectorRead(const ObjId &oid, const Finfo *f)
+{
+    if(Shell::isWaitingForBackgroundRun() &&
+       f->rttiType().find("vector") != string::npos)
+        throw runtime_error("Cannot read " + oid.path() + "." + f->name() +
+                            " while a simulation is running. Use moose.poll "
+                            "on a Table with ringSize set, or read it once "
+                            "the run is over.");
+}
+
 py::object getFieldValue(const ObjId &oid, const Finfo *f)
 {
+    checkVectorRead(oid, f);
     auto rttType = f->rttiType();
     auto fname = f->name();
     py::object r = py::none();
@@ -219,7 +233,7 @@ bool setNumField(const ObjId &oid, const Finfo *f, unsigned int num)
 py::object getLookupValueFinfoItem(const ObjId &oid, const Finfo *f,
                                    const py::object &key)
 {
-
+    checkVectorRead(oid, f);
     auto rttType = f->rttiType();
     auto fname = f->name();
     vector<string> srcDestType;
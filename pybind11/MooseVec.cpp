@@ -21,11 +21,36 @@ namespace py = pybind11;
 
 #include "../utility/strutil.h"
 
+#include "../ksolve/VoxelPoolsBase.h"
+#include "../mesh/VoxelJunction.h"
+#include "../ksolve/XferInfo.h"
+#include "../ksolve/KsolveBase.h"
+#include "../hsolve/HSolveStruct.h"
+#include "../hsolve/HinesMatrix.h"
+#include "../hsolve/HSolvePassive.h"
+#include "../hsolve/RateLookup.h"
+#include "../hsolve/HSolveActive.h"
+#include "../hsolve/HSolve.h"
+
 #include "Finfo.h"
 #include "helper.h"
 #include "pymoose.h"
 #include "MooseVec.h"
 
+// Converts a sequence to a vector. Numpy arrays are copied as a block,
+// not element by element through python.
+template <typename T>
+static vector<T> toVector(const py::object& val)
+{
+    if(py::isinstance<py::array>(val)) {
+        auto a = py::array_t<T, py::array::c_style | py::array::forcecast>::
+            ensure(val);
+        if(a)
+            return vector<T>(a.data(), a.data() + a.size());
+    }
+    return val.cast<vector<T>>();
+}
+
 MooseVec::MooseVec(const string& path, unsigned int n = 0,
                    const string& dtype = "Neutral")
     : path_(path)
@@ -149,7 +174,7 @@ py::object MooseVec::getAttribute(const string& name)
     if(rttType == "unsigned int")
         return getAttributeNumpy<unsigned int>(name);
     if(rttType == "int")
-        return getAttributeNumpy<unsigned int>(name);
+        return getAttributeNumpy<int>(name);
 
     vector<py::object> res(size());
     for(unsigned int i = 0; i < size(); i++)
@@ -187,10 +212,12 @@ bool MooseVec::setAttribute(const string& name, const py::object& val)
 
     if(isVector) {
         if(rttType == "double")
-            return setAttrOneToOne<double>(name, val.cast<vector<double>>());
+            return setAttrOneToOne<double>(name, toVector<double>(val));
         if(rttType == "unsigned int")
             return setAttrOneToOne<unsigned int>(
-                name, val.cast<vector<unsigned int>>());
+                name, toVector<unsigned int>(val));
+        if(rttType == "int")
+            return setAttrOneToOne<int>(name, toVector<int>(val));
         if(rttType == "bool")
             return setAttrOneToOne<bool>(
                 name, val.cast<vector<bool>>());
@@ -200,6 +227,8 @@ bool MooseVec::setAttribute(const string& name, const py::object& val)
         if(rttType == "unsigned int")
             return setAttrOneToAll<unsigned int>(name,
                                                  val.cast<unsigned int>());
+        if(rttType == "int")
+            return setAttrOneToAll<int>(name, val.cast<int>());
         if(rttType == "bool")
             return setAttrOneToAll<bool>(name,
 					 val.cast<bool>());
@@ -209,6 +238,50 @@ bool MooseVec::setAttribute(const string& name, const py::object& val)
     throw runtime_error(__func__ + string("::NotImplementedError."));
 }
 
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Numpy array with a copy of state held in solver memory, taken
+ * in one block rather than field by field. Known fields are `nVec` of a
+ * Ksolve or Gsolve, for the voxel given by index, and `Vm` of an HSolve
+ * entry, in the order of its `compartments` field. The array owns its
+ * data, so it stays valid after the solver is deleted or rebuilt.
+ *
+ * @Param name
+ * @Param index
+ *
+ * @Returns
+ */
+/* ----------------------------------------------------------------------------*/
+py::array MooseVec::getSnapshot(const string& name, unsigned int index) const
+{
+    auto cinfo = oid_.element()->cinfo();
+    const double* data = nullptr;
+    size_t n = 0;
+    if(name == "nVec" && (cinfo->isA("Ksolve") || cinfo->isA("Gsolve"))) {
+        auto ksolve = reinterpret_cast<KsolveBase*>(oid_.data());
+        if(index >= ksolve->getNumLocalVoxels())
+            throw py::index_error("Voxel " + to_string(index) +
+                                  " is out of range.");
+        const VoxelPoolsBase* pools = ksolve->pools(index);
+        data = pools->S();
+        n = pools->size();
+    } else if(name == "Vm" && cinfo->isA("HSolve")) {
+        if(index >= oid_.element()->numData())
+            throw py::index_error("HSolve entry " + to_string(index) +
+                                  " is out of range.");
+        auto hsolve =
+            reinterpret_cast<const HSolve*>(ObjId(oid_.id, index).data());
+        data = hsolve->getVmVector().data();
+        n = hsolve->getVmVector().size();
+    } else {
+        throw py::key_error("No snapshot of '" + name + "' on " + dtype() +
+                            ".");
+    }
+
+    // Without a base object, numpy copies the data into the array.
+    return py::array_t<double>(n, data);
+}
+
 ObjId MooseVec::connectToSingle(const string& srcfield, const ObjId& tgt,
                                 const string& tgtfield, const string& msgtype)
 {
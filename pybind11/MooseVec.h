@@ -10,6 +10,8 @@
 #ifndef MOOSE_VEC_H
 #define MOOSE_VEC_H
 
+#include <memory>
+
 #include "../basecode/header.h"
 
 #include <pybind11/pybind11.h>
@@ -89,15 +91,13 @@ public:
 
         bool isSameType = (expectedType == givenType);
 
+        // Same type: one lookup of the field for all the entries.
+        if (isSameType)
+            return Field<T>::setRepeat(oid_, name, val);
+
         bool res = true;
         for (size_t i = 0; i < size(); i++)
         {
-            if (isSameType)
-            {
-                res &= Field<T>::set(getItem(i), name, val);
-                continue;
-            }
-
             // else try coercing the types.
             if (!setAttributeAtIndex<T>(i, name, val, expectedType))
                 throw py::value_error("Unexpected type '" + givenType +
@@ -126,15 +126,12 @@ public:
                 "Expected " +
                 to_string(size()) + ", got " + to_string(val.size()));
 
+        if (isSameType)
+            return Field<T>::setVec(oid_, name, val);
+
         bool res = true;
         for (size_t i = 0; i < size(); i++)
         {
-            if (isSameType)
-            {
-                res &= Field<T>::set(getItem(i), name, val[i]);
-                continue;
-            }
-
             // Else conservatively coerse value. Required for int -> double
             // etc.
             if (!setAttributeAtIndex<T>(i, name, val[i], expectedType))
@@ -154,15 +151,23 @@ public:
 
     vector<ObjId> objs() const;
 
+    // Gets the field of all entries with one lookup of the field. The
+    // numpy array takes over the vector, so the values are not copied.
     template <typename T>
     py::array_t<T> getAttributeNumpy(const string& name)
     {
-        vector<T> res(size());
-        for (unsigned int i = 0; i < size(); i++)
-            res[i] = Field<T>::get(getItem(i), name);
-        return py::array_t<T>(res.size(), res.data());
+        auto res = std::make_unique<vector<T>>();
+        Field<T>::getVec(oid_, name, *res);
+        const vector<T>* data = res.get();
+        py::capsule owner(res.release(), [](void* p) {
+            delete reinterpret_cast<vector<T>*>(p);
+        });
+        return py::array_t<T>(data->size(), data->data(), owner);
     }
 
+    // Copies state held by a solver into a numpy array in one go.
+    py::array getSnapshot(const string& name, unsigned int index) const;
+
     ObjId connectToSingle(const string& srcfield, const ObjId& tgt,
                           const string& tgtfield, const string& msgtype);
 
@@ -204,6 +204,7 @@ void PyRun::trigger(const Eref &e, double input)
     if (mode_ == 1) {
         return;
     }
+    PyGILState_STATE gstate = PyGILState_Ensure();
 
     PyObject *value = PyDict_GetItemString(locals_, inputvar_.c_str());
     if (value) {
@@ -229,10 +230,12 @@ void PyRun::trigger(const Eref &e, double input)
             outputOut()->send(e, output);
         }
     }
+    PyGILState_Release(gstate);
 }
 
 void PyRun::run(const Eref &e, string statement)
 {
+    PyGILState_STATE gstate = PyGILState_Ensure();
     PyRun_SimpleString(statement.c_str());
     PyObject *value = PyDict_GetItemString(locals_, outputvar_.c_str());
     if (value) {
@@ -242,22 +245,24 @@ void PyRun::run(const Eref &e, string statement)
         else
             outputOut()->send(e, output);
     }
+    PyGILState_Release(gstate);
 }
 
 void PyRun::process(const Eref &e, ProcPtr p)
 {
-    // Make sure the get the GIL. Ksolve/Gsolve can be multithreaded.
-    PyGILState_STATE gstate = PyGILState_Ensure();
-
-    // PyRun_String(runstr_.c_str(), 0, globals_, locals_);
-    // PyRun_SimpleString(runstr_.c_str());
+    // Make sure the get the GIL. Ksolve/Gsolve can be multithreaded, and
+    // moose.start releases the GIL while the simulation runs.
     if (!runcompiled_ || mode_ == 2) {
         return;
     }
+    PyGILState_STATE gstate = PyGILState_Ensure();
 
+    // PyRun_String(runstr_.c_str(), 0, globals_, locals_);
+    // PyRun_SimpleString(runstr_.c_str());
     PyEval_EvalCode(runcompiled_, globals_, locals_);
     if (PyErr_Occurred()) {
         PyErr_Print();
+        PyGILState_Release(gstate);
         return;
     }
 
@@ -266,6 +271,7 @@ void PyRun::process(const Eref &e, ProcPtr p)
         double output = PyFloat_AsDouble(value);
         if (PyErr_Occurred()) {
             PyErr_Print();
+            PyGILState_Release(gstate);
             return;
         } else
             outputOut()->send(e, output);
@@ -33,6 +33,8 @@ namespace py = pybind11;
 #include "../basecode/global.h"
 
 #include "../builtins/Variable.h"
+#include "../builtins/TableBase.h"
+#include "../builtins/Table.h"
 #include "../mpi/PostMaster.h"
 #include "../scheduling/Clock.h"
 #include "../shell/Neutral.h"
@@ -144,6 +146,10 @@ ObjId createIdFromPath(string path, string type, unsigned int numData)
         return Id();
     }
 
+    if(Shell::isWaitingForBackgroundRun())
+        throw std::runtime_error("Cannot create " + path +
+                                 " while a simulation is running.");
+
     auto nId =
         pShell->doCreate(type, parent_id, string(name), numData, MooseGlobal);
 
@@ -377,6 +383,27 @@ void mooseStop()
     getShellPtr()->doStop();
 }
 
+void mooseStartAsync(double runtime)
+{
+    getShellPtr()->doNonBlockingStart(runtime);
+}
+
+void mooseWait()
+{
+    getShellPtr()->doWait();
+}
+
+py::tuple moosePoll(const ObjId& table)
+{
+    if(!table.element()->cinfo()->isA("Table"))
+        throw py::type_error(table.path() + " is not a Table.");
+    vector<double> data;
+    size_t dropped = reinterpret_cast<Table*>(table.data())->pollRing(data);
+    py::array_t<double> res({data.size() / 2, size_t(2)});
+    std::copy(data.begin(), data.end(), res.mutable_data());
+    return py::make_tuple(res, dropped);
+}
+
 // Id is synonym with Id in previous binding.
 MooseVec mooseCopy(const py::object& elem, const py::object& newParent,
                    string newName, unsigned int n = 1, bool toGlobal = false,
@@ -466,6 +493,21 @@ bool mooseIsRunning()
     return getShellPtr()->isRunning();
 }
 
+bool mooseCheckpoint(const string& fileName)
+{
+    return getShellPtr()->doCheckpoint(fileName);
+}
+
+bool mooseRestore(const string& fileName)
+{
+    return getShellPtr()->doRestore(fileName);
+}
+
+void mooseLoadBalance()
+{
+    getShellPtr()->doLoadBalance();
+}
+
 string fieldDocFormatted(const string& name, const Cinfo* cinfo,
                          const Finfo* finfo, const string& prefix = "")
 {
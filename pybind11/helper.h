@@ -208,6 +208,12 @@ void mooseStart(double runtime, bool notify);
 
 void mooseStop();
 
+void mooseStartAsync(double runtime);
+
+void mooseWait();
+
+py::tuple moosePoll(const ObjId& table);
+
 py::cpp_function getPropertyDestFinfo(const ObjId& oid, const Finfo* finfo);
 
 vector<string> mooseGetFieldNames(const string& className,
@@ -217,6 +223,12 @@ string finfoNotFoundMsg(const Cinfo* cinfo);
 
 bool mooseIsRunning();
 
+bool mooseCheckpoint(const string& fileName);
+
+bool mooseRestore(const string& fileName);
+
+void mooseLoadBalance();
+
 string mooseClassDoc(const string& classname);
 
 string mooseDoc(const string& string);
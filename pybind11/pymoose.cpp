@@ -373,6 +373,7 @@ PYBIND11_MODULE(_moose, m)
         // Templated function won't work here. The first one is always called.
         .def("__getattr__", &MooseVec::getAttribute)
         .def("__setattr__", &MooseVec::setAttribute)
+        .def("snapshot", &MooseVec::getSnapshot, "field"_a, "index"_a = 0)
         .def("__repr__",
              [](const MooseVec &v) -> string {
                  return "<moose.vec class=" + v.dtype() + " path=" + v.path() +
@@ -427,10 +428,19 @@ PYBIND11_MODULE(_moose, m)
     m.def("element", &mooseObjIdMooseVec);
 
     m.def("reinit", &mooseReinit);
-    m.def("start", &mooseStart, "runtime"_a, "notify"_a = false);
+    // The simulation may call back into python from PyRun, so the GIL is
+    // released while it runs.
+    m.def("start", &mooseStart, "runtime"_a, "notify"_a = false,
+          py::call_guard<py::gil_scoped_release>());
+    m.def("startAsync", &mooseStartAsync, "runtime"_a);
+    m.def("wait", &mooseWait, py::call_guard<py::gil_scoped_release>());
     m.def("stop", &mooseStop);
+    m.def("poll", &moosePoll, "table"_a);
 
     m.def("isRunning", &mooseIsRunning);
+    m.def("checkpoint", &mooseCheckpoint);
+    m.def("restore", &mooseRestore);
+    m.def("loadBalance", &mooseLoadBalance);
 
     m.def("exists", &mooseExists);
     m.def("getCwe", &mooseGetCwe);
@@ -22,7 +22,9 @@ References:
 
 import sys
 import pydoc
+import atexit
 import os
+import time
 
 import moose._moose as _moose
 from moose import model_utils
@@ -387,6 +389,158 @@ def stop():
     _moose.stop()
 
 
+class AsyncRun(object):
+    """Handle to a simulation started by moose.startAsync."""
+
+    def __init__(self, runtime):
+        self._clock = _moose.element("/clock")
+        self._t0 = self._clock.currentTime
+        self.runtime = runtime
+        _moose.startAsync(runtime)
+
+    @property
+    def progress(self):
+        """Fraction of the run that is done, between 0 and 1."""
+        if self.done or self.runtime <= 0:
+            return 1.0
+        return min(1.0, (self._clock.currentTime - self._t0) / self.runtime)
+
+    @property
+    def done(self):
+        """True once the run has finished or been stopped."""
+        return not _moose.isRunning()
+
+    def wait(self):
+        """Block until the run is over."""
+        _moose.wait()
+
+    def stop(self):
+        """Stop the run at the next clock step and wait for it."""
+        # A stop sent before the clock loop has begun is lost, so repeat it.
+        while _moose.isRunning():
+            _moose.stop()
+            time.sleep(1e-3)
+        _moose.wait()
+
+
+def startAsync(runtime):
+    """Run simulation for `runtime` in the background and return at once.
+
+    The simulation runs on a thread of its own, so Python stays free to plot
+    or poll tables in the meantime (see moose.poll). While it runs, scalar
+    fields can be read but not set. Reading a vector field, such as
+    Table.vector or Ksolve.nVec, raises RuntimeError, as the run may resize
+    it meanwhile; use moose.poll for recent Table values. Calls that create,
+    delete, move, copy or connect objects, load models or change the clock
+    are refused with a warning. Use `stop()` or `wait()` on the returned
+    handle first.
+
+    Parameters
+    ----------
+    runtime : float
+        duration of simulation.
+
+    Returns
+    -------
+    AsyncRun
+        handle with `progress`, `done`, `wait()` and `stop()`.
+
+    See also
+    --------
+    moose.start : Run in the foreground.
+    """
+    if _moose.isRunning():
+        raise RuntimeError("A simulation is already running.")
+    return AsyncRun(runtime)
+
+
+def poll(table):
+    """Values recorded by a Table since the last poll.
+
+    The table must have `ringSize` set before reinit. This can be called
+    while a simulation started by moose.startAsync is running.
+
+    Parameters
+    ----------
+    table : moose.Table
+        table to read.
+
+    Returns
+    -------
+    numpy.ndarray
+        array of shape (n, 2) with rows of time and value.
+    int
+        number of values lost so far because the ring was full.
+    """
+    return _moose.poll(table)
+
+
+def _stopBackgroundRun():
+    if _moose.isRunning():
+        _moose.stop()
+    _moose.wait()
+
+
+atexit.register(_stopBackgroundRun)
+
+
+def checkpoint(filename):
+    """Save the state of the simulation to a checkpoint file.
+
+    The file holds the numerical fields of every object, the internal state
+    of solvers and synapse handlers, the clock and the random number
+    generator, so that a run can go on from this point later.
+
+    Parameters
+    ----------
+    filename : str
+        file to write.
+
+    See also
+    --------
+    moose.restore : Go on from a checkpoint.
+    """
+    if not _moose.checkpoint(filename):
+        raise RuntimeError("Could not save checkpoint to %s" % filename)
+
+
+def restore(filename):
+    """Go on with a simulation from a checkpoint file.
+
+    The model must be built again as it was when the checkpoint was saved,
+    and moose.reinit() called. The state in the file is then put back, and
+    moose.start() goes on from the time of the checkpoint.
+
+    Parameters
+    ----------
+    filename : str
+        checkpoint written by moose.checkpoint.
+
+    See also
+    --------
+    moose.checkpoint : Save a checkpoint.
+    """
+    if not _moose.restore(filename):
+        raise RuntimeError("Could not restore checkpoint from %s" % filename)
+
+
+def loadBalance():
+    """Spread the model over the MPI nodes.
+
+    Each object is given a cost, and the work is split so that the nodes
+    get about equal shares. Cells and chemical compartments stay whole
+    with their solvers and are placed so that few messages cross nodes.
+    Large arrays are cut into ranges, as are the voxels of a mesh whose
+    global Ksolve or Gsolve is set up and has no Dsolve. Messages between
+    nodes are routed as usual. Does nothing on a single node.
+
+    Call this after the objects and messages of the model are made. Objects
+    moved to another node take their fields, solver state and synapses
+    along.
+    """
+    _moose.loadBalance()
+
+
 def setCwe(arg):
     """Set the current working element.
 
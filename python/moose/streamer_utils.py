@@ -47,6 +47,37 @@ def decode_data(data):
     assert int(arr[0]) == ord('H'), "First char must be H"
     return np_array_to_data(arr)
 
+def read_bin(filename, offset=0):
+    """Read a chunked binary file written by a Table or Streamer with
+    format 'bin', while or after it is being written.
+
+    Only the chunks that are complete are read, starting at byte `offset`
+    (0 for the first chunk). Returns a structured array with one field
+    per column, and the offset to continue from once the file has grown.
+    """
+    with open(filename, 'rb') as f:
+        buf = f.read()
+    assert buf[:8] == b'MOOSEBIN', 'Not a MOOSE chunked binary file'
+    version, ncols = struct.unpack_from('=II', buf, 8)
+    n = 16
+    names = []
+    for i in range(ncols):
+        size, = struct.unpack_from('=I', buf, n)
+        names.append(buf[n+4:n+4+size].decode())
+        n += 4 + size
+    n = max(n, offset)
+    chunks = []
+    while n + 8 <= len(buf):
+        nrows, = struct.unpack_from('=Q', buf, n)
+        size = nrows * ncols * 8
+        if n + 8 + size > len(buf):
+            break
+        chunks.append(np.frombuffer(buf, float, nrows * ncols, n + 8))
+        n += 8 + size
+    data = np.concatenate(chunks) if chunks else np.zeros(0)
+    dtype = np.dtype([(name, float) for name in names])
+    return data.reshape(-1, ncols).copy().view(dtype)[:, 0], n
+
 def test():
     with open(sys.argv[1], 'rb') as f:
         data = f.read()
@@ -8,6 +8,7 @@
  *        License:  MIT License
  */
 
+#include <sstream>
 #include "RNG.h"
 
 namespace moose {
@@ -71,4 +72,17 @@ double RNG::uniform( void )
     return dist_( rng_ );
 }
 
+string RNG::getState( void ) const
+{
+    ostringstream ss;
+    ss << rng_ << ' ' << dist_;
+    return ss.str();
+}
+
+void RNG::setState( const string& state )
+{
+    istringstream ss( state );
+    ss >> rng_ >> dist_;
+}
+
 }
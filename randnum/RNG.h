@@ -23,6 +23,7 @@
 #include <iostream>
 #include <random>
 #include <cassert>
+#include <string>
 
 #include "Definitions.h"
 #include "Distributions.h"
@@ -56,6 +57,12 @@ class RNG
 
         double uniform( void );
 
+        /// State of the engine as text, for checkpoints.
+        string getState( void ) const;
+
+        /// Restores a state from getState.
+        void setState( const string& state );
+
 
     private:
         /* ====================  DATA MEMBERS  ======================================= */
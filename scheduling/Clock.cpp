@@ -50,12 +50,10 @@
 
 #include "../basecode/header.h"
 #include "../utility/print_function.hpp"
+#include "../utility/utility.h"
+#include "../utility/ThreadPool.h"
 #include "Clock.h"
 
-#if PARALLELIZE_CLOCK_USING_CPP11_ASYNC
-#include <future>
-#endif
-
 // Declaration of some static variables.
 const unsigned int Clock::numTicks = 32;
 /// minimumDt is smaller than any known event on the scales MOOSE handles.
@@ -169,6 +167,18 @@ const Cinfo* Clock::initCinfo()
         "stride = smallest active timestep/smallest defined timestep.",
         &Clock::getStride
     );
+    static ValueFinfo< Clock, unsigned int > numThreads(
+        "numThreads",
+        "Number of threads used to run solver objects on the same tick "
+        "concurrently. Objects that declare a 'coupledObjects' field "
+        "(Ksolve, Gsolve, Dsolve, HSolve) are grouped so that solvers "
+        "sharing state stay on one thread; everything else on the tick "
+        "is called serially, in the usual order. Ticks themselves are "
+        "always run one after another. Default is 1 (fully serial), or "
+        "the MOOSE_CLOCK_THREADS environment variable.",
+        &Clock::setNumThreads,
+        &Clock::getNumThreads
+    );
     static ReadOnlyValueFinfo< Clock, unsigned long > currentStep(
         "currentStep",
         "Current simulation step",
@@ -265,6 +275,7 @@ const Cinfo* Clock::initCinfo()
         &nsteps,                // ReadOnlyValue
         &numTicks,              // ReadOnlyValue
         &stride,                // ReadOnlyValue
+        &numThreads,            // Value
         &currentStep,           // ReadOnlyValue
         &dts,                   // ReadOnlyValue
         &isRunning,             // ReadOnlyValue
@@ -325,6 +336,10 @@ const Cinfo* Clock::initCinfo()
         "numerical order, lowest tick first and highest last. "
         "There is no guarantee of execution order for objects within "
         "a clock tick.\n"
+        "When numThreads > 1, solvers on the same tick that do not share "
+        "any state (for example one HSolve per neuron, or one Ksolve per "
+        "chemical compartment) are run concurrently. Ticks are still "
+        "run one after another.\n"
         "The clock provides default scheduling for all objects which "
         "can be accessed using Clock::lookupDefaultTick( className ). "
         "Specific items of note are that the output/file dump objects are "
@@ -460,7 +475,8 @@ Clock::Clock()
       isRunning_( false ),
       doingReinit_( false ),
       info_(),
-      ticks_( Clock::numTicks, 0 )
+      ticks_( Clock::numTicks, 0 ),
+      numThreads_( 1 )
 {
     buildDefaultTick();
     dt_ = defaultDt_[0];
@@ -468,6 +484,7 @@ Clock::Clock()
     {
         ticks_[i] = round( defaultDt_[i] / dt_ );
     }
+    setNumThreads( moose::getEnvInt( "MOOSE_CLOCK_THREADS", 1 ) );
 }
 
 Clock::~Clock()
@@ -539,6 +556,27 @@ vector< double > Clock::getDts() const
     return ret;
 }
 
+void Clock::getCheckpoint( vector< double >& state ) const
+{
+    state.clear();
+    state.push_back( dt_ );
+    state.push_back( currentStep_ );
+    state.push_back( currentTime_ );
+    state.insert( state.end(), ticks_.begin(), ticks_.end() );
+}
+
+void Clock::setCheckpoint( const vector< double >& state )
+{
+    if ( isRunning_ || doingReinit_ || state.size() != 3 + ticks_.size() )
+        return;
+    dt_ = state[0];
+    currentStep_ = nSteps_ = static_cast< unsigned long >( state[1] );
+    currentTime_ = info_.currTime = state[2];
+    runTime_ = nSteps_ * dt_;
+    for ( unsigned int i = 0; i < ticks_.size(); ++i )
+        ticks_[i] = static_cast< unsigned int >( state[ 3 + i ] );
+}
+
 bool Clock::isRunning() const
 {
     return isRunning_;
@@ -620,6 +658,18 @@ double Clock::getTickDt( unsigned int i ) const
     return 0.0;
 }
 
+void Clock::setNumThreads( unsigned int v )
+{
+    numThreads_ = ( v == 0 ) ? 1 : v;
+    if ( numThreads_ > 1 )
+        moose::ThreadPool::global().reserve( numThreads_ );
+}
+
+unsigned int Clock::getNumThreads() const
+{
+    return numThreads_;
+}
+
 unsigned int Clock::getDefaultTick( string s ) const
 {
     return Clock::lookupDefaultTick( s );
@@ -684,6 +734,144 @@ void Clock::buildTicks( const Eref& e )
         }
     }
     // Should really do the HCF of N numbers here to get the stride.
+
+    if ( numThreads_ > 1 )
+        buildTickPlan( e );
+    else
+        tickPlan_.clear();
+}
+
+/// True if the target's class tells us which objects its process touches.
+static bool declaresCoupling( const Eref& er )
+{
+    return er.element()->cinfo()->findFinfo( "getCoupledObjects" ) != 0;
+}
+
+/**
+ * Splits a run of solver calls into tasks with no shared state, using
+ * union-find over the objects each call declares it touches. Calls keep
+ * their original relative order inside each task, and tasks are ordered
+ * by their first call, so the plan is deterministic.
+ */
+static vector< vector< pair< const OpFunc1Base< ProcPtr >*, Eref > > >
+groupCoupledCalls(
+    const vector< pair< const OpFunc1Base< ProcPtr >*, Eref > >& calls )
+{
+    vector< unsigned int > parent( calls.size() );
+    for ( unsigned int i = 0; i < calls.size(); ++i )
+        parent[i] = i;
+    auto findRoot = [&parent]( unsigned int i ) {
+        while ( parent[i] != i )
+            i = parent[i] = parent[ parent[i] ];
+        return i;
+    };
+
+    map< ObjId, unsigned int > owner;
+    for ( unsigned int i = 0; i < calls.size(); ++i )
+    {
+        vector< ObjId > touched = Field< vector< ObjId > >::get(
+                calls[i].second.objId(), "coupledObjects" );
+        touched.push_back( calls[i].second.objId() );
+        for ( const ObjId& obj : touched )
+        {
+            auto ret = owner.insert( make_pair( obj, i ) );
+            if ( !ret.second )
+            {
+                unsigned int a = findRoot( i );
+                unsigned int b = findRoot( ret.first->second );
+                if ( a != b )
+                    parent[ max( a, b ) ] = min( a, b );
+            }
+        }
+    }
+
+    vector< vector< pair< const OpFunc1Base< ProcPtr >*, Eref > > > tasks;
+    map< unsigned int, unsigned int > rootToTask;
+    for ( unsigned int i = 0; i < calls.size(); ++i )
+    {
+        unsigned int r = findRoot( i );
+        auto ret = rootToTask.insert( make_pair( r, tasks.size() ) );
+        if ( ret.second )
+            tasks.resize( tasks.size() + 1 );
+        tasks[ ret.first->second ].push_back( calls[i] );
+    }
+    return tasks;
+}
+
+void Clock::buildTickPlan( const Eref& e )
+{
+    tickPlan_.assign( activeTicksMap_.size(), vector< TickStage >() );
+    for ( unsigned int i = 0; i < activeTicksMap_.size(); ++i )
+    {
+        // Flatten the digest into individual calls, in send order.
+        TickTask calls;
+        const vector< MsgDigest >& md =
+            e.msgDigest( processVec()[ activeTicksMap_[i] ]->getBindIndex() );
+        for ( const MsgDigest& d : md )
+        {
+            const OpFunc1Base< ProcPtr >* f =
+                dynamic_cast< const OpFunc1Base< ProcPtr >* >( d.func );
+            assert( f );
+            for ( const Eref& tgt : d.targets )
+            {
+                if ( tgt.dataIndex() == ALLDATA )
+                {
+                    Element* elm = tgt.element();
+                    unsigned int start = elm->localDataStart();
+                    unsigned int end = start + elm->numLocalData();
+                    for ( unsigned int k = start; k < end; ++k )
+                        calls.push_back( make_pair( f, Eref( elm, k ) ) );
+                }
+                else
+                {
+                    calls.push_back( make_pair( f, tgt ) );
+                }
+            }
+        }
+
+        // Consecutive ordinary objects form one serial stage. Consecutive
+        // solvers form one stage split into independent tasks.
+        vector< TickStage >& plan = tickPlan_[i];
+        unsigned int j = 0;
+        while ( j < calls.size() )
+        {
+            bool isSolver = declaresCoupling( calls[j].second );
+            TickTask run;
+            while ( j < calls.size() &&
+                    declaresCoupling( calls[j].second ) == isSolver )
+                run.push_back( calls[j++] );
+            if ( isSolver )
+                plan.push_back( groupCoupledCalls( run ) );
+            else
+                plan.push_back( TickStage( 1, run ) );
+        }
+    }
+}
+
+void Clock::processTick( const Eref& e, unsigned int activeIndex )
+{
+    if ( numThreads_ < 2 || activeIndex >= tickPlan_.size() )
+    {
+        processVec()[ activeTicksMap_[ activeIndex ] ]->send( e, &info_ );
+        return;
+    }
+
+    const ProcInfo* p = &info_;
+    for ( const TickStage& stage : tickPlan_[ activeIndex ] )
+    {
+        if ( stage.size() == 1 )
+        {
+            for ( const auto& call : stage[0] )
+                call.first->op( call.second, p );
+            continue;
+        }
+        moose::ThreadPool::global().parallelFor( stage.size(), 1,
+                [&stage, p]( size_t begin, size_t end ) {
+                    for ( size_t t = begin; t < end; ++t )
+                        for ( const auto& call : stage[t] )
+                            call.first->op( call.second, p );
+                }, numThreads_ );
+    }
 }
 
 /**
@@ -729,52 +917,14 @@ void Clock::handleStep( const Eref& e, unsigned long numSteps )
         unsigned long endStep = currentStep_ + stride_;
         currentTime_ = info_.currTime = dt_ * endStep;
 
-#if 0
-
-//#if PARALLELIZE_CLOCK_USING_CPP11_ASYNC
-
-        // NOTE: It does not produce very promising results. The challenge here
-        // is doing load-balancing.
-        // TODO: To start with, we can put one solver on one thread and everything
-        // else onto 1 thread. Each Hsove, Ksolve, and Gsolve can take its own
-        // thread and rest are on different threads.
-
-        unsigned int nTasks = activeTicks_.size( );
-        unsigned int numThreads_ = 3;
-        unsigned int blockSize = 1 + (nTasks / numThreads_);
-
-        for( unsigned int i = 0; i < numThreads_; ++i  )
-        {
-            std::async( std::launch::async, [this,blockSize,i,nTasks,endStep,e]
-            {
-                unsigned int mapI = i * blockSize;
-                // Get the block we want to run in paralle.
-                for( unsigned int ii = i * blockSize; ii < min((i+1) * blockSize, nTasks); ii++ )
-                {
-                    unsigned int j = activeTicks_[ ii ];
-                    if( endStep % j == 0  )
-                    {
-                        info_.dt = j * dt_;
-                        processVec( )[ activeTicksMap_[mapI] ]->send( e, &info_ );
-                    }
-                    mapI++;
-                }
-            }
-          );
-        }
-#else
-        vector< unsigned int >::const_iterator k = activeTicksMap_.begin();
-        for ( vector< unsigned int>::iterator j =
-                    activeTicks_.begin(); j != activeTicks_.end(); ++j )
+        for ( unsigned int i = 0; i < activeTicks_.size(); ++i )
         {
-            if ( endStep % *j == 0 )
+            if ( endStep % activeTicks_[i] == 0 )
             {
-                info_.dt = *j * dt_;
-                processVec()[*k]->send( e, &info_ );
+                info_.dt = activeTicks_[i] * dt_;
+                processTick( e, i );
             }
-            ++k;
         }
-#endif
 		info_.setRunning();
 
         // When 10% of simulation is over, notify user when notify_ is set to
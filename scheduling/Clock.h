@@ -39,6 +39,8 @@ class Clock
     unsigned long getNsteps( ) const;
     unsigned long getCurrentStep() const;
     unsigned int getStride( ) const;
+    void setNumThreads( unsigned int v );
+    unsigned int getNumThreads() const;
 
     void setTickStep( unsigned int i, unsigned int v );
     unsigned int getTickStep( unsigned int i ) const;
@@ -48,6 +50,14 @@ class Clock
 
     vector< double > getDts() const;
 
+    /**
+     * Time keeping state for checkpoints: dt, the steps done and the
+     * step of each tick. setCheckpoint leaves the Clock ready to continue
+     * from there, as if it had stopped after that many steps.
+     */
+    void getCheckpoint( vector< double >& state ) const;
+    void setCheckpoint( const vector< double >& state );
+
     //////////////////////////////////////////////////////////
     //  Dest functions
     //////////////////////////////////////////////////////////
@@ -122,6 +132,27 @@ class Clock
 
     private:
     void buildTicks( const Eref& e );
+
+    /**
+     * Builds tickPlan_ from the process messages of the active ticks.
+     * Only used when numThreads_ > 1.
+     */
+    void buildTickPlan( const Eref& e );
+
+    /// Runs one active tick, either by plain send or through tickPlan_.
+    void processTick( const Eref& e, unsigned int activeIndex );
+
+    /**
+     * A task is a list of process calls that must run in this order on
+     * one thread.
+     */
+    typedef vector< pair< const OpFunc1Base< ProcPtr >*, Eref > > TickTask;
+
+    /**
+     * Stages of a tick run one after another. The tasks within a stage
+     * touch disjoint objects and may run concurrently.
+     */
+    typedef vector< TickTask > TickStage;
     double runTime_;
     double currentTime_;
     unsigned long nSteps_;
@@ -162,6 +193,18 @@ class Clock
      */
     vector< unsigned int > activeTicksMap_;
 
+    /**
+     * Number of threads used to run independent solvers on a tick.
+     * 1 means every tick is a plain serial send.
+     */
+    unsigned int numThreads_;
+
+    /**
+     * Execution plan for each entry of activeTicks_, built by
+     * buildTickPlan when numThreads_ > 1.
+     */
+    vector< vector< TickStage > > tickPlan_;
+
     /**
      * This is the database of default scheduling. Assigns
      * classes to ticks. Filled in at Clock creation time.
@@ -0,0 +1,624 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2026 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+/**
+ * Checkpoints of a running simulation. A checkpoint holds, for every
+ * object in the tree, the value of each numerical field that can be
+ * both read and written, the internal state of the solvers,
+ * SynHandlers and integrate-and-fire neurons, and the state of the
+ * Clock and of the global RNG. It
+ * also lists the classes, sizes and messages of the objects.
+ *
+ * Restoring does not build the model. The script that made the model
+ * builds it again and calls reinit, and doRestore then checks that the
+ * objects and messages are the same as in the file before it puts
+ * the state back. The fields are read and written through their
+ * OpFuncs in the packed form of Conv, as remote gets and sets do, so
+ * doubles come back exactly. Fields are only set where they differ,
+ * and this is repeated until nothing changes, in case setting one
+ * field changes another.
+ */
+
+#include <fstream>
+#include <set>
+#include <cstdint>
+#include "../basecode/header.h"
+#include "../scheduling/Clock.h"
+#include "../synapse/SynHandlerBase.h"
+#include "../ksolve/VoxelPoolsBase.h"
+#include "../mesh/VoxelJunction.h"
+#include "../ksolve/XferInfo.h"
+#include "../ksolve/KsolveBase.h"
+#include "../hsolve/HSolveStruct.h"
+#include "../hsolve/HinesMatrix.h"
+#include "../hsolve/HSolvePassive.h"
+#include "../hsolve/RateLookup.h"
+#include "../hsolve/HSolveActive.h"
+#include "../hsolve/HSolve.h"
+#include "../biophysics/CompartmentBase.h"
+#include "../biophysics/Compartment.h"
+#include "../intfire/IntFireBase.h"
+#include "../randnum/randnum.h"
+#include "Shell.h"
+#include "Checkpoint.h"
+
+static const char checkpointMagic[] = "MOOSECKP";
+static const uint32_t checkpointVersion = 1;
+
+/**
+ * Field types that checkpoints save. Others are structure, not state.
+ * Entries moved to another node also take their text fields along.
+ */
+static bool isStateType( const string& type, bool withText = false )
+{
+    if ( withText && type == "string" )
+        return true;
+    static const set< string > types = {
+        "double", "float", "int", "unsigned int", "short",
+        "unsigned short", "long", "unsigned long", "size_t", "bool",
+        "vector<double>", "vector<float>", "vector<int>",
+        "vector<unsigned int>", "vector< vector<double> >"
+    };
+    return types.count( type ) > 0;
+}
+
+/// The fields of a class that checkpoints save.
+struct StateField
+{
+    string name;
+    const OpFunc* get;
+    const OpFunc* set;
+};
+
+static vector< StateField > stateFields( const Cinfo* cinfo,
+                                         bool withText = false )
+{
+    vector< StateField > ret;
+    // Name, parent and size are set up by the script that builds the
+    // model, so the fields of Neutral are left out.
+    unsigned int first = Neutral::initCinfo()->getNumValueFinfo();
+    for ( unsigned int i = first; i < cinfo->getNumValueFinfo(); ++i )
+    {
+        const ValueFinfoBase* vf =
+            dynamic_cast< const ValueFinfoBase* >( cinfo->getValueFinfo( i ) );
+        if ( !vf || !vf->setFinfo() || !vf->getFinfo() ||
+                !isStateType( vf->rttiType(), withText ) )
+            continue;
+        StateField f = { vf->name(), vf->getFinfo()->getOpFunc(),
+                         vf->setFinfo()->getOpFunc() };
+        ret.push_back( f );
+    }
+    return ret;
+}
+
+/// All objects of the model, parents before children.
+static void modelTree( Id id, vector< Id >& tree )
+{
+    vector< Id > kids;
+    Neutral::children( id.eref(), kids );
+    for ( Id kid : kids )
+    {
+        if ( id == Id() )
+        {
+            const string& name = kid.element()->getName();
+            if ( name == "classes" || name == "Msgs" || name == "clock" ||
+                    name == "postmaster" )
+                continue;
+        }
+        tree.push_back( kid );
+        modelTree( kid, tree );
+    }
+}
+
+/// The messages between objects of the model, as sorted text.
+static vector< string > modelMsgs( const vector< Id >& tree )
+{
+    set< ObjId > mids;
+    for ( Id id : tree )
+    {
+        const vector< ObjId >& m = id.element()->msgIn();
+        mids.insert( m.begin(), m.end() );
+    }
+    vector< string > ret;
+    for ( ObjId mid : mids )
+    {
+        const Msg* m = Msg::getMsg( mid );
+        if ( !m )
+            continue;
+        ret.push_back( mid.element()->cinfo()->name() + " " +
+                       m->e1()->id().path() + " " + m->e2()->id().path() );
+    }
+    sort( ret.begin(), ret.end() );
+    return ret;
+}
+
+/// The ObjIds of the data and field entries of an Element, in order.
+static vector< ObjId > entries( Id id )
+{
+    vector< ObjId > ret;
+    Element* e = id.element();
+    unsigned int start = e->localDataStart();
+    for ( unsigned int i = 0; i < e->numLocalData(); ++i )
+    {
+        unsigned int numField = e->numField( i );
+        for ( unsigned int j = 0; j < numField; ++j )
+            ret.push_back( ObjId( id, start + i, j ) );
+    }
+    return ret;
+}
+
+/**
+ * Internal state that the fields of an object do not show. Returns
+ * false for classes that have none.
+ */
+static bool getInternalState( const Eref& er, vector< double >& state )
+{
+    const Cinfo* cinfo = er.element()->cinfo();
+    state.clear();
+    if ( cinfo->isA( "SynHandlerBase" ) )
+        reinterpret_cast< const SynHandlerBase* >( er.data() )->
+            vGetEvents( state );
+    else if ( cinfo->isA( "Ksolve" ) || cinfo->isA( "Gsolve" ) ||
+              cinfo->isA( "Dsolve" ) )
+        reinterpret_cast< const KsolveBase* >( er.data() )->
+            getCheckpoint( state );
+    else if ( cinfo->isA( "HSolve" ) )
+        reinterpret_cast< const HSolve* >( er.data() )->
+            getCheckpoint( state );
+    else if ( cinfo->isA( "IntFireBase" ) )
+        reinterpret_cast< const moose::IntFireBase* >( er.data() )->
+            getCheckpoint( state );
+    else
+        return false;
+    return true;
+}
+
+static bool setInternalState( const Eref& er, const vector< double >& state,
+                              double t )
+{
+    const Cinfo* cinfo = er.element()->cinfo();
+    if ( cinfo->isA( "SynHandlerBase" ) )
+        reinterpret_cast< SynHandlerBase* >( er.data() )->
+            vSetEvents( state, t );
+    else if ( cinfo->isA( "Ksolve" ) || cinfo->isA( "Gsolve" ) ||
+              cinfo->isA( "Dsolve" ) )
+        reinterpret_cast< KsolveBase* >( er.data() )->
+            setCheckpoint( state );
+    else if ( cinfo->isA( "HSolve" ) )
+        return reinterpret_cast< HSolve* >( er.data() )->
+            setCheckpoint( state );
+    else if ( cinfo->isA( "IntFireBase" ) )
+        reinterpret_cast< moose::IntFireBase* >( er.data() )->
+            setCheckpoint( state );
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Reading and writing the file
+//////////////////////////////////////////////////////////////////////
+
+static void putUint( ofstream& out, uint64_t v )
+{
+    out.write( reinterpret_cast< const char* >( &v ), sizeof( v ) );
+}
+
+static void putString( ofstream& out, const string& s )
+{
+    putUint( out, s.size() );
+    out.write( s.data(), s.size() );
+}
+
+static void putVector( ofstream& out, const vector< double >& v )
+{
+    putUint( out, v.size() );
+    out.write( reinterpret_cast< const char* >( v.data() ),
+               v.size() * sizeof( double ) );
+}
+
+static uint64_t getUint( ifstream& in )
+{
+    uint64_t v = 0;
+    in.read( reinterpret_cast< char* >( &v ), sizeof( v ) );
+    return v;
+}
+
+static string getString( ifstream& in )
+{
+    uint64_t n = getUint( in );
+    if ( !in || n > ( 1UL << 32 ) )
+    {
+        in.setstate( ios::failbit );
+        return "";
+    }
+    string s( n, '\0' );
+    in.read( &s[0], n );
+    return s;
+}
+
+static void getVector( ifstream& in, vector< double >& v )
+{
+    uint64_t n = getUint( in );
+    if ( !in || n > ( 1UL << 40 ) )
+    {
+        in.setstate( ios::failbit );
+        v.clear();
+        return;
+    }
+    v.resize( n );
+    in.read( reinterpret_cast< char* >( v.data() ), n * sizeof( double ) );
+}
+
+//////////////////////////////////////////////////////////////////////
+
+bool Shell::doCheckpoint( const string& fileName ) const
+{
+    if ( isRunning() )
+    {
+        cout << "Error: Shell::doCheckpoint: cannot save while the "
+             "simulation is running.\n";
+        return false;
+    }
+    if ( numNodes() > 1 )
+    {
+        cout << "Error: Shell::doCheckpoint: not supported on more than "
+             "one node.\n";
+        return false;
+    }
+    ofstream out( fileName.c_str(), ios::binary );
+    if ( !out )
+    {
+        cout << "Error: Shell::doCheckpoint: could not open '" << fileName
+             << "'.\n";
+        return false;
+    }
+    out.write( checkpointMagic, 8 );
+    out.write( reinterpret_cast< const char* >( &checkpointVersion ),
+               sizeof( checkpointVersion ) );
+
+    vector< double > state;
+    Id clockId( 1 );
+    reinterpret_cast< const Clock* >( clockId.eref().data() )->
+        getCheckpoint( state );
+    putVector( out, state );
+    putString( out, moose::rng.getState() );
+
+    vector< Id > tree;
+    modelTree( Id(), tree );
+    putUint( out, tree.size() );
+    vector< double > buf;
+    for ( Id id : tree )
+    {
+        Element* e = id.element();
+        putString( out, id.path() );
+        putString( out, e->cinfo()->name() );
+        vector< ObjId > objs = entries( id );
+        putUint( out, e->numData() );
+        putUint( out, objs.size() );
+
+        vector< StateField > fields = stateFields( e->cinfo() );
+        putUint( out, fields.size() );
+        for ( const StateField& f : fields )
+        {
+            putString( out, f.name );
+            for ( ObjId oid : objs )
+            {
+                f.get->getBuffer( oid.eref(), buf );
+                putVector( out, buf );
+            }
+        }
+
+        // Internal state goes with each data entry.
+        unsigned int start = e->localDataStart();
+        bool hasState = getInternalState( ObjId( id, start ).eref(), state );
+        putUint( out, hasState );
+        if ( hasState )
+        {
+            for ( unsigned int i = 0; i < e->numLocalData(); ++i )
+            {
+                getInternalState( ObjId( id, start + i ).eref(), state );
+                putVector( out, state );
+            }
+        }
+    }
+
+    vector< string > msgs = modelMsgs( tree );
+    putUint( out, msgs.size() );
+    for ( const string& m : msgs )
+        putString( out, m );
+
+    if ( !out )
+    {
+        cout << "Error: Shell::doCheckpoint: could not write '" << fileName
+             << "'.\n";
+        return false;
+    }
+    return true;
+}
+
+/// The saved state of one object in the tree.
+struct SavedElement
+{
+    Id id;
+    vector< StateField > fields;
+    vector< vector< vector< double > > > values; ///< [field][entry]
+    vector< vector< double > > internal; ///< [data entry]
+};
+
+bool Shell::doRestore( const string& fileName )
+{
+    if ( isRunning() )
+    {
+        cout << "Error: Shell::doRestore: cannot restore while the "
+             "simulation is running.\n";
+        return false;
+    }
+    if ( numNodes() > 1 )
+    {
+        cout << "Error: Shell::doRestore: not supported on more than "
+             "one node.\n";
+        return false;
+    }
+    ifstream in( fileName.c_str(), ios::binary );
+    char magic[8];
+    uint32_t version = 0;
+    in.read( magic, 8 );
+    in.read( reinterpret_cast< char* >( &version ), sizeof( version ) );
+    if ( !in || string( magic, 8 ) != checkpointMagic ||
+            version != checkpointVersion )
+    {
+        cout << "Error: Shell::doRestore: '" << fileName
+             << "' is not a MOOSE checkpoint.\n";
+        return false;
+    }
+
+    // Read everything, and check it against the model, before any of
+    // the state is changed.
+    vector< double > clockState;
+    getVector( in, clockState );
+    string rngState = getString( in );
+
+    vector< Id > tree;
+    modelTree( Id(), tree );
+    uint64_t numElements = getUint( in );
+    if ( !in || numElements != tree.size() )
+    {
+        cout << "Error: Shell::doRestore: the model has " << tree.size()
+             << " objects, the checkpoint has " << numElements << ".\n";
+        return false;
+    }
+    vector< SavedElement > saved( numElements );
+    for ( SavedElement& s : saved )
+    {
+        string path = getString( in );
+        string className = getString( in );
+        uint64_t numData = getUint( in );
+        uint64_t numEntries = getUint( in );
+        ObjId oid( path );
+        if ( !in || oid.bad() ||
+                oid.element()->cinfo()->name() != className ||
+                oid.element()->numData() != numData ||
+                entries( oid.id ).size() != numEntries )
+        {
+            cout << "Error: Shell::doRestore: '" << path << "' of class "
+                 << className << " does not match the model.\n";
+            return false;
+        }
+        s.id = oid.id;
+
+        vector< StateField > fields = stateFields( oid.element()->cinfo() );
+        uint64_t numFields = getUint( in );
+        for ( uint64_t i = 0; i < numFields && in; ++i )
+        {
+            string name = getString( in );
+            vector< vector< double > > values( numEntries );
+            for ( vector< double >& v : values )
+                getVector( in, v );
+            // Fields that this build does not have are skipped.
+            for ( const StateField& f : fields )
+            {
+                if ( f.name == name )
+                {
+                    s.fields.push_back( f );
+                    s.values.push_back( values );
+                    break;
+                }
+            }
+        }
+        if ( getUint( in ) )
+        {
+            s.internal.resize( oid.element()->numLocalData() );
+            for ( vector< double >& v : s.internal )
+                getVector( in, v );
+        }
+    }
+
+    vector< string > msgs( getUint( in ) );
+    for ( string& m : msgs )
+        m = getString( in );
+    if ( !in )
+    {
+        cout << "Error: Shell::doRestore: '" << fileName
+             << "' is truncated.\n";
+        return false;
+    }
+    if ( msgs != modelMsgs( tree ) )
+    {
+        cout << "Error: Shell::doRestore: the messages of the model do not "
+             "match the checkpoint.\n";
+        return false;
+    }
+
+    Id clockId( 1 );
+    reinterpret_cast< Clock* >( clockId.eref().data() )->
+        setCheckpoint( clockState );
+    double t = Field< double >::get( clockId, "currentTime" );
+
+    vector< double > buf;
+    for ( unsigned int pass = 0; pass < 4; ++pass )
+    {
+        bool changed = false;
+        for ( const SavedElement& s : saved )
+        {
+            vector< ObjId > objs = entries( s.id );
+            for ( unsigned int i = 0; i < s.fields.size(); ++i )
+            {
+                for ( unsigned int j = 0; j < objs.size(); ++j )
+                {
+                    const vector< double >& v = s.values[i][j];
+                    Eref er = objs[j].eref();
+                    s.fields[i].get->getBuffer( er, buf );
+                    if ( buf == v )
+                        continue;
+                    vector< double > arg( v );
+                    s.fields[i].set->opBuffer( er, arg.data() );
+                    changed = true;
+                }
+            }
+        }
+        if ( !changed )
+            break;
+    }
+
+    bool ok = true;
+    for ( const SavedElement& s : saved )
+    {
+        unsigned int start = s.id.element()->localDataStart();
+        for ( unsigned int i = 0; i < s.internal.size(); ++i )
+        {
+            if ( !setInternalState( ObjId( s.id, start + i ).eref(),
+                                    s.internal[i], t ) )
+            {
+                cout << "Warning: Shell::doRestore: could not restore the "
+                     "state of " << s.id.path() << ".\n";
+                ok = false;
+            }
+        }
+    }
+    moose::rng.setState( rngState );
+    return ok;
+}
+
+///////////////////////////////////////////////////////////////////
+// State of single entries, for moving them between nodes.
+///////////////////////////////////////////////////////////////////
+
+static void packFields( const Eref& er, const vector< StateField >& fields,
+                        vector< double >& buf )
+{
+    vector< double > value;
+    for ( const StateField& f : fields )
+    {
+        f.get->getBuffer( er, value );
+        buf.push_back( value.size() );
+        buf.insert( buf.end(), value.begin(), value.end() );
+    }
+}
+
+/// Sets the fields packed by packFields, returning the position after them.
+static const double* unpackFields( const Eref& er,
+                                   const vector< StateField >& fields,
+                                   const double* buf )
+{
+    const double* begin = buf;
+    vector< double > value;
+    for ( unsigned int pass = 0; pass < 4; ++pass )
+    {
+        bool changed = false;
+        buf = begin;
+        for ( const StateField& f : fields )
+        {
+            unsigned int size = *buf++;
+            vector< double > arg( buf, buf + size );
+            buf += size;
+            f.get->getBuffer( er, value );
+            if ( value == arg )
+                continue;
+            f.set->opBuffer( er, arg.data() );
+            changed = true;
+        }
+        if ( !changed )
+            break;
+    }
+    return buf;
+}
+
+/// The FieldElements below an Element, in the order of its children.
+static vector< Id > fieldKids( Id id )
+{
+    vector< Id > kids;
+    vector< Id > ret;
+    Neutral::children( id.eref(), kids );
+    for ( Id kid : kids )
+        if ( kid.element()->hasFields() )
+            ret.push_back( kid );
+    return ret;
+}
+
+void getEntryState( const Eref& er, vector< double >& buf )
+{
+    buf.clear();
+    Element* e = er.element();
+    packFields( er, stateFields( e->cinfo(), true ), buf );
+
+    vector< double > state;
+    bool hasState = getInternalState( er, state );
+    buf.push_back( hasState );
+    if ( hasState )
+    {
+        buf.push_back( state.size() );
+        buf.insert( buf.end(), state.begin(), state.end() );
+    }
+
+    unsigned int rawIndex = er.dataIndex() - e->localDataStart();
+    for ( Id kid : fieldKids( e->id() ) )
+    {
+        vector< StateField > fields = stateFields( kid.element()->cinfo() );
+        unsigned int numField = kid.element()->numField( rawIndex );
+        buf.push_back( numField );
+        for ( unsigned int j = 0; j < numField; ++j )
+            packFields( ObjId( kid, er.dataIndex(), j ).eref(), fields, buf );
+    }
+}
+
+void setEntryState( const Eref& er, const vector< double >& buf )
+{
+    Element* e = er.element();
+    const double* p = unpackFields( er, stateFields( e->cinfo(), true ),
+                                    buf.data() );
+    if ( *p++ )
+    {
+        unsigned int size = *p++;
+        vector< double > state( p, p + size );
+        p += size;
+        double t = Field< double >::get( Id( 1 ), "currentTime" );
+        if ( !setInternalState( er, state, t ) )
+            cout << "Warning: setEntryState: could not set the state of "
+                 << er.objId().path() << ".\n";
+    }
+
+    // The size fields of the entry have been set, so its field entries
+    // are there to take their own fields.
+    unsigned int rawIndex = er.dataIndex() - e->localDataStart();
+    for ( Id kid : fieldKids( e->id() ) )
+    {
+        vector< StateField > fields = stateFields( kid.element()->cinfo() );
+        unsigned int numField = *p++;
+        for ( unsigned int j = 0; j < numField; ++j )
+        {
+            if ( j < kid.element()->numField( rawIndex ) )
+            {
+                p = unpackFields( ObjId( kid, er.dataIndex(), j ).eref(),
+                                  fields, p );
+                continue;
+            }
+            for ( unsigned int k = 0; k < fields.size(); ++k )
+                p += 1 + static_cast< unsigned int >( *p );
+        }
+    }
+}
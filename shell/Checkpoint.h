@@ -0,0 +1,27 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2026 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _CHECKPOINT_H
+#define _CHECKPOINT_H
+
+/**
+ * Packs the state of one data entry into buf: the numerical and text
+ * fields that can be read and written, the internal state of solvers
+ * and synapse handlers, and the fields of its field entries such as
+ * Synapses. Used to move entries between nodes.
+ */
+void getEntryState( const Eref& er, vector< double >& buf );
+
+/**
+ * Puts back a state packed by getEntryState, into an entry of the same
+ * class.
+ */
+void setEntryState( const Eref& er, const vector< double >& buf );
+
+#endif // _CHECKPOINT_H
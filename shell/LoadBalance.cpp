@@ -0,0 +1,631 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2013 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+/**
+ * Spreads the entries of the model over the nodes.
+ *
+ * The model is first grouped into units that must stay on one node: a
+ * chemical compartment with its tree and its solvers, and the tree of a
+ * cell with its HSolve. Every other Element is a unit of its own.
+ * Units that are big compared to the share of one node are cut into
+ * contiguous ranges: arrays by entry, and meshes by voxel when their
+ * solvers can split them. The rest are placed whole, by partitioning the
+ * graph of messages between units. Messages that end up crossing nodes
+ * go through the PostMaster as usual.
+ */
+
+#ifdef USE_MPI
+#include <mpi.h>
+#endif
+#include <queue>
+#include <numeric>
+#include "../basecode/header.h"
+#include "../ksolve/VoxelPoolsBase.h"
+#include "../mesh/VoxelJunction.h"
+#include "../ksolve/XferInfo.h"
+#include "../ksolve/KsolveBase.h"
+#include "Shell.h"
+#include "Checkpoint.h"
+#include "LoadBalance.h"
+
+vector< unsigned int > partitionRanges( const vector< double >& cost,
+                                        unsigned int numParts )
+{
+    unsigned int n = cost.size();
+    vector< double > prefix( n + 1, 0.0 );
+    for ( unsigned int i = 0; i < n; ++i )
+        prefix[i + 1] = prefix[i] + cost[i];
+    if ( prefix[n] <= 0.0 )
+        for ( unsigned int i = 0; i <= n; ++i )
+            prefix[i] = i;
+
+    vector< unsigned int > ret( numParts + 1, n );
+    ret[0] = 0;
+    unsigned int j = 0;
+    for ( unsigned int p = 1; p < numParts; ++p )
+    {
+        // Put the boundary where the running cost is closest to p shares.
+        double goal = prefix[n] * p / numParts;
+        while ( j < n && prefix[j + 1] - goal < goal - prefix[j] )
+            ++j;
+        ret[p] = j;
+    }
+    return ret;
+}
+
+vector< unsigned int > partitionGraph( const vector< double >& cost,
+                                       const vector< vector< unsigned int > >& edges,
+                                       unsigned int numParts )
+{
+    const unsigned int none = ~0U;
+    unsigned int n = cost.size();
+    vector< unsigned int > part( n, none );
+    if ( numParts <= 1 )
+    {
+        part.assign( n, 0 );
+        return part;
+    }
+    double target = accumulate( cost.begin(), cost.end(), 0.0 ) / numParts;
+    vector< double > load( numParts, 0.0 );
+
+    // Grow each part from the lowest vertex not yet placed, taking next
+    // the vertex with most edges into the part, until adding it would
+    // take the part further from its share. The queue holds the edge
+    // count and the negated vertex, so ties go to the lower vertex, and
+    // entries with an old count are skipped.
+    unsigned int seed = 0;
+    vector< unsigned int > conn( n );
+    for ( unsigned int p = 0; p < numParts; ++p )
+    {
+        bool isLast = ( p + 1 == numParts );
+        conn.assign( n, 0 );
+        priority_queue< pair< unsigned int, int > > front;
+        while ( true )
+        {
+            if ( front.empty() )
+            {
+                while ( seed < n && part[seed] != none )
+                    ++seed;
+                if ( seed == n )
+                    break;
+                front.push( make_pair( 0U, -static_cast< int >( seed ) ) );
+            }
+            unsigned int v = -front.top().second;
+            unsigned int c = front.top().first;
+            front.pop();
+            if ( part[v] != none || c != conn[v] )
+                continue;
+            if ( !isLast && load[p] > 0.0 &&
+                 load[p] + cost[v] - target > target - load[p] )
+                break;
+            part[v] = p;
+            load[p] += cost[v];
+            for ( unsigned int u : edges[v] )
+                if ( part[u] == none )
+                    front.push( make_pair( ++conn[u], -static_cast< int >( u ) ) );
+        }
+    }
+
+    // Move vertices to the part they have most edges to. Each move cuts
+    // fewer edges, so this stops.
+    double maxLoad = target * 1.05;
+    vector< unsigned int > partConn( numParts );
+    for ( unsigned int pass = 0; pass < 4; ++pass )
+    {
+        bool moved = false;
+        for ( unsigned int v = 0; v < n; ++v )
+        {
+            if ( edges[v].empty() )
+                continue;
+            partConn.assign( numParts, 0 );
+            for ( unsigned int u : edges[v] )
+                partConn[ part[u] ]++;
+            unsigned int from = part[v];
+            unsigned int best = from;
+            for ( unsigned int q = 0; q < numParts; ++q )
+                if ( partConn[q] > partConn[best] &&
+                     load[q] + cost[v] <= maxLoad )
+                    best = q;
+            if ( best != from )
+            {
+                load[from] -= cost[v];
+                load[best] += cost[v];
+                part[v] = best;
+                moved = true;
+            }
+        }
+        if ( !moved )
+            break;
+    }
+    return part;
+}
+
+///////////////////////////////////////////////////////////////////
+// Planning
+///////////////////////////////////////////////////////////////////
+
+static LocalDataElement* localElement( Id id )
+{
+    if ( !Id::isValid( id ) )
+        return 0;
+    return dynamic_cast< LocalDataElement* >( id.element() );
+}
+
+/// Fills ret with id and everything below it.
+static void getTree( Id id, vector< Id >& ret )
+{
+    ret.push_back( id );
+    vector< Id > kids;
+    Neutral::children( id.eref(), kids );
+    for ( Id kid : kids )
+        getTree( kid, ret );
+}
+
+static unsigned int findUnit( vector< unsigned int >& up, unsigned int i )
+{
+    while ( up[i] != i )
+    {
+        up[i] = up[ up[i] ];
+        i = up[i];
+    }
+    return i;
+}
+
+/// Joins the units of all the Elements in ids that are distributed.
+static void joinUnits( vector< unsigned int >& up,
+                       const vector< unsigned int >& index,
+                       const vector< Id >& ids )
+{
+    const unsigned int none = ~0U;
+    unsigned int first = none;
+    for ( Id id : ids )
+    {
+        unsigned int k = index[ id.value() ];
+        if ( k == none )
+            continue;
+        if ( first == none )
+        {
+            first = k;
+            continue;
+        }
+        // The lower index stays the root, so every node joins alike.
+        unsigned int a = findUnit( up, first );
+        unsigned int b = findUnit( up, k );
+        if ( a < b )
+            up[b] = a;
+        else if ( b < a )
+            up[a] = b;
+    }
+}
+
+static bool isChemSolver( const Cinfo* c )
+{
+    return c->isA( "Ksolve" ) || c->isA( "Gsolve" ) || c->isA( "Dsolve" ) ||
+           c->isA( "Stoich" );
+}
+
+static vector< unsigned int > wholeOnNode( unsigned int node,
+                                           unsigned int numData,
+                                           unsigned int numNodes )
+{
+    vector< unsigned int > ret( numNodes + 1, numData );
+    for ( unsigned int i = 0; i <= node; ++i )
+        ret[i] = 0;
+    return ret;
+}
+
+LoadBalancePlan planLoadBalance( unsigned int numNodes )
+{
+    const unsigned int none = ~0U;
+    LoadBalancePlan plan;
+    if ( numNodes == 0 )
+        return plan;
+
+    // The Elements whose entries are spread over the nodes.
+    vector< Id > elms;
+    vector< unsigned int > index( Id::numIds(), none );
+    for ( unsigned int i = 0; i < Id::numIds(); ++i )
+    {
+        if ( localElement( Id( i ) ) )
+        {
+            index[i] = elms.size();
+            elms.push_back( Id( i ) );
+        }
+    }
+    unsigned int n = elms.size();
+    vector< unsigned int > up( n );
+    iota( up.begin(), up.end(), 0 );
+
+    // Group the solvers with what they solve. Fields are read only from
+    // global solvers, which every node has.
+    vector< Id > compts;
+    map< Id, vector< Id > > solvers;
+    for ( unsigned int i = 0; i < Id::numIds(); ++i )
+    {
+        Id id( i );
+        if ( !Id::isValid( id ) )
+            continue;
+        const Cinfo* c = id.element()->cinfo();
+        if ( c->isA( "ChemCompt" ) )
+            compts.push_back( id );
+        else if ( !id.element()->isGlobal() )
+            continue;
+        else if ( isChemSolver( c ) )
+            solvers[ Field< Id >::get( id, "compartment" ) ].push_back( id );
+        else if ( c->isA( "HSolve" ) )
+        {
+            string target = Field< string >::get( id, "target" );
+            if ( target.empty() )
+                continue;
+            Id cell( target );
+            if ( cell == Id() )
+                continue;
+            vector< Id > tree;
+            getTree( cell, tree );
+            joinUnits( up, index, tree );
+        }
+    }
+    map< Id, vector< Id > > comptTrees;
+    for ( Id compt : compts )
+    {
+        vector< Id >& tree = comptTrees[ compt ];
+        getTree( compt, tree );
+        vector< Id > all = tree;
+        all.insert( all.end(), solvers[ compt ].begin(),
+                    solvers[ compt ].end() );
+        joinUnits( up, index, all );
+    }
+
+    // An entry costs 1, except for the plain Neutrals that hold things.
+    vector< double > unitCost( n, 0.0 );
+    vector< unsigned int > unitSize( n, 0 );
+    vector< unsigned int > unitCompts( n, 0 );
+    double total = 0.0;
+    for ( unsigned int k = 0; k < n; ++k )
+    {
+        const Element* e = elms[k].element();
+        double cost = ( e->cinfo() == Neutral::initCinfo() ) ? 0.0 :
+                      e->numData();
+        unsigned int u = findUnit( up, k );
+        unitCost[u] += cost;
+        unitSize[u]++;
+        if ( e->cinfo()->isA( "ChemCompt" ) )
+            unitCompts[u]++;
+        total += cost;
+    }
+    double target = total / numNodes;
+    vector< bool > isSplit( n, false );
+
+    // Cut meshes into voxel ranges, if their solvers hold all the voxels
+    // and there is no diffusion between them.
+    for ( Id compt : compts )
+    {
+        unsigned int k = index[ compt.value() ];
+        if ( k == none )
+            continue;
+        unsigned int u = findUnit( up, k );
+        if ( unitCompts[u] != 1 || unitCost[u] <= target / 2 )
+            continue;
+        const vector< Id >& tree = comptTrees[ compt ];
+        unsigned int numVoxels = 0;
+        for ( Id id : tree )
+            if ( id.element()->cinfo()->isA( "PoolBase" ) )
+                numVoxels = max( numVoxels, id.element()->numData() );
+        if ( numVoxels <= 1 )
+            continue;
+        vector< Id > voxelSolvers;
+        bool canSplit = true;
+        bool isStochastic = false;
+        for ( Id id : tree )
+            if ( isChemSolver( id.element()->cinfo() ) &&
+                 !id.element()->isGlobal() )
+                canSplit = false;
+        for ( Id s : solvers[ compt ] )
+        {
+            const Cinfo* c = s.element()->cinfo();
+            if ( c->isA( "Dsolve" ) )
+                canSplit = false;
+            else if ( c->isA( "Ksolve" ) || c->isA( "Gsolve" ) )
+            {
+                const KsolveBase* ks =
+                    reinterpret_cast< const KsolveBase* >( ObjId( s ).data() );
+                if ( ks->getNumLocalVoxels() != numVoxels )
+                    canSplit = false;
+                isStochastic |= c->isA( "Gsolve" );
+                voxelSolvers.push_back( s );
+            }
+        }
+        if ( !canSplit || voxelSolvers.empty() )
+            continue;
+
+        // Stochastic steps go as the number of molecules, which goes as
+        // the volume.
+        vector< double > voxelCost( numVoxels, 1.0 );
+        if ( isStochastic )
+        {
+            const KsolveBase* ks = reinterpret_cast< const KsolveBase* >(
+                                       ObjId( voxelSolvers[0] ).data() );
+            for ( unsigned int v = 0; v < numVoxels; ++v )
+                voxelCost[v] = ks->volume( v );
+        }
+        vector< unsigned int > starts = partitionRanges( voxelCost, numNodes );
+        for ( Id id : tree )
+            if ( index[ id.value() ] != none &&
+                 id.element()->numData() == numVoxels )
+                plan.nodeStarts[ id ] = starts;
+        for ( Id s : voxelSolvers )
+            plan.voxelStarts[ s ] = starts;
+        isSplit[u] = true;
+    }
+
+    // Cut big arrays into even ranges.
+    for ( unsigned int k = 0; k < n; ++k )
+    {
+        unsigned int u = findUnit( up, k );
+        unsigned int numData = elms[k].element()->numData();
+        if ( isSplit[u] || unitSize[u] != 1 || numData <= 1 ||
+             unitCost[u] <= target / 2 )
+            continue;
+        plan.nodeStarts[ elms[k] ] = partitionRanges(
+                                         vector< double >( numData, 1.0 ), numNodes );
+        isSplit[u] = true;
+    }
+
+    // Place the remaining units whole.
+    vector< unsigned int > vertex( n, none );
+    vector< double > cost;
+    for ( unsigned int k = 0; k < n; ++k )
+    {
+        unsigned int u = findUnit( up, k );
+        if ( u == k && !isSplit[u] )
+        {
+            vertex[u] = cost.size();
+            cost.push_back( unitCost[u] );
+        }
+    }
+    vector< vector< unsigned int > > edges( cost.size() );
+    for ( unsigned int k = 0; k < n; ++k )
+    {
+        unsigned int a = vertex[ findUnit( up, k ) ];
+        if ( a == none )
+            continue;
+        const Element* e = elms[k].element();
+        for ( ObjId mid : e->msgIn() )
+        {
+            const Msg* m = Msg::getMsg( mid );
+            if ( !m || m->e1() != e )
+                continue;
+            unsigned int other = index[ m->e2()->id().value() ];
+            if ( other == none )
+                continue;
+            unsigned int b = vertex[ findUnit( up, other ) ];
+            if ( b == none || b == a )
+                continue;
+            edges[a].push_back( b );
+            edges[b].push_back( a );
+        }
+    }
+    vector< unsigned int > part = partitionGraph( cost, edges, numNodes );
+    for ( unsigned int k = 0; k < n; ++k )
+    {
+        unsigned int a = vertex[ findUnit( up, k ) ];
+        if ( a != none )
+            plan.nodeStarts[ elms[k] ] = wholeOnNode( part[a],
+                                         elms[k].element()->numData(), numNodes );
+    }
+    return plan;
+}
+
+/**
+ * Sends sendBuf[i] to node i, and returns what the other nodes sent
+ * here, in the order of the nodes.
+ */
+static vector< double > exchangeEntries(
+    const vector< vector< double > >& sendBuf )
+{
+#ifdef USE_MPI
+    unsigned int numNodes = sendBuf.size();
+    vector< int > sendCount( numNodes );
+    vector< int > sendDispl( numNodes );
+    vector< double > send;
+    for ( unsigned int i = 0; i < numNodes; ++i )
+    {
+        sendDispl[i] = send.size();
+        sendCount[i] = sendBuf[i].size();
+        send.insert( send.end(), sendBuf[i].begin(), sendBuf[i].end() );
+    }
+    vector< int > recvCount( numNodes );
+    vector< int > recvDispl( numNodes );
+    MPI_Alltoall( sendCount.data(), 1, MPI_INT,
+                  recvCount.data(), 1, MPI_INT, MPI_COMM_WORLD );
+    int total = 0;
+    for ( unsigned int i = 0; i < numNodes; ++i )
+    {
+        recvDispl[i] = total;
+        total += recvCount[i];
+    }
+    vector< double > recv( total );
+    MPI_Alltoallv( send.data(), sendCount.data(), sendDispl.data(),
+                   MPI_DOUBLE, recv.data(), recvCount.data(),
+                   recvDispl.data(), MPI_DOUBLE, MPI_COMM_WORLD );
+    return recv;
+#else
+    // Without MPI there is one node, and nothing leaves it.
+    return vector< double >();
+#endif
+}
+
+void applyLoadBalance( const LoadBalancePlan& plan )
+{
+    unsigned int numNodes = Shell::numNodes();
+    unsigned int myNode = Shell::myNode();
+
+    // Pack the state of the entries that leave this node, as records of
+    // Id, DataId, size and state, for the node they go to.
+    vector< pair< LocalDataElement*, const vector< unsigned int >* > > moves;
+    vector< vector< double > > sendBuf( numNodes );
+    vector< double > state;
+    for ( auto i = plan.nodeStarts.begin(); i != plan.nodeStarts.end(); ++i )
+    {
+        LocalDataElement* le = localElement( i->first );
+        const vector< unsigned int >& starts = i->second;
+        if ( !le || starts.size() != numNodes + 1 ||
+             starts.back() != le->numData() )
+            continue;
+        bool isSame = true;
+        for ( unsigned int j = 0; j < numNodes; ++j )
+            isSame &= ( le->startDataIndex( j ) == starts[j] );
+        if ( isSame )
+            continue;
+        moves.push_back( make_pair( le, &starts ) );
+        unsigned int start = le->localDataStart();
+        for ( unsigned int j = 0; j < le->numLocalData(); ++j )
+        {
+            unsigned int dataId = start + j;
+            unsigned int node = upper_bound( starts.begin(), starts.end() - 1,
+                                             dataId ) - starts.begin() - 1;
+            if ( node == myNode )
+                continue;
+            getEntryState( ObjId( i->first, dataId ).eref(), state );
+            vector< double >& buf = sendBuf[node];
+            buf.push_back( i->first.value() );
+            buf.push_back( dataId );
+            buf.push_back( state.size() );
+            buf.insert( buf.end(), state.begin(), state.end() );
+        }
+    }
+    vector< double > recvBuf = exchangeEntries( sendBuf );
+
+    // The entries that arrive start as copies, and then take the state
+    // that was sent along.
+    for ( auto& m : moves )
+        m.first->setNodeStarts( *m.second );
+    for ( size_t k = 0; k + 3 <= recvBuf.size(); )
+    {
+        Id id( static_cast< unsigned int >( recvBuf[k] ) );
+        unsigned int dataId = recvBuf[k + 1];
+        unsigned int size = recvBuf[k + 2];
+        state.assign( recvBuf.begin() + k + 3, recvBuf.begin() + k + 3 + size );
+        setEntryState( ObjId( id, dataId ).eref(), state );
+        k += 3 + size;
+    }
+
+    for ( auto i = plan.voxelStarts.begin(); i != plan.voxelStarts.end(); ++i )
+    {
+        const vector< unsigned int >& starts = i->second;
+        if ( !Id::isValid( i->first ) || starts.size() != numNodes + 1 )
+            continue;
+        KsolveBase* ks = reinterpret_cast< KsolveBase* >(
+                             ObjId( i->first ).data() );
+        if ( ks->getNumLocalVoxels() == starts.back() )
+            ks->setLocalVoxels( starts[myNode],
+                                starts[myNode + 1] - starts[myNode] );
+    }
+}
+
+///////////////////////////////////////////////////////////////////
+// Tests
+///////////////////////////////////////////////////////////////////
+
+static unsigned int nodeOf( const vector< unsigned int >& starts )
+{
+    unsigned int node = 0;
+    while ( starts[node + 1] == 0 )
+        ++node;
+    return node;
+}
+
+void testLoadBalance()
+{
+    vector< unsigned int > r = partitionRanges( vector< double >( 10, 1.0 ), 4 );
+    assert( r.size() == 5 );
+    assert( r[0] == 0 && r[1] == 2 && r[2] == 5 && r[3] == 7 && r[4] == 10 );
+    r = partitionRanges( { 4, 1, 1, 1, 1 }, 2 );
+    assert( r[1] == 1 && r[2] == 5 );
+    r = partitionRanges( vector< double >( 6, 0.0 ), 3 );
+    assert( r[1] == 2 && r[2] == 4 && r[3] == 6 );
+    r = partitionRanges( vector< double >( 2, 1.0 ), 4 );
+    for ( unsigned int i = 1; i < r.size(); ++i )
+        assert( r[i] >= r[i - 1] );
+    assert( r.back() == 2 );
+
+    // Two cliques with interleaved vertices, joined by one edge.
+    vector< vector< unsigned int > > edges( 8 );
+    for ( unsigned int i = 0; i < 8; ++i )
+        for ( unsigned int j = i % 2; j < 8; j += 2 )
+            if ( i != j )
+                edges[i].push_back( j );
+    edges[6].push_back( 7 );
+    edges[7].push_back( 6 );
+    vector< unsigned int > part = partitionGraph( vector< double >( 8, 1.0 ),
+                                  edges, 2 );
+    for ( unsigned int i = 0; i < 8; ++i )
+        assert( part[i] == i % 2 );
+    part = partitionGraph( vector< double >( 9, 1.0 ),
+                           vector< vector< unsigned int > >( 9 ), 3 );
+    vector< unsigned int > count( 3, 0 );
+    for ( unsigned int p : part )
+        count[p]++;
+    assert( count[0] == 3 && count[1] == 3 && count[2] == 3 );
+
+    Shell* shell = reinterpret_cast< Shell* >( Id().eref().data() );
+    Id top = shell->doCreate( "Neutral", Id(), "lb", 1 );
+    Id fire = shell->doCreate( "IntFire", top, "fire", 100 );
+    Id cell[2];
+    Id compt[2];
+    Id chan[2];
+    for ( unsigned int i = 0; i < 2; ++i )
+    {
+        cell[i] = shell->doCreate( "Neutral", top, "cell" + to_string( i ), 1 );
+        compt[i] = shell->doCreate( "Compartment", cell[i], "compt", 12 );
+        chan[i] = shell->doCreate( "HHChannel", compt[i], "chan", 12 );
+        shell->doAddMsg( "OneToOne", compt[i], "channel", chan[i], "channel" );
+    }
+    LoadBalancePlan plan = planLoadBalance( 2 );
+    const vector< unsigned int >& fs = plan.nodeStarts[ fire ];
+    assert( fs.size() == 3 );
+    assert( fs[0] == 0 && fs[1] == 50 && fs[2] == 100 );
+    for ( unsigned int i = 0; i < 2; ++i )
+    {
+        assert( plan.nodeStarts[ compt[i] ].back() == 12 );
+        assert( nodeOf( plan.nodeStarts[ compt[i] ] ) ==
+                nodeOf( plan.nodeStarts[ chan[i] ] ) );
+    }
+    assert( nodeOf( plan.nodeStarts[ compt[0] ] ) !=
+            nodeOf( plan.nodeStarts[ compt[1] ] ) );
+    assert( plan.voxelStarts.empty() );
+
+    // On one node everything is already in place.
+    applyLoadBalance( planLoadBalance( 1 ) );
+    assert( fire.element()->numData() == 100 );
+    assert( fire.element()->numLocalData() == 100 );
+
+    // The state sent with a moved entry carries its fields and synapses.
+    Field< double >::set( ObjId( fire, 3 ), "Vm", 0.1 / 3.0 );
+    Field< double >::set( ObjId( fire, 3 ), "thresh", 0.7 );
+    vector< double > state;
+    getEntryState( ObjId( fire, 3 ).eref(), state );
+    setEntryState( ObjId( fire, 5 ).eref(), state );
+    assert( doubleEq( Field< double >::get( ObjId( fire, 5 ), "Vm" ), 0.1 / 3.0 ) );
+    assert( doubleEq( Field< double >::get( ObjId( fire, 5 ), "thresh" ), 0.7 ) );
+    Id syn = shell->doCreate( "SimpleSynHandler", top, "syn", 4 );
+    Id synapse( syn.value() + 1 );
+    Field< unsigned int >::set( ObjId( syn, 1 ), "numSynapses", 3 );
+    for ( unsigned int j = 0; j < 3; ++j )
+        Field< double >::set( ObjId( synapse, 1, j ), "weight", 0.1 * ( j + 1 ) );
+    getEntryState( ObjId( syn, 1 ).eref(), state );
+    setEntryState( ObjId( syn, 2 ).eref(), state );
+    assert( Field< unsigned int >::get( ObjId( syn, 2 ), "numSynapses" ) == 3 );
+    for ( unsigned int j = 0; j < 3; ++j )
+        assert( doubleEq( Field< double >::get( ObjId( synapse, 2, j ), "weight" ),
+                          0.1 * ( j + 1 ) ) );
+
+    shell->doDelete( top );
+    cout << "." << flush;
+}
@@ -0,0 +1,75 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2013 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _LOAD_BALANCE_H
+#define _LOAD_BALANCE_H
+
+#include <map>
+#include <vector>
+using namespace std;
+
+class Id;
+
+/**
+ * Splits a sequence of items with the given costs into numParts
+ * contiguous ranges of about equal cost. Returns numParts + 1 boundaries:
+ * part i has the items from ret[i] up to ret[i+1]. If all costs are zero
+ * the items are split by count.
+ */
+vector< unsigned int > partitionRanges( const vector< double >& cost,
+                                        unsigned int numParts );
+
+/**
+ * Assigns each vertex of a graph to one of numParts parts, so that the
+ * parts have about equal cost and few edges cross between them.
+ * Parts are grown one at a time from the lowest unassigned vertex, each
+ * time taking the vertex with most edges into the part. Then vertices
+ * are moved to the part they have most edges to, as long as that part
+ * stays within 5% of its share. Parallel edges count as heavier edges.
+ */
+vector< unsigned int > partitionGraph( const vector< double >& cost,
+                                       const vector< vector< unsigned int > >& edges,
+                                       unsigned int numParts );
+
+/**
+ * Where the entries of the distributed Elements go on numNodes nodes.
+ */
+struct LoadBalancePlan
+{
+    /// Start of the entries on each node, numNodes + 1 values per Element.
+    map< Id, vector< unsigned int > > nodeStarts;
+    /// Start of the voxels on each node, for each chemical solver split.
+    map< Id, vector< unsigned int > > voxelStarts;
+};
+
+/**
+ * Works out how to spread the model over numNodes nodes. Each entry of
+ * an Element costs 1, except for plain Neutrals which cost nothing.
+ * A chemical compartment stays together with its tree and its solvers,
+ * as does the tree of a cell under an HSolve. Large arrays, and meshes
+ * solved by global Ksolves or Gsolves without a Dsolve, are cut into
+ * contiguous ranges of entries or voxels. Everything else is placed
+ * whole, by partitioning the graph of messages between Elements.
+ * Only fields of global solvers are read, so every node arrives at the
+ * same plan.
+ */
+LoadBalancePlan planLoadBalance( unsigned int numNodes );
+
+/**
+ * Moves entries between nodes as the plan says. Must be called on every
+ * node with the same plan. Entries that leave a node send their fields,
+ * solver state and field entries such as synapses along, and these are
+ * set on the copies made where they arrive. Messages are not moved, so
+ * this should be done after the objects and messages of the model are
+ * made. Chemical solvers have their voxels split only if they are already set
+ * up and still hold all their voxels.
+ */
+void applyLoadBalance( const LoadBalancePlan& plan );
+
+#endif // _LOAD_BALANCE_H
@@ -131,6 +131,12 @@ bool findModelParent( Id cwe, const string& path,
 /// Returns the Id of the loaded model.
 Id Shell::doLoadModel( const string& fileName, const string& modelPath, const string& solverClass )
 {
+    if ( isWaitingForBackgroundRun() )
+    {
+        cout << "Warning: Shell::doLoadModel: simulation in progress.\n"
+             " Command ignored\n";
+        return Id();
+    }
     ifstream fin( fileName.c_str() );
     if ( !fin )
     {
@@ -651,35 +651,27 @@ bool Neutral::isDescendant(Id me, Id ancestor)
 // static function
 Id Neutral::child(const Eref& e, const string& name)
 {
-    static const Finfo* pf = neutralCinfo->findFinfo("parentMsg");
-    static const DestFinfo* pf2 = dynamic_cast<const DestFinfo*>(pf);
-    static const FuncId pafid = pf2->getFid();
-    static const Finfo* cf = neutralCinfo->findFinfo("childOut");
-    static const SrcFinfo* cf2 = dynamic_cast<const SrcFinfo*>(cf);
-    static const BindIndex bi = cf2->getBindIndex();
-
-    const vector<MsgFuncBinding>* bvec = e.element()->getMsgAndFunc(bi);
-
-    vector<Id> ret;
-
-    for(vector<MsgFuncBinding>::const_iterator i = bvec->begin();
-        i != bvec->end(); ++i) {
-        if(i->fid == pafid) {
-            const Msg* m = Msg::getMsg(i->mid);
-            assert(m);
-            Element* e2 = m->e2();
-            if(e2->getName() == name) {
-                if(e.dataIndex() == ALLDATA)  // Child of any index is OK
-                {
-                    return e2->id();
-                } else {
-                    ObjId parent = m->findOtherEnd(m->getE2());
-                    // If child is a fieldElement, then all parent indices
-                    // are permitted. Otherwise insist parent dataIndex OK.
-                    if(e2->hasFields() || parent == e.objId())
-                        return e2->id();
-                }
-            }
+    // The Element keeps its child Msgs indexed by name, so only the
+    // children with this name are looked at.
+    pair<Element::ChildIndex::const_iterator,
+         Element::ChildIndex::const_iterator> range =
+        e.element()->findChildMsgs(name);
+
+    for(Element::ChildIndex::const_iterator i = range.first;
+        i != range.second; ++i) {
+        const Msg* m = Msg::getMsg(i->second);
+        assert(m);
+        Element* e2 = m->e2();
+        assert(e2->getName() == name);
+        if(e.dataIndex() == ALLDATA)  // Child of any index is OK
+        {
+            return e2->id();
+        } else {
+            ObjId parent = m->findOtherEnd(m->getE2());
+            // If child is a fieldElement, then all parent indices
+            // are permitted. Otherwise insist parent dataIndex OK.
+            if(e2->hasFields() || parent == e.objId())
+                return e2->id();
         }
     }
     return Id();
@@ -702,7 +694,9 @@ ObjId Neutral::parent(ObjId oid)
         return Id();
     }
 
-    ObjId mid = oid.element()->findCaller(pafid);
+    ObjId mid = oid.element()->findParentMsg();
+    if(mid.dataIndex == BADINDEX)
+        mid = oid.element()->findCaller(pafid);
     assert(mid != ObjId());
 
     ObjId pa = Msg::getMsg(mid)->findOtherEnd(oid);
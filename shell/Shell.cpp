@@ -10,6 +10,7 @@
 #include <string>
 #include <algorithm>
 #include <chrono>
+#include <mutex>
 
 #include "../basecode/header.h"
 #include "../basecode/global.h"
@@ -28,6 +29,7 @@
 
 #include "Shell.h"
 #include "Wildcard.h"
+#include "../utility/LruCache.h"
 
 // Want to separate out this search path into the Makefile options
 #include "../scheduling/Clock.h"
@@ -46,6 +48,9 @@ vector<unsigned int> Shell::acked_(1, 0);
 bool Shell::doReinit_(0);
 bool Shell::isParserIdle_(0);
 double Shell::runtime_(0.0);
+std::future<void> Shell::backgroundRun_;
+std::atomic<bool> Shell::isRunningInBackground_(false);
+thread_local bool Shell::startedBackgroundRun_ = false;
 
 const Cinfo* Shell::initCinfo()
 {
@@ -97,6 +102,12 @@ const Cinfo* Shell::initCinfo()
         "quit", "Stops simulation running and quits the simulator",
         new OpFunc0<Shell>(&Shell::handleQuit));
 
+    static DestFinfo handleLoadBalance(
+        "loadBalance",
+        "Spreads the entries of the model over the nodes, by their cost "
+        "and the messages between them. Runs on every node.",
+        new OpFunc0<Shell>(&Shell::handleLoadBalance));
+
     static DestFinfo handleMove(
         "move",
         "handleMove( Id orig, Id newParent ): "
@@ -122,7 +133,8 @@ const Cinfo* Shell::initCinfo()
 
     static Finfo* shellFinfos[] = {&setclock,   &handleCreate,   &handleDelete,
                                    &handleCopy, &handleMove,     &handleAddMsg,
-                                   &handleQuit, &handleUseClock, };
+                                   &handleQuit, &handleUseClock,
+                                   &handleLoadBalance, };
 
     static Dinfo<Shell> d;
     static Cinfo shellCinfo("Shell", Neutral::initCinfo(), shellFinfos,
@@ -168,6 +180,11 @@ void Shell::setShellElement(Element* shelle)
 Id Shell::doCreate(string type, ObjId parent, string name, unsigned int numData,
                    NodePolicy nodePolicy, unsigned int preferredNode)
 {
+    if (isWaitingForBackgroundRun()) {
+        cout << "Warning: Shell::doCreate: simulation in progress.\n"
+                " Command ignored\n";
+        return Id();
+    }
 
     const Cinfo* c = Cinfo::find(type);
     if (!isNameValid(name)) {
@@ -243,7 +260,8 @@ Id Shell::doCreate2(string type, ObjId parent, string name,
 
 bool Shell::doDelete(ObjId oid)
 {
-    SetGet1<ObjId>::set(ObjId(), "delete", oid);
+    if (!SetGet1<ObjId>::set(ObjId(), "delete", oid))
+        return false;
     /*
        Neutral n;
        n.destroy( i.eref(), 0 );
@@ -254,6 +272,11 @@ bool Shell::doDelete(ObjId oid)
 ObjId Shell::doAddMsg(const string& msgType, ObjId src, const string& srcField,
                       ObjId dest, const string& destField)
 {
+    if (isWaitingForBackgroundRun()) {
+        cout << "Warning: Shell::doAddMsg: simulation in progress.\n"
+                " Command ignored\n";
+        return ObjId(0, BADINDEX);
+    }
 
     if (!src.id.element()) {
         cout << myNode_ << ": Error: Shell::doAddMsg: src not found" << endl;
@@ -302,7 +325,22 @@ void Shell::doQuit()
     SetGet0::set(ObjId(), "quit");
 }
 
+void Shell::doLoadBalance()
+{
+    SetGet0::set(ObjId(), "loadBalance");
+}
+
 void Shell::doStart(double runtime, bool notify)
+{
+    if (isRunningInBackground_) {
+        cout << "Warning: Shell::doStart: simulation already in progress.\n"
+                " Command ignored\n";
+        return;
+    }
+    innerStart(runtime, notify);
+}
+
+void Shell::innerStart(double runtime, bool notify)
 {
     Id clockId(1);
     SetGet2<double, bool>::set(clockId, "start", runtime, notify);
@@ -321,6 +359,8 @@ void Shell::doStart(double runtime, bool notify)
         Streamer* pStreamer = reinterpret_cast<Streamer*>(itr->data());
         pStreamer->cleanUp();
     }
+    // Make the files of streaming Tables readable as they are.
+    StreamSink::syncAll();
 
     // Print the stats collected by profiling map.
     char* p = getenv("MOOSE_SHOW_SOLVER_PERF");
@@ -337,6 +377,11 @@ bool isDoingReinit()
 
 void Shell::doReinit()
 {
+    if (isRunningInBackground_) {
+        cout << "Warning: Shell::doReinit: simulation already in progress.\n"
+                " Command ignored\n";
+        return;
+    }
     Id clockId(1);
     SetGet0::set(clockId, "reinit");
 }
@@ -497,10 +542,57 @@ bool Shell::chopPath(const string& path, vector<string>& ret,
     return isAbsolute;
 }
 
+/**
+ * Absolute paths recently resolved by doFind. Allocated once and never
+ * freed, because Elements may still be destroyed, and clear it, during
+ * static destruction.
+ */
+static moose::LruCache<string, ObjId>& pathCache()
+{
+    static moose::LruCache<string, ObjId>* cache =
+        new moose::LruCache<string, ObjId>(4096);
+    return *cache;
+}
+
+static std::mutex& pathCacheMutex()
+{
+    static std::mutex* m = new std::mutex();
+    return *m;
+}
+
+void Shell::clearPathCache()
+{
+    std::lock_guard<std::mutex> lock(pathCacheMutex());
+    pathCache().clear();
+}
+
 ObjId Shell::doFind(const string& path) const
 {
     if (path == "/" || path == "/root") return ObjId();
 
+    // Relative paths depend on cwe_, so only absolute ones are cached.
+    bool isCached = path[0] == '/';
+    if (isCached) {
+        ObjId ret;
+        std::lock_guard<std::mutex> lock(pathCacheMutex());
+        if (pathCache().get(path, ret)) {
+            // Resizing an Element does not clear the cache.
+            if (ret.element() && ret.dataIndex < ret.element()->numData())
+                return ret;
+            pathCache().erase(path);
+        }
+    }
+
+    ObjId curr = innerFind(path);
+    if (isCached && !curr.bad()) {
+        std::lock_guard<std::mutex> lock(pathCacheMutex());
+        pathCache().put(path, curr);
+    }
+    return curr;
+}
+
+ObjId Shell::innerFind(const string& path) const
+{
     ObjId curr;
     vector<string> names;
     vector<unsigned int> indices;
@@ -562,7 +654,13 @@ bool Shell::isRunning() const
     static Id clockId(1);
     assert(clockId.element() != 0);
 
-    return (reinterpret_cast<const Clock*>(clockId.eref().data()))->isRunning();
+    return isRunningInBackground_ ||
+           (reinterpret_cast<const Clock*>(clockId.eref().data()))->isRunning();
+}
+
+bool Shell::isWaitingForBackgroundRun()
+{
+    return startedBackgroundRun_ && isRunningInBackground_;
 }
 
 /**
@@ -895,6 +993,11 @@ void Shell::handleQuit()
     Shell::keepLooping_ = 0;
 }
 
+void Shell::handleLoadBalance()
+{
+    loadBalance();
+}
+
 // Static function
 bool Shell::keepLooping()
 {
@@ -919,6 +1022,10 @@ void Shell::cleanSimulation()
 {
     Eref sheller = Id().eref();
     Shell* s = reinterpret_cast<Shell*>(sheller.data());
+    if (isRunningInBackground_) {
+        s->doStop();
+        s->doWait();
+    }
     vector<Id> kids;
     Neutral::children(sheller, kids);
     for (vector<Id>::iterator i = kids.begin(); i != kids.end(); ++i) {
@@ -11,6 +11,8 @@
 #define _SHELL_H
 
 #include <string>
+#include <atomic>
+#include <future>
 using namespace std;
 
 class DestFinfo;
@@ -68,6 +70,13 @@ public:
      */
     bool isRunning() const;
 
+    /**
+     * True if a run started by doNonBlockingStart is going on and this
+     * is the thread that started it. Such calls may read fields and stop
+     * the clock, but not change the model, see SetGet::checkSet.
+     */
+    static bool isWaitingForBackgroundRun();
+
     void setupSocketStreamer(const string host, const int port );
 
     ///////////////////////////////////////////////////////////
@@ -114,6 +123,12 @@ public:
      */
     void doQuit( );
 
+    /**
+     * Redistributes the model over all nodes. Call after the objects
+     * and messages are made, before their fields are set.
+     */
+    void doLoadBalance( );
+
     /**
      * Starts off simulation, to run for 'runtime' more than current
      * time. This version is blocking, and returns only when the
@@ -127,12 +142,20 @@ public:
      * time. This version returns at once, and the parser can go
      * on to do other things. It has to check with the
      * Shell::isRunning function (accessible as a MOOSE field)
-     * to find out if it is finished. Can call 'doStop', 'doTerminate'
-     * or 'doReinit' at any time to stop the run with increasing
-     * levels of prejudice.
+     * to find out if it is finished. Can call 'doStop' at any time
+     * to stop the run.
+     * The run goes on a thread of its own. Until it is over, field sets
+     * and the calls that create, delete, move, copy or connect objects
+     * or change the clock are refused with a warning, see doWait.
      */
     void doNonBlockingStart( double runtime );
 
+    /**
+     * Blocks until the run started by doNonBlockingStart is over.
+     * Returns at once if there is none.
+     */
+    void doWait();
+
     /**
      * Reinitializes simulation: time goes to zero, all scheduled
      * objects are set to initial conditions. If simulation is
@@ -175,6 +198,12 @@ public:
      */
     ObjId doFind( const string& path ) const;
 
+    /**
+     * Forgets the paths that doFind has cached. Called whenever an
+     * Element is renamed, moved or deleted.
+     */
+    static void clearPathCache();
+
     /**
      * Connects up process messages from the specified Tick to the
      * targets on the path. Does so for whole Elements, not individual
@@ -208,6 +237,23 @@ public:
      */
     void doSaveModel( Id model, const string& fileName, bool qflag = 0 ) const;
 
+    /**
+     * Saves the state of the simulation to a checkpoint file: the
+     * numerical fields of every object, the internal state of solvers,
+     * SynHandlers and integrate-and-fire neurons, the Clock and the
+     * random number generator.
+     * Returns false on failure. Works on a single node only.
+     */
+    bool doCheckpoint( const string& fileName ) const;
+
+    /**
+     * Puts back the state saved by doCheckpoint. The model must have
+     * been built again, as it was when saved, and reinit. Nothing is
+     * changed, and false returned, if the objects or messages of the
+     * model differ from those in the file.
+     */
+    bool doRestore( const string& fileName );
+
     /**
      * This function synchronizes fieldDimension on the DataHandler
      * across nodes. Used after function calls that might alter the
@@ -282,6 +328,9 @@ public:
      */
     void handleQuit();
 
+    /// Runs loadBalance on this node.
+    void handleLoadBalance();
+
     void handleCreate( const Eref& e,
                        string type, ObjId parent, Id newElm, string name,
                        NodeBalance nb, unsigned int parentMsgIndex );
@@ -327,6 +376,18 @@ public:
      */
     bool innerMove( Id orig, ObjId newParent );
 
+    /**
+     * Walks the path one name at a time. Used by doFind when the path
+     * is not cached.
+     */
+    ObjId innerFind( const string& path ) const;
+
+    /**
+     * Runs the simulation, and then flushes the Streamers and streaming
+     * Tables. Used by doStart and doNonBlockingStart.
+     */
+    void innerStart( double runtime, bool notify );
+
     /**
      * Handler to move Element orig onto the newParent.
      */
@@ -393,8 +454,9 @@ public:
     static unsigned int numProcessThreads();
 
     /**
-     * Stub for eventual function to handle load balancing. This must
-     * be called to set up default groups.
+     * Spreads the entries of the model over the nodes, by their cost
+     * and the messages between them. See LoadBalance.h. Called
+     * independently on each node, at startup and from doLoadBalance.
      */
     static void loadBalance();
 
@@ -601,6 +663,15 @@ private:
      */
     static double runtime_;
 
+    /**
+     * The run started by doNonBlockingStart, and a flag that is set from
+     * the start of that call to the end of the run.
+     */
+    static std::future< void > backgroundRun_;
+    static std::atomic< bool > isRunningInBackground_;
+    /// Set on the thread that called doNonBlockingStart.
+    static thread_local bool startedBackgroundRun_;
+
     static bool isParserIdle_;
 
     /// Current working Element
@@ -16,6 +16,11 @@
 Id Shell::doCopy(Id orig, ObjId newParent, string newName, unsigned int n,
                  bool toGlobal, bool copyExtMsg)
 {
+    if (isWaitingForBackgroundRun()) {
+        cout << "Warning: Shell::doCopy: simulation in progress.\n"
+                " Command ignored\n";
+        return Id();
+    }
     if (newName.length() > 0 && !isNameValid(newName)) {
         cout << "Error: Shell::doCopy: Illegal name '" + newName +
                     "' for copy.\n";
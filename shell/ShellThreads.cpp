@@ -16,6 +16,7 @@
 #endif
 #include "../basecode/header.h"
 #include "Shell.h"
+#include "LoadBalance.h"
 #include "../basecode/Dinfo.h"
 
 #define USE_NODES 1
@@ -55,17 +56,48 @@ void Shell::setHardware( unsigned int numCores, unsigned int numNodes,
 
 /**
  * Regular shell function that requires that the information about the
- * hardware have been loaded in. For now the function just assigns SimGroups
+ * hardware have been loaded in. Works out where the entries of the model
+ * go, and moves them there. Every node holds the same model, so each
+ * comes to the same plan on its own.
  */
 void Shell::loadBalance()
 {
-	// Need more info here on how to set up groups distributed over
-	// nodes. In fact this will have to be computed _after_ the
-	// simulation is loaded. Will also need quite a bit of juggling between
-	// nodes when things get really scaled up.
-	//
-	// Note that the messages have to be rebuilt after this call.
-	// Note that this function is called independently on each node.
+	if ( numNodes_ <= 1 )
+		return;
+	applyLoadBalance( planLoadBalance( numNodes_ ) );
+}
+
+/**
+ * Runs innerStart on a thread of its own. The flag is set here rather than
+ * in the thread, so that isRunning is true as soon as this returns.
+ */
+void Shell::doNonBlockingStart( double runtime )
+{
+	if ( isRunningInBackground_.exchange( true ) ) {
+		cout << "Warning: Shell::doNonBlockingStart: simulation already "
+			"in progress.\n Command ignored\n";
+		return;
+	}
+	startedBackgroundRun_ = true;
+	try {
+		backgroundRun_ = std::async( std::launch::async, [this, runtime]() {
+			// Clears the flag even if the run throws; get() in doWait
+			// passes the exception on.
+			struct ClearFlag {
+				~ClearFlag() { isRunningInBackground_ = false; }
+			} clearFlag;
+			innerStart( runtime, false );
+		} );
+	} catch ( ... ) {
+		isRunningInBackground_ = false;
+		throw;
+	}
+}
+
+void Shell::doWait()
+{
+	if ( backgroundRun_.valid() )
+		backgroundRun_.get();
 }
 
 unsigned int Shell::numCores()
@@ -7,84 +7,378 @@
 ** See the file COPYING.LIB for the full notice.
 **********************************************************************/
 
+#include <mutex>
 #include "../basecode/header.h"
+#include "../utility/ThreadPool.h"
 #include "Neutral.h"
 #include "Shell.h"
 #include "Wildcard.h"
 
-static int wildcardRelativeFind( ObjId start, const vector< string >& path,
-                                 unsigned int depth, vector< ObjId >& ret );
+/**
+ * Subtrees with fewer entries than this are scanned on the calling
+ * thread, as handing them out to the pool would cost more than the scan.
+ */
+static const size_t MIN_PARALLEL_SCAN = 10000;
 
 static unsigned int findBraceContent( const string& path,
                                       string& beforeBrace, string& insideBrace );
 
-static bool matchName( ObjId id, unsigned int index,
-                       const string& beforeBrace, const string& insideBrace );
+/**
+ * The name part of one level of a wildcard path, chopped at the #s once
+ * for all the names it is compared with. The rules are those of
+ * matchBeforeBrace.
+ */
+class NamePattern
+{
+public:
+    explicit NamePattern( const string& wild )
+        : wild_( wild ),
+          isAll_( wild == "#" || wild == "##" ),
+          hasWildcards_( wild.find_first_of( "#?" ) != string::npos )
+    {
+        if ( hasWildcards_ )
+            Shell::chopString( wild, chops_, '#' );
+    }
+
+    bool match( const string& ename ) const;
 
-// static bool matchBeforeBrace( ObjId id, const string& name );
+private:
+    string wild_;
+    bool isAll_;
+    bool hasWildcards_;
+    vector< string > chops_;
+};
 
-static bool matchInsideBrace( ObjId id, const string& inside );
 /**
- * wildcardFieldComparison returns true if the value of the
- * specified field matches the value in the comparsion string mid.
- * Format is FIELD(name)=val
- * If the format or the value does not match, return 0
+ * The condition inside the braces of one level of a wildcard path,
+ * parsed once for all the objects it is tested on. Class names are
+ * compared with the class of each object, and FIELD values are fetched
+ * in their own type and compared as numbers where they are numbers.
  */
-static bool wildcardFieldComparison( ObjId oid, const string& mid )
+class BraceCondition
 {
-    // where = could be the usual comparison operators and val
-    // could be a number. No strings yet
+public:
+    explicit BraceCondition( const string& inside );
+
+    bool match( ObjId id ) const;
+
+    /**
+     * If the condition is a TYPE, CLASS or ISA equality, fills ret with
+     * the classes of existing Elements that satisfy it, and returns true.
+     */
+    bool matchingClasses( vector< const Cinfo* >& ret ) const;
+
+    /**
+     * True if matching calls the getter of a field. Getters are not
+     * all safe to run on several threads at once.
+     */
+    bool readsField() const;
+
+private:
+    enum Kind { ALWAYS, NEVER, CLASS, ISA, FIELD };
+    enum Op { EQ, NE, GT, GE, LT, LE };
+
+    bool matchClass( const Cinfo* c ) const;
+    bool matchField( ObjId oid ) const;
+    bool compare( double actual ) const;
+    bool compare( const string& actual ) const;
+
+    Kind kind_;
+    bool isEquality_;
+    string typeName_;
+    string field_;
+    string getter_;     /// Name of the DestFinfo that gets field_
+    Op op_;
+    string testValue_;
+    double testNumber_;
+    bool isNumber_;     /// True if all of testValue_ is a number
+};
 
-    auto pos = mid.find(')');
-    if ( pos == string::npos )
-        return 0;
-    string fieldName = mid.substr( 0, pos );
-    auto pos2 = mid.find_last_of( "=<>" );
-    if ( pos2 == string::npos )
-        return 0;
-    string op = mid.substr( pos + 1, pos2 - pos );
+/**
+ * One level of a wildcard path, compiled once for a search.
+ */
+class WildcardLevel
+{
+public:
+    WildcardLevel( const string& beforeBrace, const string& insideBrace,
+                   unsigned int index, bool isEmpty )
+        : name( beforeBrace ), condition( insideBrace ), index( index ),
+          isRecursive( beforeBrace == "##" ), isEmpty( isEmpty )
+    {;}
+
+    static WildcardLevel compile( const string& path )
+    {
+        string beforeBrace;
+        string insideBrace;
+        // This has to handle ghastly cases like foo[][FIELD(x)=12.3]
+        unsigned int index = findBraceContent( path, beforeBrace, insideBrace );
+        return WildcardLevel( beforeBrace, insideBrace, index,
+                              path.length() == 0 );
+    }
 
-    string testValue = mid.substr( pos2 + 1 );
+    /**
+     * Compares the various parts of the level with the id.
+     * Indexing is messy here because we may refer to any of 3 things:
+     * - Regular array indexing
+     * - Wildcards within the braces
+     * - Simple elements with index as part of their names.
+     */
+    bool matchName( ObjId id ) const
+    {
+        const string& ename = id.element()->getName();
+        return ename.length() > 0 && name.match( ename ) &&
+               condition.match( id );
+    }
 
-    if ( testValue.length() == 0 )
-        return 0;
+    NamePattern name;
+    BraceCondition condition;
+    unsigned int index;
+    bool isRecursive;
+    bool isEmpty;
+};
 
-    /*
-    const Finfo* f = id()->findFinfo( fieldName );
-    if ( !f )
-    	return 0;
+static int levelFind( ObjId start, const WildcardLevel& level,
+                      vector< ObjId >& ret, bool isSorted );
 
+static bool classIndexFind( ObjId start, unsigned int index,
+                            const BraceCondition& cond, vector< ObjId >& ret );
+
+static void scanDescendants( ObjId start, unsigned int index,
+                             const BraceCondition& cond, vector< ObjId >& ret );
+
+//////////////////////////////////////////////////////////////////////////
+// BraceCondition
+//////////////////////////////////////////////////////////////////////////
+
+BraceCondition::BraceCondition( const string& inside )
+    : kind_( NEVER ), isEquality_( true ), op_( EQ ),
+      testNumber_( 0.0 ), isNumber_( false )
+{
+    /* Map from Genesis class names to Moose class names */
+    // const map< string, string >& classNameMap = sliClassNameConvert();
+    if ( inside == "" )
+    {
+        kind_ = ALWAYS; // empty means that there is no condition to apply.
+        return;
+    }
+
+    if ( inside.substr(0, 4 ) == "TYPE" ||
+            inside.substr(0, 5 ) == "CLASS" ||
+            inside.substr(0, 3 ) == "ISA" )
+    {
+        auto pos = inside.rfind( "=" );
+        if ( pos == string::npos )
+            return;
+        isEquality_ = ( inside[ pos - 1 ] != '!' );
+        typeName_ = inside.substr( pos + 1 );
+        if ( typeName_ == "membrane" )
+            typeName_ = "Compartment";
+
+        if ( inside.substr( 0, 5 ) == "CLASS" && typeName_ == "channel" )
+            typeName_ = "HHChannel";
+
+        kind_ = ( inside.substr( 0, 3 ) == "ISA" ) ? ISA : CLASS;
+    }
+    else if ( inside.substr( 0, 6 ) == "FIELD(" )
+    {
+        // Format is FIELD(name)op val, where op could be the usual
+        // comparison operators and val could be a number or a string.
+        string mid = inside.substr( 6 );
+        auto pos = mid.find( ')' );
+        auto pos2 = mid.find_last_of( "=<>" );
+        if ( pos == string::npos || pos2 == string::npos || pos2 < pos )
+            return;
+        field_ = mid.substr( 0, pos );
+        string op = mid.substr( pos + 1, pos2 - pos );
+        testValue_ = mid.substr( pos2 + 1 );
+        if ( field_.length() == 0 || testValue_.length() == 0 )
+            return;
+
+        if ( op == "==" || op == "=" )
+            op_ = EQ;
+        else if ( op == "!=" )
+            op_ = NE;
+        else if ( op == ">" )
+            op_ = GT;
+        else if ( op == ">=" )
+            op_ = GE;
+        else if ( op == "<" )
+            op_ = LT;
+        else if ( op == "<=" )
+            op_ = LE;
+        else
+            return;
+
+        getter_ = "get" + field_;
+        getter_[3] = std::toupper( getter_[3] );
+        char* end;
+        testNumber_ = strtod( testValue_.c_str(), &end );
+        isNumber_ = ( *end == '\0' );
+        kind_ = FIELD;
+    }
+}
+
+bool BraceCondition::match( ObjId id ) const
+{
+    switch ( kind_ )
+    {
+    case ALWAYS:
+        return true;
+    case CLASS:
+    case ISA:
+        return matchClass( id.element()->cinfo() );
+    case FIELD:
+        if ( id.dataIndex == ALLDATA )
+            return matchField( id.id );
+        return matchField( id );
+    default:
+        return false;
+    }
+}
+
+bool BraceCondition::readsField() const
+{
+    return kind_ == FIELD;
+}
+
+bool BraceCondition::matchingClasses( vector< const Cinfo* >& ret ) const
+{
+    if ( !( kind_ == CLASS || kind_ == ISA ) || !isEquality_ )
+        return false;
+    const Element::ClassIndex& index = Element::classIndex();
+    for ( Element::ClassIndex::const_iterator
+            i = index.begin(); i != index.end(); ++i )
+    {
+        if ( i->second.size() > 0 && matchClass( i->first ) )
+            ret.push_back( i->first );
+    }
+    return true;
+}
+
+bool BraceCondition::matchClass( const Cinfo* c ) const
+{
+    bool isEqual;
+    if ( kind_ == ISA )
+        isEqual = c->isA( typeName_ );
+    else
+        isEqual = ( typeName_ == c->name() );
+    return ( isEqual == isEquality_ );
+}
+
+/**
+ * Returns true if the value of the field of oid compares as specified
+ * with the test value. Numerical fields are read directly; other types
+ * go through their string form, as do objects on other nodes.
+ */
+bool BraceCondition::matchField( ObjId oid ) const
+{
+    const DestFinfo* df = dynamic_cast< const DestFinfo* >(
+                              oid.element()->cinfo()->findFinfo( getter_ ) );
+    if ( df && oid.isDataHere() )
+    {
+        const OpFunc* func = df->getOpFunc();
+        Eref e = oid.eref();
+        if ( const GetOpFuncBase< double >* f =
+                    dynamic_cast< const GetOpFuncBase< double >* >( func ) )
+            return compare( f->returnOp( e ) );
+        if ( const GetOpFuncBase< unsigned int >* f =
+                    dynamic_cast< const GetOpFuncBase< unsigned int >* >( func ) )
+            return compare( double( f->returnOp( e ) ) );
+        if ( const GetOpFuncBase< int >* f =
+                    dynamic_cast< const GetOpFuncBase< int >* >( func ) )
+            return compare( double( f->returnOp( e ) ) );
+        if ( const GetOpFuncBase< bool >* f =
+                    dynamic_cast< const GetOpFuncBase< bool >* >( func ) )
+            return compare( double( f->returnOp( e ) ) );
+        if ( const GetOpFuncBase< string >* f =
+                    dynamic_cast< const GetOpFuncBase< string >* >( func ) )
+            return compare( f->returnOp( e ) );
+    }
+
+    // The string conversion goes through shared buffers, so scans on
+    // several threads take turns here.
+    static mutex strGetMutex;
     string actualValue;
-    bool ret = f->strGet( id.eref(), actualValue );
-    */
-    string actualValue;
+    {
+        lock_guard< mutex > lock( strGetMutex );
+        if ( !SetGet::strGet( oid, field_, actualValue ) )
+            return false;
+    }
+    return compare( actualValue );
+}
 
-    bool ret = SetGet::strGet( oid, fieldName, actualValue );
-    if ( ret == 0 )
-        return 0;
-    if ( op == "==" || op == "=" )
-        return ( testValue == actualValue );
-    if ( op == "!=" )
-        return ( testValue != actualValue );
+bool BraceCondition::compare( double actual ) const
+{
+    switch ( op_ )
+    {
+    case EQ:
+        return isNumber_ && actual == testNumber_;
+    case NE:
+        return !isNumber_ || actual != testNumber_;
+    case GT:
+        return actual > testNumber_;
+    case GE:
+        return actual >= testNumber_;
+    case LT:
+        return actual < testNumber_;
+    case LE:
+        return actual <= testNumber_;
+    }
+    return false;
+}
+
+bool BraceCondition::compare( const string& actual ) const
+{
+    if ( op_ == EQ )
+        return ( testValue_ == actual );
+    if ( op_ == NE )
+        return ( testValue_ != actual );
+    return compare( atof( actual.c_str() ) );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Path traversal
+//////////////////////////////////////////////////////////////////////////
 
-    double v1 = atof( actualValue.c_str() );
-    double v2 = atof( testValue.c_str() );
-    if ( op == ">" )
-        return ( v1 > v2 );
-    if ( op == ">=" )
-        return ( v1 >= v2 );
-    if ( op == "<" )
-        return ( v1 < v2 );
-    if ( op == "<=" )
-        return ( v1 <= v2 );
+/**
+ * This is the main recursive function of the wildcarding scheme.
+ * It builds a wildcard list based on the compiled path. Puts found Ids
+ * into ret, and returns # found.
+ * The start ObjId is one that already matches.
+ * depth is the position on the path.
+ * If isSorted, the caller sorts the result, so it may come in any order.
+ * This should work for multi-node wildcard searches since it only
+ * refers to messaging and basic Element information that is present on
+ * all nodes.
+ */
+static int wildcardRelativeFind( ObjId start,
+                                 const vector< WildcardLevel >& path,
+                                 unsigned int depth, vector< ObjId >& ret, bool isSorted )
+{
+    int nret = 0;
+    vector< ObjId > currentLevelIds;
+    if ( depth == path.size() )
+    {
+        if ( ret.size() == 0 || ret.back() != start )
+        {
+            ret.push_back( start );
+        }
+        return 1;
+    }
 
-    return 0;
+    if ( levelFind( start, path[depth], currentLevelIds, isSorted ) > 0 )
+    {
+        vector< ObjId >::iterator i;
+        for ( i = currentLevelIds.begin(); i != currentLevelIds.end(); ++i )
+            nret += wildcardRelativeFind( *i, path, depth + 1, ret, isSorted );
+    }
+    return nret;
 }
 
 /**
  * Does the wildcard find on a single path
  */
-static int innerFind( const string& path, vector< ObjId >& ret)
+static int innerFind( const string& path, vector< ObjId >& ret, bool isSorted )
 {
     if ( path == "/" || path == "/root")
     {
@@ -93,7 +387,6 @@ static int innerFind( const string& path, vector< ObjId >& ret)
     }
 
     vector< string > names;
-    vector< vector< unsigned int > > indices;
     bool isAbsolute = Shell::chopString( path, names, '/' );
     ObjId start; // set to root id.
     if ( !isAbsolute )
@@ -101,7 +394,25 @@ static int innerFind( const string& path, vector< ObjId >& ret)
         Shell* s = reinterpret_cast< Shell* >( ObjId().data() );
         start = s->getCwe();
     }
-    return wildcardRelativeFind( start, names, 0, ret );
+    vector< WildcardLevel > levels;
+    for ( vector< string >::const_iterator
+            i = names.begin(); i != names.end(); ++i )
+        levels.push_back( WildcardLevel::compile( *i ) );
+    return wildcardRelativeFind( start, levels, 0, ret, isSorted );
+}
+
+static int findAll( const string& path, vector< ObjId >& ret, bool isSorted )
+{
+    if ( path.length() == 0 )
+        return 0;
+    unsigned int n = ret.size();
+    vector< string > wildcards;
+    Shell::chopString( path, wildcards, ',' );
+    vector< string >::iterator i;
+    for ( i = wildcards.begin(); i != wildcards.end(); ++i )
+        innerFind( *i, ret, isSorted );
+
+    return ret.size() - n;
 }
 
 /**
@@ -117,16 +428,7 @@ static int innerFind( const string& path, vector< ObjId >& ret)
  */
 int simpleWildcardFind( const string& path, vector< ObjId >& ret)
 {
-    if ( path.length() == 0 )
-        return 0;
-    unsigned int n = ret.size();
-    vector< string > wildcards;
-    Shell::chopString( path, wildcards, ',' );
-    vector< string >::iterator i;
-    for ( i = wildcards.begin(); i != wildcards.end(); ++i )
-        innerFind( *i, ret );
-
-    return ret.size() - n;
+    return findAll( path, ret, false );
 }
 
 static void myUnique(vector<ObjId>& ret)
@@ -150,7 +452,9 @@ int wildcardFind(const string& path, vector<ObjId>& ret, bool clear)
 {
     if(clear)
         ret.resize( 0 );
-    simpleWildcardFind( path, ret );
+    // The result is sorted below, so the search is free to use the
+    // class index instead of the tree order.
+    findAll( path, ret, true );
     myUnique( ret );
     return ret.size();
 }
@@ -163,32 +467,32 @@ vector<ObjId> wildcardFind2(const char* path)
 }
 
 /**
- * 	singleLevelWildcard parses a single level of the path and returns all
+ * 	levelFind uses a single level of the path and returns all
  * 	ids that match it. If there is a suitable doublehash, it will recurse
  * 	into child elements.
  * 	Returns # of ids found.
  */
-int singleLevelWildcard( ObjId start, const string& path, vector< ObjId >& ret )
+static int levelFind( ObjId start, const WildcardLevel& level,
+                      vector< ObjId >& ret, bool isSorted )
 {
-    if ( path.length() == 0 )
+    if ( level.isEmpty )
         return 0;
     unsigned int nret = ret.size();
 
-    string beforeBrace;
-    string insideBrace;
-    // This has to handle ghastly cases like foo[][FIELD(x)=12.3]
-    unsigned int index = findBraceContent( path, beforeBrace, insideBrace );
-    if ( beforeBrace == "##" )
-        // recursive.
-        return allChildren( start, index, insideBrace, ret );
+    unsigned int index = level.index;
+    if ( level.isRecursive )
+    {
+        if ( !( isSorted && classIndexFind( start, index, level.condition, ret ) ) )
+            scanDescendants( start, index, level.condition, ret );
+        return ret.size() - nret;
+    }
 
     vector< Id > kids;
     Neutral::children( start.eref(), kids );
     vector< Id >::iterator i;
     for ( i = kids.begin(); i != kids.end(); i++ )
     {
-        if ( matchName( ObjId( *i, ALLDATA ),
-                        index, beforeBrace, insideBrace ) )
+        if ( level.matchName( ObjId( *i, ALLDATA ) ) )
         {
             if ( index == ALLDATA )
             {
@@ -209,6 +513,19 @@ int singleLevelWildcard( ObjId start, const string& path, vector< ObjId >& ret )
     return ret.size() - nret;
 }
 
+/**
+ * 	singleLevelWildcard parses a single level of the path and returns all
+ * 	ids that match it. If there is a suitable doublehash, it will recurse
+ * 	into child elements.
+ * 	Returns # of ids found.
+ */
+int singleLevelWildcard( ObjId start, const string& path, vector< ObjId >& ret )
+{
+    if ( path.length() == 0 )
+        return 0;
+    return levelFind( start, WildcardLevel::compile( path ), ret, false );
+}
+
 /**
  * Parses the name and separates out the stuff before the brace,
  * the stuff inside it, and if present, the index which is also in a
@@ -271,96 +588,28 @@ unsigned int findBraceContent( const string& path, string& beforeBrace,
     return index;
 }
 
-/**
- * Compares the various parts of the wildcard name with the id
- * Indexing is messy here because we may refer to any of 3 things:
- * - Regular array indexing
- * - Wildcards within the braces
- * - Simple elements with index as part of their names.
- */
-bool matchName( ObjId id, unsigned int index,
-                const string& beforeBrace, const string& insideBrace )
-{
-    string temp = id.element()->getName();
-    if ( temp.length() <= 0 )
-    {
-        return false;
-    }
-
-    // if ( index == ALLDATA || index == id.dataIndex ) {
-    if ( matchBeforeBrace( id, beforeBrace ) )
-    {
-        if ( insideBrace.length() == 0 )
-        {
-            return true;
-        }
-        else
-        {
-            return matchInsideBrace( id, insideBrace );
-        }
-    }
-    // }
-    return 0;
-}
-
 /**
  * matchInsideBrace checks for element property matches
  * Still has some legacy hacks for reading GENESIS code.
  */
-bool matchInsideBrace( ObjId id, const string& inside )
+static bool matchInsideBrace( ObjId id, const string& inside )
 {
-    /* Map from Genesis class names to Moose class names */
-    // const map< string, string >& classNameMap = sliClassNameConvert();
-    if ( inside == "" )
-        return true; // empty means that there is no condition to apply.
+    return BraceCondition( inside ).match( id );
+}
 
-    if ( inside.substr(0, 4 ) == "TYPE" ||
-            inside.substr(0, 5 ) == "CLASS" ||
-            inside.substr(0, 3 ) == "ISA" )
+/// alignedSingleWildcardMatch on name from position pos on.
+static bool alignedMatchAt( const string& name, unsigned int pos,
+                            const string& wild )
+{
+    unsigned int len = wild.length();
+    if ( name.length() < pos + len )
+        return false;
+    for ( unsigned int i = 0; i < len; i++ )
     {
-        auto pos = inside.rfind( "=" );
-        if ( pos == string::npos )
+        if ( wild[i] != '?' && name[pos + i] != wild[i] )
             return false;
-        bool isEquality = ( inside[ pos - 1 ] != '!' );
-        string typeName = inside.substr( pos + 1 );
-        if ( typeName == "membrane" )
-            typeName = "Compartment";
-
-        if ( inside.substr( 0, 5 ) == "CLASS" && typeName == "channel" )
-            typeName = "HHChannel";
-
-        bool isEqual;
-        if ( inside.substr( 0, 3 ) == "ISA" )
-        {
-            isEqual = id.element()->cinfo()->isA( typeName );
-        }
-        else
-        {
-            isEqual = ( typeName == id.element()->cinfo()->name() );
-        }
-        /*
-        map< string, string >::const_iterator iter = classNameMap.find( typeName );
-        if ( iter != classNameMap.end() )
-        	isEqual = ( iter->second == id()->className() );
-        else
-        	isEqual = ( typeName == id()->className() );
-        	*/
-
-        return ( isEqual == isEquality );
     }
-    else if ( inside.substr( 0, 6 ) == "FIELD(" )
-    {
-        if ( id.dataIndex == ALLDATA )
-        {
-            return wildcardFieldComparison( id.id, inside.substr( 6 ) );
-        }
-        else
-        {
-            return wildcardFieldComparison( id, inside.substr( 6 ) );
-        }
-    }
-
-    return false;
+    return true;
 }
 
 /**
@@ -370,15 +619,7 @@ bool matchInsideBrace( ObjId id, const string& inside )
  */
 bool alignedSingleWildcardMatch( const string& name, const string& wild )
 {
-    unsigned int len = wild.length();
-    if ( name.length() < len )
-        return false;
-    for ( unsigned int i = 0; i < len; i++ )
-    {
-        if ( wild[i] != '?' && name[i] != wild[i] )
-            return false;
-    }
-    return true;
+    return alignedMatchAt( name, 0, wild );
 }
 
 /**
@@ -399,7 +640,7 @@ unsigned int findWithSingleCharWildcard(
     unsigned int end = 1 + name.length() - len;
     for ( unsigned int i = start; i < end; ++i )
     {
-        if ( alignedSingleWildcardMatch( name.substr(i), wild ) )
+        if ( alignedMatchAt( name, i, wild ) )
             return i;
     }
     return ~0;
@@ -419,71 +660,76 @@ unsigned int findWithSingleCharWildcard(
  */
 bool matchBeforeBrace( ObjId id, const string& wild )
 {
-    if ( wild == "#" || wild == "##" )
+    return NamePattern( wild ).match( id.element()->getName() );
+}
+
+bool NamePattern::match( const string& ename ) const
+{
+    if ( isAll_ )
         return true;
 
-    string ename = id.element()->getName();
-    if ( wild == ename )
+    if ( wild_ == ename )
         return true;
 
     // Check if the wildcard string has any # or ? symbols.
-    if ( wild.find_first_of( "#?" ) == string::npos )
+    if ( !hasWildcards_ )
         return false;
 
-    // Break the 'wild' into the sections that must match, at the #s.
-    // Then go through each of these sections doing a match to ename.
+    // The 'wild' is broken into the sections that must match, at the #s.
+    // Go through each of these sections doing a match to ename.
     // If not found, then return false.
-    vector< string > chops;
-    Shell::chopString( wild, chops, '#' );
     unsigned int prev = 0;
     unsigned int start = 0;
 
-    for ( vector< string >::iterator
-            i = chops.begin(); i != chops.end(); ++i )
+    for ( vector< string >::const_iterator
+            i = chops_.begin(); i != chops_.end(); ++i )
     {
         start = findWithSingleCharWildcard( ename, prev, *i );
         if ( start == ~0U )
             return false;
-        if ( prev == 0 && start > 0 && wild[0] != '#' )
+        if ( prev == 0 && start > 0 && wild_[0] != '#' )
             return false;
         prev = start + i->length();
     }
     return true;
+}
 
-    /*
-
-    auto pre = name.find( "#" );
-    auto post = name.rfind( "#" );
+//////////////////////////////////////////////////////////////////////////
+// Recursive searches
+//////////////////////////////////////////////////////////////////////////
 
-    // # may only be used once in the wildcard, but substitutes for any
-    // number of characters.
-    if ( pre != string::npos && post == pre ) {
-    	if ( ename.length() < ( name.length() - post - 1 ) )
-    			return false;
-    	unsigned int epos = ename.length() - ( name.length() - post - 1 );
-    	return ( name.substr( 0, pre ) == ename.substr( 0, pre ) &&
-    		name.substr( post + 1 ) == ename.substr( epos ) );
+/// Adds the field child kid of entry dataIndex of its parent, if it matches.
+static void matchFieldChild( Id kid, unsigned int dataIndex,
+                             unsigned int index, const BraceCondition& cond, vector< ObjId >& ret )
+{
+    if ( cond.match( kid ) )
+    {
+        if ( index == ALLDATA )
+        {
+            ret.push_back( ObjId( kid, dataIndex ) );
+        }
+        else if ( index < kid.element()->numField( dataIndex ) )
+        {
+            ret.push_back( ObjId( kid, dataIndex, index ) );
+        }
     }
+}
 
-    // ? may be used any number of times in the wildcard, and
-    // must substitute exactly for characters.
-    if ( name.length() != ename.length() )
-    	return 0;
-    for ( unsigned int i = 0; i < name.length(); i++ )
-    	if ( name[i] != '?' && name[i] != ename[i] )
-    		return false;
-    return true;
-    */
+/// Adds the data entry oid, if it matches.
+static void matchEntry( ObjId oid, unsigned int index,
+                        const BraceCondition& cond, vector< ObjId >& ret )
+{
+    if ( ( index == ALLDATA || index == oid.dataIndex ) && cond.match( oid ) )
+        ret.push_back( oid );
 }
 
 /**
  * Recursive function to compare all descendants and cram matches into ret.
- * Returns number of matches.
+ * Each data entry comes after its own descendants.
  */
-int allChildren( ObjId start,
-                 unsigned int index, const string& insideBrace, vector< ObjId >& ret )
+static void scanChildren( ObjId start, unsigned int index,
+                          const BraceCondition& cond, vector< ObjId >& ret )
 {
-    unsigned int nret = ret.size();
     vector< Id > kids;
     Neutral::children( start.eref(), kids );
     vector< Id >::iterator i;
@@ -491,65 +737,268 @@ int allChildren( ObjId start,
     {
         if ( i->element()->hasFields() )
         {
-            if ( matchInsideBrace( *i, insideBrace ) )
+            matchFieldChild( *i, start.dataIndex, index, cond, ret );
+        }
+        else
+        {
+            for ( unsigned int j = 0; j < i->element()->numData(); ++j )
             {
-                if ( index == ALLDATA )
-                {
-                    ObjId oid( *i, start.dataIndex );
-                    ret.push_back( oid );
-                }
-                else if (index < i->element()->numField( start.dataIndex ) )
-                {
-                    ObjId oid( *i, start.dataIndex, index );
-                    ret.push_back( oid );
-                }
+                ObjId oid( *i, j );
+                scanChildren( oid, index, cond, ret );
+                matchEntry( oid, index, cond, ret );
             }
         }
+    }
+}
+
+/**
+ * A piece of a scan over the descendants of an entry. Scanning a list of
+ * these in order gives the same result, in the same order, as
+ * scanChildren on the entry.
+ */
+struct ScanItem
+{
+    enum Kind {
+        FIELD_CHILD,    /// Field child oid.id of entry oid.dataIndex
+        SUBTREE,        /// Descendants of oid, then oid itself
+        SELF            /// oid itself
+    };
+
+    ScanItem( ObjId oid, Kind kind )
+        : oid( oid ), kind( kind )
+    {;}
+
+    ObjId oid;
+    Kind kind;
+};
+
+/// Fills items with the pieces of the scan over the children of start.
+static void splitScan( ObjId start, vector< ScanItem >& items )
+{
+    vector< Id > kids;
+    Neutral::children( start.eref(), kids );
+    for ( vector< Id >::iterator i = kids.begin(); i != kids.end(); ++i )
+    {
+        if ( i->element()->hasFields() )
+        {
+            items.push_back( ScanItem( ObjId( *i, start.dataIndex ),
+                                       ScanItem::FIELD_CHILD ) );
+        }
         else
         {
             for ( unsigned int j = 0; j < i->element()->numData(); ++j )
+                items.push_back( ScanItem( ObjId( *i, j ), ScanItem::SUBTREE ) );
+        }
+    }
+}
+
+static void scanItem( const ScanItem& item, unsigned int index,
+                      const BraceCondition& cond, vector< ObjId >& ret )
+{
+    switch ( item.kind )
+    {
+    case ScanItem::FIELD_CHILD:
+        matchFieldChild( item.oid.id, item.oid.dataIndex, index, cond, ret );
+        break;
+    case ScanItem::SUBTREE:
+        scanChildren( item.oid, index, cond, ret );
+        matchEntry( item.oid, index, cond, ret );
+        break;
+    case ScanItem::SELF:
+        matchEntry( item.oid, index, cond, ret );
+        break;
+    }
+}
+
+/**
+ * Returns true if there are more than limit data entries below start.
+ * Stops counting as soon as the limit is passed.
+ */
+static bool subtreeLargerThan( ObjId start, size_t limit )
+{
+    size_t n = 0;
+    vector< Id > stack;
+    Neutral::children( start.eref(), stack );
+    while ( !stack.empty() )
+    {
+        Element* e = stack.back().element();
+        stack.pop_back();
+        n += e->numData();
+        if ( n > limit )
+            return true;
+        if ( !e->hasFields() )
+            Neutral::children( Eref( e, ALLDATA ), stack );
+    }
+    return false;
+}
+
+/**
+ * Scans all descendants of start, as scanChildren does. Large subtrees
+ * are cut into pieces near the top, which the thread pool scans in
+ * parallel; the pieces are put back together in order. Conditions on
+ * fields are scanned serially, since they run the getters of objects.
+ */
+static void scanDescendants( ObjId start, unsigned int index,
+                             const BraceCondition& cond, vector< ObjId >& ret )
+{
+    moose::ThreadPool& pool = moose::ThreadPool::global();
+    size_t numThreads = pool.size();
+    if ( numThreads < 2 || Shell::numNodes() > 1 || cond.readsField() ||
+            !subtreeLargerThan( start, MIN_PARALLEL_SCAN ) )
+    {
+        scanChildren( start, index, cond, ret );
+        return;
+    }
+
+    // Split subtrees near the top until there are a few pieces for
+    // each thread.
+    vector< ScanItem > items;
+    splitScan( start, items );
+    for ( unsigned int depth = 0; depth < 4 && items.size() < 8 * numThreads;
+            ++depth )
+    {
+        vector< ScanItem > next;
+        bool isSplit = false;
+        for ( vector< ScanItem >::const_iterator
+                i = items.begin(); i != items.end(); ++i )
+        {
+            if ( i->kind == ScanItem::SUBTREE )
             {
-                ObjId oid( *i, j );
-                allChildren( oid, index, insideBrace, ret );
-                if ( (index == ALLDATA || index == j) && matchInsideBrace( oid, insideBrace ) )
-                    ret.push_back( oid );
+                splitScan( i->oid, next );
+                next.push_back( ScanItem( i->oid, ScanItem::SELF ) );
+                isSplit = true;
+            }
+            else
+            {
+                next.push_back( *i );
             }
         }
+        items.swap( next );
+        if ( !isSplit )
+            break;
     }
-    return ret.size() - nret;
+
+    vector< vector< ObjId > > found( items.size() );
+    pool.parallelFor( items.size(), 1,
+                      [&]( size_t begin, size_t end )
+    {
+        for ( size_t i = begin; i < end; ++i )
+            scanItem( items[i], index, cond, found[i] );
+    } );
+    for ( vector< vector< ObjId > >::const_iterator
+            i = found.begin(); i != found.end(); ++i )
+        ret.insert( ret.end(), i->begin(), i->end() );
 }
 
 /**
- * This is the main recursive function of the wildcarding scheme.
- * It builds a wildcard list based on path. Puts found Ids into ret,
- * and returns # found.
- * The start ObjId is one that already matches.
- * depth is the position on the path.
- * This should work for multi-node wildcard searches since it only
- * refers to messaging and basic Element information that is present on
- * all nodes.
+ * Returns true if the entries of e are all below entry start, that is,
+ * if scanChildren( start ) would reach them. Climbs from e towards the
+ * root, remembering the answer for every Element on the way.
  */
-int wildcardRelativeFind( ObjId start, const vector< string >& path,
-                          unsigned int depth, vector< ObjId >& ret )
+static bool isBelow( Element* e, ObjId start,
+                     unordered_map< const Element*, bool >& memo )
 {
-    int nret = 0;
-    vector< ObjId > currentLevelIds;
-    if ( depth == path.size() )
+    vector< const Element* > chain;
+    bool ret = false;
+    Element* curr = e;
+    while ( true )
     {
-        if ( ret.size() == 0 || ret.back() != start )
+        unordered_map< const Element*, bool >::const_iterator
+        i = memo.find( curr );
+        if ( i != memo.end() )
         {
-            ret.push_back( start );
+            ret = i->second;
+            break;
         }
-        return 1;
+        chain.push_back( curr );
+        // The scan does not go below field elements, nor above the root.
+        if ( ( curr != e && curr->hasFields() ) || curr->id() == Id() )
+            break;
+        ObjId mid = curr->findParentMsg();
+        if ( mid.dataIndex == BADINDEX )
+            break;
+        ObjId pa = Msg::getMsg( mid )->findOtherEnd( ObjId( curr->id(), 0 ) );
+        if ( pa.element() == start.element() )
+        {
+            ret = ( pa.dataIndex == start.dataIndex );
+            break;
+        }
+        curr = pa.element();
     }
+    for ( vector< const Element* >::const_iterator
+            i = chain.begin(); i != chain.end(); ++i )
+        memo[ *i ] = ret;
+    return ret;
+}
+
+/**
+ * Finds the descendants of start whose class satisfies a TYPE, CLASS or
+ * ISA equality from the class index, instead of scanning the subtree.
+ * The result has the same entries as scanChildren gives, but in no
+ * particular order. Returns false, having done nothing, if the
+ * condition is of another kind or a scan of the subtree would be
+ * cheaper.
+ */
+static bool classIndexFind( ObjId start, unsigned int index,
+                            const BraceCondition& cond, vector< ObjId >& ret )
+{
+    vector< const Cinfo* > classes;
+    if ( start.dataIndex == ALLDATA || Shell::numNodes() > 1 ||
+            !cond.matchingClasses( classes ) )
+        return false;
+
+    const Element::ClassIndex& classIndex = Element::classIndex();
+    size_t numCandidates = 0;
+    for ( vector< const Cinfo* >::const_iterator
+            i = classes.begin(); i != classes.end(); ++i )
+        numCandidates += classIndex.find( *i )->second.size();
+
+    // Checking a candidate costs about as much as scanning one entry.
+    if ( start.id != Id() && !subtreeLargerThan( start, numCandidates ) )
+        return false;
 
-    if ( singleLevelWildcard( start, path[depth], currentLevelIds ) > 0 )
+    unordered_map< const Element*, bool > memo;
+    for ( vector< const Cinfo* >::const_iterator
+            i = classes.begin(); i != classes.end(); ++i )
     {
-        vector< ObjId >::iterator i;
-        for ( i = currentLevelIds.begin(); i != currentLevelIds.end(); ++i )
-            nret += wildcardRelativeFind( *i, path, depth + 1, ret );
+        const unordered_set< Id >& elms = classIndex.find( *i )->second;
+        for ( unordered_set< Id >::const_iterator
+                j = elms.begin(); j != elms.end(); ++j )
+        {
+            Element* e = j->element();
+            if ( e->hasFields() )
+            {
+                // A field child of each entry of its parent.
+                ObjId mid = e->findParentMsg();
+                if ( mid.dataIndex == BADINDEX )
+                    continue;
+                Element* pa = Msg::getMsg( mid )->e1();
+                if ( pa == start.element() )
+                    matchFieldChild( *j, start.dataIndex, index, cond, ret );
+                else if ( isBelow( pa, start, memo ) )
+                    for ( unsigned int k = 0; k < pa->numData(); ++k )
+                        matchFieldChild( *j, k, index, cond, ret );
+            }
+            else if ( isBelow( e, start, memo ) )
+            {
+                for ( unsigned int k = 0; k < e->numData(); ++k )
+                    matchEntry( ObjId( *j, k ), index, cond, ret );
+            }
+        }
     }
-    return nret;
+    return true;
+}
+
+/**
+ * Recursive function to compare all descendants and cram matches into ret.
+ * Returns number of matches.
+ */
+int allChildren( ObjId start,
+                 unsigned int index, const string& insideBrace, vector< ObjId >& ret )
+{
+    unsigned int nret = ret.size();
+    scanDescendants( start, index, BraceCondition( insideBrace ), ret );
+    return ret.size() - nret;
 }
 
 void wildcardTestFunc( ObjId* elist, unsigned int ne, const string& path )
@@ -576,6 +1025,43 @@ void wildcardTestFunc( ObjId* elist, unsigned int ne, const string& path )
     cout << ".";
 }
 
+/**
+ * A subtree large enough to be scanned by the thread pool must give the
+ * same matches, in the same order, as the serial scan.
+ */
+static void testParallelScan()
+{
+    Shell* shell = reinterpret_cast< Shell* >( Id().eref().data() );
+    moose::ThreadPool::global().reserve( 2 );
+    Id top = shell->doCreate( "Neutral", Id(), "scan", 1 );
+    for ( unsigned int i = 0; i < 6; ++i )
+    {
+        Id group = shell->doCreate( "Neutral", top, "g" + to_string( i ), 3 );
+        shell->doCreate( "Arith", group, "arith", 2000 );
+        Id syn = shell->doCreate( "SimpleSynHandler", group, "syn", 2 );
+        Field< unsigned int >::set( ObjId( syn, 1 ), "numSynapses", i + 1 );
+    }
+    assert( subtreeLargerThan( ObjId( top ), MIN_PARALLEL_SCAN ) );
+    const char* conds[] = { "", "TYPE=Arith", "ISA=Neutral", "TYPE=Synapse",
+                            "FIELD(outputValue)=0"
+                          };
+    for ( unsigned int i = 0; i < 5; ++i )
+    {
+        BraceCondition cond( conds[i] );
+        for ( unsigned int index : { ALLDATA, 2U } )
+        {
+            vector< ObjId > serial;
+            vector< ObjId > parallel;
+            scanChildren( ObjId( top ), index, cond, serial );
+            scanDescendants( ObjId( top ), index, cond, parallel );
+            assert( !serial.empty() );
+            assert( parallel == serial );
+        }
+    }
+    shell->doDelete( top );
+    cout << "." << flush;
+}
+
 void testWildcard()
 {
     unsigned long i;
@@ -837,6 +1323,35 @@ void testWildcard()
     simpleWildcardFind( "/a1/x[2]/y[]", vec );
     assert( vec.size() == 5 );
 
+    // The class index must find the same entries as a scan of the tree.
+    Id syn = shell->doCreate( "SimpleSynHandler", ObjId( x, 1 ), "syn", 3 );
+    for ( i = 0; i < 3; ++i )
+        Field< unsigned int >::set( ObjId( syn, i ), "numSynapses", i + 1 );
+    const char* indexed[] = { "/##[ISA=Arith]", "/##[TYPE=IntFire]",
+                              "/a1/##[CLASS=Annotator]", "/a1/x[2]/##[TYPE=Arith]", "/##[TYPE=Synapse]"
+                            };
+    for ( i = 0; i < 5; ++i )
+    {
+        vector< ObjId > scanned;
+        simpleWildcardFind( indexed[i], scanned );
+        sort( scanned.begin(), scanned.end() );
+        wildcardFind( indexed[i], vec );
+        assert( vec == scanned );
+    }
+    wildcardFind( "/a1/##[TYPE=Synapse]", vec );
+    assert( vec.size() == 3 );
+    vec.clear();
+    simpleWildcardFind( "/a1/x[2]/##[TYPE=Arith]", vec );
+    assert( vec.size() == 10 );
+    vec.clear();
+
+    // Field comparisons are done on the typed value.
+    wildcardTestFunc( el2 + 3, 1, "/a1/c1/##[FIELD(z)=3]" );
+    wildcardTestFunc( el2 + 3, 1, "/a1/c1/##[FIELD(z)==3.0]" );
+    wildcardTestFunc( el2 + 3, 1, "/a1/c1/##[FIELD(name)=ch3]" );
+    wildcardTestFunc( el2 + 90, 10, "/a1/c1/##[FIELD(z)>=90]" );
+    wildcardTestFunc( el2, 99, "/a1/c1/##[FIELD(z)!=99]" );
+
     // Here I test exclusive wildcards, should NOT get additional terms.
     Id xyzzy = shell->doCreate( "Arith", a1, "xyzzy", 5 );
     Id xdotp = shell->doCreate( "Arith", a1, "x.P", 5 );
@@ -856,5 +1371,6 @@ void testWildcard()
     //a1.destroy();
     shell->doDelete( a1 );
     cout << "." << flush;
+    testParallelScan();
 }
 
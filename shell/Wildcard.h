@@ -56,6 +56,9 @@ int simpleWildcardFind(const string& path, vector<ObjId>& ret);
  * wildcardFind returns the number of Ids found.
  * This behaves the same as simpleWildcardFind, except that it eliminates
  * non-unique entries, and in the process will scramble the ordering.
+ * Since the order is lost anyway, '##[TYPE=...]', '##[CLASS=...]' and
+ * '##[ISA=...]' levels look their class up in the class index of
+ * Element instead of walking the tree, when that is cheaper.
  *
  * If clear=true, then reset the ret to 0 size.
  */
@@ -78,6 +81,8 @@ vector<ObjId> wildcardFind2(const char* pattern);
  *   [CLASS!=<string>]
  *   [ISA!=<string>]
  *   [FIELD(<fieldName)=<string>]
+ * Large subtrees are scanned in parallel on the global ThreadPool, with
+ * the matches kept in the same order as a serial scan.
  */
 int allChildren(ObjId start, unsigned int index, const string& insideBrace,
                 vector<ObjId>& ret);
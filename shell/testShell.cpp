@@ -319,6 +319,60 @@ void testChildren()
     cout << "." << flush;
 }
 
+/// Test that the child index and the path cache follow renames, moves
+/// and deletes.
+void testChildIndex()
+{
+    Eref sheller = Id().eref();
+    Shell* shell = reinterpret_cast<Shell*>(sheller.data());
+
+    const unsigned int n = 1000;
+    Id f1 = shell->doCreate("Neutral", Id(), "f1", 1);
+    Id f2 = shell->doCreate("Neutral", Id(), "f2", 1);
+    vector<Id> kids;
+    for (unsigned int i = 0; i < n; ++i)
+        kids.push_back(
+            shell->doCreate("Neutral", f1, "k" + to_string(i), 1));
+    for (unsigned int i = 0; i < n; i += 97) {
+        assert(Neutral::child(f1.eref(), "k" + to_string(i)) == kids[i]);
+        assert(shell->doFind("/f1/k" + to_string(i)) == kids[i]);
+    }
+    assert(Neutral::child(f1.eref(), "k" + to_string(n)) == Id());
+
+    // Rename
+    Field<string>::set(kids[5], "name", "five");
+    assert(Neutral::child(f1.eref(), "k5") == Id());
+    assert(Neutral::child(f1.eref(), "five") == kids[5]);
+    assert(shell->doFind("/f1/k5").bad());
+    assert(shell->doFind("/f1/five") == kids[5]);
+
+    // Move
+    shell->doMove(kids[5], f2);
+    assert(Neutral::child(f1.eref(), "five") == Id());
+    assert(Neutral::child(f2.eref(), "five") == kids[5]);
+    assert(shell->doFind("/f1/five").bad());
+    assert(shell->doFind("/f2/five") == kids[5]);
+
+    // Delete, and create again with the same name
+    assert(shell->doFind("/f1/k6") == kids[6]);
+    shell->doDelete(kids[6]);
+    assert(Neutral::child(f1.eref(), "k6") == Id());
+    assert(shell->doFind("/f1/k6").bad());
+    Id k6 = shell->doCreate("Neutral", f1, "k6", 1);
+    assert(shell->doFind("/f1/k6") == k6);
+
+    // Resize
+    Id arr = shell->doCreate("Neutral", f2, "arr", 10);
+    assert(shell->doFind("/f2/arr[7]") == ObjId(arr, 7));
+    arr.element()->resize(5);
+    assert(shell->doFind("/f2/arr[7]").bad());
+
+    shell->doDelete(f1);
+    shell->doDelete(f2);
+    assert(shell->doFind("/f1/k1").bad());
+    cout << "." << flush;
+}
+
 void testMove()
 {
     Eref sheller = Id().eref();
@@ -1807,6 +1861,7 @@ void testFilterOffNodeTargets()
 }
 
 extern void testWildcard();
+extern void testLoadBalance();
 
 void testShell()
 {
@@ -1814,10 +1869,12 @@ void testShell()
     testChopPath();
     testTreeTraversal();
     testChildren();
+    testChildIndex();
     testWildcard();
     ////// testShellParserQuit();
     testGetMsgs();  // Tests getting Msg info from Neutral.
     testGetMsgSrcAndTarget();
+    testLoadBalance();
 
     // This is a multinode test, but only needs to run on master node.
     testFilterOffNodeTargets();
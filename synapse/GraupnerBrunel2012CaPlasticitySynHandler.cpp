@@ -16,8 +16,6 @@
 #include "SynHandlerBase.h"
 #include "GraupnerBrunel2012CaPlasticitySynHandler.h"
 
-#include <queue>
-
 const Cinfo* GraupnerBrunel2012CaPlasticitySynHandler::initCinfo()
 {
     static string doc[] =
@@ -285,13 +283,9 @@ GraupnerBrunel2012CaPlasticitySynHandler&
             i = synapses_.begin(); i != synapses_.end(); ++i )
         i->setHandler( this );
 
-    // For no apparent reason, priority queues don't have a clear operation.
-    while( !events_.empty() )
-        events_.pop();
-    while( !delayDPreEvents_.empty() )
-        events_.pop();
-    while( !postEvents_.empty() )
-        postEvents_.pop();
+    events_.clear();
+    delayDPreEvents_.clear();
+    postEvents_.clear();
 
     return *this;
 }
@@ -332,7 +326,7 @@ double GraupnerBrunel2012CaPlasticitySynHandler::getTopSpike(
 {
     if ( events_.empty() )
         return 0.0;
-    return events_.top().time;
+    return events_.topTime();
 }
 
 
@@ -492,10 +486,8 @@ void GraupnerBrunel2012CaPlasticitySynHandler::vProcess( const Eref& e, ProcPtr
     weightFactors wFacs;
 
     // process pre-synaptic spike events for activation, Ca and weight update
-    while( !events_.empty() && events_.top().time <= currTime )
+    for ( const PreSynEvent& currEvent : events_.popDue( currTime ) )
     {
-        PreSynEvent currEvent = events_.top();
-
         unsigned int synIndex = currEvent.synIndex;
         // Warning, coder! 'STDPSynapse currSyn = synapses_[synIndex];' is wrong,
         // it creates a new, shallow-copied object.
@@ -532,15 +524,14 @@ void GraupnerBrunel2012CaPlasticitySynHandler::vProcess( const Eref& e, ProcPtr
             wFacs = updateCaWeightFactors( currTime );
             CaFactorsUpdated = true;
         }
-
-        events_.pop();
     }
     if ( activation != 0.0 )
         SynHandlerBase::activationOut()->send( e, activation );
 
     // process delayed pre-synaptic spike events for Ca and weight update
     // delayD after pre-spike accounts for NMDA rise time
-    while( !delayDPreEvents_.empty() && delayDPreEvents_.top().time <= currTime )
+    unsigned int numDelayDPreEvents = delayDPreEvents_.popDue( currTime ).size();
+    for ( unsigned int j = 0; j < numDelayDPreEvents; ++j )
     {
         // Update Ca, and add CaPre
         // update only once for this time-step if an event occurs
@@ -551,12 +542,11 @@ void GraupnerBrunel2012CaPlasticitySynHandler::vProcess( const Eref& e, ProcPtr
             CaFactorsUpdated = true;
         }
         Ca_ += CaPre_;
-
-        delayDPreEvents_.pop();
     }
 
     // process post-synaptic spike events for Ca and weight update
-    while( !postEvents_.empty() && postEvents_.top().time <= currTime )
+    unsigned int numPostEvents = postEvents_.popDue( currTime ).size();
+    for ( unsigned int j = 0; j < numPostEvents; ++j )
     {
         // update Ca, then add CaPost
         // update only once for this time-step if an event occurs
@@ -567,8 +557,6 @@ void GraupnerBrunel2012CaPlasticitySynHandler::vProcess( const Eref& e, ProcPtr
             CaFactorsUpdated = true;
         }
         Ca_ += CaPost_;
-
-        postEvents_.pop();
     }
 
     // If any event has happened, update all pre-synaptic weights
@@ -591,16 +579,28 @@ void GraupnerBrunel2012CaPlasticitySynHandler::vProcess( const Eref& e, ProcPtr
 
 void GraupnerBrunel2012CaPlasticitySynHandler::vReinit( const Eref& e, ProcPtr p )
 {
-    // For no apparent reason, priority queues don't have a clear operation.
-    while( !events_.empty() )
-        events_.pop();
-    while( !delayDPreEvents_.empty() )
-        events_.pop();
-    while( !postEvents_.empty() )
-        postEvents_.pop();
+    events_.reinit( p->dt );
+    delayDPreEvents_.reinit( p->dt );
+    postEvents_.reinit( p->dt );
     Ca_ = CaInit_;
 }
 
+void GraupnerBrunel2012CaPlasticitySynHandler::vGetEvents(
+                vector< double >& buf ) const
+{
+    events_.pack( buf );
+    delayDPreEvents_.pack( buf );
+    postEvents_.pack( buf );
+}
+
+void GraupnerBrunel2012CaPlasticitySynHandler::vSetEvents(
+                const vector< double >& buf, double t )
+{
+    size_t pos = events_.unpack( buf, 0, t );
+    pos = delayDPreEvents_.unpack( buf, pos, t );
+    postEvents_.unpack( buf, pos, t );
+}
+
 unsigned int GraupnerBrunel2012CaPlasticitySynHandler::addSynapse()
 {
     unsigned int newSynIndex = synapses_.size();
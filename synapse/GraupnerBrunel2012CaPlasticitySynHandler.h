@@ -13,7 +13,7 @@
 #include "../basecode/global.h"
 #include "../randnum/RNG.h"
 
-#include <queue>
+#include "SpikeQueue.h"
 
 using namespace std;
 
@@ -56,6 +56,8 @@ public:
     Synapse* vGetSynapse( unsigned int i );
     void vProcess( const Eref& e, ProcPtr p );
     void vReinit( const Eref& e, ProcPtr p );
+    void vGetEvents( vector< double >& buf ) const;
+    void vSetEvents( const vector< double >& buf, double t );
     /// Adds a new synapse, returns its index.
     unsigned int addSynapse();
     void dropSynapse( unsigned int droppedSynNumber );
@@ -113,9 +115,9 @@ private:
 
     vector< Synapse > synapses_;
 
-    priority_queue< PreSynEvent, vector< PreSynEvent >, CompareSynEvent > events_;
-    priority_queue< PreSynEvent, vector< PreSynEvent >, CompareSynEvent > delayDPreEvents_;
-    priority_queue< PostSynEvent, vector< PostSynEvent >, ComparePostSynEvent > postEvents_;
+    SpikeQueue< PreSynEvent > events_;
+    SpikeQueue< PreSynEvent > delayDPreEvents_;
+    SpikeQueue< PostSynEvent > postEvents_;
 
     double Ca_;
     double CaInit_;
@@ -7,7 +7,6 @@
 ** See the file COPYING.LIB for the full notice.
 **********************************************************************/
 
-#include <queue>
 #include "../basecode/header.h"
 #include "Synapse.h"
 #include "SynEvent.h" // only using the SynEvent class from this
@@ -150,12 +149,8 @@ STDPSynHandler& STDPSynHandler::operator=( const STDPSynHandler& ssh)
 					i = synapses_.begin(); i != synapses_.end(); ++i )
 			i->setHandler( this );
 
-	// For no apparent reason, priority queues don't have a clear operation.
-	while( !events_.empty() )
-		events_.pop();
-
-	while( !postEvents_.empty() )
-		postEvents_.pop();
+	events_.clear();
+	postEvents_.clear();
 
 	return *this;
 }
@@ -194,7 +189,7 @@ double STDPSynHandler::getTopSpike( unsigned int index ) const
 {
 	if ( events_.empty() )
 		return 0.0;
-	return events_.top().time;
+	return events_.topTime();
 }
 
 void STDPSynHandler::addPostSpike( const Eref& e, double time )
@@ -207,9 +202,7 @@ void STDPSynHandler::vProcess( const Eref& e, ProcPtr p )
 	double activation = 0.0;
 
     // process pre-synaptic spike events for activation and STDP
-	while( !events_.empty() && events_.top().time <= p->currTime ) {
-        PreSynEvent currEvent = events_.top();
-
+	for ( const PreSynEvent& currEvent : events_.popDue( p->currTime ) ) {
         unsigned int synIndex = currEvent.synIndex;
         // Warning, coder! 'STDPSynapse currSyn = synapses_[synIndex];' is wrong,
         // it creates a new, shallow-copied object.
@@ -243,14 +236,13 @@ void STDPSynHandler::vProcess( const Eref& e, ProcPtr p )
         double newWeight = currEvent.weight + aMinus_;
         newWeight = std::max(weightMin_, std::min(newWeight, weightMax_));
         currSynPtr->setWeight( newWeight );
-
-		events_.pop();
 	}
 	if ( activation != 0.0 )
 		SynHandlerBase::activationOut()->send( e, activation );
 
     // process post-synaptic spike events for STDP
-	while( !postEvents_.empty() && postEvents_.top().time <= p->currTime ) {
+	unsigned int numPostEvents = postEvents_.popDue( p->currTime ).size();
+	for ( unsigned int j = 0; j < numPostEvents; ++j ) {
         // Add aMinus0 to the aMinus for this synapse
         aMinus_ += aMinus0_;
 
@@ -267,8 +259,6 @@ void STDPSynHandler::vProcess( const Eref& e, ProcPtr p )
             newWeight = std::max(weightMin_, std::min(newWeight, weightMax_));
             currSynPtr->setWeight( newWeight );
         }
-
-		postEvents_.pop();
 	}
 
     // modify aPlus and aMinus at every time step
@@ -294,11 +284,20 @@ void STDPSynHandler::vProcess( const Eref& e, ProcPtr p )
 
 void STDPSynHandler::vReinit( const Eref& e, ProcPtr p )
 {
-	// For no apparent reason, priority queues don't have a clear operation.
-	while( !events_.empty() )
-		events_.pop();
-	while( !postEvents_.empty() )
-		postEvents_.pop();
+	events_.reinit( p->dt );
+	postEvents_.reinit( p->dt );
+}
+
+void STDPSynHandler::vGetEvents( vector< double >& buf ) const
+{
+	events_.pack( buf );
+	postEvents_.pack( buf );
+}
+
+void STDPSynHandler::vSetEvents( const vector< double >& buf, double t )
+{
+	size_t pos = events_.unpack( buf, 0, t );
+	postEvents_.unpack( buf, pos, t );
 }
 
 unsigned int STDPSynHandler::addSynapse()
@@ -10,6 +10,8 @@
 #ifndef _STDP_SYN_HANDLER_H
 #define _STDP_SYN_HANDLER_H
 
+#include "SpikeQueue.h"
+
 /*
 class PreSynEvent: public SynEvent
 {
@@ -73,6 +75,8 @@ class STDPSynHandler: public SynHandlerBase
 		STDPSynapse* vGetSynapse( unsigned int i );
 		void vProcess( const Eref& e, ProcPtr p );
 		void vReinit( const Eref& e, ProcPtr p );
+		void vGetEvents( vector< double >& buf ) const;
+		void vSetEvents( const vector< double >& buf, double t );
 		/// Adds a new synapse, returns its index.
 		unsigned int addSynapse();
 		void dropSynapse( unsigned int droppedSynNumber );
@@ -104,8 +108,8 @@ class STDPSynHandler: public SynHandlerBase
 		static const Cinfo* initCinfo();
 	private:
 		vector< STDPSynapse > synapses_;
-		priority_queue< PreSynEvent, vector< PreSynEvent >, CompareSynEvent > events_;
-		priority_queue< PostSynEvent, vector< PostSynEvent >, ComparePostSynEvent > postEvents_;
+		SpikeQueue< PreSynEvent > events_;
+		SpikeQueue< PostSynEvent > postEvents_;
 		double aMinus_;
 		double aMinus0_;
         double tauMinus_;
@@ -7,7 +7,6 @@
 ** See the file COPYING.LIB for the full notice.
 **********************************************************************/
 
-#include <queue>
 #include <numeric>
 
 #include "../randnum/randnum.h"
@@ -237,9 +236,7 @@ SeqSynHandler& SeqSynHandler::operator=( const SeqSynHandler& ssh)
             i = synapses_.begin(); i != synapses_.end(); ++i )
         i->setHandler( this );
 
-    // For no apparent reason, priority queues don't have a clear operation.
-    while( !events_.empty() )
-        events_.pop();
+    events_.clear();
 
     return *this;
 }
@@ -537,7 +534,7 @@ double SeqSynHandler::getTopSpike( unsigned int index ) const
 {
     if ( events_.empty() )
         return 0.0;
-    return events_.top().time;
+    return events_.topTime();
 }
 
 unsigned int SeqSynHandler::addSynapse()
@@ -559,14 +556,9 @@ void SeqSynHandler::vProcess( const Eref& e, ProcPtr p )
 {
     // Here we look at the correlations and do something with them.
     int nh = numHistory();
-	vector< PreSynEvent > newEvents;
-    while( !events_.empty() && events_.top().time <= p->currTime )
-    {
-        newEvents.push_back( events_.top() );
-		latestSpikes_[ synapseOrder_[ events_.top().synIndex ] ] += 
-			events_.top().weight;
-        events_.pop();
-    }
+	const vector< PreSynEvent >& newEvents = events_.popDue( p->currTime );
+	for ( const auto& ee : newEvents )
+		latestSpikes_[ synapseOrder_[ ee.synIndex ] ] += ee.weight;
 
     // Check if we need to do correlations at all.
     if ( nh > 0 && kernel_.size() > 0 )
@@ -658,9 +650,17 @@ void SeqSynHandler::vProcess( const Eref& e, ProcPtr p )
 
 void SeqSynHandler::vReinit( const Eref& e, ProcPtr p )
 {
-    // For no apparent reason, priority queues don't have a clear operation.
-    while( !events_.empty() )
-        events_.pop();
+    events_.reinit( p->dt );
+}
+
+void SeqSynHandler::vGetEvents( vector< double >& buf ) const
+{
+    events_.pack( buf );
+}
+
+void SeqSynHandler::vSetEvents( const vector< double >& buf, double t )
+{
+    events_.unpack( buf, 0, t );
 }
 
 int SeqSynHandler::numHistory() const
@@ -10,6 +10,8 @@
 #ifndef _SEQ_SYN_HANDLER_H
 #define _SEQ_SYN_HANDLER_H
 
+#include "SpikeQueue.h"
+
 /**
  * This handles synapses organized sequentially. The parent class
  * SimpleSynHandler deals with the mechanics of data arrival.
@@ -38,6 +40,8 @@ class SeqSynHandler: public SynHandlerBase
 		Synapse* vGetSynapse( unsigned int i );
 		void vProcess( const Eref& e, ProcPtr p );
 		void vReinit( const Eref& e, ProcPtr p );
+		void vGetEvents( vector< double >& buf ) const;
+		void vSetEvents( const vector< double >& buf, double t );
 
 		////////////////////////////////////////////////////////////////
 		/// Adds a new synapse, returns its index.
@@ -153,7 +157,7 @@ class SeqSynHandler: public SynHandlerBase
 		int synapseOrderOption_;
 
 		vector< Synapse > synapses_;
-		priority_queue< PreSynEvent, vector< PreSynEvent >, CompareSynEvent > events_;
+		SpikeQueue< PreSynEvent > events_;
 
 
 };
@@ -7,7 +7,6 @@
 ** See the file COPYING.LIB for the full notice.
 **********************************************************************/
 
-#include <queue>
 #include "../basecode/header.h"
 #include "Synapse.h"
 #include "SynEvent.h"
@@ -19,7 +18,7 @@ const Cinfo* SimpleSynHandler::initCinfo()
     static string doc[] = {
         "Name", "SimpleSynHandler", "Author", "Upi Bhalla", "Description",
         "The SimpleSynHandler handles simple synapses without plasticity. "
-        "It uses a priority queue to manage them."};
+        "It uses a calendar queue to manage them."};
 
     static FieldElementFinfo<SynHandlerBase, Synapse> synFinfo(
         "synapse", "Sets up field Elements for synapse", Synapse::initCinfo(),
@@ -56,8 +55,7 @@ SimpleSynHandler& SimpleSynHandler::operator=(const SimpleSynHandler& ssh)
     for (auto i = synapses_.begin(); i != synapses_.end(); ++i)
         i->setHandler(this);
 
-    // For no apparent reason, priority queues don't have a clear operation.
-    while (!events_.empty()) events_.pop();
+    events_.clear();
 
     return *this;
 }
@@ -92,13 +90,13 @@ void SimpleSynHandler::addSpike(unsigned int index, double time, double weight)
 double SimpleSynHandler::getTopSpike(unsigned int index) const
 {
     if (events_.empty()) return 0.0;
-    return events_.top().time;
+    return events_.topTime();
 }
 
 void SimpleSynHandler::vProcess(const Eref& e, ProcPtr p)
 {
     double activation = 0.0;
-    while (!events_.empty() && events_.top().time <= p->currTime) {
+    for (const SynEvent& event : events_.popDue(p->currTime)) {
         // Send out weight / dt for every spike
         //      Since it is an impulse active only for one dt,
         //      need to send it divided by dt.
@@ -106,16 +104,24 @@ void SimpleSynHandler::vProcess(const Eref& e, ProcPtr p)
         //      or to LIF as an impulse to voltage.
         // See:
         // http://www.genesis-sim.org/GENESIS/Hyperdoc/Manual-26.html#synchan
-        activation += events_.top().weight / p->dt;
-        events_.pop();
+        activation += event.weight / p->dt;
     }
     if (activation != 0.0) SynHandlerBase::activationOut()->send(e, activation);
 }
 
 void SimpleSynHandler::vReinit(const Eref& e, ProcPtr p)
 {
-    // For no apparent reason, priority queues don't have a clear operation.
-    while (!events_.empty()) events_.pop();
+    events_.reinit(p->dt);
+}
+
+void SimpleSynHandler::vGetEvents(vector<double>& buf) const
+{
+    events_.pack(buf);
+}
+
+void SimpleSynHandler::vSetEvents(const vector<double>& buf, double t)
+{
+    events_.unpack(buf, 0, t);
 }
 
 unsigned int SimpleSynHandler::addSynapse()
@@ -10,7 +10,7 @@
 #ifndef _SIMPLE_SYN_HANDLER_H
 #define _SIMPLE_SYN_HANDLER_H
 
-#include <queue>
+#include "SpikeQueue.h"
 
 /*
 class SynEvent
@@ -40,9 +40,8 @@ struct CompareSynEvent
 */
 
 /**
- * This handles simple synapses without plasticity. It uses a priority
- * queue to manage them. This gets inefficient for large numbers of
- * synapses but is pretty robust.
+ * This handles simple synapses without plasticity. Pending spikes are
+ * kept in a SpikeQueue, which delivers them in time order.
  */
 class SimpleSynHandler: public SynHandlerBase
 {
@@ -59,6 +58,8 @@ class SimpleSynHandler: public SynHandlerBase
 		Synapse* vGetSynapse( unsigned int i );
 		void vProcess( const Eref& e, ProcPtr p );
 		void vReinit( const Eref& e, ProcPtr p );
+		void vGetEvents( vector< double >& buf ) const;
+		void vSetEvents( const vector< double >& buf, double t );
 		/// Adds a new synapse, returns its index.
 		unsigned int addSynapse();
 		void dropSynapse( unsigned int droppedSynNumber );
@@ -68,7 +69,7 @@ class SimpleSynHandler: public SynHandlerBase
 		static const Cinfo* initCinfo();
 	private:
 		vector< Synapse > synapses_;
-		priority_queue< SynEvent, vector< SynEvent >, CompareSynEvent > events_;
+		SpikeQueue< SynEvent > events_;
 };
 
 #endif // _SIMPLE_SYN_HANDLER_H
@@ -0,0 +1,254 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2013 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _SPIKE_QUEUE_H
+#define _SPIKE_QUEUE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * Calendar queue of pending synaptic events, used by the SynHandlers in
+ * place of a priority_queue. Events are kept in a ring of buckets, one
+ * per time step of width dt, each a linked list threaded through a pool
+ * of nodes. Insertion is O(1) and does not allocate once the pool has
+ * grown, and popDue costs O(events delivered) plus the buckets passed.
+ *
+ * The ring grows to a power of 2 that spans the longest delay seen, up to
+ * maxBuckets. Events further ahead share buckets with earlier laps; they
+ * are still delivered correctly, as every event is checked against the
+ * current time before it is taken out.
+ *
+ * T must have a 'double time' member. For pack and unpack it must also
+ * write and read its fields as T::numWords doubles, as SynEvent does.
+ */
+template< class T > class SpikeQueue
+{
+	public:
+		SpikeQueue()
+			: dt_( 1.0 ), invDt_( 1.0 ), curr_( 0 ), size_( 0 ),
+			free_( NIL )
+		{
+			head_.assign( 1, NIL );
+		}
+
+		/// Empties the queue, and sets the bucket width to dt.
+		void reinit( double dt )
+		{
+			if ( dt > 0.0 ) {
+				dt_ = dt;
+				invDt_ = 1.0 / dt;
+			}
+			head_.assign( head_.size(), NIL );
+			nodes_.clear();
+			free_ = NIL;
+			curr_ = 0;
+			size_ = 0;
+		}
+
+		void clear()
+		{
+			reinit( dt_ );
+		}
+
+		bool empty() const
+		{
+			return size_ == 0;
+		}
+
+		unsigned int size() const
+		{
+			return size_;
+		}
+
+		void push( const T& event )
+		{
+			int64_t step = stepOf( event.time );
+			if ( step < curr_ ) // Late: deliver at the next popDue.
+				step = curr_;
+			else if ( step - curr_ >= static_cast< int64_t >( head_.size() )
+					&& head_.size() < maxBuckets )
+				grow( step - curr_ + 1 );
+
+			uint32_t n;
+			if ( free_ != NIL ) {
+				n = free_;
+				free_ = nodes_[ n ].next;
+				nodes_[ n ].event = event;
+			} else {
+				n = static_cast< uint32_t >( nodes_.size() );
+				nodes_.push_back( Node{ event, NIL } );
+			}
+			uint32_t& head = head_[ step & ( head_.size() - 1 ) ];
+			nodes_[ n ].next = head;
+			head = n;
+			++size_;
+		}
+
+		/// Time of the earliest pending event. The queue must not be empty.
+		double topTime() const
+		{
+			double t = HUGE_VAL;
+			for ( uint32_t head : head_ )
+				for ( uint32_t n = head; n != NIL; n = nodes_[ n ].next )
+					t = std::min( t, nodes_[ n ].event.time );
+			return t;
+		}
+
+		/**
+		 * Takes out all events with time <= t, and returns them in order
+		 * of time. Events with equal times come in the order they were
+		 * pushed. The returned vector is reused by the next call.
+		 */
+		const vector< T >& popDue( double t )
+		{
+			due_.clear();
+			if ( size_ == 0 )
+				return due_;
+			int64_t last = stepOf( t );
+			int64_t end = std::min( last + 1,
+					curr_ + static_cast< int64_t >( head_.size() ) );
+			for ( int64_t step = curr_; step < end; ++step )
+				popBucket( step & ( head_.size() - 1 ), t );
+			if ( last > curr_ )
+				curr_ = last;
+			if ( due_.size() > 1 )
+				std::stable_sort( due_.begin(), due_.end(),
+					[]( const T& a, const T& b ) { return a.time < b.time; } );
+			return due_;
+		}
+
+		/**
+		 * Appends the pending events to ret. Events with equal times come
+		 * in the order they were pushed, so pushing ret back in order
+		 * gives a queue that delivers them as this one would.
+		 */
+		void getEvents( vector< T >& ret ) const
+		{
+			vector< uint32_t > order;
+			for ( uint32_t head : head_ ) {
+				order.clear();
+				for ( uint32_t n = head; n != NIL; n = nodes_[ n ].next )
+					order.push_back( n );
+				for ( auto n = order.rbegin(); n != order.rend(); ++n )
+					ret.push_back( nodes_[ *n ].event );
+			}
+		}
+
+		/**
+		 * Appends the pending events to buf, for checkpoints: their
+		 * number, then the fields of each event.
+		 */
+		void pack( vector< double >& buf ) const
+		{
+			vector< T > events;
+			getEvents( events );
+			buf.push_back( events.size() );
+			size_t start = buf.size();
+			buf.resize( start + T::numWords * events.size() );
+			for ( size_t i = 0; i < events.size(); ++i )
+				events[ i ].pack( &buf[ start + i * T::numWords ] );
+		}
+
+		/**
+		 * Replaces the contents by the events that pack wrote into buf
+		 * at pos, as due at time t or later. Returns the position after
+		 * them.
+		 */
+		size_t unpack( const vector< double >& buf, size_t pos, double t )
+		{
+			clear();
+			curr_ = stepOf( t );
+			if ( pos >= buf.size() )
+				return pos;
+			size_t n = static_cast< size_t >( buf[ pos++ ] );
+			T event;
+			for ( size_t i = 0; i < n && pos + T::numWords <= buf.size(); ++i ) {
+				event.unpack( &buf[ pos ] );
+				push( event );
+				pos += T::numWords;
+			}
+			return pos;
+		}
+
+	private:
+		static constexpr uint32_t NIL = ~0u;
+		static constexpr size_t maxBuckets = 1 << 16;
+
+		struct Node
+		{
+			T event;
+			uint32_t next;
+		};
+
+		int64_t stepOf( double t ) const
+		{
+			return static_cast< int64_t >( std::floor( t * invDt_ ) );
+		}
+
+		/// Moves the events due by t from one bucket into due_.
+		void popBucket( size_t bucket, double t )
+		{
+			size_t first = due_.size();
+			uint32_t* link = &head_[ bucket ];
+			while ( *link != NIL ) {
+				uint32_t n = *link;
+				if ( nodes_[ n ].event.time <= t ) {
+					due_.push_back( nodes_[ n ].event );
+					*link = nodes_[ n ].next;
+					nodes_[ n ].next = free_;
+					free_ = n;
+					--size_;
+				} else {
+					link = &nodes_[ n ].next;
+				}
+			}
+			// Buckets are pushed at the front.
+			std::reverse( due_.begin() + first, due_.end() );
+		}
+
+		/// Resizes the ring to hold at least span buckets from curr_.
+		void grow( int64_t span )
+		{
+			size_t n = head_.size();
+			while ( static_cast< int64_t >( n ) < span && n < maxBuckets )
+				n *= 2;
+
+			// Relink each bucket from its oldest event on, so that events
+			// in a bucket stay in push order.
+			vector< uint32_t > old;
+			old.swap( head_ );
+			head_.assign( n, NIL );
+			vector< uint32_t > order;
+			for ( uint32_t head : old ) {
+				order.clear();
+				for ( uint32_t i = head; i != NIL; i = nodes_[ i ].next )
+					order.push_back( i );
+				for ( auto i = order.rbegin(); i != order.rend(); ++i ) {
+					int64_t step = std::max( stepOf( nodes_[ *i ].event.time ),
+							curr_ );
+					uint32_t& h = head_[ step & ( n - 1 ) ];
+					nodes_[ *i ].next = h;
+					h = *i;
+				}
+			}
+		}
+
+		vector< uint32_t > head_;	///< First node of each bucket
+		vector< Node > nodes_;		///< Pool of list nodes
+		vector< T > due_;			///< Events returned by popDue
+		double dt_;
+		double invDt_;
+		int64_t curr_;				///< Step of the last popDue
+		unsigned int size_;
+		uint32_t free_;				///< Free list through nodes_
+};
+
+#endif // _SPIKE_QUEUE_H
@@ -21,6 +21,19 @@ class SynEvent
 			: time( t ), weight( w )
 		{;}
 
+		/// Number of doubles that pack writes and unpack reads.
+		static constexpr unsigned int numWords = 2;
+		void pack( double* buf ) const
+		{
+			buf[0] = time;
+			buf[1] = weight;
+		}
+		void unpack( const double* buf )
+		{
+			time = buf[0];
+			weight = buf[1];
+		}
+
 		double time;
 		double weight;
 };
@@ -49,6 +62,18 @@ class PreSynEvent: public SynEvent
               synIndex( i )
 		{;}
 
+		static constexpr unsigned int numWords = 3;
+		void pack( double* buf ) const
+		{
+			SynEvent::pack( buf );
+			buf[2] = synIndex;
+		}
+		void unpack( const double* buf )
+		{
+			SynEvent::unpack( buf );
+			synIndex = static_cast< unsigned int >( buf[2] );
+		}
+
         unsigned int synIndex;
 };
 
@@ -63,6 +88,16 @@ class PostSynEvent
 			: time( t )
 		{;}
 
+		static constexpr unsigned int numWords = 1;
+		void pack( double* buf ) const
+		{
+			buf[0] = time;
+		}
+		void unpack( const double* buf )
+		{
+			time = buf[0];
+		}
+
 		double time;
 };
 
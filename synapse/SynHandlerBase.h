@@ -88,6 +88,16 @@ public:
     virtual Synapse* vGetSynapse( unsigned int i ) = 0;
     virtual void vProcess( const Eref& e, ProcPtr p ) = 0;
     virtual void vReinit( const Eref& e, ProcPtr p ) = 0;
+
+    /**
+     * Pending synaptic events, for checkpoints. vGetEvents appends them
+     * to buf, and vSetEvents puts back what it wrote, as due at time t
+     * or later.
+     */
+    virtual void vGetEvents( vector< double >& buf ) const
+    {;}
+    virtual void vSetEvents( const vector< double >& buf, double t )
+    {;}
     ////////////////////////////////////////////////////////////////
     static SrcFinfo1< double >* activationOut();
     static const Cinfo* initCinfo();
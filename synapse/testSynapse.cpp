@@ -199,6 +199,82 @@ void testSeqSynapse()
 	shell->doDelete( sid );
 }
 
+/// Checks the SpikeQueue against a plain sort of the same events.
+void testSpikeQueue()
+{
+	const double dt = 0.1;
+	SpikeQueue< SynEvent > q;
+	q.reinit( dt );
+	vector< SynEvent > all;
+	// Delays from 0 to 50 steps, some on step boundaries, some far
+	// enough out to grow the ring, and one late arrival.
+	for ( unsigned int i = 0; i < 200; ++i ) {
+		double t = 0.05 * ( ( i * 37 ) % 101 ) + ( i % 7 == 0 ? 0.0 : 0.01 );
+		all.push_back( SynEvent( t, i ) );
+	}
+	for ( unsigned int i = 0; i < 100; ++i )
+		q.push( all[i] );
+	assert( q.size() == 100 );
+	assert( doubleEq( q.topTime(), 0.0 ) );
+
+	vector< SynEvent > got;
+	for ( unsigned int step = 0; step <= 60; ++step ) {
+		double t = step * dt;
+		if ( step == 10 ) {
+			for ( unsigned int i = 100; i < 200; ++i )
+				q.push( all[i] );
+			q.push( SynEvent( 0.2, 1000 ) ); // Already due.
+			all.push_back( SynEvent( 0.2, 1000 ) );
+		}
+		const vector< SynEvent >& due = q.popDue( t );
+		for ( unsigned int i = 0; i < due.size(); ++i ) {
+			assert( due[i].time <= t );
+			if ( i > 0 )
+				assert( due[i-1].time <= due[i].time );
+		}
+		got.insert( got.end(), due.begin(), due.end() );
+	}
+	assert( q.empty() );
+	assert( got.size() == all.size() );
+
+	// Each event arrives exactly once.
+	vector< bool > seen( 1001, false );
+	for ( unsigned int i = 0; i < got.size(); ++i ) {
+		unsigned int w = got[i].weight;
+		assert( !seen[w] );
+		seen[w] = true;
+	}
+
+	q.push( SynEvent( 1.0, 1.0 ) );
+	q.reinit( dt );
+	assert( q.empty() );
+	assert( q.popDue( 2.0 ).empty() );
+
+	// Checkpoints hold each event as its fields.
+	SpikeQueue< PreSynEvent > pre;
+	SpikeQueue< PreSynEvent > restored;
+	pre.reinit( dt );
+	restored.reinit( dt );
+	for ( unsigned int i = 0; i < 20; ++i )
+		pre.push( PreSynEvent( i, 0.3 * i, 0.5 * i ) );
+	vector< double > buf;
+	pre.pack( buf );
+	assert( buf.size() == 1 + 20 * PreSynEvent::numWords );
+	assert( restored.unpack( buf, 0, 0.0 ) == buf.size() );
+	vector< PreSynEvent > before;
+	vector< PreSynEvent > after;
+	pre.getEvents( before );
+	restored.getEvents( after );
+	assert( before.size() == after.size() );
+	for ( unsigned int i = 0; i < before.size(); ++i ) {
+		assert( after[i].time == before[i].time );
+		assert( after[i].weight == before[i].weight );
+		assert( after[i].synIndex == before[i].synIndex );
+	}
+
+	cout << "." << flush;
+}
+
 #endif // DO_UNIT_TESTS
 
 // This tests stuff without using the messaging.
@@ -208,6 +284,7 @@ void testSynapse()
 	testRollingMatrix();
 	testRollingMatrix2();
 	testSeqSynapse();
+	testSpikeQueue();
 #endif // DO_UNIT_TESTS
 }
 
@@ -0,0 +1,77 @@
+# Check that a run restored from a checkpoint goes on exactly as the run
+# that saved it.
+
+import os
+import tempfile
+import numpy as np
+import moose
+
+N = 20
+DT = 1e-4
+
+def makeNetwork():
+    """A ring of neurons, each exciting the next one through a synapse."""
+    net = moose.Neutral('/net')
+    nrn = moose.vec('/net/nrn', N, 0, 'LIF')
+    nrn.Rm = 1e8
+    nrn.Cm = 1e-10
+    nrn.Em = -0.065
+    nrn.initVm = -0.065
+    nrn.thresh = -0.05
+    nrn.vReset = -0.07
+    nrn.refractoryPeriod = 2e-3
+    nrn.inject = 1.5e-10 + 1e-12 * (np.arange(N) % 7)
+    syn = moose.vec('/net/syn', N, 0, 'SimpleSynHandler')
+    syn.numSynapses = 1
+    for i in range(N):
+        s = syn[(i + 1) % N].synapse[0]
+        s.weight = 0.004
+        s.delay = 2e-3 + 1e-4 * (i % 5)
+        moose.connect(nrn[i], 'spikeOut', s, 'addSpike')
+    moose.connect(syn, 'activationOut', nrn, 'activation', 'OneToOne')
+    tab = moose.Table('/net/tab')
+    moose.connect(tab, 'requestOut', nrn[0], 'getVm')
+    moose.setClock(0, DT)
+    moose.setClock(1, DT)
+    moose.setClock(2, DT)
+    moose.useClock(0, '/net/syn', 'process')
+    moose.useClock(1, '/net/nrn', 'process')
+    moose.useClock(2, '/net/tab', 'process')
+    return nrn, tab
+
+def test_checkpoint():
+    fname = os.path.join(tempfile.mkdtemp(), 'run.ckp')
+    nrn, tab = makeNetwork()
+    moose.reinit()
+    moose.start(0.05)
+    moose.checkpoint(fname)
+    moose.start(0.05)
+    Vm = np.array(nrn.Vm)
+    last = np.array(nrn.lastEventTime)
+    vec = np.array(tab.vector)
+    assert last.max() > 0.05
+
+    moose.delete('/net')
+    nrn, tab = makeNetwork()
+    moose.reinit()
+    moose.restore(fname)
+    assert moose.element('/clock').currentTime == 0.05
+    moose.start(0.05)
+    assert np.array_equal(Vm, np.array(nrn.Vm))
+    assert np.array_equal(last, np.array(nrn.lastEventTime))
+    assert np.array_equal(vec, np.array(tab.vector))
+
+    # A different model is refused, and left as it is.
+    moose.delete('/net/tab')
+    moose.reinit()
+    try:
+        moose.restore(fname)
+        assert False, 'restored into a different model'
+    except RuntimeError:
+        pass
+    assert moose.element('/clock').currentTime == 0.0
+    moose.delete('/net')
+    os.remove(fname)
+
+if __name__ == '__main__':
+    test_checkpoint()
@@ -0,0 +1,137 @@
+# Check that running independent solvers on the same tick in parallel
+# (Clock.numThreads > 1) gives the same answer as the serial schedule.
+
+import numpy as np
+import moose
+
+def buildModel(nCompts=4):
+    """Independent cylinders, each with its own Ksolve and Dsolve."""
+    pools = []
+    for i in range(nCompts):
+        root = moose.Neutral('/model%d' % i)
+        compt = moose.CylMesh('%s/cyl' % root.path)
+        compt.r0 = compt.r1 = 1e-6
+        compt.x1 = 20e-6
+        compt.diffLength = 1e-6
+        a = moose.Pool('%s/a' % compt.path)
+        b = moose.Pool('%s/b' % compt.path)
+        a.diffConst = b.diffConst = 1e-12
+        r = moose.Reac('%s/r' % compt.path)
+        r.Kf = 0.1 * (i + 1)
+        r.Kb = 0.05
+        moose.connect(r, 'sub', a, 'reac')
+        moose.connect(r, 'prd', b, 'reac')
+
+        ksolve = moose.Ksolve('%s/ksolve' % root.path)
+        dsolve = moose.Dsolve('%s/dsolve' % root.path)
+        stoich = moose.Stoich('%s/stoich' % root.path)
+        stoich.compartment = compt
+        stoich.ksolve = ksolve
+        stoich.dsolve = dsolve
+        stoich.reacSystemPath = '%s/##' % compt.path
+        a.vec.nInit = np.linspace(0, 100, len(a.vec))
+        pools.append(b)
+    return pools
+
+def runModel(numThreads):
+    for i in range(4):
+        if moose.exists('/model%d' % i):
+            moose.delete('/model%d' % i)
+    pools = buildModel()
+    moose.element('/clock').numThreads = numThreads
+    moose.reinit()
+    moose.start(20)
+    return np.array([p.vec.n for p in pools])
+
+def test_clock_threads():
+    serial = runModel(1)
+    threaded = runModel(4)
+    moose.element('/clock').numThreads = 1
+    assert np.allclose(serial, threaded, rtol=0, atol=1e-12), (serial, threaded)
+
+def buildCoupledModel():
+    """Pairs of cylinders end to end, joined by diffusion junctions."""
+    pools = []
+    ksolves = []
+    for i in range(4):
+        root = moose.Neutral('/coupled%d' % i)
+        compt = moose.CylMesh('%s/cyl' % root.path)
+        compt.r0 = compt.r1 = 1e-6
+        compt.x0 = 20e-6 * (i % 2)
+        compt.x1 = compt.x0 + 20e-6
+        compt.diffLength = 1e-6
+        a = moose.Pool('%s/a' % compt.path)
+        b = moose.Pool('%s/b' % compt.path)
+        a.diffConst = b.diffConst = 1e-12
+        r = moose.Reac('%s/r' % compt.path)
+        r.Kf = 0.1 * (i + 1)
+        r.Kb = 0.05
+        moose.connect(r, 'sub', a, 'reac')
+        moose.connect(r, 'prd', b, 'reac')
+
+        ksolve = moose.Ksolve('%s/ksolve' % root.path)
+        dsolve = moose.Dsolve('%s/dsolve' % root.path)
+        stoich = moose.Stoich('%s/stoich' % root.path)
+        stoich.compartment = compt
+        stoich.ksolve = ksolve
+        stoich.dsolve = dsolve
+        stoich.reacSystemPath = '%s/##' % compt.path
+        a.vec.nInit = np.linspace(0, 100, len(a.vec)) * (i % 2)
+        pools.append(a)
+        ksolves.append(ksolve)
+        if i % 2:
+            dsolve.buildMeshJunctions(moose.element('/coupled%d/dsolve' % (i - 1)))
+    return pools, ksolves
+
+def runCoupledModel(numThreads):
+    for i in range(4):
+        if moose.exists('/coupled%d' % i):
+            moose.delete('/coupled%d' % i)
+    pools, ksolves = buildCoupledModel()
+    moose.element('/clock').numThreads = numThreads
+    moose.reinit()
+    moose.start(20)
+    return np.array([p.vec.n for p in pools]), ksolves
+
+def test_clock_threads_junctions():
+    serial, ksolves = runCoupledModel(1)
+    # Ksolves whose Dsolves share a junction must not run together.
+    for i in (1, 3):
+        coupled = [moose.element(o).path for o in ksolves[i].coupledObjects]
+        assert ksolves[i - 1].path in coupled, coupled
+    threaded, _ = runCoupledModel(4)
+    moose.element('/clock').numThreads = 1
+    # Molecules crossed the junctions into the empty cylinders.
+    assert serial[0].sum() > 0 and serial[2].sum() > 0, serial
+    assert np.allclose(serial, threaded, rtol=0, atol=1e-12), (serial, threaded)
+
+def test_hsolve_spikes_coupled():
+    """HSolves spiking onto synapses of one handler share that handler."""
+    synh = moose.SimpleSynHandler('/spikeTarget')
+    synh.numSynapses = 2
+    hsolves = []
+    for i in range(2):
+        cell = moose.Neutral('/spikeCell%d' % i)
+        soma = moose.Compartment('%s/soma' % cell.path)
+        soma.Cm = 0.007854e-6
+        soma.Ra = 7639.44e3
+        soma.Rm = 424.4e3
+        spike = moose.SpikeGen('%s/spike' % soma.path)
+        moose.connect(soma, 'VmOut', spike, 'Vm')
+        moose.connect(spike, 'spikeOut', synh.synapse[i], 'addSpike')
+        hsolve = moose.HSolve('/spikeCell%d_hsolve' % i)
+        hsolve.dt = 2e-5
+        hsolve.target = cell.path
+        hsolves.append(hsolve)
+    for hsolve in hsolves:
+        coupled = [moose.element(o).path for o in hsolve.coupledObjects]
+        assert synh.path in coupled, coupled
+    for i in range(2):
+        moose.delete('/spikeCell%d_hsolve' % i)
+        moose.delete('/spikeCell%d' % i)
+    moose.delete(synh)
+
+if __name__ == '__main__':
+    test_clock_threads()
+    test_clock_threads_junctions()
+    test_hsolve_spikes_coupled()
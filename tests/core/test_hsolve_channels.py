@@ -0,0 +1,193 @@
+# Check that SynChans, HHChannelFs, HHChannel2Ds and MarkovChannels taken
+# over by an HSolve give the same answer as the channels on their own.
+
+import numpy as np
+import moose
+
+EREST = -0.07
+DT = 2e-5
+
+def makeCompt(path):
+    c = moose.Compartment(path)
+    c.Cm = 0.007854e-6
+    c.Ra = 7639.44e3
+    c.Rm = 424.4e3
+    c.Em = EREST + 0.010613
+    c.initVm = EREST
+    return c
+
+def addChan(compt, chan):
+    moose.connect(compt, 'channel', chan, 'channel')
+    return chan
+
+def makeFormulaChannels(soma):
+    na = addChan(soma, moose.HHChannelF('%s/Na' % soma.path))
+    na.Ek = EREST + 0.115
+    na.Gbar = 0.94248e-3
+    na.Xpower = 3
+    na.Ypower = 1
+    na.gateX.alpha = '1e5 * (-0.045 - v) / (exp((-0.045 - v) / 0.01) - 1)'
+    na.gateX.beta = '4e3 * exp((-0.07 - v) / 0.018)'
+    na.gateY.alpha = '70 * exp((-0.07 - v) / 0.02)'
+    na.gateY.beta = '1e3 / (exp((-0.04 - v) / 0.01) + 1)'
+    k = addChan(soma, moose.HHChannelF('%s/K' % soma.path))
+    k.Ek = EREST - 0.012
+    k.Gbar = 0.282743e-3
+    k.Xpower = 4
+    k.gateX.alpha = '1e4 * (-0.06 - v) / (exp((-0.06 - v) / 0.01) - 1)'
+    k.gateX.beta = '125 * exp((-0.07 - v) / 0.08)'
+
+def makeCalciumChannels(soma):
+    """A Ca channel feeds a CaConc, which an HHChannel2D looks up."""
+    caconc = moose.CaConc('%s/Ca_conc' % soma.path)
+    caconc.CaBasal = 5e-5
+    caconc.tau = 0.02
+    caconc.B = 5e9
+    ca = addChan(soma, moose.HHChannelF('%s/Ca' % soma.path))
+    ca.Ek = 0.08
+    ca.Gbar = 1e-5
+    ca.Xpower = 2
+    ca.gateX.alpha = '1600 / (1 + exp(-72 * (v - 0.005)))'
+    ca.gateX.beta = '20 * (v + 0.0089) / (exp((v + 0.0089) / 0.005) - 1)'
+    moose.connect(ca, 'IkOut', caconc, 'current')
+
+    kca = addChan(soma, moose.HHChannel2D('%s/KCa' % soma.path))
+    kca.Ek = EREST - 0.012
+    kca.Gbar = 5e-5
+    kca.Xpower = 1
+    kca.Xindex = 'VOLT_C1_INDEX'
+    v = np.linspace(-0.1, 0.05, 31)[:, None]
+    c = np.linspace(0, 0.01, 21)[None, :]
+    alpha = 500 * c / (c + 1e-3) * np.exp(v / 0.03)
+    gate = moose.element('%s/gateX' % kca.path)
+    gate.xmin, gate.xmax, gate.xdivs = -0.1, 0.05, 30
+    gate.ymin, gate.ymax, gate.ydivs = 0, 0.01, 20
+    gate.tableA = alpha.tolist()
+    gate.tableB = (alpha + 100).tolist()
+    moose.connect(caconc, 'concOut', kca, 'concen')
+
+def makeSynapse(cell, dend):
+    syn = addChan(dend, moose.SynChan('%s/syn' % dend.path))
+    syn.Gbar = 1e-8
+    syn.tau1 = 1e-3
+    syn.tau2 = 2e-3
+    syn.Ek = 0.0
+    sh = moose.SimpleSynHandler('%s/sh' % syn.path)
+    sh.synapse.num = 1
+    sh.synapse[0].weight = 1.0
+    sh.synapse[0].delay = 1e-3
+    moose.connect(sh, 'activationOut', syn, 'activation')
+    pg = moose.PulseGen('%s/pg' % cell.path)
+    pg.firstLevel = 1.0
+    pg.firstWidth = 1e-3
+    pg.firstDelay = 4e-3
+    sg = moose.SpikeGen('%s/sg' % cell.path)
+    sg.threshold = 0.5
+    sg.refractT = 1e-3
+    moose.connect(pg, 'output', sg, 'Vm')
+    moose.connect(sg, 'spikeOut', sh.synapse[0], 'addSpike')
+
+def makeMarkovChannel(dend):
+    """A two state channel with voltage dependent rates."""
+    mc = addChan(dend, moose.MarkovChannel('%s/mc' % dend.path))
+    mc.numStates = 2
+    mc.numOpenStates = 1
+    mc.initialState = [0.0, 1.0]
+    mc.gbar = [2e-6]
+    mc.Ek = EREST - 0.012
+    rates = moose.MarkovRateTable('%s/rates' % dend.path)
+    rates.init(2)
+    v = np.linspace(-0.1, 0.05, 101)
+    for (i, j), table in [((1, 2), 200 * np.exp(-v / 0.02)),
+                          ((2, 1), 100 * np.exp(v / 0.02))]:
+        vt = moose.VectorTable('%s/vt%d%d' % (dend.path, i, j))
+        vt.xmin, vt.xmax, vt.xdivs = -0.1, 0.05, 100
+        vt.table = table.tolist()
+        rates.set1d(i, j, vt, 0)
+    solver = moose.MarkovSolver('%s/solver' % dend.path)
+    solver.initialState = [0.0, 1.0]
+    solver.init(rates, DT)
+    moose.connect(dend, 'VmOut', solver, 'handleVm')
+    moose.connect(solver, 'stateOut', mc, 'handleState')
+
+def makeCell(name):
+    cell = moose.Neutral('/%s' % name)
+    soma = makeCompt('%s/soma' % cell.path)
+    dend = makeCompt('%s/dend' % cell.path)
+    moose.connect(soma, 'axial', dend, 'raxial')
+    soma.inject = 0.1e-6
+    makeFormulaChannels(soma)
+    makeCalciumChannels(soma)
+    makeSynapse(cell, dend)
+    makeMarkovChannel(dend)
+    return cell
+
+def Vm(cell):
+    return np.array([moose.element('%s/%s' % (cell.path, c)).Vm
+                     for c in ('soma', 'dend')])
+
+def test_hsolve_channels():
+    for i in range(10):
+        moose.setClock(i, DT)
+    plain = makeCell('plain')
+    solved = makeCell('solved')
+    hsolve = moose.HSolve('/hsolve')
+    hsolve.dt = DT
+    hsolve.target = solved.path
+    moose.useClock(6, '/hsolve', 'process')
+    for path, cls in [('soma/Na', 'ZombieHHChannel'),
+                      ('dend/syn', 'ZombieSynChan'),
+                      ('soma/KCa', 'ZombieHHChannel2D'),
+                      ('dend/mc', 'ZombieMarkovChannel')]:
+        assert moose.element('%s/%s' % (solved.path, path)).className == cls
+
+    moose.reinit()
+    err = 0.0
+    for t in range(50):
+        moose.start(1e-3)
+        err = max(err, np.abs(Vm(plain) - Vm(solved)).max())
+    # Formula gates are tabulated by the solver, and 2-D gates use its
+    # integration scheme, so the answers agree only closely.
+    assert err < 2e-4, err
+    synGk = [moose.element('%s/dend/syn' % c.path).Gk for c in (plain, solved)]
+    assert np.isclose(synGk[0], synGk[1], rtol=1e-6), synGk
+
+    # Parameters set on the zombies must reach the solver.
+    for cell in (plain, solved):
+        moose.element('%s/dend/syn' % cell.path).Gbar = 3e-8
+        moose.element('%s/dend/syn' % cell.path).tau2 = 4e-3
+        moose.element('%s/soma/KCa' % cell.path).Gbar = 1e-4
+        moose.element('%s/dend/mc' % cell.path).gbar = [2e-5]
+        moose.element('%s/pg' % cell.path).firstDelay = 1e-3
+    moose.reinit()
+    err = 0.0
+    for t in range(20):
+        moose.start(1e-3)
+        err = max(err, np.abs(Vm(plain) - Vm(solved)).max())
+    assert err < 2e-4, err
+    state = [moose.element('%s/dend/mc' % c.path).state for c in (plain, solved)]
+    assert np.allclose(state[0], state[1], rtol=1e-3), state
+
+def test_hsolve_float_tables():
+    # Single precision tables only round the rates.
+    for i in range(10):
+        moose.setClock(i, DT)
+    cells = [makeCell('double'), makeCell('single')]
+    for cell in cells:
+        hsolve = moose.HSolve('/hsolve_%s' % cell.name)
+        hsolve.dt = DT
+        hsolve.floatTables = cell.name == 'single'
+        hsolve.target = cell.path
+        moose.useClock(6, hsolve.path, 'process')
+    assert moose.element('/hsolve_single').floatTables
+
+    moose.reinit()
+    err = 0.0
+    for t in range(20):
+        moose.start(1e-3)
+        err = max(err, np.abs(Vm(cells[0]) - Vm(cells[1])).max())
+    assert 0 < err < 1e-5, err
+
+if __name__ == '__main__':
+    test_hsolve_channels()
+    test_hsolve_float_tables()
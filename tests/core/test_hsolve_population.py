@@ -0,0 +1,89 @@
+# Check that an HSolve array in population mode, which integrates identical
+# cells as one batch, gives the same answer as the per-cell solvers.
+
+import numpy as np
+import moose
+
+EREST = -0.07
+NCELLS = 5
+
+def makeLib():
+    lib = moose.Neutral('/library')
+    na = moose.HHChannel('/library/Na')
+    na.Ek = EREST + 0.115
+    na.Xpower = 3
+    na.Ypower = 1
+    na.gateX.setupAlpha([0.1e6 * (EREST + 0.025), -0.1e6, -1.0,
+                         -(EREST + 0.025), -0.01, 4e3, 0.0, 0.0,
+                         -EREST, 0.018, 150, -0.1, 0.05])
+    na.gateY.setupAlpha([70.0, 0.0, 0.0, -EREST, 0.02, 1e3, 0.0, 1.0,
+                         -(EREST + 0.03), -0.01, 150, -0.1, 0.05])
+    k = moose.HHChannel('/library/K')
+    k.Ek = EREST - 0.012
+    k.Xpower = 4
+    k.gateX.setupAlpha([1e4 * (0.01 + EREST), -1e4, -1.0,
+                        -(EREST + 0.01), -0.01, 0.125e3, 0.0, 0.0,
+                        -EREST, 0.08, 150, -0.1, 0.05])
+    return lib
+
+def makeCell(parent, name):
+    """A soma with three dendrites, one of which branches."""
+    cell = moose.Neutral('%s/%s' % (parent, name))
+    compts = []
+    for cname, parentIndex in [('soma', -1), ('d0', 0), ('d1', 0),
+                               ('d2', 0), ('a', 1), ('b', 1), ('b0', 5)]:
+        c = moose.Compartment('%s/%s' % (cell.path, cname))
+        c.Cm = 0.007854e-6
+        c.Ra = 7639.44e3
+        c.Rm = 424.4e3
+        c.Em = EREST + 0.010613
+        c.initVm = EREST
+        if parentIndex >= 0:
+            moose.connect(compts[parentIndex], 'axial', c, 'raxial')
+        for chan, gbar in [('Na', 0.94248e-3), ('K', 0.282743e-3)]:
+            ch = moose.copy('/library/%s' % chan, c, chan)
+            ch.Gbar = gbar
+            moose.connect(c, 'channel', ch, 'channel')
+        compts.append(c)
+    return cell
+
+def runModel(name, population, numThreads=1):
+    model = moose.Neutral('/%s' % name)
+    for i in range(NCELLS):
+        cell = makeCell(model.path, 'c%d' % i)
+        moose.element('%s/soma' % cell.path).inject = 0.05e-9 + 0.02e-9 * i
+    hsolve = moose.vec('/%s_hsolve' % name, n=NCELLS, dtype='HSolve')
+    for i in range(NCELLS):
+        hsolve[i].dt = 2e-5
+        hsolve[i].population = population
+        hsolve[i].numThreads = numThreads
+        hsolve[i].target = '%s/c%d' % (model.path, i)
+    moose.useClock(1, '/%s_hsolve' % name, 'process')
+    return model
+
+def somaVm(model):
+    return np.array([moose.element('%s/c%d/soma' % (model.path, i)).Vm
+                     for i in range(NCELLS)])
+
+def test_hsolve_population():
+    makeLib()
+    moose.setClock(1, 2e-5)
+    single = runModel('single', False)
+    batch = runModel('batch', True, numThreads=2)
+    moose.reinit()
+    moose.start(0.02)
+    assert np.array_equal(somaVm(single), somaVm(batch)), \
+        (somaVm(single), somaVm(batch))
+    # The cells received different injections, so they must have diverged.
+    assert len(np.unique(somaVm(single))) == NCELLS
+
+    # Changing one cell through its zombie must reach the batch.
+    for model in (single, batch):
+        moose.element('%s/c2/soma/K' % model.path).Gbar = 0.1e-3
+        moose.element('%s/c3/d1' % model.path).Vm = -0.03
+    moose.start(0.01)
+    assert np.array_equal(somaVm(single), somaVm(batch)), \
+        (somaVm(single), somaVm(batch))
+
+if __name__ == '__main__':
+    test_hsolve_population()
@@ -0,0 +1,59 @@
+# Check that integrate-and-fire arrays in population mode, which advance all
+# their entries in one loop, give the same answer as the per-entry updates.
+
+import numpy as np
+import moose
+
+N = 100
+DT = 1e-4
+
+def makeNetwork(name, cls, population, numThreads=1):
+    """A ring of neurons, each exciting the next one through a synapse."""
+    net = moose.Neutral('/%s' % name)
+    nrn = moose.vec('%s/nrn' % net.path, N, 0, cls)
+    nrn.Rm = 1e8
+    nrn.Cm = 1e-10
+    nrn.Em = -0.065
+    nrn.initVm = -0.065
+    nrn.thresh = -0.05
+    nrn.vReset = -0.07
+    nrn.refractoryPeriod = 2e-3
+    nrn.inject = 1.5e-10 + 1e-12 * (np.arange(N) % 37)
+    if cls in ('ExIF', 'AdExIF'):
+        nrn.vPeak = -0.04
+        nrn.deltaThresh = 0.002
+    nrn[0].population = population
+    nrn[0].numThreads = numThreads
+
+    syn = moose.vec('%s/syn' % net.path, N, 0, 'SimpleSynHandler')
+    syn.numSynapses = 1
+    for i in range(N):
+        s = syn[(i + 1) % N].synapse[0]
+        s.weight = 0.004
+        s.delay = 1e-3 + 1e-4 * (i % 5)
+        moose.connect(nrn[i], 'spikeOut', s, 'addSpike')
+    moose.connect(syn, 'activationOut', nrn, 'activation', 'OneToOne')
+    moose.useClock(0, '%s/syn' % net.path, 'process')
+    moose.useClock(1, '%s/nrn' % net.path, 'process')
+    return nrn
+
+def test_intfire_population():
+    moose.setClock(0, DT)
+    moose.setClock(1, DT)
+    for cls in ['LIF', 'ExIF', 'AdExIF']:
+        modes = [(False, 1), (True, 1), (True, 4)]
+        names = ['%s%d' % (cls, i) for i in range(len(modes))]
+        nets = [makeNetwork(name, cls, pop, threads)
+                for name, (pop, threads) in zip(names, modes)]
+        moose.reinit()
+        moose.start(0.1)
+        last = [np.array(n.lastEventTime) for n in nets]
+        assert last[0].max() > 0, cls
+        for n, l in zip(nets[1:], last[1:]):
+            assert np.array_equal(np.array(nets[0].Vm), np.array(n.Vm)), cls
+            assert np.array_equal(last[0], l), cls
+        for name in names:
+            moose.delete('/' + name)
+
+if __name__ == '__main__':
+    test_intfire_population()
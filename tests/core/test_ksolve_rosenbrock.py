@@ -0,0 +1,55 @@
+# -*- coding: utf-8 -*-
+# Check the implicit 'rosenbrock' Ksolve method against LSODA, on a model
+# whose fast and slow reactions are six orders of magnitude apart.
+
+import numpy as np
+import moose
+
+def runModel(method):
+    if moose.exists('/compt'):
+        moose.delete('/compt')
+    compt = moose.CubeMesh('/compt')
+    compt.volume = 1e-20
+    a = moose.Pool('/compt/a')
+    b = moose.Pool('/compt/b')
+    c = moose.Pool('/compt/c')
+    e = moose.Pool('/compt/e')
+    a.concInit = 1.0
+    e.concInit = 0.01
+    fast = moose.Reac('/compt/fast')
+    moose.connect(fast, 'sub', a, 'reac')
+    moose.connect(fast, 'prd', b, 'reac')
+    fast.Kf = 1e4
+    fast.Kb = 2e4
+    slow = moose.Reac('/compt/slow')
+    moose.connect(slow, 'sub', b, 'reac')
+    moose.connect(slow, 'sub', b, 'reac')
+    moose.connect(slow, 'prd', c, 'reac')
+    slow.Kf = 0.01
+    slow.Kb = 0.0
+    enz = moose.MMenz('/compt/e/enz')
+    moose.connect(e, 'nOut', enz, 'enzDest')
+    moose.connect(enz, 'sub', c, 'reac')
+    moose.connect(enz, 'prd', a, 'reac')
+    enz.Km = 0.5
+    enz.kcat = 0.2
+
+    ksolve = moose.Ksolve('/compt/ksolve')
+    ksolve.method = method
+    stoich = moose.Stoich('/compt/stoich')
+    stoich.compartment = compt
+    stoich.ksolve = ksolve
+    stoich.path = '/compt/##'
+    moose.reinit()
+    moose.start(100)
+    return np.array([p.conc for p in (a, b, c)])
+
+def test_ksolve_rosenbrock():
+    ref = runModel('lsoda')
+    ros = runModel('rosenbrock')
+    assert np.allclose(ros, ref, rtol=1e-4, atol=1e-8), (ros, ref)
+    # 2b -> c, so a + b + 2c is conserved.
+    assert abs(ros[0] + ros[1] + 2 * ros[2] - 1.0) < 1e-6, ros
+
+if __name__ == '__main__':
+    test_ksolve_rosenbrock()
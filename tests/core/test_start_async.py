@@ -0,0 +1,72 @@
+# Check that a background run records the same values as a blocking run,
+# and that a Table can be polled while it goes on.
+
+import time
+import numpy as np
+import moose
+
+RUNTIME = 2.0
+
+def makeModel():
+    """A pulse generator recorded by a Table with a ring."""
+    model = moose.Neutral('/model')
+    pulse = moose.PulseGen('/model/pulse')
+    pulse.delay[0] = 0.1
+    pulse.width[0] = 0.2
+    pulse.level[0] = 1.0
+    tab = moose.Table('/model/tab')
+    tab.ringSize = 1 << 16
+    moose.connect(tab, 'requestOut', pulse, 'getOutputValue')
+    moose.setClock(0, 1e-4)
+    moose.useClock(0, '/model/##', 'process')
+    return tab
+
+def test_start_async():
+    tab = makeModel()
+    moose.reinit()
+    moose.start(RUNTIME)
+    expected = np.array(tab.vector)
+
+    moose.reinit()
+    run = moose.startAsync(RUNTIME)
+    rows = []
+    while not run.done:
+        rows.append(moose.poll(tab)[0])
+        assert 0.0 <= run.progress <= 1.0
+        time.sleep(1e-3)
+    run.wait()
+    data, dropped = moose.poll(tab)
+    rows.append(data)
+    assert dropped == 0
+    polled = np.concatenate(rows)
+    assert polled.shape == (len(expected), 2)
+    assert np.array_equal(polled[:, 1], np.array(tab.vector))
+    assert np.array_equal(polled[:, 1], expected)
+    assert run.progress == 1.0
+
+    # A run can be stopped early, and another started after it. While it
+    # goes on the model cannot be changed under the running clock, nor can
+    # vectors that the run may resize be read.
+    moose.reinit()
+    run = moose.startAsync(RUNTIME * 1000)
+    tab.ringSize = 16
+    assert tab.ringSize == 1 << 16
+    try:
+        moose.Neutral('/model/late')
+        assert False, 'created an object during a run'
+    except RuntimeError:
+        pass
+    assert not moose.exists('/model/late')
+    try:
+        tab.vector
+        assert False, 'read a vector during a run'
+    except RuntimeError:
+        pass
+    run.stop()
+    assert run.done
+    assert moose.element('/clock').currentTime < RUNTIME * 1000
+    moose.startAsync(0.01).wait()
+    moose.delete('/model')
+
+if __name__ == '__main__':
+    test_start_async()
@@ -17,6 +17,7 @@ __status__           = "Development"
 import os
 import sys
 import moose
+import moose.streamer_utils as streamer_utils
 import numpy as np
 print( '[INFO] Using moose form %s' % moose.__file__ )
 
@@ -70,6 +71,34 @@ def test_small( ):
     assert (len(a) == len(b) == len(c))
     print( ' MOOSE is done' )
 
+def test_bin_format():
+    # A chunked binary file holds the same data as a npy one.
+    if moose.exists('/comptD'):
+        moose.delete('/comptD')
+    moose.CubeMesh('/comptD')
+    a = moose.Pool('/comptD/a')
+    a.concInit = 1
+    b = moose.Pool('/comptD/b')
+    r = moose.Reac('/comptD/r')
+    moose.connect(r, 'sub', a, 'reac')
+    moose.connect(r, 'prd', b, 'reac')
+    r.Kf = 0.1
+    tabs = []
+    for fmt in ['npy', 'bin']:
+        t = moose.Table2('/comptD/tab_%s' % fmt)
+        t.datafile = 'tabled.%s' % fmt
+        moose.connect(t, 'requestOut', b, 'getConc')
+        tabs.append(t)
+    moose.reinit()
+    moose.start(100)
+    npData = np.load('tabled.npy')
+    binData, offset = streamer_utils.read_bin('tabled.bin')
+    assert offset == os.path.getsize('tabled.bin')
+    assert len(npData) == len(binData) > 0, (len(npData), len(binData))
+    assert binData.dtype.names == npData.dtype.names, binData.dtype
+    for name in npData.dtype.names:
+        assert (npData[name] == binData[name]).all()
+
 def buildLargeSystem(useStreamer = False):
     # create a huge system.
     if moose.exists('/comptB'):
@@ -144,6 +173,7 @@ def test_large_system():
 
 def main( ):
     test_small( )
+    test_bin_format()
     test_large_system()
     print( '[INFO] All tests passed' )
 
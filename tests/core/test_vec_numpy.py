@@ -0,0 +1,85 @@
+# Check bulk numpy access to fields of a moose.vec, and the snapshots
+# of solver state.
+
+import numpy as np
+import moose
+
+def test_vec_numpy():
+    n = 1000
+    compts = moose.vec('/compts', n, 0, 'Compartment')
+    vm = np.linspace(-0.08, 0.02, n)
+    compts.Vm = vm
+    assert np.array_equal(compts.Vm, vm)
+    assert all(compts[i].Vm == vm[i] for i in (0, 17, n - 1))
+    compts.Cm = 2e-12
+    assert np.all(compts.Cm == 2e-12)
+    compts.Vm = list(vm[::-1])
+    assert np.array_equal(compts.Vm, vm[::-1])
+
+    syn = moose.SimpleSynHandler('/syn')
+    syn.numSynapses = 5
+    syn.synapse.weight = np.arange(5.0)
+    assert np.array_equal(syn.synapse.weight, np.arange(5.0))
+
+    hh = moose.vec('/hh', 10, 0, 'HHChannel')
+    hh.instant = np.arange(10) % 3
+    assert np.array_equal(hh.instant, np.arange(10) % 3)
+    moose.delete('/compts')
+    moose.delete('/syn')
+    moose.delete('/hh')
+
+def test_solver_snapshots():
+    compt = moose.CubeMesh('/kin')
+    compt.volume = 1e-18
+    a = moose.Pool('/kin/a')
+    b = moose.Pool('/kin/b')
+    a.concInit = 1.0
+    reac = moose.Reac('/kin/reac')
+    moose.connect(reac, 'sub', a, 'reac')
+    moose.connect(reac, 'prd', b, 'reac')
+    reac.Kf = 1.0
+    reac.Kb = 0.5
+    ksolve = moose.Ksolve('/kin/ksolve')
+    stoich = moose.Stoich('/kin/stoich')
+    stoich.compartment = compt
+    stoich.ksolve = ksolve
+    stoich.path = '/kin/##'
+
+    cell = moose.Neutral('/cell')
+    prev = None
+    for i in range(5):
+        c = moose.Compartment('/cell/c%d' % i)
+        c.Rm, c.Ra, c.Cm, c.Em, c.initVm = 1e9, 1e6, 1e-11, -0.06, -0.07
+        if prev is not None:
+            moose.connect(prev, 'axial', c, 'raxial')
+        prev = c
+    moose.element('/cell/c0').inject = 1e-11
+    hsolve = moose.HSolve('/hsolve')
+    hsolve.dt = 1e-4
+    hsolve.target = '/cell'
+
+    moose.reinit()
+    moose.start(0.1)
+    nvec = moose.vec(ksolve).snapshot('nVec')
+    assert np.array_equal(nvec, ksolve.nVec[0])
+    before = nvec.copy()
+    moose.start(0.1)
+    assert np.array_equal(nvec, before)
+    nvec = moose.vec(ksolve).snapshot('nVec')
+    assert not np.array_equal(nvec, before)
+    assert np.array_equal(nvec, ksolve.nVec[0])
+
+    vm = moose.vec(hsolve).snapshot('Vm')
+    order = [moose.element(x).path for x in hsolve.compartments]
+    assert len(order) == 5
+    assert np.array_equal(vm, [moose.element(p).Vm for p in order])
+    moose.delete('/kin')
+    moose.delete('/cell')
+    moose.delete('/hsolve')
+    # The arrays own their data, so they outlive the solvers.
+    assert nvec.flags.owndata and vm.flags.owndata
+    assert len(vm) == 5
+
+if __name__ == '__main__':
+    test_vec_numpy()
+    test_solver_snapshots()
@@ -0,0 +1,96 @@
+/***
+ *    Description:  Fixed size cache that evicts the least recently used entry.
+ *
+ *        Created:  2026-10-18
+ *
+ *   Organization:  NCBS Bangalore
+ *        License:  GNU GPL3
+ */
+
+#ifndef _LRU_CACHE_H
+#define _LRU_CACHE_H
+
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace moose
+{
+
+/**
+ * @brief Map of at most capacity entries. A lookup moves the entry to
+ * the front of the use list, and inserting into a full cache evicts the
+ * entry at the back. Not thread safe.
+ */
+template< class K, class V > class LruCache
+{
+public:
+    explicit LruCache( size_t capacity ) : capacity_( capacity )
+    {;}
+
+    /// Copies the value of key into ret and returns true, if present.
+    bool get( const K& key, V& ret )
+    {
+        auto i = index_.find( key );
+        if ( i == index_.end() )
+            return false;
+        entries_.splice( entries_.begin(), entries_, i->second );
+        ret = i->second->second;
+        return true;
+    }
+
+    void put( const K& key, const V& value )
+    {
+        auto i = index_.find( key );
+        if ( i != index_.end() )
+        {
+            i->second->second = value;
+            entries_.splice( entries_.begin(), entries_, i->second );
+            return;
+        }
+        if ( capacity_ == 0 )
+            return;
+        if ( entries_.size() == capacity_ )
+        {
+            index_.erase( entries_.back().first );
+            entries_.pop_back();
+        }
+        entries_.emplace_front( key, value );
+        index_[ key ] = entries_.begin();
+    }
+
+    void erase( const K& key )
+    {
+        auto i = index_.find( key );
+        if ( i == index_.end() )
+            return;
+        entries_.erase( i->second );
+        index_.erase( i );
+    }
+
+    void clear()
+    {
+        index_.clear();
+        entries_.clear();
+    }
+
+    size_t size() const
+    {
+        return entries_.size();
+    }
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+private:
+    size_t capacity_;
+    std::list< std::pair< K, V > > entries_; ///< Most recently used first
+    std::unordered_map< K,
+        typename std::list< std::pair< K, V > >::iterator > index_;
+};
+
+} // namespace moose
+
+#endif // _LRU_CACHE_H
@@ -0,0 +1,98 @@
+/***
+ *    Description:  Lock-free ring buffer for one writer and one reader.
+ *
+ *        Created:  2026-10-18
+ *
+ *   Organization:  NCBS Bangalore
+ *        License:  GNU GPL3
+ */
+
+#ifndef _RING_BUFFER_H
+#define _RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace moose
+{
+
+/**
+ * @brief Fixed size queue that one thread fills while another drains it,
+ * without locks.
+ *
+ * The writer only moves head_ and the reader only moves tail_, each with
+ * release stores that the other side reads with acquire loads, so a
+ * value is fully written before the reader can see it. When the buffer
+ * is full, push drops the value and counts it in dropped(); the writer
+ * never waits for the reader.
+ */
+template< class T > class RingBuffer
+{
+public:
+    /// Holds at least capacity values; the size is rounded up to a power of 2.
+    explicit RingBuffer( size_t capacity )
+        : head_( 0 ), tail_( 0 ), dropped_( 0 )
+    {
+        size_t n = 1;
+        while ( n < capacity )
+            n *= 2;
+        data_.resize( n );
+        mask_ = n - 1;
+    }
+
+    size_t capacity() const
+    {
+        return data_.size();
+    }
+
+    /// Writer side. Returns false, and drops the value, if full.
+    bool push( const T& value )
+    {
+        size_t head = head_.load( std::memory_order_relaxed );
+        if ( head - tail_.load( std::memory_order_acquire ) == data_.size() )
+        {
+            dropped_.fetch_add( 1, std::memory_order_relaxed );
+            return false;
+        }
+        data_[ head & mask_ ] = value;
+        head_.store( head + 1, std::memory_order_release );
+        return true;
+    }
+
+    /// Reader side. Appends all values written so far to ret.
+    size_t drain( std::vector< T >& ret )
+    {
+        size_t tail = tail_.load( std::memory_order_relaxed );
+        size_t head = head_.load( std::memory_order_acquire );
+        for ( size_t i = tail; i != head; ++i )
+            ret.push_back( data_[ i & mask_ ] );
+        tail_.store( head, std::memory_order_release );
+        return head - tail;
+    }
+
+    /// Number of values dropped because the buffer was full.
+    size_t dropped() const
+    {
+        return dropped_.load( std::memory_order_relaxed );
+    }
+
+    /// Empties the buffer. Neither side may be in use at the same time.
+    void clear()
+    {
+        head_.store( 0 );
+        tail_.store( 0 );
+        dropped_.store( 0 );
+    }
+
+private:
+    std::vector< T > data_;
+    size_t mask_;
+    std::atomic< size_t > head_;   ///< Next slot to write
+    std::atomic< size_t > tail_;   ///< Next slot to read
+    std::atomic< size_t > dropped_;
+};
+
+} // namespace moose
+
+#endif // _RING_BUFFER_H
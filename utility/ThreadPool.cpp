@@ -0,0 +1,164 @@
+/***
+ *    Description:  Persistent worker pool shared by the multithreaded solvers.
+ *
+ *        Created:  2026-10-18
+ *
+ *   Organization:  NCBS Bangalore
+ *        License:  GNU GPL3
+ */
+
+#include <algorithm>
+#include <cassert>
+
+#include "utility.h"
+#include "ThreadPool.h"
+
+namespace moose
+{
+
+thread_local bool ThreadPool::isWorker_ = false;
+thread_local bool ThreadPool::inJob_ = false;
+
+ThreadPool::ThreadPool( size_t numThreads ) :
+    job_( nullptr ),
+    generation_( 0 ),
+    busy_( 0 ),
+    stop_( false )
+{
+    reserve( numThreads );
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard< std::mutex > lock( mutex_ );
+        stop_ = true;
+    }
+    wakeCv_.notify_all();
+    for ( auto& t : workers_ )
+        t.join();
+}
+
+ThreadPool& ThreadPool::global()
+{
+    static ThreadPool pool( std::max( 1, getEnvInt( "MOOSE_NUM_THREADS", 1 ) ) );
+    return pool;
+}
+
+size_t ThreadPool::size() const
+{
+    return workers_.size() + 1;
+}
+
+void ThreadPool::reserve( size_t numThreads )
+{
+    // Never resize while a job is running. From inside a job the pool
+    // stays as it is, since this thread may already hold runMutex_.
+    if ( isWorker_ || inJob_ )
+        return;
+    std::lock_guard< std::mutex > runLock( runMutex_ );
+    while ( workers_.size() + 1 < numThreads )
+        workers_.emplace_back( &ThreadPool::workerLoop, this );
+}
+
+size_t ThreadPool::grainSize( size_t n, size_t numThreads )
+{
+    // Four chunks per thread is enough to even out uneven voxels without
+    // making the shared counter a hotspot.
+    const size_t numChunks = std::max< size_t >( 1, numThreads * 4 );
+    return std::max< size_t >( 1, ( n + numChunks - 1 ) / numChunks );
+}
+
+void ThreadPool::runChunks( Job& job )
+{
+    size_t chunk;
+    while ( ( chunk = job.next.fetch_add( 1 ) ) < job.numChunks )
+    {
+        size_t begin = chunk * job.grain;
+        size_t end = std::min( job.n, begin + job.grain );
+        ( *job.func )( begin, end );
+        job.done.fetch_add( 1 );
+    }
+}
+
+void ThreadPool::workerLoop()
+{
+    isWorker_ = true;
+    size_t seen = 0;
+    std::unique_lock< std::mutex > lock( mutex_ );
+    while ( true )
+    {
+        wakeCv_.wait( lock, [&]() {
+                return stop_ || ( job_ && generation_ != seen );
+                } );
+        if ( stop_ )
+            return;
+        seen = generation_;
+        Job* job = job_;
+        if ( job->joined.fetch_add( 1 ) >= job->maxWorkers )
+            continue;
+        ++busy_;
+        lock.unlock();
+        runChunks( *job );
+        lock.lock();
+        if ( --busy_ == 0 )
+            doneCv_.notify_all();
+    }
+}
+
+void ThreadPool::parallelFor( size_t n, size_t grain, const ChunkFunc& func,
+        size_t maxThreads )
+{
+    if ( n == 0 )
+        return;
+    grain = std::max< size_t >( 1, grain );
+    if ( maxThreads == 0 || maxThreads > size() )
+        maxThreads = size();
+
+    // The caller of a running job holds runMutex_, so it must not
+    // try_lock it again.
+    std::unique_lock< std::mutex > runLock( runMutex_, std::defer_lock );
+    if ( isWorker_ || inJob_ || maxThreads < 2 || n <= grain ||
+            !runLock.try_lock() )
+    {
+        // Nested or concurrent call: do it here, in order.
+        for ( size_t begin = 0; begin < n; begin += grain )
+            func( begin, std::min( n, begin + grain ) );
+        return;
+    }
+
+    Job job;
+    job.func = &func;
+    job.n = n;
+    job.grain = grain;
+    job.numChunks = ( n + grain - 1 ) / grain;
+    job.maxWorkers = maxThreads - 1;
+    job.next = 0;
+    job.done = 0;
+    job.joined = 0;
+
+    {
+        std::lock_guard< std::mutex > lock( mutex_ );
+        job_ = &job;
+        ++generation_;
+    }
+    wakeCv_.notify_all();
+
+    {
+        struct InJob
+        {
+            InJob() { inJob_ = true; }
+            ~InJob() { inJob_ = false; }
+        } inJob;
+        runChunks( job );
+    }
+
+    std::unique_lock< std::mutex > lock( mutex_ );
+    doneCv_.wait( lock, [&]() {
+            return busy_ == 0 && job.done.load() == job.numChunks;
+            } );
+    job_ = nullptr;
+    assert( job.done == job.numChunks );
+}
+
+} // namespace moose
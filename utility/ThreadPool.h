@@ -0,0 +1,109 @@
+/***
+ *    Description:  Persistent worker pool shared by the multithreaded solvers.
+ *
+ *        Created:  2026-10-18
+ *
+ *   Organization:  NCBS Bangalore
+ *        License:  GNU GPL3
+ */
+
+#ifndef _THREAD_POOL_H
+#define _THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace moose
+{
+
+/**
+ * @brief A process-wide pool of worker threads.
+ *
+ * Solvers used to create a fresh set of std::async tasks on every clock
+ * step, which costs as much as the integration itself when dt is small.
+ * The pool keeps its threads alive across steps. Work is handed out as
+ * a range [0, n) cut into chunks of `grain` items; every participating
+ * thread (the caller included) keeps claiming the next unclaimed chunk
+ * from a shared atomic counter until the range is exhausted, so a thread
+ * that finishes early steals the chunks a slow one has not reached yet.
+ *
+ * Only one parallelFor runs at a time. A call made from inside a pool
+ * task, or while another call is in flight, runs serially on the calling
+ * thread instead of deadlocking.
+ */
+class ThreadPool
+{
+public:
+    typedef std::function< void( size_t begin, size_t end ) > ChunkFunc;
+
+    explicit ThreadPool( size_t numThreads = 1 );
+    ~ThreadPool();
+
+    /**
+     * The shared pool. It is created on first use with MOOSE_NUM_THREADS
+     * threads and grows when a solver asks for more via reserve().
+     */
+    static ThreadPool& global();
+
+    /// Total number of threads that can work on a job, caller included.
+    size_t size() const;
+
+    /// Make sure at least numThreads threads (caller included) exist.
+    void reserve( size_t numThreads );
+
+    /**
+     * Run func over [0, n) in chunks of `grain` items using at most
+     * maxThreads threads (0 means all of them). Blocks until every
+     * chunk is done.
+     */
+    void parallelFor( size_t n, size_t grain, const ChunkFunc& func,
+            size_t maxThreads = 0 );
+
+    /// Chunk size giving each of numThreads threads a few chunks to steal.
+    static size_t grainSize( size_t n, size_t numThreads );
+
+private:
+    struct Job
+    {
+        const ChunkFunc* func;
+        size_t n;
+        size_t grain;
+        size_t numChunks;
+        size_t maxWorkers;
+        std::atomic< size_t > next;
+        std::atomic< size_t > done;
+        std::atomic< size_t > joined;
+    };
+
+    void workerLoop();
+    static void runChunks( Job& job );
+
+    std::vector< std::thread > workers_;
+
+    /// Serializes parallelFor calls.
+    std::mutex runMutex_;
+
+    /// Guards job_, generation_, busy_ and stop_.
+    std::mutex mutex_;
+    std::condition_variable wakeCv_;
+    std::condition_variable doneCv_;
+
+    Job* job_;
+    size_t generation_;
+    size_t busy_;
+    bool stop_;
+
+    /// True on the pool's own worker threads.
+    static thread_local bool isWorker_;
+
+    /// True on the thread that called parallelFor while its job runs.
+    static thread_local bool inJob_;
+};
+
+} // namespace moose
+
+#endif // _THREAD_POOL_H
@@ -164,35 +164,29 @@ void changeHeaderShape(std::fstream& fs, const size_t data_len, const size_t num
     fs.write(newHeader.c_str(), newHeader.size());
 }
 
-size_t writeHeader(std::fstream& fs, const vector<string>& colnames, const vector<size_t>& shape)
+string npyHeader(const vector<string>& colnames, const vector<size_t>& shape, size_t minSize)
 {
-    // Heder are always at the begining of file.
-    fs.seekp(0);
-
-    // Write the format string. 8 bytes.
-    fs.write(&__pre__[0], __pre__.size());
-
+    // The format string. 8 bytes.
+    string res(__pre__.begin(), __pre__.end());
     char endianChar = cnpy2::BigEndianTest();
     const char formatChar = 'd';
-
     // Next 4 bytes are header length. This is computed again when data is
     // appended to the file. We can have maximum of 2^32 bytes of header which
     // ~4GB.
-
     string header = ""; // This is the header to numpy file
     header += "{'descr':[";
     for( auto it = colnames.cbegin(); it != colnames.end(); it++ )
         header += "('" + *it + "','" + endianChar + formatChar + "'),";
-
     // shape is changed everytime we append the data. We use fixed number of
     // character in shape. Its a int, we will use 13 chars to represent shape.
     header += "], 'fortran_order':False,'shape':";
     header += shapeToString(shape);
     header += ",}";
-
     // Add some extra sapce for safety.
     header += string(12, ' ');
-
+    // Make room for a header of minSize bytes, newline included.
+    if( 12 + header.size() + 1 < minSize )
+        header += string(minSize - 12 - header.size() - 1, ' ');
     // FROM THE DOC: It is terminated by a newline (\n) and padded with spaces
     // (\x20) to make the total of len(magic string) + 2 + len(length) +
     // HEADER_LEN be evenly divisible by 64 for alignment purposes.
@@ -202,14 +196,20 @@ size_t writeHeader(std::fstream& fs, const vector<string>& colnames, const vecto
     unsigned int remainder = 16 - (12 + header.size()) % 16;
     header.insert(header.end(), remainder-1, ' ');
     header += '\n';                             // Add newline. 
-
     // Now write the size of header. Its 4 byte long in version 2.
     uint32_t s = header.size();
-    fs.write((char*)&s, 4);
-    fs << header;
-    return fs.tellp();
+    res.append((char*)&s, 4);
+    res += header;
+    return res;
 }
 
+size_t writeHeader(std::fstream& fs, const vector<string>& colnames, const vector<size_t>& shape)
+{
+    // Heder are always at the begining of file.
+    fs.seekp(0);
+    fs << npyHeader(colnames, shape);
+    return fs.tellp();
+}
 
 size_t initNumpyFile(const string& outfile, const vector<string>& colnames)
 {
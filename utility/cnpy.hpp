@@ -81,6 +81,14 @@ static vector<char> __pre__ {
     , (char)0x02, (char) 0x00               /* format */
 };
 
+/**
+ * @brief The complete header, magic string included, of a npy file that
+ * holds a table with the given column names and shape. It is padded with
+ * spaces to at least minSize bytes, so that a header written with room to
+ * spare can later be overwritten in place by one with a larger shape.
+ */
+string npyHeader(const vector<string>& colnames, const vector<size_t>& shape, size_t minSize = 0);
+
 size_t writeHeader(std::fstream& fp, const vector<string>& colnames, const vector<size_t>& shape);
 
 void writeNumpy(const string& outfile, const vector<double>& vec, const vector<string>& colnames);